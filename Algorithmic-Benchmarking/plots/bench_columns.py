@@ -0,0 +1,78 @@
+import os
+import mmap
+import struct
+from glob import glob
+import numpy as np
+import pandas as pd
+
+# === samples.bin layout (written by bench_write_columns in src/common/bench_output.c) ===
+# Header (208 bytes): magic, version, header size, columns, batch, rows, algorithm, host, timer
+# Column descriptor (72 bytes): op, metric, dtype (1 = f64), reserved, data offset, count
+# Columns: little-endian f64 arrays starting at a 64-byte aligned offset
+MAGIC = b"BENCHCOL"
+HEADER = struct.Struct("<8sIIIIQ96s64s16s")
+COLUMN = struct.Struct("<16s32sIIQQ")
+DTYPES = {1: np.dtype("<f8")}
+
+
+def _text(raw):
+    return raw.split(b"\0", 1)[0].decode()
+
+
+class ColumnFile:
+    """Memory-mapped samples.bin; columns are numpy views without copying."""
+
+    def __init__(self, path):
+        self.path = path
+        with open(path, "rb") as f:
+            self._map = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+
+        (magic, self.version, header_size, ncolumns, self.batch, self.rows,
+         algorithm, host, timer) = HEADER.unpack_from(self._map, 0)
+        if magic != MAGIC:
+            raise ValueError(f"{path}: not a samples.bin file")
+        if self.version != 1:
+            raise ValueError(f"{path}: unsupported version {self.version}")
+        self.algorithm, self.host, self.timer = _text(algorithm), _text(host), _text(timer)
+
+        self.columns = []
+        for i in range(ncolumns):
+            op, metric, dtype, _, offset, count = COLUMN.unpack_from(
+                self._map, HEADER.size + i * COLUMN.size)
+            if offset < header_size or dtype not in DTYPES:
+                raise ValueError(f"{path}: bad descriptor for column {i}")
+            self.columns.append({"op": _text(op), "metric": _text(metric),
+                                 "dtype": DTYPES[dtype], "offset": offset, "count": count})
+
+    def names(self):
+        return [f"{c['op']}_{c['metric']}" for c in self.columns]
+
+    def column(self, op, metric):
+        for c in self.columns:
+            if c["op"] == op and c["metric"] == metric:
+                return np.frombuffer(self._map, dtype=c["dtype"], count=c["count"], offset=c["offset"])
+        raise KeyError(f"{op}_{metric}")
+
+    def to_dict(self):
+        """Columns keyed like the raw CSV files: "<op>_<metric>" -> numpy array."""
+        return {f"{c['op']}_{c['metric']}": self.column(c["op"], c["metric"]) for c in self.columns}
+
+    def to_frame(self):
+        return pd.DataFrame(self.to_dict())
+
+
+# === Helper Function: Raw samples of a result folder (samples.bin or raw_*.csv) ===
+def load_raw(folder):
+    """Return {"<op>_<metric>": pandas.Series} for a benchmark result folder."""
+    path = os.path.join(folder, "samples.bin")
+    if os.path.isfile(path):
+        return {name: pd.Series(values) for name, values in ColumnFile(path).to_dict().items()}
+
+    raw = {}
+    for filepath in sorted(glob(os.path.join(folder, "raw_*.csv"))):
+        if os.path.getsize(filepath) == 0:
+            continue  # Counter files of runs without a usable PMU are empty
+        name = os.path.basename(filepath).replace("raw_", "").replace(".csv", "")
+        data = pd.read_csv(filepath, header=None).squeeze("columns")
+        raw[name] = pd.to_numeric(data, errors="coerce").dropna().reset_index(drop=True)
+    return raw
@@ -3,7 +3,7 @@ import os
 import pandas as pd
 import matplotlib.pyplot as plt
 import seaborn as sns
-from glob import glob
+from bench_columns import load_raw
 
 # === Style Configuration ===
 sns.set(style="whitegrid")
@@ -13,9 +13,8 @@ if len(sys.argv) < 2:
     print("Usage: python3 boxplot_combined_metrics.py <DATA_FOLDER>")
     sys.exit(1)
 
-# Folder containing raw_*.csv files
+# Folder containing samples.bin or raw_*.csv files
 DATA_FOLDER = sys.argv[1]
-RAW_PATTERN = os.path.join(DATA_FOLDER, "raw_*.csv")
 
 # Output path for generated plots
 OUTPUT_FOLDER = os.path.join(DATA_FOLDER, "plots")
@@ -33,11 +32,7 @@ def clip_outliers(df, percentile=0.95):
 cycles_data = {}
 us_data = {}
 
-for filepath in glob(RAW_PATTERN):
-    name = os.path.basename(filepath).replace("raw_", "").replace(".csv", "")
-    data = pd.read_csv(filepath, header=None).squeeze()
-    data = pd.to_numeric(data, errors="coerce").dropna()
-
+for name, data in load_raw(DATA_FOLDER).items():
     if name.endswith("cycles"):
         cycles_data[name] = data.reset_index(drop=True)
     elif name.endswith("us"):
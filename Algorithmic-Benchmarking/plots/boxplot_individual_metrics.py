@@ -1,9 +1,8 @@
-import pandas as pd
 import matplotlib.pyplot as plt
 import seaborn as sns
 import os
 import sys
-from glob import glob
+from bench_columns import load_raw
 
 # === USAGE CHECK ===
 if len(sys.argv) < 2:
@@ -26,20 +25,13 @@ def clip_outliers(series, percentile=0.95):
     return series.clip(upper=threshold)
 
 # === LOAD AND PLOT ===
-raw_files = glob(os.path.join(DATA_FOLDER, "raw_*.csv"))
+raw_data = load_raw(DATA_FOLDER)
 
-if not raw_files:
-    print(f"No raw_*.csv files found in {DATA_FOLDER}")
+if not raw_data:
+    print(f"No samples.bin or raw_*.csv files found in {DATA_FOLDER}")
     sys.exit(0)
 
-for filepath in raw_files:
-    filename = os.path.basename(filepath)
-    label = filename.replace("raw_", "").replace(".csv", "")
-
-    # Load data
-    data = pd.read_csv(filepath, header=None).squeeze()
-    data = pd.to_numeric(data, errors="coerce").dropna()
-
+for label, data in raw_data.items():
     if CLIP_OUTLIERS:
         data = clip_outliers(data, percentile=CLIP_PERCENTILE)
 
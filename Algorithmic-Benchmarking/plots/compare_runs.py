@@ -0,0 +1,166 @@
+import os
+import sys
+import math
+import argparse
+from glob import glob
+import numpy as np
+import pandas as pd
+from bench_columns import load_raw
+
+# === Cross-run regression check ===
+# Matches every algorithm/operation of a baseline and a candidate result tree, compares
+# the raw samples and exits with 1 if any operation got significantly slower than the
+# threshold allows. Exit code 2 means nothing could be compared.
+
+
+# === Argument Parsing ===
+parser = argparse.ArgumentParser(
+    description="Compare two benchmark result trees and flag regressions.",
+    epilog="Example: python3 compare_runs.py Results_Algorithmic-Benchmarking/Rasp1 benchmarks "
+           "--threshold 5 --only ML-KEM-768")
+parser.add_argument("baseline", help="Result tree of the reference run (e.g. .../Rasp1)")
+parser.add_argument("candidate", help="Result tree of the new run")
+parser.add_argument("--threshold", type=float, default=5.0,
+                    help="Relative slowdown of the median in percent that counts as regression (default 5)")
+parser.add_argument("--test", choices=["mwu", "bootstrap"], default="mwu",
+                    help="Mann-Whitney U test (default) or bootstrap CI of the median ratio")
+parser.add_argument("--alpha", type=float, default=0.01,
+                    help="Significance level / 1 - confidence of the CI (default 0.01)")
+parser.add_argument("--metric", default="us", help="Metric to compare (default us)")
+parser.add_argument("--resamples", type=int, default=2000, help="Bootstrap resamples (default 2000)")
+parser.add_argument("--max-samples", type=int, default=200000,
+                    help="Random subsample per side for very long runs (default 200000)")
+parser.add_argument("--only", action="append", default=[],
+                    help="Only compare this algorithm (repeatable)")
+parser.add_argument("--csv", help="Also write the comparison table to this CSV file")
+args = parser.parse_args()
+
+rng = np.random.default_rng(1)
+
+
+# === Helper Function: Normalize folder names (hqc_128, HQC-128 -> hqc-128) ===
+def normalize(name):
+    return name.lower().replace("_", "-")
+
+
+# === Helper Function: Latest run per (host folder, kind, algorithm) of a tree ===
+# The root is either a "benchmarks" folder itself (as the driver writes it) or a
+# tree containing one or more of them.
+def find_runs(root):
+    runs = {}
+    summaries = glob(os.path.join(root, "*", "*", "*", "summary.csv"))
+    direct = bool(summaries)
+    if not direct:
+        summaries = glob(os.path.join(root, "**", "benchmarks", "*", "*", "*", "summary.csv"),
+                         recursive=True)
+    for summary in summaries:
+        run = os.path.dirname(summary)
+        alg_dir = os.path.dirname(run)
+        kind_dir = os.path.dirname(alg_dir)
+        prefix = "." if direct else \
+            os.path.relpath(os.path.dirname(os.path.dirname(kind_dir)), root)
+        key = (prefix if prefix != "." else "", os.path.basename(kind_dir),
+               normalize(os.path.basename(alg_dir)))
+        # Timestamps sort chronologically
+        if key not in runs or os.path.basename(run) > os.path.basename(runs[key]):
+            runs[key] = run
+    return runs
+
+
+def subsample(values):
+    values = np.asarray(values, dtype=float)
+    if len(values) > args.max_samples:
+        values = rng.choice(values, args.max_samples, replace=False)
+    return values
+
+
+# === Mann-Whitney U, one-sided (candidate larger), normal approximation with tie correction ===
+def mann_whitney(base, cand):
+    n1, n2 = len(base), len(cand)
+    values = np.concatenate([base, cand])
+    order = np.argsort(values, kind="mergesort")
+    ranks = np.empty(len(values))
+    sorted_vals = values[order]
+    # Average ranks for ties
+    _, first, counts = np.unique(sorted_vals, return_index=True, return_counts=True)
+    avg = first + (counts + 1) / 2.0
+    ranks[order] = np.repeat(avg, counts)
+
+    u_cand = ranks[n1:].sum() - n2 * (n2 + 1) / 2.0
+    n = n1 + n2
+    tie = (counts ** 3 - counts).sum()
+    sigma = np.sqrt(n1 * n2 / 12.0 * ((n + 1) - tie / (n * (n - 1))))
+    if sigma == 0:
+        return 1.0
+    z = (u_cand - n1 * n2 / 2.0 - 0.5) / sigma
+    return 0.5 * math.erfc(float(z) / math.sqrt(2))
+
+
+# === Bootstrap CI of median(candidate) / median(baseline) - 1 ===
+def bootstrap(base, cand):
+    ratios = np.empty(args.resamples)
+    chunk = max(1, 20000000 // (len(base) + len(cand)))
+    for start in range(0, args.resamples, chunk):
+        k = min(chunk, args.resamples - start)
+        mb = np.median(rng.choice(base, (k, len(base))), axis=1)
+        mc = np.median(rng.choice(cand, (k, len(cand))), axis=1)
+        ratios[start:start + k] = mc / mb - 1.0
+    lo, hi = np.quantile(ratios, [args.alpha / 2, 1 - args.alpha / 2])
+    return lo * 100, hi * 100
+
+
+# === Match and compare ===
+base_runs, cand_runs = find_runs(args.baseline), find_runs(args.candidate)
+only = {normalize(a) for a in args.only}
+rows, regressions = [], 0
+
+for key in sorted(base_runs.keys() & cand_runs.keys()):
+    host, kind, alg = key
+    if only and alg not in only:
+        continue
+    base_raw, cand_raw = load_raw(base_runs[key]), load_raw(cand_runs[key])
+
+    for name in sorted(base_raw.keys() & cand_raw.keys()):
+        op, _, metric = name.partition("_")
+        if metric != args.metric:
+            continue
+        base, cand = subsample(base_raw[name]), subsample(cand_raw[name])
+        if len(base) < 2 or len(cand) < 2:
+            continue
+        mb, mc = np.median(base), np.median(cand)
+        change = (mc / mb - 1.0) * 100 if mb > 0 else 0.0
+
+        if args.test == "mwu":
+            # Significantly slower and the median moved by more than the threshold
+            p = mann_whitney(base, cand)
+            regression = p < args.alpha and change > args.threshold
+            detail = f"p={p:.2g}"
+        else:
+            # Even the optimistic end of the CI is slower than the threshold
+            lo, hi = bootstrap(base, cand)
+            regression = lo > args.threshold
+            detail = f"CI=[{lo:+.1f}%, {hi:+.1f}%]"
+        regressions += regression
+
+        status = "REGRESSION" if regression else ("faster" if change < -args.threshold else "ok")
+        rows.append({"Host": host, "Kind": kind, "Algorithm": alg, "Operation": op,
+                     "Metric": metric, "BaselineMedian": mb, "CandidateMedian": mc,
+                     "ChangePercent": change, "Test": detail, "Status": status})
+
+if not rows:
+    print("No matching algorithm/operation pairs found")
+    sys.exit(2)
+
+# === Report ===
+print(f"{'Algorithm':<28} {'Op':<8} {'Baseline':>12} {'Candidate':>12} {'Change':>8}  {'Test':<26} Status")
+for r in rows:
+    name = f"{r['Host']}/{r['Algorithm']}" if r["Host"] else r["Algorithm"]
+    print(f"{name:<28} {r['Operation']:<8} {r['BaselineMedian']:>12.2f} {r['CandidateMedian']:>12.2f} "
+          f"{r['ChangePercent']:>+7.1f}%  {r['Test']:<26} {r['Status']}")
+
+if args.csv:
+    pd.DataFrame(rows).to_csv(args.csv, index=False)
+
+print(f"\n{len(rows)} operation(s) compared, {regressions} regression(s) above {args.threshold:g}% "
+      f"({args.test}, alpha {args.alpha:g})")
+sys.exit(1 if regressions else 0)
@@ -0,0 +1,34 @@
+import os
+import sys
+from bench_columns import ColumnFile
+
+# === Argument Parsing ===
+if len(sys.argv) < 2 or sys.argv[1] not in ("csv", "parquet"):
+    print("Usage: python3 export_columns.py csv|parquet <DATA_FOLDER>...")
+    print("  csv     : write raw_<op>_<metric>.csv next to samples.bin (old layout)")
+    print("  parquet : write samples.parquet, one column per operation & metric")
+    sys.exit(1)
+
+FORMAT = sys.argv[1]
+
+# === Export every given result folder ===
+for folder in sys.argv[2:]:
+    path = os.path.join(folder, "samples.bin")
+    if not os.path.isfile(path):
+        print(f"samples.bin not found in {folder}")
+        continue
+
+    cols = ColumnFile(path)
+    if FORMAT == "csv":
+        for name, values in cols.to_dict().items():
+            # Same precision as the driver's own CSV output
+            fmt = "%.2f" if name.endswith("_us") else "%.0f"
+            with open(os.path.join(folder, f"raw_{name}.csv"), "w") as f:
+                f.write("\n".join(fmt % v for v in values))
+                f.write("\n")
+    else:
+        df = cols.to_frame()
+        df.attrs.update({"algorithm": cols.algorithm, "host": cols.host, "timer": cols.timer})
+        df.to_parquet(os.path.join(folder, "samples.parquet"))  # needs pyarrow
+
+    print(f"Exported {len(cols.columns)} columns ({cols.rows} rows) of {cols.algorithm} in {folder}")
@@ -1,9 +1,8 @@
-import pandas as pd
 import matplotlib.pyplot as plt
 import seaborn as sns
 import os
 import sys
-from glob import glob
+from bench_columns import load_raw
 
 # === USAGE CHECK ===
 if len(sys.argv) < 2:
@@ -18,19 +17,15 @@ os.makedirs(OUTPUT_FOLDER, exist_ok=True)
 # === STYLING ===
 sns.set(style="whitegrid")
 
-# === LOAD raw_*.csv FILES ===
-raw_files = glob(os.path.join(DATA_FOLDER, "raw_*.csv"))
+# === LOAD samples.bin OR raw_*.csv FILES ===
+raw_data = load_raw(DATA_FOLDER)
 
-if not raw_files:
-    print(f"No raw_*.csv files found in {DATA_FOLDER}")
+if not raw_data:
+    print(f"No samples.bin or raw_*.csv files found in {DATA_FOLDER}")
     sys.exit(0)
 
 # === PLOTTING LOOP ===
-for filepath in raw_files:
-    data = pd.read_csv(filepath, header=None).squeeze()
-    data = pd.to_numeric(data, errors="coerce").dropna()
-
-    filename = os.path.basename(filepath).replace("raw_", "").replace(".csv", "")
+for filename, data in raw_data.items():
 
     # Label y-axis depending on type
     if "us" in filename:
@@ -0,0 +1,93 @@
+import os
+import sys
+import math
+import struct
+import matplotlib.pyplot as plt
+import seaborn as sns
+
+# === Style Configuration ===
+sns.set(style="whitegrid")
+
+# === Argument Parsing ===
+if len(sys.argv) < 2:
+    print("Usage: python3 plot_hdr_percentiles.py <DATA_FOLDER>")
+    sys.exit(1)
+
+DATA_FOLDER = sys.argv[1]
+HIST_PATH = os.path.join(DATA_FOLDER, "histograms.bin")
+OUTPUT_FOLDER = os.path.join(DATA_FOLDER, "plots")
+os.makedirs(OUTPUT_FOLDER, exist_ok=True)
+
+PERCENTILES = [50, 75, 90, 95, 99, 99.5, 99.9, 99.95, 99.99, 99.999]
+
+# === Helper Function: Read histograms.bin (layout in README.md) ===
+def read_histograms(path):
+    hists = []
+    with open(path, "rb") as f:
+        data = f.read()
+    pos = 0
+    while pos < len(data):
+        if data[pos:pos + 4] != b"BHST":
+            raise ValueError(f"Bad histogram magic at offset {pos}")
+        sub_bits = data[pos + 4]
+        pos += 5
+        names = []
+        for _ in range(2):
+            n = data[pos]
+            names.append(data[pos + 1:pos + 1 + n].decode())
+            pos += 1 + n
+        unit, total, n = struct.unpack_from("<dQI", data, pos)
+        pos += 20
+        buckets = [struct.unpack_from("<IQ", data, pos + 12 * i) for i in range(n)]
+        pos += 12 * n
+        hists.append({"op": names[0], "metric": names[1], "sub_bits": sub_bits,
+                      "unit": unit, "total": total, "buckets": buckets})
+    return hists
+
+# === Helper Function: Value range [lo, hi) of a bucket index ===
+def bucket_range(index, sub_bits, unit):
+    sub, half = 1 << sub_bits, 1 << (sub_bits - 1)
+    if index < sub:
+        return index * unit, (index + 1) * unit
+    e = (index - sub) // half + sub_bits
+    m = (index - sub) % half + half
+    shift = e - (sub_bits - 1)
+    return (m << shift) * unit, ((m + 1) << shift) * unit
+
+def percentile(hist, p):
+    rank = max(1, math.ceil(p / 100 * hist["total"]))
+    seen = 0
+    for index, count in hist["buckets"]:
+        seen += count
+        if seen >= rank:
+            lo, hi = bucket_range(index, hist["sub_bits"], hist["unit"])
+            return lo if index < (1 << hist["sub_bits"]) else (lo + hi) / 2
+    return 0.0
+
+# === Load, print and plot the latency percentiles ===
+if not os.path.isfile(HIST_PATH):
+    print(f"histograms.bin not found in {DATA_FOLDER}")
+    sys.exit(1)
+
+hists = [h for h in read_histograms(HIST_PATH) if h["metric"] == "us" and h["total"] > 0]
+
+plt.figure(figsize=(10, 5))
+for h in hists:
+    values = [percentile(h, p) for p in PERCENTILES]
+    print(f"{h['op']:>8}: " + ", ".join(f"p{p}={v:.2f}" for p, v in zip(PERCENTILES, values)))
+    # Percentiles on a "number of nines" axis
+    x = [1 / (1 - p / 100) for p in PERCENTILES]
+    plt.plot(x, values, marker="o", label=h["op"])
+
+plt.xscale("log")
+plt.xticks([1 / (1 - p / 100) for p in PERCENTILES], [f"{p}%" for p in PERCENTILES], rotation=45)
+plt.title("Latency by Percentile (us)")
+plt.xlabel("Percentile")
+plt.ylabel("Time (us)")
+plt.legend()
+plt.tight_layout()
+
+output_path = os.path.join(OUTPUT_FOLDER, "hdr_percentiles.pdf")
+plt.savefig(output_path)
+plt.close()
+print(f"Saved percentile plot: {output_path}")
@@ -1,9 +1,8 @@
-import pandas as pd
 import matplotlib.pyplot as plt
 import seaborn as sns
 import os
 import sys
-from glob import glob
+from bench_columns import load_raw
 
 # === USAGE CHECK ===
 if len(sys.argv) < 2:
@@ -23,21 +22,14 @@ CLIP_PERCENTILE = 0.99  # Clip top 1% of values
 # === SEABORN STYLE ===
 sns.set(style="whitegrid")
 
-# === PROCESS RAW FILES ===
-raw_files = glob(os.path.join(DATA_FOLDER, "raw_*.csv"))
-
-for filepath in raw_files:
-    # Load CSV data
-    data = pd.read_csv(filepath, header=None).squeeze()
-    data = pd.to_numeric(data, errors="coerce").dropna()
-
+# === PROCESS RAW SAMPLES ===
+for filename, data in load_raw(DATA_FOLDER).items():
     # Clip outliers (optional)
     if CLIP_OUTLIERS:
         threshold = data.quantile(CLIP_PERCENTILE)
         data = data[data <= threshold]
 
-    # Parse filename for label and axis
-    filename = os.path.basename(filepath).replace("raw_", "").replace(".csv", "")
+    # Parse metric name for label and axis
     if "us" in filename:
         x_label = "Time (μs)"
     elif "cycles" in filename:
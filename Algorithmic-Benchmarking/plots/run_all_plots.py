@@ -10,7 +10,8 @@ PLOT_SCRIPTS = [
     "plots/lineplot_individual_metrics.py",
     "plots/boxplot_individual_metrics.py",
     "plots/boxplot_combined_metrics.py",
-    "plots/plot_summary_metrics.py"
+    "plots/plot_summary_metrics.py",
+    "plots/plot_hdr_percentiles.py"
 ]
 
 # ======================
@@ -1,19 +1,16 @@
 #!/bin/bash
 
-echo "Compiling all KEM and SIG benchmarks..."
+# Navigate to repo root (assumes script is in scripts/)
+cd "$(dirname "$0")/.."
 
-# Compile KEM benchmarks
-./scripts/compile_all_kem.sh
-if [ $? -ne 0 ]; then
-    echo "KEM compilation failed."
-    exit 1
-fi
+# Create output directory if it doesn't exist
+mkdir -p bin
 
-# Compile SIG benchmarks
-./scripts/compile_all_sig.sh
+echo "Compiling benchmark driver..."
+gcc -O3 src/benchmark.c src/common/*.c -I./liboqs/include -L./liboqs/build/lib -loqs -lssl -lcrypto -lm -pthread -o ./bin/benchmark
 if [ $? -ne 0 ]; then
-    echo "SIG compilation failed."
+    echo "Compilation failed for benchmark!"
     exit 1
 fi
 
-echo "All benchmarks compiled successfully."
+echo "Benchmark driver compiled successfully (bin/benchmark)."
@@ -3,28 +3,25 @@
 # Navigate to repo root (assumes script is in scripts/)
 cd "$(dirname "$0")/.."
 
-# List of all benchmark programs
-benchmarks=(
-    benchmark_hqc128
-    benchmark_hqc192
-    benchmark_hqc256
-    benchmark_kyber512
-    benchmark_kyber768
-    benchmark_kyber1024
-    benchmark_ml-kem-512
-    benchmark_ml-kem-768
-    benchmark_ml-kem-1024
+# KEM algorithms (liboqs names, see ./bin/benchmark --list)
+algorithms=(
+    HQC-128
+    HQC-192
+    HQC-256
+    Kyber512
+    Kyber768
+    Kyber1024
+    ML-KEM-512
+    ML-KEM-768
+    ML-KEM-1024
 )
 
-# Run each benchmark
-for bench in "${benchmarks[@]}"; do
-    echo "Running $bench..."
-    ./bin/$bench
-    if [ $? -ne 0 ]; then
-        echo "Execution failed for $bench!"
-        exit 1
-    fi
-done
+# Run all of them in one process; extra arguments (e.g. -n 5000) are passed through
+echo "Running KEM benchmarks..."
+./bin/benchmark "$@" "${algorithms[@]}"
+if [ $? -ne 0 ]; then
+    echo "KEM benchmark execution failed!"
+    exit 1
+fi
 
 echo "All KEM benchmarks completed successfully."
-
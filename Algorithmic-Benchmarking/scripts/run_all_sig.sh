@@ -3,29 +3,26 @@
 # Navigate to repo root (assumes script is in scripts/)
 cd "$(dirname "$0")/.."
 
-# List of all signature benchmark binaries
-benchmarks=(
-    benchmark_dilithium2
-    benchmark_dilithium3
-    benchmark_dilithium5
-    benchmark_falcon-512
-    benchmark_falcon-1024
-    benchmark_falcon-padded-512
-    benchmark_falcon-padded-1024
-    benchmark_ml-dsa-44
-    benchmark_ml-dsa-65
-    benchmark_ml-dsa-87
+# Signature algorithms (liboqs names, see ./bin/benchmark --list)
+algorithms=(
+    Dilithium2
+    Dilithium3
+    Dilithium5
+    Falcon-512
+    Falcon-1024
+    Falcon-padded-512
+    Falcon-padded-1024
+    ML-DSA-44
+    ML-DSA-65
+    ML-DSA-87
 )
 
-# Run each benchmark
-for bench in "${benchmarks[@]}"; do
-    echo "Running $bench..."
-    ./bin/$bench
-    if [ $? -ne 0 ]; then
-        echo "Execution failed for $bench!"
-        exit 1
-    fi
-done
+# Run all of them in one process; extra arguments (e.g. -n 5000) are passed through
+echo "Running signature benchmarks..."
+./bin/benchmark "$@" "${algorithms[@]}"
+if [ $? -ne 0 ]; then
+    echo "Signature benchmark execution failed!"
+    exit 1
+fi
 
 echo "All signature benchmarks completed successfully."
-
@@ -0,0 +1,477 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <getopt.h>
+#include <oqs/oqs.h>
+#include "common/bench_algs.h"
+#include "common/bench_timing.h"
+#include "common/bench_pmu.h"
+#include "common/bench_output.h"
+#include "common/bench_threads.h"
+#include "common/bench_system.h"
+#include "common/bench_warmup.h"
+
+// === Defaults (overridable on the command line) ===
+#define DEFAULT_REPEAT 1000
+#define DEFAULT_BASE_PATH ".."
+#define MESSAGE_LEN 32 // Length of dummy message for signing
+#define DEFAULT_TIMER "clock"
+#define DEFAULT_BATCH 1 // Calls per timed window, 1 = single-shot latency
+#define DEFAULT_RAW_FORMAT "bin" // samples.bin; raw_*.csv via --raw-format or plots/export_columns.py
+#define DEFAULT_WARMUP "auto"
+#define DEFAULT_STEADY_WINDOW 20 // Iterations in the steady-state CV window
+#define DEFAULT_STEADY_CV 0.05
+#define DEFAULT_SYS_INTERVAL_MS 1000 // Frequency/temperature sampling window
+#define RAW_SAMPLE_LIMIT 1000000 // Above this --repeat, raw samples are dropped (histograms only)
+// ===================================================
+
+typedef struct {
+    int repeat;
+    size_t msg_len;
+    const char *base_path;
+    const char *ops;        // Comma-separated operation labels, NULL = all
+    int with_provider;
+    int kinds;              // Bitmask of (1 << bench_kind) to include
+    const char *timer;      // Timing backend name
+    int batch;              // Back-to-back calls per timed window
+    const char *threads;    // Thread counts for the throughput mode, NULL = off
+    double duration_s;      // Fixed-duration workload per thread run (0 = use --repeat)
+    int keep_raw;           // Store every sample for the raw output files
+    int raw_format;         // BENCH_RAW_* bits
+    double max_temp_c;      // Wait (or refuse) while the CPU is hotter, 0 = off
+    int refuse_hot;
+    int sys_interval_ms;    // Window length for system.csv
+    int warmup;             // Warm-up iterations or BENCH_WARMUP_AUTO
+    int steady_window;
+    double steady_cv;
+} bench_opts;
+
+// Long options without a short form
+enum { OPT_REFUSE_HOT = 256, OPT_SYS_INTERVAL, OPT_STEADY_WINDOW, OPT_STEADY_CV };
+
+static void usage(const char *prog) {
+    fprintf(stderr,
+        "Usage: %s [options] [ALGORITHM...]\n"
+        "\n"
+        "Benchmarks every given KEM/SIG algorithm in one process. Without algorithm\n"
+        "names, every enabled algorithm (filtered by --type) is benchmarked.\n"
+        "\n"
+        "Options:\n"
+        "  -l, --list             List available algorithms and exit\n"
+        "  -n, --repeat N         Iterations per algorithm (default %d)\n"
+        "  -t, --type kem|sig     Restrict to KEMs or signatures\n"
+        "  -O, --ops LIST         Comma-separated operations, e.g. encaps,decaps or sign\n"
+        "  -o, --outdir DIR       Base directory for results (default %s)\n"
+        "  -m, --msglen N         Message length for signing (default %d)\n"
+        "  -T, --timer NAME       Timing backend: clock, tsc (x86), cntvct (aarch64),\n"
+        "                         rdpmc (default %s)\n"
+        "  -b, --batch K          Time K back-to-back calls per sample and report the\n"
+        "                         amortized per-call cost and ops/sec (default %d)\n"
+        "  -j, --threads LIST     Throughput mode with pinned worker threads: N, a list\n"
+        "                         like 1,2,4, max (all CPUs) or scale (1,2,4,..,all)\n"
+        "  -d, --duration SEC     Fixed-duration workload per thread run instead of\n"
+        "                         --repeat calls per thread\n"
+        "  -F, --raw-format FMT   Raw sample output: bin (samples.bin), csv (raw_*.csv)\n"
+        "                         or both (default %s)\n"
+        "  -R, --no-raw           Keep only streaming statistics and histograms, no\n"
+        "                         raw samples (automatic above %d iterations, as raw\n"
+        "                         samples take ~170 bytes per iteration in memory)\n"
+        "  -w, --warmup N|auto    Warm-up iterations before measuring, reported\n"
+        "                         separately; auto = until steady (default %s)\n"
+        "      --steady-window N  Iterations in the steady-state window (default %d)\n"
+        "      --steady-cv X      Steady when the window's CV is below X (default %.2f)\n"
+        "  -C, --max-temp C       Wait before a run and pause between iterations while\n"
+        "                         the CPU is at or above C degrees\n"
+        "      --refuse-hot       With --max-temp: fail instead of waiting at start\n"
+        "      --sys-interval MS  Frequency/temperature sampling window (default %d)\n"
+        "  -p, --provider         Include algorithms of the loaded OpenSSL providers;\n"
+        "                         select them as " BENCH_OSSL_PREFIX "<name>\n"
+        "  -h, --help             Show this help\n",
+        prog, DEFAULT_REPEAT, DEFAULT_BASE_PATH, MESSAGE_LEN, DEFAULT_TIMER,
+        DEFAULT_BATCH, DEFAULT_RAW_FORMAT, RAW_SAMPLE_LIMIT, DEFAULT_WARMUP, DEFAULT_STEADY_WINDOW,
+        DEFAULT_STEADY_CV, DEFAULT_SYS_INTERVAL_MS);
+}
+
+// === Helper: Parse --ops for one algorithm kind ===
+static int parse_ops(const char *spec, bench_kind kind, int ops[BENCH_NUM_OPS]) {
+    char buf[128];
+    int any = 0;
+
+    for (int i = 0; i < BENCH_NUM_OPS; i++)
+        ops[i] = spec == NULL;
+    if (spec == NULL)
+        return 1;
+
+    snprintf(buf, sizeof(buf), "%s", spec);
+    for (char *tok = strtok(buf, ","); tok; tok = strtok(NULL, ",")) {
+        int idx = bench_op_index(kind, tok);
+        if (idx >= 0) {
+            ops[idx] = 1;
+            any = 1;
+        }
+    }
+    return any;
+}
+
+static void list_algs(const bench_alg *algs, size_t count, int kinds) {
+    printf("liboqs %s\n\n", OQS_version());
+    for (size_t i = 0; i < count; i++) {
+        if (!(kinds & (1 << algs[i].kind)))
+            continue;
+        printf("%s  %s%s\n", bench_kind_name(algs[i].kind),
+               algs[i].backend == BENCH_BACKEND_OSSL ? BENCH_OSSL_PREFIX : "", algs[i].name);
+    }
+}
+
+// === Benchmark loop for one algorithm ===
+// Each iteration runs the operations in order. Unselected operations are only run
+// (untimed) when an earlier operation replaced their inputs and a later one is measured.
+// In batch mode a sample is one window of res->batch back-to-back calls; samples store
+// the amortized per-call cost.
+static int run_iteration(bench_ctx *ctx, const bench_timer *timer, bench_pmu *pmu,
+                         const bench_results *res, int last, int i, double us[BENCH_NUM_OPS],
+                         double counters[BENCH_NUM_OPS][BENCH_PMU_MAX_EVENTS]) {
+    uint64_t start, end, delta[BENCH_PMU_MAX_EVENTS];
+    int ran = 0;
+
+    for (int op = 0; op <= last; op++) {
+        if (!res->ops[op]) {
+            if (ran && !bench_ctx_run(ctx, op))
+                return 0;
+            continue;
+        }
+
+        int ok = 1;
+        bench_pmu_start(pmu);
+        start = bench_timer_start(timer);
+        for (int k = 0; k < res->batch; k++)
+            ok &= bench_ctx_run(ctx, op);
+        end = bench_timer_stop(timer);
+        bench_pmu_stop(pmu, delta);
+        us[op] = bench_timer_us(timer, start, end) / res->batch;
+        for (int c = 0; c < res->ncounters; c++)
+            counters[op][c] = (double)delta[c] / res->batch;
+        ran = 1;
+
+        if (!ok || !bench_ctx_check(ctx, op)) {
+            fprintf(stderr, "%s %s failed (iteration %d)\n", ctx->alg->name,
+                    bench_op_label(ctx->alg->kind, op), i);
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// The warm-up iterations run first and are only recorded in `warm`. Between
+// measured iterations the system monitor may open a new frequency/temperature window
+// or pause for cooling.
+static int run_loop(bench_ctx *ctx, const bench_timer *timer, bench_pmu *pmu, bench_results *res,
+                    bench_warmup *warm, bench_sysmon *mon) {
+    double us[BENCH_NUM_OPS], counters[BENCH_NUM_OPS][BENCH_PMU_MAX_EVENTS];
+    int last = -1;
+
+    for (int op = 0; op < BENCH_NUM_OPS; op++) {
+        if (res->ops[op])
+            last = op;
+    }
+
+    // Produce valid inputs for the first measured operation.
+    for (int op = 0; op < BENCH_NUM_OPS && !res->ops[op]; op++) {
+        if (!bench_ctx_run(ctx, op))
+            return 0;
+    }
+
+    while (bench_warmup_pending(warm)) {
+        if (!run_iteration(ctx, timer, pmu, res, last, warm->iters, us, counters))
+            return 0;
+        bench_warmup_add(warm, us);
+    }
+
+    for (int i = 0; i < res->repeat; i++) {
+        bench_sysmon_tick(mon, i);
+        if (!run_iteration(ctx, timer, pmu, res, last, i, us, counters))
+            return 0;
+        for (int op = 0; op <= last; op++) {
+            if (res->ops[op])
+                bench_results_add(res, op, i, us[op], counters[op]);
+        }
+    }
+    return 1;
+}
+
+// === Throughput mode: N pinned threads per run, see bench_threads.c ===
+static int benchmark_alg_threads(const bench_alg *alg, const int ops[BENCH_NUM_OPS],
+                                 const bench_opts *opts, const bench_timer *timer,
+                                 const bench_ctx *ctx) {
+    bench_threads_opts topts = {
+        .duration_s = opts->duration_s,
+        .calls_per_thread = opts->repeat,
+        .msg_len = opts->msg_len,
+    };
+    bench_results res = {
+        .repeat = opts->repeat,
+        .batch = 1,
+        .timer = timer,
+        .mode = "threads",
+    };
+    bench_sysmon mon;
+    char dirpath[512];
+
+    if (!bench_threads_parse(opts->threads, &topts)) {
+        fprintf(stderr, "Invalid thread list: %s\n", opts->threads);
+        return 0;
+    }
+    memcpy(res.ops, ops, sizeof(res.ops));
+
+    if (!bench_output_dir(dirpath, sizeof(dirpath), opts->base_path, alg)
+            || !bench_write_metadata(dirpath, ctx, &res)
+            || !bench_threads_write_metadata(dirpath, &topts)
+            || !bench_sysmon_start(&mon, NULL, opts->max_temp_c, opts->refuse_hot,
+                                   opts->sys_interval_ms))
+        return 0;
+    int ok = bench_threads_run(alg, ops, &topts, timer, dirpath);
+    bench_sysmon_stop(&mon, 0);
+
+    return ok
+        && bench_sysmon_write_metadata(dirpath, &mon)
+        && printf("Benchmark complete. Results saved to %s\n\n", dirpath) > 0;
+}
+
+static int benchmark_alg(const bench_alg *alg, const bench_opts *opts, const bench_timer *timer,
+                         bench_pmu *pmu) {
+    int ops[BENCH_NUM_OPS];
+    int ok = 0;
+    bench_results res = {0};
+    bench_sysmon mon;
+    bench_warmup warm = {0};
+    char dirpath[512];
+
+    if (!parse_ops(opts->ops, alg->kind, ops)) {
+        printf("Skipping %s: none of the requested operations apply\n", alg->name);
+        return 1;
+    }
+
+    // === Load algorithm ===
+    bench_ctx *ctx = bench_ctx_new(alg, opts->msg_len);
+    if (!ctx) {
+        fprintf(stderr, "Algorithm not available: %s\n", alg->name);
+        return 0;
+    }
+
+    printf("Benchmarking %s: %s\n\n", alg->kind == BENCH_KEM ? "KEM" : "Signature", alg->name);
+    bench_ctx_print_sizes(ctx, stdout);
+
+    if (opts->threads) {
+        ok = benchmark_alg_threads(alg, ops, opts, timer, ctx);
+        goto end;
+    }
+
+    if (!bench_results_init(&res, opts->repeat, ops, pmu, opts->batch, opts->keep_raw)) {
+        fprintf(stderr, "Out of memory\n");
+        goto end;
+    }
+    if (!bench_output_dir(dirpath, sizeof(dirpath), opts->base_path, alg))
+        goto end;
+    res.timer = timer;
+    res.raw_format = opts->raw_format;
+    if (!bench_warmup_init(&warm, opts->warmup, opts->steady_window, opts->steady_cv,
+                           opts->repeat, ops)
+            || !bench_warmup_open(&warm, dirpath, alg->kind))
+        goto end;
+
+    if (!bench_sysmon_start(&mon, dirpath, opts->max_temp_c, opts->refuse_hot, opts->sys_interval_ms))
+        goto end;
+    ok = run_loop(ctx, timer, pmu, &res, &warm, &mon);
+    bench_sysmon_stop(&mon, res.repeat);
+    if (!ok)
+        goto end;
+
+    ok = bench_write_metadata(dirpath, ctx, &res)
+        && bench_warmup_write_metadata(dirpath, &warm, alg->kind)
+        && bench_sysmon_write_metadata(dirpath, &mon)
+        && bench_write_columns(dirpath, alg, &res)
+        && bench_write_raw(dirpath, alg, &res)
+        && bench_write_summary(dirpath, alg, &res)
+        && bench_write_histograms(dirpath, alg, &res);
+    if (ok)
+        printf("Benchmark complete. Results saved to %s\n\n", dirpath);
+
+end:
+    bench_warmup_free(&warm);
+    bench_results_free(&res);
+    bench_ctx_free(ctx);
+    return ok;
+}
+
+int main(int argc, char *argv[]) {
+    static const struct option long_opts[] = {
+        {"list",     no_argument,       NULL, 'l'},
+        {"repeat",   required_argument, NULL, 'n'},
+        {"type",     required_argument, NULL, 't'},
+        {"ops",      required_argument, NULL, 'O'},
+        {"outdir",   required_argument, NULL, 'o'},
+        {"msglen",   required_argument, NULL, 'm'},
+        {"provider", no_argument,       NULL, 'p'},
+        {"timer",    required_argument, NULL, 'T'},
+        {"batch",    required_argument, NULL, 'b'},
+        {"threads",  required_argument, NULL, 'j'},
+        {"duration", required_argument, NULL, 'd'},
+        {"no-raw",   no_argument,       NULL, 'R'},
+        {"raw-format", required_argument, NULL, 'F'},
+        {"max-temp", required_argument, NULL, 'C'},
+        {"warmup",   required_argument, NULL, 'w'},
+        {"steady-window", required_argument, NULL, OPT_STEADY_WINDOW},
+        {"steady-cv", required_argument, NULL, OPT_STEADY_CV},
+        {"refuse-hot", no_argument,     NULL, OPT_REFUSE_HOT},
+        {"sys-interval", required_argument, NULL, OPT_SYS_INTERVAL},
+        {"help",     no_argument,       NULL, 'h'},
+        {NULL, 0, NULL, 0}
+    };
+    bench_opts opts = {
+        .repeat = DEFAULT_REPEAT,
+        .msg_len = MESSAGE_LEN,
+        .base_path = DEFAULT_BASE_PATH,
+        .kinds = (1 << BENCH_KEM) | (1 << BENCH_SIG),
+        .timer = DEFAULT_TIMER,
+        .batch = DEFAULT_BATCH,
+        .keep_raw = 1,
+        .raw_format = BENCH_RAW_BIN,
+        .sys_interval_ms = DEFAULT_SYS_INTERVAL_MS,
+        .warmup = BENCH_WARMUP_AUTO,
+        .steady_window = DEFAULT_STEADY_WINDOW,
+        .steady_cv = DEFAULT_STEADY_CV,
+    };
+    int list = 0, c;
+
+    while ((c = getopt_long(argc, argv, "ln:t:O:o:m:pT:b:j:d:RF:C:w:h", long_opts, NULL)) != -1) {
+        switch (c) {
+        case 'l': list = 1; break;
+        case 'n':
+            opts.repeat = atoi(optarg);
+            if (opts.repeat <= 0) opts.repeat = DEFAULT_REPEAT;
+            break;
+        case 't':
+            if (strcmp(optarg, "kem") == 0) opts.kinds = 1 << BENCH_KEM;
+            else if (strcmp(optarg, "sig") == 0) opts.kinds = 1 << BENCH_SIG;
+            else { usage(argv[0]); return EXIT_FAILURE; }
+            break;
+        case 'O': opts.ops = optarg; break;
+        case 'o': opts.base_path = optarg; break;
+        case 'm': opts.msg_len = strtoul(optarg, NULL, 10); break;
+        case 'p': opts.with_provider = 1; break;
+        case 'T': opts.timer = optarg; break;
+        case 'b':
+            opts.batch = atoi(optarg);
+            if (opts.batch <= 0) opts.batch = DEFAULT_BATCH;
+            break;
+        case 'j': opts.threads = optarg; break;
+        case 'd': opts.duration_s = atof(optarg); break;
+        case 'R': opts.keep_raw = 0; break;
+        case 'w':
+            if (!bench_warmup_parse(optarg, &opts.warmup)) { usage(argv[0]); return EXIT_FAILURE; }
+            break;
+        case OPT_STEADY_WINDOW:
+            opts.steady_window = atoi(optarg);
+            if (opts.steady_window < 2) opts.steady_window = DEFAULT_STEADY_WINDOW;
+            break;
+        case OPT_STEADY_CV: opts.steady_cv = atof(optarg); break;
+        case 'C': opts.max_temp_c = atof(optarg); break;
+        case OPT_REFUSE_HOT: opts.refuse_hot = 1; break;
+        case OPT_SYS_INTERVAL:
+            opts.sys_interval_ms = atoi(optarg);
+            if (opts.sys_interval_ms <= 0) opts.sys_interval_ms = DEFAULT_SYS_INTERVAL_MS;
+            break;
+        case 'F':
+            if (strcmp(optarg, "bin") == 0) opts.raw_format = BENCH_RAW_BIN;
+            else if (strcmp(optarg, "csv") == 0) opts.raw_format = BENCH_RAW_CSV;
+            else if (strcmp(optarg, "both") == 0) opts.raw_format = BENCH_RAW_BIN | BENCH_RAW_CSV;
+            else { usage(argv[0]); return EXIT_FAILURE; }
+            break;
+        case 'h': usage(argv[0]); return EXIT_SUCCESS;
+        default: usage(argv[0]); return EXIT_FAILURE;
+        }
+    }
+
+    if (opts.keep_raw && opts.repeat > RAW_SAMPLE_LIMIT && !opts.threads) {
+        printf("Note: %d iterations, raw samples are not stored (summary and histograms only)\n",
+               opts.repeat);
+        opts.keep_raw = 0;
+    }
+
+    OQS_init();
+
+    // === Build the list of algorithms to run ===
+    bench_alg *algs = NULL;
+    size_t count = 0;
+    if (list || optind == argc) {
+        if (!bench_algs_collect(&algs, &count, opts.with_provider)) {
+            fprintf(stderr, "Out of memory\n");
+            return EXIT_FAILURE;
+        }
+    } else {
+        algs = calloc(argc - optind, sizeof(*algs));
+        if (!algs) {
+            fprintf(stderr, "Out of memory\n");
+            return EXIT_FAILURE;
+        }
+        for (int i = optind; i < argc; i++) {
+            if (!bench_alg_lookup(argv[i], &algs[count])) {
+                fprintf(stderr, "Algorithm not available: %s (see --list)\n", argv[i]);
+                free(algs);
+                return EXIT_FAILURE;
+            }
+            count++;
+        }
+    }
+
+    if (list) {
+        list_algs(algs, count, opts.kinds);
+        free(algs);
+        return EXIT_SUCCESS;
+    }
+
+    // === Setup timer and PMU counter group (shared by all algorithms) ===
+    bench_timer timer;
+    if (!bench_timer_open(&timer, opts.timer)) {
+        free(algs);
+        return EXIT_FAILURE;
+    }
+    printf("Timer: %s (%.3f ticks/us, overhead %.1f ticks subtracted)\n",
+           bench_timer_name(&timer), timer.ticks_per_us, timer.overhead_ticks);
+    if (opts.threads && timer.kind == BENCH_TIMER_RDPMC) {
+        // The mmap'd counter belongs to the main thread
+        fprintf(stderr, "The rdpmc timer cannot be used with --threads\n");
+        bench_timer_close(&timer);
+        free(algs);
+        return EXIT_FAILURE;
+    }
+
+    bench_pmu pmu;
+    bench_pmu_open(&pmu);
+    if (pmu.available) {
+        printf("PMU counters:");
+        for (int c = 0; c < pmu.nevents; c++)
+            printf(" %s", pmu.names[c]);
+        printf("\n\n");
+    }
+
+    int failures = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (!(opts.kinds & (1 << algs[i].kind)))
+            continue;
+        if (!benchmark_alg(&algs[i], &opts, &timer, &pmu))
+            failures++;
+    }
+
+    bench_pmu_close(&pmu);
+    bench_timer_close(&timer);
+    free(algs);
+    OQS_destroy();
+
+    if (failures) {
+        fprintf(stderr, "%d algorithm(s) failed\n", failures);
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,371 @@
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <oqs/oqs.h>
+#include <openssl/evp.h>
+#include <openssl/core_names.h>
+#include "bench_algs.h"
+
+#define MESSAGE_FILL 42 // Dummy message byte for signing
+
+static const char *kem_labels[BENCH_NUM_OPS] = {"keygen", "encaps", "decaps"};
+static const char *sig_labels[BENCH_NUM_OPS] = {"keygen", "sign", "verify"};
+
+const char *bench_kind_name(bench_kind kind) {
+    return kind == BENCH_KEM ? "kem" : "sig";
+}
+
+const char *bench_op_label(bench_kind kind, int op) {
+    return kind == BENCH_KEM ? kem_labels[op] : sig_labels[op];
+}
+
+int bench_op_index(bench_kind kind, const char *label) {
+    for (int i = 0; i < BENCH_NUM_OPS; i++) {
+        if (strcmp(bench_op_label(kind, i), label) == 0)
+            return i;
+    }
+    return -1;
+}
+
+// === Helper: Fill name/dir of a table entry ===
+static void set_alg(bench_alg *alg, bench_kind kind, bench_backend backend, const char *name) {
+    size_t off = 0;
+
+    alg->kind = kind;
+    alg->backend = backend;
+    snprintf(alg->name, sizeof(alg->name), "%s", name);
+    if (backend == BENCH_BACKEND_OSSL)
+        off = snprintf(alg->dir, sizeof(alg->dir), "ossl-");
+    for (size_t i = 0; name[i] != '\0' && off < sizeof(alg->dir) - 1; i++) {
+        char c = (char)tolower((unsigned char)name[i]);
+        alg->dir[off++] = (c == '/' || c == ' ') ? '_' : c;
+    }
+    alg->dir[off] = '\0';
+}
+
+// === Dynamic list used while collecting algorithms ===
+typedef struct {
+    bench_alg *items;
+    size_t count, cap;
+    bench_kind kind;
+    int failed; // Set when a provider callback could not add its entry
+} alg_list;
+
+static int alg_list_push(alg_list *l, bench_kind kind, bench_backend backend, const char *name) {
+    if (l->count == l->cap) {
+        size_t cap = l->cap ? l->cap * 2 : 32;
+        bench_alg *items = realloc(l->items, cap * sizeof(*items));
+        if (!items)
+            return 0;
+        l->items = items;
+        l->cap = cap;
+    }
+    set_alg(&l->items[l->count++], kind, backend, name);
+    return 1;
+}
+
+// Only names with a key manager can be used for keygen
+static int ossl_has_keymgmt(const char *name) {
+    EVP_KEYMGMT *km = EVP_KEYMGMT_fetch(NULL, name, NULL);
+
+    EVP_KEYMGMT_free(km);
+    return km != NULL;
+}
+
+static void collect_ossl_push(alg_list *l, bench_kind kind, const char *name) {
+    if (!l->failed && !alg_list_push(l, kind, BENCH_BACKEND_OSSL, name))
+        l->failed = 1;
+}
+
+static void collect_ossl_kem(EVP_KEM *kem, void *arg) {
+    const char *name = EVP_KEM_get0_name(kem);
+
+    if (ossl_has_keymgmt(name))
+        collect_ossl_push(arg, BENCH_KEM, name);
+}
+
+static void collect_ossl_sig(EVP_SIGNATURE *sig, void *arg) {
+    // Skip the legacy MAC-as-signature adapters, they have no public/private key pair
+    static const char *macs[] = {"HMAC", "SIPHASH", "POLY1305", "CMAC"};
+    const char *name = EVP_SIGNATURE_get0_name(sig);
+
+    for (size_t i = 0; i < sizeof(macs) / sizeof(macs[0]); i++) {
+        if (EVP_SIGNATURE_is_a(sig, macs[i]))
+            return;
+    }
+    // Skip composite sigalgs such as "RSA-SHA256", they have no key manager
+    if (ossl_has_keymgmt(name))
+        collect_ossl_push(arg, BENCH_SIG, name);
+}
+
+int bench_algs_collect(bench_alg **list, size_t *count, int with_provider) {
+    alg_list l = {0};
+
+    for (int i = 0; i < OQS_KEM_alg_count(); i++) {
+        const char *name = OQS_KEM_alg_identifier(i);
+        if (OQS_KEM_alg_is_enabled(name) && !alg_list_push(&l, BENCH_KEM, BENCH_BACKEND_OQS, name))
+            goto err;
+    }
+    for (int i = 0; i < OQS_SIG_alg_count(); i++) {
+        const char *name = OQS_SIG_alg_identifier(i);
+        if (OQS_SIG_alg_is_enabled(name) && !alg_list_push(&l, BENCH_SIG, BENCH_BACKEND_OQS, name))
+            goto err;
+    }
+    if (with_provider) {
+        EVP_KEM_do_all_provided(NULL, collect_ossl_kem, &l);
+        EVP_SIGNATURE_do_all_provided(NULL, collect_ossl_sig, &l);
+        if (l.failed)
+            goto err;
+    }
+
+    *list = l.items;
+    *count = l.count;
+    return 1;
+
+err:
+    free(l.items);
+    return 0;
+}
+
+int bench_alg_lookup(const char *name, bench_alg *out) {
+    size_t plen = strlen(BENCH_OSSL_PREFIX);
+
+    if (strncmp(name, BENCH_OSSL_PREFIX, plen) == 0) {
+        const char *pname = name + plen;
+        EVP_KEM *kem = EVP_KEM_fetch(NULL, pname, NULL);
+        EVP_SIGNATURE *sig = kem ? NULL : EVP_SIGNATURE_fetch(NULL, pname, NULL);
+
+        if (!kem && !sig)
+            return 0;
+        set_alg(out, kem ? BENCH_KEM : BENCH_SIG, BENCH_BACKEND_OSSL, pname);
+        EVP_KEM_free(kem);
+        EVP_SIGNATURE_free(sig);
+        return 1;
+    }
+
+    if (OQS_KEM_alg_is_enabled(name)) {
+        set_alg(out, BENCH_KEM, BENCH_BACKEND_OQS, name);
+        return 1;
+    }
+    if (OQS_SIG_alg_is_enabled(name)) {
+        set_alg(out, BENCH_SIG, BENCH_BACKEND_OQS, name);
+        return 1;
+    }
+    return 0;
+}
+
+// === OpenSSL provider backend ===
+static int ossl_keygen(bench_ctx *ctx) {
+    EVP_PKEY *pkey = NULL;
+
+    if (EVP_PKEY_generate(ctx->genctx, &pkey) <= 0)
+        return 0;
+    EVP_PKEY_free(ctx->pkey);
+    ctx->pkey = pkey;
+    return 1;
+}
+
+static int ossl_encaps(bench_ctx *ctx) {
+    size_t ct_len = ctx->ct_len, ss_len = ctx->ss_len;
+
+    return EVP_PKEY_encapsulate(ctx->encctx, ctx->ct, &ct_len, ctx->ss, &ss_len) > 0;
+}
+
+static int ossl_decaps(bench_ctx *ctx) {
+    size_t ss_len = ctx->ss_len;
+
+    return EVP_PKEY_decapsulate(ctx->decctx, ctx->ss2, &ss_len, ctx->ct, ctx->ct_len) > 0;
+}
+
+// Digest sign/verify contexts are single-use, so every call starts from a copy of the
+// template initialised in ossl_init() instead of fetching the algorithm again.
+static int ossl_sign(bench_ctx *ctx) {
+    size_t sig_len = ctx->sig_len;
+    int ok = EVP_MD_CTX_copy_ex(ctx->mdctx, ctx->signtmpl)
+        && EVP_DigestSign(ctx->mdctx, ctx->sig, &sig_len, ctx->msg, ctx->msg_len) > 0;
+
+    ctx->sig_out_len = sig_len;
+    return ok;
+}
+
+static int ossl_verify(bench_ctx *ctx) {
+    int ok = EVP_MD_CTX_copy_ex(ctx->mdctx, ctx->verifytmpl);
+
+    ctx->verify_ok = ok
+        && EVP_DigestVerify(ctx->mdctx, ctx->sig, ctx->sig_out_len, ctx->msg, ctx->msg_len) == 1;
+    return ok;
+}
+
+// Determine buffer sizes of an OpenSSL algorithm from a freshly generated key and set up
+// the operation contexts, so the timed calls do no allocation or algorithm fetching.
+// The contexts hold their own reference to this key; later keygen samples replace
+// ctx->pkey without affecting them.
+static int ossl_init(bench_ctx *ctx) {
+    ctx->genctx = EVP_PKEY_CTX_new_from_name(NULL, ctx->alg->name, NULL);
+    if (!ctx->genctx || EVP_PKEY_keygen_init(ctx->genctx) <= 0 || !ossl_keygen(ctx))
+        return 0;
+
+    if (EVP_PKEY_get_raw_public_key(ctx->pkey, NULL, &ctx->pk_len) <= 0)
+        EVP_PKEY_get_octet_string_param(ctx->pkey, OSSL_PKEY_PARAM_ENCODED_PUBLIC_KEY,
+                                        NULL, 0, &ctx->pk_len);
+    if (EVP_PKEY_get_raw_private_key(ctx->pkey, NULL, &ctx->sk_len) <= 0)
+        ctx->sk_len = 0;
+
+    if (ctx->alg->kind == BENCH_KEM) {
+        ctx->encctx = EVP_PKEY_CTX_new_from_pkey(NULL, ctx->pkey, NULL);
+        ctx->decctx = EVP_PKEY_CTX_new_from_pkey(NULL, ctx->pkey, NULL);
+        return ctx->encctx != NULL && ctx->decctx != NULL
+            && EVP_PKEY_encapsulate_init(ctx->encctx, NULL) > 0
+            && EVP_PKEY_decapsulate_init(ctx->decctx, NULL) > 0
+            && EVP_PKEY_encapsulate(ctx->encctx, NULL, &ctx->ct_len, NULL, &ctx->ss_len) > 0;
+    }
+    ctx->sig_len = (size_t)EVP_PKEY_get_size(ctx->pkey);
+    ctx->signtmpl = EVP_MD_CTX_new();
+    ctx->verifytmpl = EVP_MD_CTX_new();
+    ctx->mdctx = EVP_MD_CTX_new();
+    return ctx->sig_len > 0
+        && ctx->signtmpl != NULL && ctx->verifytmpl != NULL && ctx->mdctx != NULL
+        && EVP_DigestSignInit_ex(ctx->signtmpl, NULL, NULL, NULL, NULL, ctx->pkey, NULL) > 0
+        && EVP_DigestVerifyInit_ex(ctx->verifytmpl, NULL, NULL, NULL, NULL, ctx->pkey,
+                                   NULL) > 0;
+}
+
+// === liboqs backend ===
+static int oqs_init(bench_ctx *ctx) {
+    if (ctx->alg->kind == BENCH_KEM) {
+        OQS_KEM *kem = OQS_KEM_new(ctx->alg->name);
+        if (!kem)
+            return 0;
+        ctx->oqs = kem;
+        ctx->pk_len = kem->length_public_key;
+        ctx->sk_len = kem->length_secret_key;
+        ctx->ct_len = kem->length_ciphertext;
+        ctx->ss_len = kem->length_shared_secret;
+    } else {
+        OQS_SIG *sig = OQS_SIG_new(ctx->alg->name);
+        if (!sig)
+            return 0;
+        ctx->oqs = sig;
+        ctx->pk_len = sig->length_public_key;
+        ctx->sk_len = sig->length_secret_key;
+        ctx->sig_len = sig->length_signature;
+    }
+    return 1;
+}
+
+bench_ctx *bench_ctx_new(const bench_alg *alg, size_t msg_len) {
+    bench_ctx *ctx = calloc(1, sizeof(*ctx));
+    if (!ctx)
+        return NULL;
+    ctx->alg = alg;
+    ctx->msg_len = msg_len;
+
+    int ok = alg->backend == BENCH_BACKEND_OQS ? oqs_init(ctx) : ossl_init(ctx);
+    if (!ok) {
+        bench_ctx_free(ctx);
+        return NULL;
+    }
+
+    // === Allocate memory (at least one byte so malloc never returns NULL legitimately) ===
+    ctx->pk = malloc(ctx->pk_len + 1);
+    ctx->sk = malloc(ctx->sk_len + 1);
+    if (alg->kind == BENCH_KEM) {
+        ctx->ct = malloc(ctx->ct_len + 1);
+        ctx->ss = malloc(ctx->ss_len + 1);
+        ctx->ss2 = malloc(ctx->ss_len + 1);
+        ok = ctx->ct && ctx->ss && ctx->ss2;
+    } else {
+        ctx->msg = malloc(msg_len + 1);
+        ctx->sig = malloc(ctx->sig_len + 1);
+        ok = ctx->msg && ctx->sig;
+        if (ok)
+            memset(ctx->msg, MESSAGE_FILL, msg_len); // Fill message with dummy data
+    }
+    if (!ok || !ctx->pk || !ctx->sk) {
+        bench_ctx_free(ctx);
+        return NULL;
+    }
+    return ctx;
+}
+
+void bench_ctx_free(bench_ctx *ctx) {
+    if (!ctx)
+        return;
+    if (ctx->alg->kind == BENCH_KEM)
+        OQS_KEM_free(ctx->oqs);
+    else
+        OQS_SIG_free(ctx->oqs);
+    EVP_PKEY_free(ctx->pkey);
+    EVP_PKEY_CTX_free(ctx->genctx);
+    EVP_PKEY_CTX_free(ctx->encctx);
+    EVP_PKEY_CTX_free(ctx->decctx);
+    EVP_MD_CTX_free(ctx->signtmpl);
+    EVP_MD_CTX_free(ctx->verifytmpl);
+    EVP_MD_CTX_free(ctx->mdctx);
+    free(ctx->pk); free(ctx->sk); free(ctx->ct); free(ctx->ss); free(ctx->ss2);
+    free(ctx->msg); free(ctx->sig);
+    free(ctx);
+}
+
+int bench_ctx_run(bench_ctx *ctx, int op) {
+    if (ctx->alg->backend == BENCH_BACKEND_OSSL) {
+        if (ctx->alg->kind == BENCH_KEM) {
+            switch (op) {
+            case 0: return ossl_keygen(ctx);
+            case 1: return ossl_encaps(ctx);
+            default: return ossl_decaps(ctx);
+            }
+        }
+        switch (op) {
+        case 0: return ossl_keygen(ctx);
+        case 1: return ossl_sign(ctx);
+        default: return ossl_verify(ctx);
+        }
+    }
+
+    if (ctx->alg->kind == BENCH_KEM) {
+        switch (op) {
+        case 0: return OQS_KEM_keypair(ctx->oqs, ctx->pk, ctx->sk) == OQS_SUCCESS;
+        case 1: return OQS_KEM_encaps(ctx->oqs, ctx->ct, ctx->ss, ctx->pk) == OQS_SUCCESS;
+        default: return OQS_KEM_decaps(ctx->oqs, ctx->ss2, ctx->ct, ctx->sk) == OQS_SUCCESS;
+        }
+    }
+    switch (op) {
+    case 0:
+        return OQS_SIG_keypair(ctx->oqs, ctx->pk, ctx->sk) == OQS_SUCCESS;
+    case 1:
+        return OQS_SIG_sign(ctx->oqs, ctx->sig, &ctx->sig_out_len, ctx->msg, ctx->msg_len,
+                            ctx->sk) == OQS_SUCCESS;
+    default:
+        ctx->verify_ok = OQS_SIG_verify(ctx->oqs, ctx->msg, ctx->msg_len, ctx->sig,
+                                        ctx->sig_out_len, ctx->pk) == OQS_SUCCESS;
+        return 1;
+    }
+}
+
+int bench_ctx_check(const bench_ctx *ctx, int op) {
+    if (op != BENCH_NUM_OPS - 1)
+        return 1;
+    if (ctx->alg->kind == BENCH_KEM)
+        return memcmp(ctx->ss, ctx->ss2, ctx->ss_len) == 0;
+    return ctx->verify_ok;
+}
+
+void bench_ctx_print_sizes(const bench_ctx *ctx, FILE *out) {
+    fprintf(out, "Public key: %zu bytes\n", ctx->pk_len);
+    fprintf(out, "Secret key: %zu bytes\n", ctx->sk_len);
+    if (ctx->alg->kind == BENCH_KEM) {
+        fprintf(out, "Ciphertext:  %zu bytes\n", ctx->ct_len);
+        fprintf(out, "Shared key:  %zu bytes\n\n", ctx->ss_len);
+    } else {
+        fprintf(out, "Signature:  %zu bytes\n\n", ctx->sig_len);
+    }
+}
+
+void bench_ctx_write_sizes(const bench_ctx *ctx, FILE *meta) {
+    fprintf(meta, "PublicKeyBytes: %zu\nSecretKeyBytes: %zu\n", ctx->pk_len, ctx->sk_len);
+    if (ctx->alg->kind == BENCH_KEM)
+        fprintf(meta, "CiphertextBytes: %zu\nSharedSecretBytes: %zu\n", ctx->ct_len, ctx->ss_len);
+    else
+        fprintf(meta, "SignatureBytes: %zu\nMessageBytes: %zu\n", ctx->sig_len, ctx->msg_len);
+}
@@ -0,0 +1,61 @@
+#ifndef BENCH_ALGS_H
+#define BENCH_ALGS_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+
+// === Algorithm table shared by all benchmark modes ===
+// Every algorithm offers exactly three operations, run in this order per iteration:
+//   KEM: keygen -> encaps -> decaps
+//   SIG: keygen -> sign   -> verify
+#define BENCH_NUM_OPS 3
+#define BENCH_OSSL_PREFIX "ossl:" // CLI prefix selecting the OpenSSL provider backend
+
+typedef enum { BENCH_KEM, BENCH_SIG } bench_kind;
+typedef enum { BENCH_BACKEND_OQS, BENCH_BACKEND_OSSL } bench_backend;
+
+typedef struct {
+    bench_kind kind;
+    bench_backend backend;
+    char name[96]; // Name as understood by liboqs / the OpenSSL provider
+    char dir[112]; // Folder name for results (lowercase, backend-prefixed for OpenSSL)
+} bench_alg;
+
+// === Per-algorithm benchmark state (keys, buffers, backend objects) ===
+typedef struct {
+    const bench_alg *alg;
+    size_t pk_len, sk_len;
+    size_t ct_len, ss_len;     // KEM only
+    size_t sig_len, msg_len;   // SIG only
+    uint8_t *pk, *sk, *ct, *ss, *ss2, *msg, *sig;
+    size_t sig_out_len;
+    int verify_ok;
+    void *oqs;                 // OQS_KEM * or OQS_SIG *
+    void *pkey;                // EVP_PKEY * (OpenSSL backend)
+    void *genctx;              // EVP_PKEY_CTX * used for key generation
+    void *encctx, *decctx;     // EVP_PKEY_CTX * initialised for encaps / decaps (KEM)
+    void *signtmpl, *verifytmpl; // EVP_MD_CTX * initialised for sign / verify (SIG)
+    void *mdctx;               // EVP_MD_CTX * the templates are copied into per call
+} bench_ctx;
+
+const char *bench_kind_name(bench_kind kind);
+const char *bench_op_label(bench_kind kind, int op);
+int bench_op_index(bench_kind kind, const char *label);
+
+// Collect every enabled algorithm of liboqs (and the OpenSSL provider if requested).
+// The returned array must be released with free().
+int bench_algs_collect(bench_alg **list, size_t *count, int with_provider);
+// Resolve a CLI name ("ML-KEM-768", "ossl:ML-DSA-44", ...) to an algorithm entry.
+int bench_alg_lookup(const char *name, bench_alg *out);
+
+bench_ctx *bench_ctx_new(const bench_alg *alg, size_t msg_len);
+void bench_ctx_free(bench_ctx *ctx);
+// Run one operation; returns 1 on success. Kept free of checks so it can be timed directly.
+int bench_ctx_run(bench_ctx *ctx, int op);
+// Validate the output of the operation just run (shared secret / signature check).
+int bench_ctx_check(const bench_ctx *ctx, int op);
+void bench_ctx_print_sizes(const bench_ctx *ctx, FILE *out);
+void bench_ctx_write_sizes(const bench_ctx *ctx, FILE *meta);
+
+#endif
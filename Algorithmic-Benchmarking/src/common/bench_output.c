@@ -0,0 +1,386 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <oqs/oqs.h>
+#include <openssl/crypto.h>
+#include "bench_output.h"
+#include "bench_stats.h"
+
+static void add_metric(bench_results *res, const char *name, const char *fmt, double unit, int derived) {
+    for (int i = 0; i < BENCH_NUM_OPS; i++) {
+        bench_metric *m = &res->metrics[i][res->nmetrics];
+
+        m->name = name;
+        m->fmt = fmt;
+        m->derived = derived;
+        bench_stat_init(&m->stat);
+        if (!res->ops[i])
+            continue;
+        m->hist = malloc(sizeof(*m->hist));
+        if (m->hist)
+            bench_hist_init(m->hist, unit);
+        if (res->keep_raw && !derived)
+            m->samples = malloc(sizeof(double) * res->repeat);
+    }
+    res->nmetrics++;
+}
+
+int bench_results_init(bench_results *res, int repeat, const int ops[BENCH_NUM_OPS],
+                       const bench_pmu *pmu, int batch, int keep_raw) {
+    int cyc = -1, ins = -1;
+
+    memset(res, 0, sizeof(*res));
+    res->repeat = repeat;
+    res->batch = batch;
+    res->keep_raw = keep_raw;
+    res->ipc_metric = res->ops_metric = -1;
+    memcpy(res->ops, ops, sizeof(res->ops));
+    res->ncounters = pmu && pmu->available ? pmu->nevents : 0;
+
+    // Times in us (histogram resolution 1 ns), counters as integers
+    add_metric(res, "us", "%.2f", 0.001, 0);
+    for (int c = 0; c < res->ncounters; c++) {
+        res->counter_names[c] = pmu->names[c];
+        if (strcmp(pmu->names[c], "cycles") == 0) cyc = c;
+        if (strcmp(pmu->names[c], "instructions") == 0) ins = c;
+        add_metric(res, pmu->names[c], "%.0f", 1.0, 0);
+    }
+    if (cyc >= 0 && ins >= 0) {
+        res->ipc_metric = res->nmetrics;
+        add_metric(res, "ipc", "%.3f", 0.001, 1);
+    }
+    if (batch > 1) {
+        res->ops_metric = res->nmetrics;
+        add_metric(res, "ops_per_sec", "%.1f", 1.0, 1);
+    }
+
+    for (int i = 0; i < BENCH_NUM_OPS; i++) {
+        for (int m = 0; m < res->nmetrics && ops[i]; m++) {
+            bench_metric *bm = &res->metrics[i][m];
+            if (!bm->hist || (res->keep_raw && !bm->derived && !bm->samples)) {
+                bench_results_free(res);
+                return 0;
+            }
+        }
+    }
+    return 1;
+}
+
+void bench_results_free(bench_results *res) {
+    for (int i = 0; i < BENCH_NUM_OPS; i++) {
+        for (int m = 0; m < BENCH_MAX_METRICS; m++) {
+            free(res->metrics[i][m].hist);
+            free(res->metrics[i][m].samples);
+            res->metrics[i][m].hist = NULL;
+            res->metrics[i][m].samples = NULL;
+        }
+    }
+}
+
+static void record(bench_metric *m, int i, double v) {
+    bench_stat_add(&m->stat, v);
+    bench_hist_add(m->hist, v);
+    if (m->samples)
+        m->samples[i] = v;
+}
+
+void bench_results_add(bench_results *res, int op, int i, double us, const double *counters) {
+    bench_metric *m = res->metrics[op];
+
+    record(&m[0], i, us);
+    for (int c = 0; c < res->ncounters; c++)
+        record(&m[1 + c], i, counters[c]);
+    if (res->ipc_metric >= 0) {
+        // Instructions per cycle of this sample
+        int cyc = 0, ins = 0;
+        for (int c = 0; c < res->ncounters; c++) {
+            if (strcmp(res->counter_names[c], "cycles") == 0) cyc = c;
+            if (strcmp(res->counter_names[c], "instructions") == 0) ins = c;
+        }
+        record(&m[res->ipc_metric], i, counters[cyc] > 0 ? counters[ins] / counters[cyc] : 0.0);
+    }
+    if (res->ops_metric >= 0)
+        record(&m[res->ops_metric], i, us > 0 ? 1e6 / us : 0.0);
+}
+
+// === Helper: Create folder path (recursive, like mkdir -p) ===
+static int create_dir(const char *path) {
+    char tmp[512];
+
+    snprintf(tmp, sizeof(tmp), "%s", path);
+    for (char *p = tmp + 1; *p; p++) {
+        if (*p != '/')
+            continue;
+        *p = '\0';
+        if (mkdir(tmp, 0755) != 0 && errno != EEXIST)
+            return 0;
+        *p = '/';
+    }
+    return mkdir(tmp, 0755) == 0 || errno == EEXIST;
+}
+
+int bench_output_dir(char *dirpath, size_t len, const char *base, const bench_alg *alg) {
+    char timestamp[64];
+    time_t now = time(NULL);
+    strftime(timestamp, sizeof(timestamp), "%Y-%m-%d_%H-%M-%S", localtime(&now));
+
+    snprintf(dirpath, len, "%s/benchmarks/%s/%s/%s", base, bench_kind_name(alg->kind), alg->dir, timestamp);
+    if (!create_dir(dirpath)) {
+        perror(dirpath);
+        return 0;
+    }
+    return 1;
+}
+
+static FILE *open_in_dir(const char *dirpath, const char *name) {
+    char path[512];
+    snprintf(path, sizeof(path), "%s/%s", dirpath, name);
+    FILE *f = fopen(path, "w");
+    if (!f)
+        perror(path);
+    return f;
+}
+
+static void host_name(char *host, size_t len) {
+    if (gethostname(host, len) != 0)
+        snprintf(host, len, "unknown");
+    host[len - 1] = '\0';
+}
+
+// === Write metadata ===
+int bench_write_metadata(const char *dirpath, const bench_ctx *ctx, const bench_results *res) {
+    FILE *meta = open_in_dir(dirpath, "metadata.txt");
+    if (!meta)
+        return 0;
+
+    char host[64];
+    host_name(host, sizeof(host));
+
+    fprintf(meta, "Algorithm: %s\n", ctx->alg->name);
+    fprintf(meta, "Host: %s\n", host);
+    if (ctx->alg->backend == BENCH_BACKEND_OQS)
+        fprintf(meta, "Backend: liboqs %s\n", OQS_version());
+    else
+        fprintf(meta, "Backend: %s provider\n", OpenSSL_version(OPENSSL_VERSION));
+    bench_ctx_write_sizes(ctx, meta);
+    fprintf(meta, "Repeat: %d\n", res->repeat);
+    if (res->mode)
+        fprintf(meta, "Mode: %s\n", res->mode);
+    else if (res->batch > 1)
+        fprintf(meta, "Mode: batch\nBatch: %d\n", res->batch);
+    else
+        fprintf(meta, "Mode: single-shot\n");
+    if (res->timer) {
+        fprintf(meta, "Timer: %s\nTimerTicksPerUs: %.3f\nTimerOverheadUs: %.4f\n",
+                bench_timer_name(res->timer), res->timer->ticks_per_us,
+                res->timer->overhead_ticks / res->timer->ticks_per_us);
+    }
+    fprintf(meta, "Counters:");
+    for (int c = 0; c < res->ncounters; c++)
+        fprintf(meta, " %s", res->counter_names[c]);
+    fprintf(meta, "%s\n", res->ncounters ? "" : " none");
+    fprintf(meta, "Operations:");
+    for (int i = 0; i < BENCH_NUM_OPS; i++) {
+        if (res->ops[i])
+            fprintf(meta, " %s", bench_op_label(ctx->alg->kind, i));
+    }
+    fprintf(meta, "\n");
+    if (res->batch > 1 && !res->mode) {
+        // Aggregate throughput: all calls divided by the total time of all windows
+        for (int i = 0; i < BENCH_NUM_OPS; i++) {
+            double mean = res->metrics[i][0].stat.mean;
+
+            if (!res->ops[i])
+                continue;
+            fprintf(meta, "Throughput_%s: %.1f ops/s\n", bench_op_label(ctx->alg->kind, i),
+                    mean > 0 ? 1e6 / mean : 0.0);
+        }
+    }
+    if (!res->keep_raw)
+        fprintf(meta, "RawSamples: none\n");
+    else
+        fprintf(meta, "RawSamples: %s%s%s\n", res->raw_format & BENCH_RAW_BIN ? "samples.bin" : "",
+                res->raw_format == (BENCH_RAW_BIN | BENCH_RAW_CSV) ? " " : "",
+                res->raw_format & BENCH_RAW_CSV ? "raw_*.csv" : "");
+    fclose(meta);
+    return 1;
+}
+
+// === Write raw data: raw_<op>_us.csv and raw_<op>_<counter>.csv ===
+static int write_column(const char *dirpath, const char *op, const bench_metric *m, int count) {
+    char name[128];
+
+    snprintf(name, sizeof(name), "raw_%s_%s.csv", op, m->name);
+    FILE *f = open_in_dir(dirpath, name);
+    if (!f)
+        return 0;
+    for (int j = 0; j < count; j++) {
+        fprintf(f, m->fmt, m->samples[j]);
+        fputc('\n', f);
+    }
+    fclose(f);
+    return 1;
+}
+
+int bench_write_raw(const char *dirpath, const bench_alg *alg, const bench_results *res) {
+    if (!res->keep_raw || !(res->raw_format & BENCH_RAW_CSV))
+        return 1;
+    for (int i = 0; i < BENCH_NUM_OPS; i++) {
+        if (!res->ops[i])
+            continue;
+        for (int m = 0; m < res->nmetrics; m++) {
+            const bench_metric *bm = &res->metrics[i][m];
+            if (bm->samples && !write_column(dirpath, bench_op_label(alg->kind, i), bm, res->repeat))
+                return 0;
+        }
+    }
+    return 1;
+}
+
+// === Write samples.bin: all raw columns of the run in one binary file ===
+#define COL_MAGIC "BENCHCOL"
+#define COL_VERSION 1
+#define COL_HEADER_SIZE 208
+#define COL_DESC_SIZE 72
+#define COL_ALIGN 64
+#define COL_DTYPE_F64 1
+
+static void put_le(uint8_t *p, uint64_t v, int bytes) {
+    for (int i = 0; i < bytes; i++)
+        p[i] = (uint8_t)(v >> (8 * i));
+}
+
+static void put_field(uint8_t *p, const char *s, size_t size) {
+    // NUL-padded; the last byte always stays 0
+    size_t n = strlen(s);
+    memcpy(p, s, n < size ? n : size - 1);
+}
+
+static int write_f64_column(FILE *f, const double *v, size_t n) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    return fwrite(v, sizeof(double), n, f) == n;
+#else
+    for (size_t i = 0; i < n; i++) {
+        uint8_t b[8];
+        uint64_t bits;
+        memcpy(&bits, &v[i], sizeof(bits));
+        put_le(b, bits, 8);
+        if (fwrite(b, 1, 8, f) != 8)
+            return 0;
+    }
+    return 1;
+#endif
+}
+
+int bench_write_columns(const char *dirpath, const bench_alg *alg, const bench_results *res) {
+    const bench_metric *cols[BENCH_NUM_OPS * BENCH_MAX_METRICS];
+    const char *col_ops[BENCH_NUM_OPS * BENCH_MAX_METRICS];
+    int ncols = 0;
+    char host[64];
+
+    if (!res->keep_raw || !(res->raw_format & BENCH_RAW_BIN))
+        return 1;
+    for (int i = 0; i < BENCH_NUM_OPS; i++) {
+        for (int m = 0; m < res->nmetrics && res->ops[i]; m++) {
+            if (res->metrics[i][m].samples) {
+                col_ops[ncols] = bench_op_label(alg->kind, i);
+                cols[ncols++] = &res->metrics[i][m];
+            }
+        }
+    }
+    host_name(host, sizeof(host));
+
+    // Header and column table are built in memory and written in one go
+    size_t table = COL_HEADER_SIZE + (size_t)ncols * COL_DESC_SIZE;
+    size_t data = (table + COL_ALIGN - 1) / COL_ALIGN * COL_ALIGN;
+    size_t col_bytes = (size_t)res->repeat * sizeof(double);
+    uint8_t *hdr = calloc(1, data);
+    if (!hdr)
+        return 0;
+
+    memcpy(hdr, COL_MAGIC, 8);
+    put_le(hdr + 8, COL_VERSION, 4);
+    put_le(hdr + 12, data, 4);
+    put_le(hdr + 16, ncols, 4);
+    put_le(hdr + 20, res->batch, 4);
+    put_le(hdr + 24, res->repeat, 8);
+    put_field(hdr + 32, alg->name, 96);
+    put_field(hdr + 128, host, 64);
+    put_field(hdr + 192, res->timer ? bench_timer_name(res->timer) : "", 16);
+    for (int c = 0; c < ncols; c++) {
+        uint8_t *d = hdr + COL_HEADER_SIZE + c * COL_DESC_SIZE;
+        put_field(d, col_ops[c], 16);
+        put_field(d + 16, cols[c]->name, 32);
+        put_le(d + 48, COL_DTYPE_F64, 4);
+        put_le(d + 56, data + c * col_bytes, 8);
+        put_le(d + 64, res->repeat, 8);
+    }
+
+    FILE *f = open_in_dir(dirpath, "samples.bin");
+    int ok = f != NULL && fwrite(hdr, 1, data, f) == data;
+    for (int c = 0; ok && c < ncols; c++)
+        ok = write_f64_column(f, cols[c]->samples, res->repeat);
+    if (f && fclose(f) != 0)
+        ok = 0;
+    free(hdr);
+    return ok;
+}
+
+// === Write summary (one row per operation and metric, plus IPC when available) ===
+// In batch mode all values are per call and an ops_per_sec row gives the throughput
+// of each window. Percentiles come from the histograms (within 0.8 % of the exact value).
+static const double summary_pct[] = {50, 90, 99, 99.9, 99.99};
+
+int bench_write_summary(const char *dirpath, const bench_alg *alg, const bench_results *res) {
+    FILE *sum = open_in_dir(dirpath, "summary.csv");
+    if (!sum)
+        return 0;
+
+    fprintf(sum, "Operation,Metric,Average,Min,Max,Variance,Sigma,P50,P90,P99,P99.9,P99.99\n");
+    for (int i = 0; i < BENCH_NUM_OPS; i++) {
+        if (!res->ops[i])
+            continue;
+        for (int m = 0; m < res->nmetrics; m++) {
+            const bench_metric *bm = &res->metrics[i][m];
+            double var = bench_stat_var(&bm->stat);
+            double row[5] = {bm->stat.mean, bm->stat.min, bm->stat.max, var, sqrt(var)};
+
+            fprintf(sum, "%s,%s", bench_op_label(alg->kind, i), bm->name);
+            for (int k = 0; k < 5; k++) {
+                fputc(',', sum);
+                fprintf(sum, bm->fmt, row[k]);
+            }
+            for (size_t k = 0; k < sizeof(summary_pct) / sizeof(summary_pct[0]); k++) {
+                fputc(',', sum);
+                fprintf(sum, bm->fmt, bench_hist_percentile(bm->hist, summary_pct[k]));
+            }
+            fputc('\n', sum);
+        }
+    }
+    fclose(sum);
+    return 1;
+}
+
+// === Write histograms.bin: every histogram of the run, back to back ===
+int bench_write_histograms(const char *dirpath, const bench_alg *alg, const bench_results *res) {
+    FILE *f = open_in_dir(dirpath, "histograms.bin");
+    int ok = f != NULL;
+
+    for (int i = 0; ok && i < BENCH_NUM_OPS; i++) {
+        if (!res->ops[i])
+            continue;
+        for (int m = 0; ok && m < res->nmetrics; m++) {
+            const bench_metric *bm = &res->metrics[i][m];
+            ok = bench_hist_write(bm->hist, bench_op_label(alg->kind, i), bm->name, f);
+        }
+    }
+    if (f && fclose(f) != 0)
+        ok = 0;
+    return ok;
+}
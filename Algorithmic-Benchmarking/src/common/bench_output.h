@@ -0,0 +1,63 @@
+#ifndef BENCH_OUTPUT_H
+#define BENCH_OUTPUT_H
+
+#include <stddef.h>
+#include "bench_algs.h"
+#include "bench_pmu.h"
+#include "bench_timing.h"
+#include "bench_stats.h"
+
+// Raw sample formats (bit mask)
+#define BENCH_RAW_CSV 1              // raw_<op>_<metric>.csv, one value per line
+#define BENCH_RAW_BIN 2              // samples.bin, see bench_write_columns
+
+// === Metrics of one algorithm run ===
+// Per operation: "us", one per PMU counter, "ipc" (cycles and instructions recorded)
+// and "ops_per_sec" (batch mode). Every metric keeps streaming statistics and an HDR
+// histogram; raw samples are only stored when raw CSV output is requested, so the
+// memory use does not grow with the number of iterations otherwise.
+#define BENCH_MAX_METRICS (BENCH_PMU_MAX_EVENTS + 3)
+
+typedef struct {
+    const char *name;
+    const char *fmt;                 // printf format for CSV values
+    int derived;                     // Computed from other metrics, no raw file
+    bench_stat stat;
+    bench_hist *hist;
+    double *samples;                 // NULL unless raw output is kept
+} bench_metric;
+
+typedef struct {
+    int repeat;
+    int ops[BENCH_NUM_OPS];          // 1 if the operation was measured
+    int ncounters;                   // PMU counters recorded per sample
+    const char *counter_names[BENCH_PMU_MAX_EVENTS];
+    int nmetrics;
+    bench_metric metrics[BENCH_NUM_OPS][BENCH_MAX_METRICS];
+    int ipc_metric, ops_metric;      // Index of the derived metrics, -1 if absent
+    int keep_raw;
+    int raw_format;                  // BENCH_RAW_* bits: output formats of the raw samples
+    const bench_timer *timer;        // Backend that produced the times
+    int batch;                       // Calls per timed window (1 = single-shot)
+    const char *mode;                // Overrides the single-shot/batch mode line if set
+} bench_results;
+
+int bench_results_init(bench_results *res, int repeat, const int ops[BENCH_NUM_OPS],
+                       const bench_pmu *pmu, int batch, int keep_raw);
+void bench_results_free(bench_results *res);
+// Record sample i of an operation: time in us and one value per PMU counter
+void bench_results_add(bench_results *res, int op, int i, double us, const double *counters);
+
+// Create <base>/benchmarks/<kem|sig>/<alg dir>/<timestamp> and return it in dirpath.
+int bench_output_dir(char *dirpath, size_t len, const char *base, const bench_alg *alg);
+int bench_write_metadata(const char *dirpath, const bench_ctx *ctx, const bench_results *res);
+int bench_write_raw(const char *dirpath, const bench_alg *alg, const bench_results *res);
+int bench_write_summary(const char *dirpath, const bench_alg *alg, const bench_results *res);
+// samples.bin: fixed 208-byte header (magic "BENCHCOL", version, header size, column
+// count, batch, rows, algorithm, host, timer), one 72-byte descriptor per column
+// (op, metric, dtype, offset, count), then the columns as little-endian f64 arrays
+// starting at a 64-byte aligned offset, so a reader can mmap them directly.
+int bench_write_columns(const char *dirpath, const bench_alg *alg, const bench_results *res);
+int bench_write_histograms(const char *dirpath, const bench_alg *alg, const bench_results *res);
+
+#endif
@@ -0,0 +1,135 @@
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/perf_event.h>
+#include <asm/unistd.h>
+#include "bench_pmu.h"
+
+#define CACHE_READ_MISS(cache) \
+    ((cache) | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16))
+
+typedef struct {
+    const char *name;
+    uint32_t type;
+    uint64_t config;
+} pmu_event;
+
+// Preferred group, first entry is the group leader
+static const pmu_event hw_events[] = {
+    {"cycles",        PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {"instructions",  PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {"branch_misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+    {"l1d_misses",    PERF_TYPE_HW_CACHE, CACHE_READ_MISS(PERF_COUNT_HW_CACHE_L1D)},
+    {"llc_misses",    PERF_TYPE_HW_CACHE, CACHE_READ_MISS(PERF_COUNT_HW_CACHE_LL)},
+};
+
+static const pmu_event sw_event = {"task_clock_ns", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK};
+
+// Layout of a PERF_FORMAT_GROUP | TOTAL_TIME_ENABLED | TOTAL_TIME_RUNNING read
+typedef struct {
+    uint64_t nr;
+    uint64_t time_enabled;
+    uint64_t time_running;
+    uint64_t values[BENCH_PMU_MAX_EVENTS];
+} group_read;
+
+static int open_event(const pmu_event *ev, int group_fd) {
+    struct perf_event_attr pe;
+
+    memset(&pe, 0, sizeof(pe));
+    pe.type = ev->type;
+    pe.size = sizeof(struct perf_event_attr);
+    pe.config = ev->config;
+    pe.disabled = group_fd == -1; // Only the leader starts disabled
+    pe.exclude_kernel = 1;
+    pe.exclude_hv = 1;
+    pe.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    return syscall(__NR_perf_event_open, &pe, 0, -1, group_fd, 0);
+}
+
+static void close_group(bench_pmu *pmu) {
+    for (int i = pmu->nevents - 1; i >= 0; i--)
+        close(pmu->fds[i]);
+    pmu->nevents = 0;
+    pmu->available = 0;
+}
+
+static int read_group(const bench_pmu *pmu, group_read *gr) {
+    ssize_t want = (ssize_t)(3 + pmu->nevents) * sizeof(uint64_t);
+    return read(pmu->fds[0], gr, sizeof(*gr)) == want;
+}
+
+// Open the first n events of the list as one group and make sure it can be scheduled.
+// Followers the PMU does not support are dropped; a dead leader fails the whole group.
+static int open_group(bench_pmu *pmu, const pmu_event *events, int n) {
+    pmu->nevents = 0;
+    for (int i = 0; i < n; i++) {
+        int fd = open_event(&events[i], pmu->nevents ? pmu->fds[0] : -1);
+        if (fd == -1) {
+            if (i == 0)
+                return 0;
+            continue;
+        }
+        pmu->names[pmu->nevents] = events[i].name;
+        pmu->fds[pmu->nevents++] = fd;
+    }
+    pmu->available = 1;
+
+    // A group with more events than hardware counters is never scheduled (time_running == 0)
+    group_read gr;
+    volatile unsigned spin = 0;
+    ioctl(pmu->fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    for (unsigned i = 0; i < 100000; i++)
+        spin += i;
+    if (!read_group(pmu, &gr) || gr.time_running == 0) {
+        close_group(pmu);
+        return 0;
+    }
+    return 1;
+}
+
+void bench_pmu_open(bench_pmu *pmu) {
+    int nhw = (int)(sizeof(hw_events) / sizeof(hw_events[0]));
+
+    memset(pmu, 0, sizeof(*pmu));
+    pmu->hardware = 1;
+    // Full group first, then cycles + instructions, then cycles alone
+    if (open_group(pmu, hw_events, nhw) || open_group(pmu, hw_events, 2)
+            || open_group(pmu, hw_events, 1))
+        return;
+
+    perror("perf_event_open (PMU not available, falling back to task clock)");
+    pmu->hardware = 0;
+    if (open_group(pmu, &sw_event, 1))
+        return;
+
+    printf("Warning: perf events not available — skipping counter measurements\n");
+}
+
+void bench_pmu_start(bench_pmu *pmu) {
+    group_read gr;
+
+    if (!pmu->available || !read_group(pmu, &gr))
+        return;
+    memcpy(pmu->start, gr.values, pmu->nevents * sizeof(uint64_t));
+}
+
+void bench_pmu_stop(bench_pmu *pmu, uint64_t *delta) {
+    group_read gr;
+
+    if (!pmu->available)
+        return;
+    if (!read_group(pmu, &gr)) {
+        memset(delta, 0, pmu->nevents * sizeof(uint64_t));
+        return;
+    }
+    for (int i = 0; i < pmu->nevents; i++)
+        delta[i] = gr.values[i] - pmu->start[i];
+}
+
+void bench_pmu_close(bench_pmu *pmu) {
+    if (pmu->available)
+        close_group(pmu);
+}
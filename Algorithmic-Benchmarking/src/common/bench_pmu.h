@@ -0,0 +1,29 @@
+#ifndef BENCH_PMU_H
+#define BENCH_PMU_H
+
+#include <stdint.h>
+
+// === Hardware counter group via perf_event_open ===
+// One group (cycles, instructions, L1D/LLC read misses, branch misses) is opened per
+// thread and left running; each measurement is the difference of two group reads,
+// so a sample costs two read() syscalls instead of RESET/ENABLE/DISABLE ioctls.
+// Without a usable PMU the group falls back to the software task clock.
+#define BENCH_PMU_MAX_EVENTS 5
+
+typedef struct {
+    int fds[BENCH_PMU_MAX_EVENTS];
+    int nevents;
+    int available;
+    int hardware;                                   // 0 = task-clock fallback
+    const char *names[BENCH_PMU_MAX_EVENTS];       // CSV column names, e.g. "cycles"
+    uint64_t start[BENCH_PMU_MAX_EVENTS];
+} bench_pmu;
+
+// Open the counter group for the calling thread; available == 0 if nothing could be opened.
+void bench_pmu_open(bench_pmu *pmu);
+void bench_pmu_start(bench_pmu *pmu);
+// Store the counter deltas since bench_pmu_start() in delta[0..nevents-1].
+void bench_pmu_stop(bench_pmu *pmu, uint64_t *delta);
+void bench_pmu_close(bench_pmu *pmu);
+
+#endif
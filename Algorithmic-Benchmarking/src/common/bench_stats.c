@@ -0,0 +1,130 @@
+#include <math.h>
+#include <string.h>
+#include "bench_stats.h"
+
+#define SUB_COUNT (1 << BENCH_HIST_SUB_BITS)       // Exact buckets below this value
+#define HALF_COUNT (1 << (BENCH_HIST_SUB_BITS - 1)) // Sub-buckets per power of two above
+
+void bench_stat_init(bench_stat *s) {
+    memset(s, 0, sizeof(*s));
+}
+
+void bench_stat_add(bench_stat *s, double v) {
+    if (s->count == 0 || v < s->min) s->min = v;
+    if (s->count == 0 || v > s->max) s->max = v;
+    s->count++;
+    double d = v - s->mean;
+    s->mean += d / s->count;
+    s->m2 += d * (v - s->mean);
+}
+
+double bench_stat_var(const bench_stat *s) {
+    return s->count ? s->m2 / s->count : 0.0;
+}
+
+// === Histogram index <-> value mapping ===
+static int hist_index(uint64_t v) {
+    if (v < SUB_COUNT)
+        return (int)v;
+    int e = 63 - __builtin_clzll(v);                       // e >= SUB_BITS
+    uint64_t m = v >> (e - (BENCH_HIST_SUB_BITS - 1));     // HALF_COUNT .. SUB_COUNT-1
+    return SUB_COUNT + (e - BENCH_HIST_SUB_BITS) * HALF_COUNT + (int)(m - HALF_COUNT);
+}
+
+static void hist_range(int index, uint64_t *lo, uint64_t *width) {
+    if (index < SUB_COUNT) {
+        *lo = (uint64_t)index;
+        *width = 1;
+        return;
+    }
+    int e = (index - SUB_COUNT) / HALF_COUNT + BENCH_HIST_SUB_BITS;
+    uint64_t m = (uint64_t)((index - SUB_COUNT) % HALF_COUNT + HALF_COUNT);
+    int shift = e - (BENCH_HIST_SUB_BITS - 1);
+    *lo = m << shift;
+    *width = 1ull << shift;
+}
+
+void bench_hist_init(bench_hist *h, double unit) {
+    memset(h, 0, sizeof(*h));
+    h->unit = unit;
+}
+
+void bench_hist_add(bench_hist *h, double v) {
+    double scaled = v / h->unit + 0.5;
+    uint64_t iv = scaled <= 0 ? 0 : scaled >= 1.8e19 ? UINT64_MAX : (uint64_t)scaled;
+
+    h->counts[hist_index(iv)]++;
+    h->total++;
+}
+
+// Add all counts of src (same unit) to dst
+void bench_hist_merge(bench_hist *dst, const bench_hist *src) {
+    dst->total += src->total;
+    for (int i = 0; i < BENCH_HIST_SIZE; i++)
+        dst->counts[i] += src->counts[i];
+}
+
+void bench_hist_bucket_range(const bench_hist *h, int index, double *lo, double *hi) {
+    uint64_t l, w;
+    hist_range(index, &l, &w);
+    *lo = (double)l * h->unit;
+    *hi = ((double)l + (double)w) * h->unit;
+}
+
+double bench_hist_percentile(const bench_hist *h, double p) {
+    if (h->total == 0)
+        return 0.0;
+
+    uint64_t rank = (uint64_t)ceil(p / 100.0 * (double)h->total), seen = 0;
+    if (rank == 0)
+        rank = 1;
+    for (int i = 0; i < BENCH_HIST_SIZE; i++) {
+        seen += h->counts[i];
+        if (seen >= rank) {
+            double lo, hi;
+            bench_hist_bucket_range(h, i, &lo, &hi);
+            return i < SUB_COUNT ? lo : (lo + hi) / 2;
+        }
+    }
+    return 0.0;
+}
+
+// === Binary dump ===
+// Little-endian: magic "BHST", u8 sub_bits, u8 len + op, u8 len + metric, f64 unit,
+// u64 total, u32 n, then n x (u32 bucket index, u64 count).
+static void put_u(FILE *f, uint64_t v, int bytes) {
+    for (int i = 0; i < bytes; i++)
+        fputc((int)((v >> (8 * i)) & 0xff), f);
+}
+
+static void put_str(FILE *f, const char *s) {
+    size_t n = strlen(s);
+    if (n > 255)
+        n = 255;
+    fputc((int)n, f);
+    fwrite(s, 1, n, f);
+}
+
+int bench_hist_write(const bench_hist *h, const char *op, const char *metric, FILE *f) {
+    uint64_t unit_bits;
+    uint32_t n = 0;
+
+    for (int i = 0; i < BENCH_HIST_SIZE; i++)
+        n += h->counts[i] != 0;
+    memcpy(&unit_bits, &h->unit, sizeof(unit_bits));
+
+    fwrite(BENCH_HIST_MAGIC, 1, 4, f);
+    fputc(BENCH_HIST_SUB_BITS, f);
+    put_str(f, op);
+    put_str(f, metric);
+    put_u(f, unit_bits, 8);
+    put_u(f, h->total, 8);
+    put_u(f, n, 4);
+    for (int i = 0; i < BENCH_HIST_SIZE; i++) {
+        if (!h->counts[i])
+            continue;
+        put_u(f, (uint64_t)i, 4);
+        put_u(f, h->counts[i], 8);
+    }
+    return !ferror(f);
+}
@@ -0,0 +1,43 @@
+#ifndef BENCH_STATS_H
+#define BENCH_STATS_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+// === Streaming statistics: average, min, max, variance (Welford, constant memory) ===
+typedef struct {
+    uint64_t count;
+    double mean, m2, min, max;
+} bench_stat;
+
+void bench_stat_init(bench_stat *s);
+void bench_stat_add(bench_stat *s, double v);
+double bench_stat_var(const bench_stat *s); // Population variance, as before
+
+// === HDR-style log-bucketed histogram ===
+// Values are recorded as integers in multiples of `unit` (e.g. 0.001 us = 1 ns).
+// Integers below 2^SUB_BITS get their own bucket; above that every power of two is
+// split into 2^(SUB_BITS-1) linear sub-buckets, so the relative error stays below
+// 2^-(SUB_BITS-1) (0.8 %) over the whole 64-bit range with a fixed-size table.
+#define BENCH_HIST_SUB_BITS 8
+#define BENCH_HIST_SIZE ((1 << BENCH_HIST_SUB_BITS) + \
+                         (64 - BENCH_HIST_SUB_BITS) * (1 << (BENCH_HIST_SUB_BITS - 1)))
+#define BENCH_HIST_MAGIC "BHST"
+
+typedef struct {
+    double unit;
+    uint64_t total;
+    uint64_t counts[BENCH_HIST_SIZE];
+} bench_hist;
+
+void bench_hist_init(bench_hist *h, double unit);
+void bench_hist_add(bench_hist *h, double v);
+void bench_hist_merge(bench_hist *dst, const bench_hist *src);
+// Value at percentile p (0..100), reported as the midpoint of its bucket
+double bench_hist_percentile(const bench_hist *h, double p);
+// Value range [lo, hi) covered by a bucket
+void bench_hist_bucket_range(const bench_hist *h, int index, double *lo, double *hi);
+// Append a compact binary dump (only non-empty buckets), see README for the layout
+int bench_hist_write(const bench_hist *h, const char *op, const char *metric, FILE *f);
+
+#endif
@@ -0,0 +1,189 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sched.h>
+#include <unistd.h>
+#include "bench_system.h"
+
+#define SYS_CPUFREQ "/sys/devices/system/cpu/cpu%d/cpufreq/%s"
+#define SYS_THERMAL "/sys/class/thermal/thermal_zone0/temp"
+#define SYS_THROTTLED "/sys/devices/platform/soc/soc:firmware/get_throttled"
+#define COOL_POLL_S 1
+
+// === Helper: first line of a sysfs file ===
+static int read_line(const char *path, char *buf, size_t len) {
+    FILE *f = fopen(path, "r");
+    if (!f)
+        return 0;
+    int ok = fgets(buf, (int)len, f) != NULL;
+    fclose(f);
+    if (ok)
+        buf[strcspn(buf, "\n")] = '\0';
+    return ok;
+}
+
+void bench_sys_read(bench_sysstate *s) {
+    char path[128], buf[64];
+
+    s->cpu = sched_getcpu();
+    if (s->cpu < 0)
+        s->cpu = 0;
+
+    snprintf(path, sizeof(path), SYS_CPUFREQ, s->cpu, "scaling_cur_freq");
+    s->freq_mhz = read_line(path, buf, sizeof(buf)) ? atof(buf) / 1000.0 : -1.0; // kHz
+
+    snprintf(path, sizeof(path), SYS_CPUFREQ, s->cpu, "scaling_governor");
+    if (!read_line(path, s->governor, sizeof(s->governor)))
+        snprintf(s->governor, sizeof(s->governor), "unknown");
+
+    s->temp_c = read_line(SYS_THERMAL, buf, sizeof(buf)) ? atof(buf) / 1000.0 : -1.0; // m°C
+    s->throttled = read_line(SYS_THROTTLED, buf, sizeof(buf)) ? strtol(buf, NULL, 16) : -1;
+}
+
+double bench_sys_wait_cool(double max_temp_c, int refuse, int *ok) {
+    bench_sysstate s;
+    uint64_t start = bench_clock_ns();
+    int announced = 0;
+
+    *ok = 1;
+    for (;;) {
+        bench_sys_read(&s);
+        // Without a thermal sensor there is nothing to wait for
+        if (max_temp_c <= 0 || s.temp_c < 0 || s.temp_c < max_temp_c)
+            break;
+        if (refuse) {
+            fprintf(stderr, "CPU temperature %.1f C is above the limit of %.1f C\n",
+                    s.temp_c, max_temp_c);
+            *ok = 0;
+            break;
+        }
+        if (!announced) {
+            printf("Waiting for the CPU to cool down (%.1f C, limit %.1f C)...\n",
+                   s.temp_c, max_temp_c);
+            fflush(stdout);
+            announced = 1;
+        }
+        sleep(COOL_POLL_S);
+    }
+    return (bench_clock_ns() - start) / 1e9;
+}
+
+// === Monitor ===
+static void track(bench_sysmon *m, const bench_sysstate *s) {
+    if (s->freq_mhz >= 0) {
+        if (m->min_freq < 0 || s->freq_mhz < m->min_freq) m->min_freq = s->freq_mhz;
+        if (s->freq_mhz > m->max_freq) m->max_freq = s->freq_mhz;
+    }
+    if (s->temp_c > m->max_temp)
+        m->max_temp = s->temp_c;
+}
+
+// Close the current window (iterations first_iter .. iter-1); paused is the cooling
+// pause that followed it
+static void write_window(bench_sysmon *m, int iter, double paused) {
+    if (!m->csv)
+        return;
+    fprintf(m->csv, "%d,%d,%d,%.3f,%d,%.0f,%s,%.1f,%.3f\n", m->window, m->first_iter, iter - 1,
+            (m->window_ns - m->start_ns) / 1e9, m->cur.cpu, m->cur.freq_mhz,
+            m->cur.governor, m->cur.temp_c, paused);
+}
+
+static void open_window(bench_sysmon *m, int iter) {
+    m->first_iter = iter;
+    bench_sys_read(&m->cur);
+    track(m, &m->cur);
+    m->window_ns = bench_clock_ns();
+    m->next_ns = m->window_ns + m->interval_ns;
+}
+
+int bench_sysmon_start(bench_sysmon *m, const char *dirpath, double max_temp_c, int refuse_hot,
+                       int interval_ms) {
+    int ok;
+
+    memset(m, 0, sizeof(*m));
+    m->max_temp_c = max_temp_c;
+    m->refuse_hot = refuse_hot;
+    m->interval_ns = (uint64_t)interval_ms * 1000000ull;
+    m->min_freq = m->max_freq = m->max_temp = -1.0;
+
+    double waited = bench_sys_wait_cool(max_temp_c, refuse_hot, &ok);
+    if (!ok)
+        return 0;
+    if (waited >= COOL_POLL_S) {
+        m->pauses++;
+        m->paused_s += waited;
+    }
+
+    if (dirpath) {
+        char path[512];
+        snprintf(path, sizeof(path), "%s/system.csv", dirpath);
+        m->csv = fopen(path, "w");
+        if (!m->csv) {
+            perror(path);
+            return 0;
+        }
+        fprintf(m->csv, "Window,FirstIteration,LastIteration,StartSec,CPU,FreqMHz,Governor,TempC,PausedSec\n");
+    }
+
+    m->start_ns = bench_clock_ns();
+    open_window(m, 0);
+    m->before = m->cur;
+    return 1;
+}
+
+void bench_sysmon_window(bench_sysmon *m, int iter) {
+    double paused = 0.0;
+
+    // Pause between iterations (never inside a timed region) if the CPU got too hot
+    if (m->max_temp_c > 0) {
+        bench_sysstate s;
+        int ok;
+        bench_sys_read(&s);
+        track(m, &s);
+        if (s.temp_c >= m->max_temp_c) {
+            paused = bench_sys_wait_cool(m->max_temp_c, 0, &ok);
+            m->pauses++;
+            m->paused_s += paused;
+        }
+    }
+    write_window(m, iter, paused);
+    m->window++;
+    open_window(m, iter);
+}
+
+void bench_sysmon_stop(bench_sysmon *m, int iter) {
+    write_window(m, iter, 0.0);
+    if (m->csv)
+        fclose(m->csv);
+    m->csv = NULL;
+    bench_sys_read(&m->after);
+    track(m, &m->after);
+}
+
+static void write_state(FILE *meta, const char *when, const bench_sysstate *s) {
+    fprintf(meta, "CPUFreqMHz_%s: %.0f\nGovernor_%s: %s\nTempC_%s: %.1f\n",
+            when, s->freq_mhz, when, s->governor, when, s->temp_c);
+    if (s->throttled >= 0)
+        fprintf(meta, "Throttled_%s: 0x%lx\n", when, s->throttled);
+}
+
+int bench_sysmon_write_metadata(const char *dirpath, const bench_sysmon *m) {
+    char path[512];
+
+    snprintf(path, sizeof(path), "%s/metadata.txt", dirpath);
+    FILE *meta = fopen(path, "a");
+    if (!meta) {
+        perror(path);
+        return 0;
+    }
+    write_state(meta, "before", &m->before);
+    write_state(meta, "after", &m->after);
+    fprintf(meta, "CPUFreqMHz_min: %.0f\nCPUFreqMHz_max: %.0f\nTempC_max: %.1f\n",
+            m->min_freq, m->max_freq, m->max_temp);
+    if (m->max_temp_c > 0)
+        fprintf(meta, "TempLimitC: %.1f\nThermalPauses: %d\nThermalPausedSec: %.1f\n",
+                m->max_temp_c, m->pauses, m->paused_s);
+    fclose(meta);
+    return 1;
+}
@@ -0,0 +1,59 @@
+#ifndef BENCH_SYSTEM_H
+#define BENCH_SYSTEM_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include "bench_timing.h"
+
+// === CPU frequency, governor and thermal state ===
+// Read from sysfs (cpufreq of the CPU the benchmark runs on, thermal_zone0). Values that
+// are not available (VMs, containers) are reported as -1 / "unknown".
+typedef struct {
+    int cpu;
+    double freq_mhz;        // scaling_cur_freq
+    double temp_c;          // thermal_zone0 temperature
+    char governor[32];      // scaling_governor
+    long throttled;         // Raspberry Pi firmware throttle flags (get_throttled), -1 if absent
+} bench_sysstate;
+
+void bench_sys_read(bench_sysstate *s);
+
+// Block until the temperature is below max_temp_c (polled once per second). With refuse
+// set, return 0 immediately instead of waiting. Returns the seconds waited otherwise.
+double bench_sys_wait_cool(double max_temp_c, int refuse, int *ok);
+
+// === Monitor for one benchmark run ===
+// The state is sampled before the run, at the start of every window of interval_ns and
+// after the run. Every window is written to system.csv with the iterations it covers,
+// so samples can be matched with the frequency/temperature they ran at. If a window
+// starts above max_temp_c, the run pauses until the CPU has cooled down.
+typedef struct {
+    double max_temp_c;      // 0 = no limit
+    int refuse_hot;         // Do not start a run (instead of waiting) when too hot
+    uint64_t interval_ns;
+    FILE *csv;
+    int window;
+    int first_iter;
+    uint64_t start_ns, window_ns, next_ns;
+    double paused_s;        // Total time spent waiting for the CPU to cool down
+    int pauses;
+    bench_sysstate before, cur, after;
+    double min_freq, max_freq, max_temp;
+} bench_sysmon;
+
+// Wait for / check the start temperature and open <dirpath>/system.csv (dirpath may be
+// NULL for no per-window file). Returns 0 if the run must not start.
+int bench_sysmon_start(bench_sysmon *m, const char *dirpath, double max_temp_c, int refuse_hot,
+                       int interval_ms);
+void bench_sysmon_window(bench_sysmon *m, int iter);
+void bench_sysmon_stop(bench_sysmon *m, int iter);
+// Append the before/after state and the extremes of the run to metadata.txt
+int bench_sysmon_write_metadata(const char *dirpath, const bench_sysmon *m);
+
+// Called between iterations: opens a new window once the interval has elapsed
+static inline void bench_sysmon_tick(bench_sysmon *m, int iter) {
+    if (bench_clock_ns() >= m->next_ns)
+        bench_sysmon_window(m, iter);
+}
+
+#endif
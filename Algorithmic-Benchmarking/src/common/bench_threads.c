@@ -0,0 +1,272 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include "bench_threads.h"
+#include "bench_stats.h"
+
+typedef struct {
+    const bench_alg *alg;
+    const bench_threads_opts *opts;
+    const bench_timer *timer;
+    int op;
+    int cpu;
+    int *ready;            // Workers that finished their setup
+    int *go;               // Set by the main thread once all workers are ready
+    int *stop;
+    // Results
+    int ok;
+    uint64_t calls;
+    uint64_t start_ns, end_ns;
+    bench_stat stat;
+    bench_hist hist;
+} worker;
+
+// === Helper: CPUs this process may run on, in ascending order ===
+static int allowed_cpus(int *cpus, int max) {
+    cpu_set_t set;
+    int n = 0;
+
+    if (sched_getaffinity(0, sizeof(set), &set) != 0) {
+        cpus[0] = 0;
+        return 1;
+    }
+    for (int c = 0; c < CPU_SETSIZE && n < max; c++) {
+        if (CPU_ISSET(c, &set))
+            cpus[n++] = c;
+    }
+    return n ? n : 1;
+}
+
+int bench_threads_parse(const char *spec, bench_threads_opts *opts) {
+    int cpus[CPU_SETSIZE];
+    int ncpu = allowed_cpus(cpus, CPU_SETSIZE);
+    char buf[256];
+
+    opts->ncounts = 0;
+    if (strcmp(spec, "scale") == 0) {
+        for (int n = 1; n < ncpu && opts->ncounts < BENCH_MAX_THREAD_COUNTS - 1; n *= 2)
+            opts->counts[opts->ncounts++] = n;
+        opts->counts[opts->ncounts++] = ncpu;
+        return 1;
+    }
+
+    snprintf(buf, sizeof(buf), "%s", spec);
+    for (char *tok = strtok(buf, ","); tok; tok = strtok(NULL, ",")) {
+        int n = strcmp(tok, "max") == 0 ? ncpu : atoi(tok);
+        if (n <= 0 || opts->ncounts == BENCH_MAX_THREAD_COUNTS)
+            return 0;
+        opts->counts[opts->ncounts++] = n;
+    }
+    return opts->ncounts > 0;
+}
+
+static void *worker_main(void *arg) {
+    worker *w = arg;
+    cpu_set_t set;
+
+    CPU_ZERO(&set);
+    CPU_SET(w->cpu, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+
+    // Own algorithm object and buffers, with valid inputs for the measured operation
+    bench_ctx *ctx = bench_ctx_new(w->alg, w->opts->msg_len);
+    w->ok = ctx != NULL;
+    for (int op = 0; w->ok && op <= w->op; op++)
+        w->ok = bench_ctx_run(ctx, op) && bench_ctx_check(ctx, op);
+
+    __atomic_add_fetch(w->ready, 1, __ATOMIC_RELEASE);
+    while (!__atomic_load_n(w->go, __ATOMIC_ACQUIRE))
+        sched_yield();
+    if (!w->ok) {
+        bench_ctx_free(ctx);
+        return NULL;
+    }
+
+    uint64_t limit = w->opts->duration_s > 0 ? UINT64_MAX : (uint64_t)w->opts->calls_per_thread;
+    w->start_ns = bench_clock_ns();
+    while (!__atomic_load_n(w->stop, __ATOMIC_RELAXED) && w->calls < limit) {
+        uint64_t start = bench_timer_start(w->timer);
+        int ok = bench_ctx_run(ctx, w->op);
+        uint64_t end = bench_timer_stop(w->timer);
+
+        if (!ok || !bench_ctx_check(ctx, w->op)) {
+            w->ok = 0;
+            break;
+        }
+        double us = bench_timer_us(w->timer, start, end);
+        bench_stat_add(&w->stat, us);
+        bench_hist_add(&w->hist, us);
+        w->calls++;
+    }
+    w->end_ns = bench_clock_ns();
+
+    bench_ctx_free(ctx);
+    return NULL;
+}
+
+// === Write per-thread latency histogram: one row per non-empty bucket, one column per thread ===
+static int write_histograms(const char *dirpath, const char *label, const worker *w, int n) {
+    char path[512];
+
+    snprintf(path, sizeof(path), "%s/latency_hist_%s_%dt.csv", dirpath, label, n);
+    FILE *f = fopen(path, "w");
+    if (!f) {
+        perror(path);
+        return 0;
+    }
+    fprintf(f, "LowerUs,UpperUs");
+    for (int t = 0; t < n; t++)
+        fprintf(f, ",T%d", t);
+    fprintf(f, "\n");
+    for (int b = 0; b < BENCH_HIST_SIZE; b++) {
+        uint64_t any = 0;
+        double lo, hi;
+        for (int t = 0; t < n; t++)
+            any |= w[t].hist.counts[b];
+        if (!any)
+            continue;
+        bench_hist_bucket_range(&w[0].hist, b, &lo, &hi);
+        fprintf(f, "%.3f,%.3f", lo, hi);
+        for (int t = 0; t < n; t++)
+            fprintf(f, ",%llu", (unsigned long long)w[t].hist.counts[b]);
+        fprintf(f, "\n");
+    }
+    fclose(f);
+    return 1;
+}
+
+// === One run: n threads executing one operation ===
+static int run_threads(const bench_alg *alg, int op, int n, const int *cpus, int ncpu,
+                       const bench_threads_opts *opts, const bench_timer *timer,
+                       FILE *csv, const char *dirpath) {
+    const char *label = bench_op_label(alg->kind, op);
+    worker *w = calloc(n, sizeof(*w));
+    pthread_t *tid = calloc(n, sizeof(*tid));
+    int ready = 0, go = 0, stop = 0;
+    int started = 0, ok = 0;
+
+    if (!w || !tid)
+        goto end;
+    for (int t = 0; t < n; t++) {
+        w[t] = (worker){ .alg = alg, .opts = opts, .timer = timer, .op = op,
+                         .cpu = cpus[t % ncpu], .ready = &ready, .go = &go, .stop = &stop };
+        bench_stat_init(&w[t].stat);
+        bench_hist_init(&w[t].hist, 0.001);
+        if (pthread_create(&tid[t], NULL, worker_main, &w[t]) != 0) {
+            fprintf(stderr, "pthread_create failed\n");
+            __atomic_store_n(&stop, 1, __ATOMIC_RELAXED);
+            break;
+        }
+        started++;
+    }
+
+    // Start all workers at once after their setup (key generation etc.) is done
+    while (__atomic_load_n(&ready, __ATOMIC_ACQUIRE) < started)
+        sched_yield();
+    __atomic_store_n(&go, 1, __ATOMIC_RELEASE);
+
+    if (started == n && opts->duration_s > 0) {
+        usleep((useconds_t)(opts->duration_s * 1e6));
+        __atomic_store_n(&stop, 1, __ATOMIC_RELAXED);
+    }
+    for (int t = 0; t < started; t++)
+        pthread_join(tid[t], NULL);
+    if (started < n)
+        goto end;
+
+    // === Aggregate: total calls over the span from first start to last end ===
+    uint64_t calls = 0, first = UINT64_MAX, last = 0;
+    bench_hist *all = malloc(sizeof(*all));
+    if (!all)
+        goto end;
+    bench_hist_init(all, 0.001);
+    ok = 1;
+    for (int t = 0; t < n; t++) {
+        double secs = (w[t].end_ns - w[t].start_ns) / 1e9;
+
+        if (!w[t].ok) {
+            fprintf(stderr, "%s %s failed in thread %d\n", alg->name, label, t);
+            ok = 0;
+        }
+        calls += w[t].calls;
+        if (w[t].start_ns < first) first = w[t].start_ns;
+        if (w[t].end_ns > last) last = w[t].end_ns;
+        bench_hist_merge(all, &w[t].hist);
+        fprintf(csv, "%s,%d,%d,%d,%llu,%.6f,%.1f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f\n", label, n, t,
+                w[t].cpu, (unsigned long long)w[t].calls, secs, secs > 0 ? w[t].calls / secs : 0.0,
+                w[t].stat.mean, w[t].stat.count ? w[t].stat.min : 0.0,
+                w[t].stat.count ? w[t].stat.max : 0.0, bench_hist_percentile(&w[t].hist, 50),
+                bench_hist_percentile(&w[t].hist, 99), bench_hist_percentile(&w[t].hist, 99.9));
+    }
+    double span = last > first ? (last - first) / 1e9 : 0.0;
+    double ops_sec = span > 0 ? calls / span : 0.0;
+    fprintf(csv, "%s,%d,all,,%llu,%.6f,%.1f,,,,%.2f,%.2f,%.2f\n", label, n, (unsigned long long)calls,
+            span, ops_sec, bench_hist_percentile(all, 50), bench_hist_percentile(all, 99),
+            bench_hist_percentile(all, 99.9));
+    free(all);
+    printf("  %-8s %3d thread(s): %12.1f ops/s (%.1f per thread)\n", label, n, ops_sec, ops_sec / n);
+
+    ok = ok && write_histograms(dirpath, label, w, n);
+
+end:
+    free(w);
+    free(tid);
+    return ok;
+}
+
+int bench_threads_write_metadata(const char *dirpath, const bench_threads_opts *opts) {
+    char path[512];
+    int cpus[CPU_SETSIZE];
+    int ncpu = allowed_cpus(cpus, CPU_SETSIZE);
+
+    snprintf(path, sizeof(path), "%s/metadata.txt", dirpath);
+    FILE *meta = fopen(path, "a");
+    if (!meta) {
+        perror(path);
+        return 0;
+    }
+    fprintf(meta, "Threads:");
+    for (int i = 0; i < opts->ncounts; i++)
+        fprintf(meta, "%s%d", i ? "," : " ", opts->counts[i]);
+    fprintf(meta, "\n");
+    if (opts->duration_s > 0)
+        fprintf(meta, "DurationSec: %.3f\n", opts->duration_s);
+    else
+        fprintf(meta, "CallsPerThread: %d\n", opts->calls_per_thread);
+    fprintf(meta, "CPUs:");
+    for (int i = 0; i < ncpu; i++)
+        fprintf(meta, "%s%d", i ? "," : " ", cpus[i]);
+    fprintf(meta, "\n");
+    fclose(meta);
+    return 1;
+}
+
+int bench_threads_run(const bench_alg *alg, const int ops[BENCH_NUM_OPS],
+                      const bench_threads_opts *opts, const bench_timer *timer,
+                      const char *dirpath) {
+    int cpus[CPU_SETSIZE];
+    int ncpu = allowed_cpus(cpus, CPU_SETSIZE);
+    char path[512];
+    int ok = 1;
+
+    snprintf(path, sizeof(path), "%s/throughput.csv", dirpath);
+    FILE *csv = fopen(path, "w");
+    if (!csv) {
+        perror(path);
+        return 0;
+    }
+    fprintf(csv, "Operation,Threads,Thread,CPU,Calls,Seconds,OpsPerSec,AvgUs,MinUs,MaxUs,P50Us,P99Us,P99.9Us\n");
+
+    for (int op = 0; op < BENCH_NUM_OPS && ok; op++) {
+        if (!ops[op])
+            continue;
+        for (int i = 0; i < opts->ncounts && ok; i++)
+            ok = run_threads(alg, op, opts->counts[i], cpus, ncpu, opts, timer, csv, dirpath);
+    }
+    fclose(csv);
+    return ok;
+}
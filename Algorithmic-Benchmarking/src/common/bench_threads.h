@@ -0,0 +1,31 @@
+#ifndef BENCH_THREADS_H
+#define BENCH_THREADS_H
+
+#include "bench_algs.h"
+#include "bench_timing.h"
+
+// === Multi-threaded throughput mode ===
+// For every measured operation and every thread count, N pinned worker threads run the
+// operation concurrently, each with its own liboqs/OpenSSL object and buffers.
+#define BENCH_MAX_THREAD_COUNTS 32
+
+typedef struct {
+    int counts[BENCH_MAX_THREAD_COUNTS]; // Thread counts to sweep
+    int ncounts;
+    double duration_s;                   // > 0: fixed-duration workload per run
+    int calls_per_thread;                // Fixed-count workload when duration_s == 0
+    size_t msg_len;
+} bench_threads_opts;
+
+// Parse "4", "1,2,4", "max" (all CPUs) or "scale" (1, 2, 4, ... up to all CPUs)
+int bench_threads_parse(const char *spec, bench_threads_opts *opts);
+
+// Append thread counts, workload and CPU set to metadata.txt
+int bench_threads_write_metadata(const char *dirpath, const bench_threads_opts *opts);
+
+// Run the sweep for one algorithm and write throughput.csv and latency histograms to dirpath
+int bench_threads_run(const bench_alg *alg, const int ops[BENCH_NUM_OPS],
+                      const bench_threads_opts *opts, const bench_timer *timer,
+                      const char *dirpath);
+
+#endif
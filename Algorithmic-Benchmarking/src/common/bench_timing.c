@@ -0,0 +1,175 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/ioctl.h>
+#include <asm/unistd.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+#include "bench_timing.h"
+
+#define CALIBRATION_NS 50000000ull  // Reference window for tick rate calibration (50 ms)
+#define OVERHEAD_SAMPLES 1001       // Empty start/stop pairs measured for the overhead
+
+static const char *timer_names[] = {"clock", "tsc", "cntvct", "rdpmc"};
+
+const char *bench_timer_name(const bench_timer *t) {
+    return timer_names[t->kind];
+}
+
+// === rdpmc: user-space counter read following the perf mmap page seqlock protocol ===
+uint64_t bench_timer_read_rdpmc(const bench_timer *t) {
+    volatile struct perf_event_mmap_page *pc = t->page;
+    uint32_t seq, idx;
+    uint64_t count;
+
+    do {
+        seq = pc->lock;
+        __atomic_signal_fence(__ATOMIC_SEQ_CST);
+        idx = pc->index;
+        count = pc->offset;
+        if (pc->cap_user_rdpmc && idx) {
+            uint16_t width = pc->pmc_width;
+            int64_t pmc = 0;
+#if defined(__x86_64__) || defined(__i386__)
+            uint32_t lo, hi;
+            __asm__ __volatile__("rdpmc" : "=a"(lo), "=d"(hi) : "c"(idx - 1));
+            pmc = (int64_t)(((uint64_t)hi << 32) | lo);
+#elif defined(__aarch64__)
+            uint64_t val;
+            // Index 32 is the dedicated cycle counter, the others are PMEVCNTR<idx - 1>_EL0
+            if (idx - 1 == 31) {
+                __asm__ __volatile__("mrs %0, pmccntr_el0" : "=r"(val));
+            } else {
+                __asm__ __volatile__("msr pmselr_el0, %0\n\tisb" : : "r"((uint64_t)(idx - 1)));
+                __asm__ __volatile__("mrs %0, pmxevcntr_el0" : "=r"(val));
+            }
+            pmc = (int64_t)val;
+#endif
+            // Sign-extend the counter from its width, as the perf ABI describes
+            if (width > 0 && width < 64) {
+                pmc = (int64_t)((uint64_t)pmc << (64 - width));
+                pmc >>= 64 - width;
+            }
+            count += (uint64_t)pmc;
+        }
+        __atomic_signal_fence(__ATOMIC_SEQ_CST);
+    } while (pc->lock != seq);
+
+    return count;
+}
+
+static int open_rdpmc(bench_timer *t) {
+    struct perf_event_attr pe;
+
+    memset(&pe, 0, sizeof(pe));
+    pe.type = PERF_TYPE_HARDWARE;
+    pe.size = sizeof(struct perf_event_attr);
+    pe.config = PERF_COUNT_HW_CPU_CYCLES;
+    pe.exclude_kernel = 1;
+    pe.exclude_hv = 1;
+#if defined(__aarch64__)
+    pe.config1 = 0x3; // 64-bit counter + user access (needs kernel.perf_user_access=1)
+#endif
+
+    t->fd = syscall(__NR_perf_event_open, &pe, 0, -1, -1, 0);
+    if (t->fd == -1) {
+        perror("perf_event_open (rdpmc timer)");
+        return 0;
+    }
+    t->page = mmap(NULL, sysconf(_SC_PAGESIZE), PROT_READ, MAP_SHARED, t->fd, 0);
+    if (t->page == MAP_FAILED) {
+        perror("mmap (rdpmc timer)");
+        t->page = NULL;
+        return 0;
+    }
+    if (!t->page->cap_user_rdpmc) {
+        fprintf(stderr, "rdpmc timer: user-space counter reads are disabled by the kernel\n");
+        return 0;
+    }
+    return 1;
+}
+
+// === Calibration ===
+static int cmp_u64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+// Ticks per microsecond, measured against CLOCK_MONOTONIC
+static double calibrate_rate(const bench_timer *t) {
+    uint64_t ns0 = bench_clock_ns(), c0 = bench_timer_start(t), ns1;
+
+    while ((ns1 = bench_clock_ns()) - ns0 < CALIBRATION_NS)
+        ;
+    uint64_t c1 = bench_timer_stop(t);
+    return (double)(c1 - c0) * 1000.0 / (double)(ns1 - ns0);
+}
+
+static double calibrate_overhead(const bench_timer *t) {
+    uint64_t d[OVERHEAD_SAMPLES];
+
+    for (int i = 0; i < OVERHEAD_SAMPLES; i++) {
+        uint64_t s = bench_timer_start(t);
+        uint64_t e = bench_timer_stop(t);
+        d[i] = e - s;
+    }
+    qsort(d, OVERHEAD_SAMPLES, sizeof(d[0]), cmp_u64);
+    return (double)d[OVERHEAD_SAMPLES / 2];
+}
+
+int bench_timer_open(bench_timer *t, const char *name) {
+    memset(t, 0, sizeof(*t));
+    t->fd = -1;
+
+    if (strcmp(name, "clock") == 0) {
+        t->kind = BENCH_TIMER_CLOCK;
+        t->ticks_per_us = 1000.0;
+    } else if (strcmp(name, "tsc") == 0) {
+#if defined(__x86_64__) || defined(__i386__)
+        unsigned a, b, c, d;
+        t->kind = BENCH_TIMER_TSC;
+        if (!__get_cpuid(0x80000007, &a, &b, &c, &d) || !(d & (1u << 8)))
+            fprintf(stderr, "Warning: TSC is not invariant, tsc timings follow frequency changes\n");
+#else
+        fprintf(stderr, "tsc timer is only available on x86\n");
+        return 0;
+#endif
+    } else if (strcmp(name, "cntvct") == 0) {
+#if defined(__aarch64__)
+        uint64_t freq;
+        t->kind = BENCH_TIMER_CNTVCT;
+        __asm__ __volatile__("mrs %0, cntfrq_el0" : "=r"(freq));
+        t->ticks_per_us = (double)freq / 1e6;
+#else
+        fprintf(stderr, "cntvct timer is only available on aarch64\n");
+        return 0;
+#endif
+    } else if (strcmp(name, "rdpmc") == 0) {
+        t->kind = BENCH_TIMER_RDPMC;
+        if (!open_rdpmc(t)) {
+            bench_timer_close(t);
+            return 0;
+        }
+    } else {
+        fprintf(stderr, "Unknown timer: %s (clock, tsc, cntvct, rdpmc)\n", name);
+        return 0;
+    }
+
+    // TSC and cycle counters have no architectural rate, derive it from the wall clock
+    if (t->ticks_per_us == 0.0)
+        t->ticks_per_us = calibrate_rate(t);
+    t->overhead_ticks = calibrate_overhead(t);
+    return 1;
+}
+
+void bench_timer_close(bench_timer *t) {
+    if (t->page)
+        munmap(t->page, sysconf(_SC_PAGESIZE));
+    if (t->fd != -1)
+        close(t->fd);
+    t->page = NULL;
+    t->fd = -1;
+}
@@ -0,0 +1,97 @@
+#ifndef BENCH_TIMING_H
+#define BENCH_TIMING_H
+
+#include <stdint.h>
+#include <time.h>
+#include <linux/perf_event.h>
+
+// === Timing backends ===
+//   clock  : clock_gettime(CLOCK_MONOTONIC), portable, ~20-50 ns per read
+//   tsc    : lfence/rdtsc ... rdtscp/lfence on x86 (invariant TSC, calibrated to us)
+//   cntvct : isb + cntvct_el0 generic timer on aarch64 (frequency from cntfrq_el0)
+//   rdpmc  : user-space read of a perf cycle counter through its mmap'd page
+// The cost of an empty start/stop pair is calibrated once and subtracted from every sample.
+typedef enum {
+    BENCH_TIMER_CLOCK,
+    BENCH_TIMER_TSC,
+    BENCH_TIMER_CNTVCT,
+    BENCH_TIMER_RDPMC
+} bench_timer_kind;
+
+typedef struct {
+    bench_timer_kind kind;
+    double ticks_per_us;        // Conversion factor of the raw ticks
+    double overhead_ticks;      // Median cost of an empty start/stop pair
+    int fd;                     // perf event backing the rdpmc backend
+    struct perf_event_mmap_page *page;
+} bench_timer;
+
+// Open a backend by name ("clock", "tsc", "cntvct", "rdpmc"); returns 0 if unsupported here.
+int bench_timer_open(bench_timer *t, const char *name);
+const char *bench_timer_name(const bench_timer *t);
+void bench_timer_close(bench_timer *t);
+uint64_t bench_timer_read_rdpmc(const bench_timer *t);
+
+static inline uint64_t bench_clock_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// Read the counter at the start of a measured region
+static inline uint64_t bench_timer_start(const bench_timer *t) {
+    switch (t->kind) {
+#if defined(__x86_64__) || defined(__i386__)
+    case BENCH_TIMER_TSC: {
+        uint32_t lo, hi;
+        // lfence keeps earlier instructions from leaking into the measured region
+        __asm__ __volatile__("lfence\n\trdtsc" : "=a"(lo), "=d"(hi) :: "memory");
+        return ((uint64_t)hi << 32) | lo;
+    }
+#endif
+#if defined(__aarch64__)
+    case BENCH_TIMER_CNTVCT: {
+        uint64_t v;
+        __asm__ __volatile__("isb\n\tmrs %0, cntvct_el0" : "=r"(v) :: "memory");
+        return v;
+    }
+#endif
+    case BENCH_TIMER_RDPMC:
+        return bench_timer_read_rdpmc(t);
+    default:
+        return bench_clock_ns();
+    }
+}
+
+// Read the counter at the end of a measured region
+static inline uint64_t bench_timer_stop(const bench_timer *t) {
+    switch (t->kind) {
+#if defined(__x86_64__) || defined(__i386__)
+    case BENCH_TIMER_TSC: {
+        uint32_t lo, hi, aux;
+        // rdtscp waits for the region to retire, lfence keeps later code out of it
+        __asm__ __volatile__("rdtscp\n\tlfence" : "=a"(lo), "=d"(hi), "=c"(aux) :: "memory");
+        return ((uint64_t)hi << 32) | lo;
+    }
+#endif
+#if defined(__aarch64__)
+    case BENCH_TIMER_CNTVCT: {
+        uint64_t v;
+        __asm__ __volatile__("isb\n\tmrs %0, cntvct_el0\n\tisb" : "=r"(v) :: "memory");
+        return v;
+    }
+#endif
+    case BENCH_TIMER_RDPMC:
+        return bench_timer_read_rdpmc(t);
+    default:
+        return bench_clock_ns();
+    }
+}
+
+// Elapsed microseconds between two reads, minus the calibrated timer overhead
+static inline double bench_timer_us(const bench_timer *t, uint64_t start, uint64_t end) {
+    double ticks = (double)(end - start) - t->overhead_ticks;
+    return ticks > 0 ? ticks / t->ticks_per_us : 0.0;
+}
+
+#endif
@@ -0,0 +1,160 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "bench_warmup.h"
+
+int bench_warmup_parse(const char *spec, int *fixed) {
+    char *end;
+
+    if (strcmp(spec, "auto") == 0) {
+        *fixed = BENCH_WARMUP_AUTO;
+        return 1;
+    }
+    long n = strtol(spec, &end, 10);
+    if (*end != '\0' || n < 0)
+        return 0;
+    *fixed = (int)n;
+    return 1;
+}
+
+int bench_warmup_init(bench_warmup *w, int fixed, int window, double cv, int repeat,
+                      const int ops[BENCH_NUM_OPS]) {
+    memset(w, 0, sizeof(*w));
+    w->fixed = fixed;
+    w->window = window;
+    w->cv = cv;
+    // Auto mode never costs more than a tenth of the measurement (or two windows)
+    w->max_iters = repeat / 10 > 2 * window ? repeat / 10 : 2 * window;
+    memcpy(w->ops, ops, sizeof(w->ops));
+    for (int i = 0; i < BENCH_NUM_OPS; i++) {
+        bench_stat_init(&w->stat[i]);
+        if (ops[i] && fixed == BENCH_WARMUP_AUTO && !(w->ring[i] = calloc(window, sizeof(double)))) {
+            bench_warmup_free(w);
+            return 0;
+        }
+    }
+    if (fixed == BENCH_WARMUP_AUTO && !(w->scratch = calloc(window, sizeof(double)))) {
+        bench_warmup_free(w);
+        return 0;
+    }
+    return 1;
+}
+
+int bench_warmup_open(bench_warmup *w, const char *dirpath, bench_kind kind) {
+    char path[512];
+
+    if (w->fixed == 0)
+        return 1;
+    snprintf(path, sizeof(path), "%s/warmup.csv", dirpath);
+    w->csv = fopen(path, "w");
+    if (!w->csv) {
+        perror(path);
+        return 0;
+    }
+    fprintf(w->csv, "Iteration");
+    for (int i = 0; i < BENCH_NUM_OPS; i++) {
+        if (w->ops[i])
+            fprintf(w->csv, ",%s_us", bench_op_label(kind, i));
+    }
+    fprintf(w->csv, "\n");
+    return 1;
+}
+
+int bench_warmup_pending(const bench_warmup *w) {
+    if (w->fixed != BENCH_WARMUP_AUTO)
+        return w->iters < w->fixed;
+    return !w->steady && w->iters < w->max_iters;
+}
+
+static int cmp_double(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static double median(double *v, int n) {
+    qsort(v, n, sizeof(*v), cmp_double);
+    return n % 2 ? v[n / 2] : (v[n / 2 - 1] + v[n / 2]) / 2;
+}
+
+// Robust coefficient of variation of a full window: 1.4826 * MAD / median, so a single
+// interrupt or page fault in the window does not keep the warm-up going
+static double window_cv(const double *v, int n, double *scratch) {
+    memcpy(scratch, v, n * sizeof(*v));
+    double med = median(scratch, n);
+    for (int i = 0; i < n; i++)
+        scratch[i] = fabs(v[i] - med);
+    return med > 0 ? 1.4826 * median(scratch, n) / med : 0.0;
+}
+
+void bench_warmup_add(bench_warmup *w, const double us[BENCH_NUM_OPS]) {
+    int steady = 1;
+
+    if (w->csv)
+        fprintf(w->csv, "%d", w->iters);
+    for (int i = 0; i < BENCH_NUM_OPS; i++) {
+        if (!w->ops[i])
+            continue;
+        if (w->iters == 0)
+            w->first_us[i] = us[i];
+        bench_stat_add(&w->stat[i], us[i]);
+        if (w->csv)
+            fprintf(w->csv, ",%.2f", us[i]);
+        if (w->ring[i]) {
+            w->ring[i][w->iters % w->window] = us[i];
+            if (w->iters + 1 >= w->window) {
+                w->last_cv[i] = window_cv(w->ring[i], w->window, w->scratch);
+                steady &= w->last_cv[i] < w->cv;
+            } else {
+                steady = 0;
+            }
+        }
+    }
+    if (w->csv)
+        fprintf(w->csv, "\n");
+    w->iters++;
+    if (w->fixed == BENCH_WARMUP_AUTO && steady)
+        w->steady = 1;
+}
+
+void bench_warmup_free(bench_warmup *w) {
+    for (int i = 0; i < BENCH_NUM_OPS; i++) {
+        free(w->ring[i]);
+        w->ring[i] = NULL;
+    }
+    free(w->scratch);
+    w->scratch = NULL;
+    if (w->csv)
+        fclose(w->csv);
+    w->csv = NULL;
+}
+
+int bench_warmup_write_metadata(const char *dirpath, const bench_warmup *w, bench_kind kind) {
+    char path[512];
+
+    snprintf(path, sizeof(path), "%s/metadata.txt", dirpath);
+    FILE *meta = fopen(path, "a");
+    if (!meta) {
+        perror(path);
+        return 0;
+    }
+    if (w->fixed == BENCH_WARMUP_AUTO) {
+        fprintf(meta, "Warmup: auto (window %d, CV < %.3f, max %d)\n", w->window, w->cv, w->max_iters);
+        fprintf(meta, "SteadyState: %s\n", w->steady ? "reached" : "not reached");
+    } else {
+        fprintf(meta, "Warmup: %d\n", w->fixed);
+    }
+    fprintf(meta, "WarmupIterations: %d\n", w->iters);
+    for (int i = 0; i < BENCH_NUM_OPS && w->iters; i++) {
+        const char *label = bench_op_label(kind, i);
+
+        if (!w->ops[i])
+            continue;
+        fprintf(meta, "ColdStart_%s_us: %.2f\n", label, w->first_us[i]);
+        fprintf(meta, "WarmupAverage_%s_us: %.2f\n", label, w->stat[i].mean);
+        if (w->ring[i] && w->iters >= w->window)
+            fprintf(meta, "WarmupFinalCV_%s: %.4f\n", label, w->last_cv[i]);
+    }
+    fclose(meta);
+    return 1;
+}
@@ -0,0 +1,48 @@
+#ifndef BENCH_WARMUP_H
+#define BENCH_WARMUP_H
+
+#include <stdio.h>
+#include "bench_algs.h"
+#include "bench_stats.h"
+
+// === Warm-up phase with steady-state detection ===
+// The first iterations pay for page faults, lazy library initialisation and cold caches.
+// They are run before the measured iterations and reported separately (warmup.csv and the
+// ColdStart/Warmup lines of metadata.txt) instead of being mixed into summary.csv.
+//   fixed N : exactly N warm-up iterations
+//   auto    : until the robust coefficient of variation (1.4826 * MAD / median) of the
+//             last `window` times of every measured operation is below `cv`, at most
+//             max_iters iterations
+#define BENCH_WARMUP_AUTO -1
+
+typedef struct {
+    int fixed;                      // Iterations, or BENCH_WARMUP_AUTO
+    int window;
+    double cv;
+    int max_iters;
+    int ops[BENCH_NUM_OPS];
+    // State
+    int iters;
+    int steady;                     // Steady state detected (auto mode)
+    double *ring[BENCH_NUM_OPS];    // Last `window` times per operation
+    double *scratch;
+    double first_us[BENCH_NUM_OPS]; // Cold start: time of the very first call
+    double last_cv[BENCH_NUM_OPS];
+    bench_stat stat[BENCH_NUM_OPS];
+    FILE *csv;
+} bench_warmup;
+
+// Parse "auto" or an iteration count
+int bench_warmup_parse(const char *spec, int *fixed);
+int bench_warmup_init(bench_warmup *w, int fixed, int window, double cv, int repeat,
+                      const int ops[BENCH_NUM_OPS]);
+// Open <dirpath>/warmup.csv (one row per warm-up iteration, us per operation)
+int bench_warmup_open(bench_warmup *w, const char *dirpath, bench_kind kind);
+// 1 while more warm-up iterations are needed
+int bench_warmup_pending(const bench_warmup *w);
+// Record the per-call times of one warm-up iteration
+void bench_warmup_add(bench_warmup *w, const double us[BENCH_NUM_OPS]);
+void bench_warmup_free(bench_warmup *w);
+int bench_warmup_write_metadata(const char *dirpath, const bench_warmup *w, bench_kind kind);
+
+#endif
@@ -2,17 +2,23 @@
 #
 # measure‑handshake.sh
 # Run OpenSSL s_client 1000 times and log the handshake RTT (ms).
+# The first WARMUP handshakes (cold caches, lazy provider loading) are logged
+# separately to <OUTFILE without .txt>_warmup.txt and not mixed into OUTFILE.
 
 OUTFILE=
 OPENSSL_BIN=
 SERVER=
 COUNT=
 KEY_EXCHANGE=	# optional
+WARMUP=0	# optional, handshakes before the measured ones
 
-# start with a clean output file
+WARMUP_FILE="${OUTFILE%.txt}_warmup.txt"
+
+# start with clean output files
 : > "$OUTFILE"
+(( WARMUP > 0 )) && : > "$WARMUP_FILE"
 
-for ((i = 1; i <= COUNT; i++)); do
+for ((i = 1 - WARMUP; i <= COUNT; i++)); do
   # Build command in array
   CMD=(
     "$OPENSSL_BIN" s_client
@@ -25,10 +31,16 @@ for ((i = 1; i <= COUNT; i++)); do
   [[ -n "$KEY_EXCHANGE" ]] && CMD+=(-groups "$KEY_EXCHANGE")
 
   # Run command and extract RTT
+  DEST="$OUTFILE"
+  (( i <= 0 )) && DEST="$WARMUP_FILE"
   "${CMD[@]}" 2>&1 1>/dev/null | \
-    awk '/Handshake‑RTT:/ {print $(NF-1)}' >> "$OUTFILE"
+    awk '/Handshake‑RTT:/ {print $(NF-1)}' >> "$DEST"
 
-  printf "run %4d/%d\r" "$i" "$COUNT"
+  if (( i <= 0 )); then
+    printf "warm-up %4d/%d\r" "$((i + WARMUP))" "$WARMUP"
+  else
+    printf "run %4d/%d\r" "$i" "$COUNT"
+  fi
 done
 
 echo -e "\nDone. Results written to $OUTFILE"
@@ -110,6 +110,7 @@ static char *sess_out = NULL;
 static SSL_SESSION *psksess = NULL;
 
 static void print_stuff(BIO *berr, SSL *con, int full);
+static void print_hs_timeline(BIO *bio, SSL *s);
 #ifndef OPENSSL_NO_OCSP
 static int ocsp_resp_cb(SSL *s, void *arg);
 #endif
@@ -612,7 +613,8 @@ const OPTIONS s_client_options[] = {
     OPT_SECTION("Input/Output"),
     {"crlf", OPT_CRLF, '-', "Convert LF from terminal into CRLF"},
     {"quiet", OPT_QUIET, '-', "No s_client output"},
-    {"handshaketime", OPT_HANDSHAKE_TIME, '-', "Print the handshake RTT in milliseconds"},
+    {"handshaketime", OPT_HANDSHAKE_TIME, '-',
+     "Print the handshake RTT and per-phase timeline in milliseconds"},
     {"ign_eof", OPT_IGN_EOF, '-', "Ignore input eof (default when -quiet)"},
     {"no_ign_eof", OPT_NO_IGN_EOF, '-', "Don't ignore input eof"},
     {"starttls", OPT_STARTTLS, 's',
@@ -3299,6 +3301,8 @@ int s_client_main(int argc, char **argv)
  shut:
     if (in_init)
         print_stuff(bio_c_out, con, full_log);
+    else if (print_hs_time)
+        print_hs_timeline(bio_err, con);
     do_ssl_shutdown(con);
 
     /*
@@ -3659,6 +3663,36 @@ static void print_stuff(BIO *bio, SSL *s, int full)
     (void)BIO_flush(bio);
 }
 
+/*
+ * Print the handshake timeline relative to its start. This runs at the end
+ * of the connection because QUIC only confirms the handshake some time after
+ * SSL_do_handshake() has completed.
+ */
+static void print_hs_timeline(BIO *bio, SSL *s)
+{
+    static const char *names[SSL_HANDSHAKE_EVENT_NUM] = {
+        "start", "keyshare_generated", "client_hello", "first_initial_sent",
+        "server_hello", "key_exchange_done", "cert_received",
+        "cert_chain_verified", "cert_verify_received", "cert_verify_done",
+        "finished_received", "finished_sent", "complete", "confirmed"
+    };
+    const SSL_HANDSHAKE_TIMELINE *tl = SSL_get0_handshake_timeline(s);
+    uint64_t start;
+    int i;
+
+    if (tl == NULL || (start = tl->event[SSL_HANDSHAKE_EVENT_START]) == 0)
+        return;
+
+    BIO_printf(bio, "Handshake-Timeline (ms since start):\n");
+    for (i = 1; i < SSL_HANDSHAKE_EVENT_NUM; i++) {
+        if (tl->event[i] == 0 || tl->event[i] < start)
+            BIO_printf(bio, "  %-22s -\n", names[i]);
+        else
+            BIO_printf(bio, "  %-22s %.3f\n", names[i],
+                       (tl->event[i] - start) / 1e6);
+    }
+}
+
 # ifndef OPENSSL_NO_OCSP
 static int ocsp_resp_cb(SSL *s, void *arg)
 {
@@ -7,25 +7,64 @@
  * https://www.openssl.org/source/license.html
  */
 
+#include <openssl/crypto.h>
 #include <openssl/evp.h>
 
+#ifndef FIPS_MODULE
+# include "internal/sha3.h"
+
+/*
+ * Outside the FIPS provider SHAKE is computed by calling the Keccak code
+ * directly, as EVP dispatch costs more than hashing a few dozen bytes.  The
+ * strength of |md| follows from its block size.
+ */
+static ossl_inline ossl_unused int
+shake_direct(const EVP_MD *md, const uint8_t *in1, size_t in1_len,
+             const uint8_t *in2, size_t in2_len,
+             const uint8_t *in3, size_t in3_len, uint8_t *out, size_t out_len)
+{
+    KECCAK1600_CTX kctx;
+    int bsz = EVP_MD_get_block_size(md);
+    int ret;
+
+    if (bsz <= 0 || bsz >= KECCAK1600_WIDTH / 8)
+        return 0;
+    ossl_sha3_direct_init(&kctx, SHAKE_PAD,
+                          (KECCAK1600_WIDTH / 8 - (size_t)bsz) * 4);
+    ret = ossl_sha3_update(&kctx, in1, in1_len)
+        && ossl_sha3_update(&kctx, in2, in2_len)
+        && ossl_sha3_update(&kctx, in3, in3_len)
+        && ossl_sha3_final(&kctx, out, out_len);
+    OPENSSL_cleanse(&kctx, sizeof(kctx));
+    return ret;
+}
+#endif
+
 static ossl_inline ossl_unused int
 shake_xof(EVP_MD_CTX *ctx, const EVP_MD *md, const uint8_t *in, size_t in_len,
           uint8_t *out, size_t out_len)
 {
+#ifndef FIPS_MODULE
+    return shake_direct(md, in, in_len, NULL, 0, NULL, 0, out, out_len);
+#else
     return (EVP_DigestInit_ex2(ctx, md, NULL) == 1
             && EVP_DigestUpdate(ctx, in, in_len) == 1
             && EVP_DigestSqueeze(ctx, out, out_len) == 1);
+#endif
 }
 
 static ossl_inline ossl_unused int
 shake_xof_2(EVP_MD_CTX *ctx, const EVP_MD *md, const uint8_t *in1, size_t in1_len,
             const uint8_t *in2, size_t in2_len, uint8_t *out, size_t out_len)
 {
+#ifndef FIPS_MODULE
+    return shake_direct(md, in1, in1_len, in2, in2_len, NULL, 0, out, out_len);
+#else
     return EVP_DigestInit_ex2(ctx, md, NULL)
         && EVP_DigestUpdate(ctx, in1, in1_len)
         && EVP_DigestUpdate(ctx, in2, in2_len)
         && EVP_DigestSqueeze(ctx, out, out_len);
+#endif
 }
 
 static ossl_inline ossl_unused int
@@ -33,9 +72,14 @@ shake_xof_3(EVP_MD_CTX *ctx, const EVP_MD *md, const uint8_t *in1, size_t in1_le
             const uint8_t *in2, size_t in2_len,
             const uint8_t *in3, size_t in3_len, uint8_t *out, size_t out_len)
 {
+#ifndef FIPS_MODULE
+    return shake_direct(md, in1, in1_len, in2, in2_len, in3, in3_len,
+                        out, out_len);
+#else
     return EVP_DigestInit_ex2(ctx, md, NULL)
         && EVP_DigestUpdate(ctx, in1, in1_len)
         && EVP_DigestUpdate(ctx, in2, in2_len)
         && EVP_DigestUpdate(ctx, in3, in3_len)
         && EVP_DigestSqueeze(ctx, out, out_len);
+#endif
 }
@@ -29,6 +29,14 @@
 # error "rej_ntt_poly() requires SHAKE128_BLOCKSIZE to be a multiple of 3"
 #endif
 
+/*
+ * Outside the FIPS provider the independent SHAKE streams of ExpandA() and
+ * ExpandS() are computed four at a time, see keccak1600x4.c.
+ */
+#ifndef FIPS_MODULE
+# define ML_DSA_KECCAK_X4
+#endif
+
 typedef int (COEFF_FROM_NIBBLE_FUNC)(uint32_t nibble, uint32_t *out);
 
 static COEFF_FROM_NIBBLE_FUNC coeff_from_nibble_4;
@@ -94,6 +102,46 @@ static ossl_inline int coeff_from_nibble_2(uint32_t nibble, uint32_t *out)
     return 0;
 }
 
+/*
+ * The inner loops of rej_ntt_poly() and rej_bounded_poly(): sample from |len|
+ * bytes of the stream into |out|, whose first |*j| coefficients are already
+ * set.  Return 1 once all coefficients are set.
+ */
+static int rej_ntt_poly_block(const uint8_t *b, size_t len, POLY *out, int *j)
+{
+    const uint8_t *end = b + len;
+
+    for (; b < end; b += 3) {
+        if (coeff_from_three_bytes(b, &(out->coeff[*j]))) {
+            if (++*j >= ML_DSA_NUM_POLY_COEFFICIENTS)
+                return 1;   /* finished */
+        }
+    }
+    return 0;
+}
+
+static int rej_bounded_poly_block(COEFF_FROM_NIBBLE_FUNC *coef_from_nibble,
+                                  const uint8_t *b, size_t len, POLY *out,
+                                  int *j)
+{
+    const uint8_t *end = b + len;
+    uint32_t z0, z1;
+
+    for (; b < end; b++) {
+        z0 = *b & 0x0F; /* lower nibble of byte */
+        z1 = *b >> 4;   /* high nibble of byte */
+
+        if (coef_from_nibble(z0, &out->coeff[*j])
+                && ++*j >= ML_DSA_NUM_POLY_COEFFICIENTS)
+            return 1;
+        if (coef_from_nibble(z1, &out->coeff[*j])
+                && ++*j >= ML_DSA_NUM_POLY_COEFFICIENTS)
+            return 1;
+    }
+    return 0;
+}
+
+#ifndef ML_DSA_KECCAK_X4
 /**
  * @brief Use a seed value to generate a polynomial with coefficients in the
  * range of 0..q-1 using rejection sampling.
@@ -117,7 +165,7 @@ static int rej_ntt_poly(EVP_MD_CTX *g_ctx, const EVP_MD *md,
                         const uint8_t *seed, size_t seed_len, POLY *out)
 {
     int j = 0;
-    uint8_t blocks[SHAKE128_BLOCKSIZE], *b, *end = blocks + sizeof(blocks);
+    uint8_t blocks[SHAKE128_BLOCKSIZE];
 
     /*
      * Instead of just squeezing 3 bytes at a time, we grab a whole block
@@ -126,16 +174,11 @@ static int rej_ntt_poly(EVP_MD_CTX *g_ctx, const EVP_MD *md,
     if (!shake_xof(g_ctx, md, seed, seed_len, blocks, sizeof(blocks)))
         return 0;
 
-    while (1) {
-        for (b = blocks; b < end; b += 3) {
-            if (coeff_from_three_bytes(b, &(out->coeff[j]))) {
-                if (++j >= ML_DSA_NUM_POLY_COEFFICIENTS)
-                    return 1;   /* finished */
-            }
-        }
+    while (!rej_ntt_poly_block(blocks, sizeof(blocks), out, &j)) {
         if (!EVP_DigestSqueeze(g_ctx, blocks, sizeof(blocks)))
             return 0;
     }
+    return 1;
 }
 
 /**
@@ -160,29 +203,109 @@ static int rej_bounded_poly(EVP_MD_CTX *h_ctx, const EVP_MD *md,
                             const uint8_t *seed, size_t seed_len, POLY *out)
 {
     int j = 0;
-    uint32_t z0, z1;
-    uint8_t blocks[SHAKE256_BLOCKSIZE], *b, *end = blocks + sizeof(blocks);
+    uint8_t blocks[SHAKE256_BLOCKSIZE];
 
     /* Instead of just squeezing 1 byte at a time, we grab a whole block */
     if (!shake_xof(h_ctx, md, seed, seed_len, blocks, sizeof(blocks)))
         return 0;
 
-    while (1) {
-        for (b = blocks; b < end; b++) {
-            z0 = *b & 0x0F; /* lower nibble of byte */
-            z1 = *b >> 4;   /* high nibble of byte */
-
-            if (coef_from_nibble(z0, &out->coeff[j])
-                    && ++j >= ML_DSA_NUM_POLY_COEFFICIENTS)
-                return 1;
-            if (coef_from_nibble(z1, &out->coeff[j])
-                    && ++j >= ML_DSA_NUM_POLY_COEFFICIENTS)
-                return 1;
-        }
+    while (!rej_bounded_poly_block(coef_from_nibble, blocks, sizeof(blocks),
+                                   out, &j)) {
         if (!EVP_DigestSqueeze(h_ctx, blocks, sizeof(blocks)))
             return 0;
     }
+    return 1;
+}
+
+#else
+/**
+ * @brief Samples up to four polynomials at once from parallel SHAKE streams,
+ * each absorbing one of |seeds|.  A block of every stream is squeezed until
+ * all polynomials are complete.
+ *
+ * @param bitlen 128 for rej_ntt_poly() or 256 for rej_bounded_poly()
+ * @param coef_from_nibble NULL for rej_ntt_poly(), otherwise the nibble
+ *                         function for rej_bounded_poly()
+ * @param seeds The four seeds, all |seed_len| bytes long.
+ * @param out The four returned polynomials.
+ */
+static void rej_poly_x4(size_t bitlen, COEFF_FROM_NIBBLE_FUNC *coef_from_nibble,
+                        const uint8_t *const seeds[4], size_t seed_len,
+                        POLY *const out[4])
+{
+    KECCAK1600_X4_CTX ctx;
+    uint8_t blocks[4][SHAKE128_BLOCKSIZE];
+    uint8_t *const b[4] = { blocks[0], blocks[1], blocks[2], blocks[3] };
+    size_t len = SHA3_BLOCKSIZE(bitlen);
+    int j[4] = { 0, 0, 0, 0 }, done[4] = { 0, 0, 0, 0 };
+    int i, remaining = 4;
+
+    ossl_shake_x4_init(&ctx, bitlen);
+    ossl_shake_x4_absorb(&ctx, seeds, seed_len);
+    do {
+        ossl_shake_x4_squeeze(&ctx, b, len);
+        for (i = 0; i < 4; i++) {
+            if (done[i])
+                continue;
+            done[i] = coef_from_nibble == NULL
+                ? rej_ntt_poly_block(blocks[i], len, out[i], &j[i])
+                : rej_bounded_poly_block(coef_from_nibble, blocks[i], len,
+                                         out[i], &j[i]);
+            remaining -= done[i];
+        }
+    } while (remaining > 0);
+    OPENSSL_cleanse(&ctx, sizeof(ctx));
+    OPENSSL_cleanse(blocks, sizeof(blocks));
+}
+
+/*
+ * ExpandA() with four elements at a time, in the same order as
+ * ossl_ml_dsa_matrix_expand_A().  A last incomplete batch is filled up with a
+ * repeat of its final element, whose result is discarded.
+ */
+static void matrix_expand_A_x4(const uint8_t *rho, MATRIX *out)
+{
+    uint8_t seeds[4][ML_DSA_RHO_BYTES + 2];
+    const uint8_t *const s[4] = { seeds[0], seeds[1], seeds[2], seeds[3] };
+    POLY *p[4], spare;
+    size_t n = out->k * out->l, e, i, j;
+
+    for (i = 0; i < n; i += 4) {
+        for (j = 0; j < 4; j++) {
+            e = i + j < n ? i + j : n - 1;
+            memcpy(seeds[j], rho, ML_DSA_RHO_BYTES);
+            seeds[j][ML_DSA_RHO_BYTES + 1] = (uint8_t)(e / out->l);
+            seeds[j][ML_DSA_RHO_BYTES] = (uint8_t)(e % out->l);
+            p[j] = i + j < n ? &out->m_poly[e] : &spare;
+        }
+        rej_poly_x4(128, NULL, s, sizeof(seeds[0]), p);
+    }
+}
+
+/* ExpandS() with four polynomials of s1 and then s2 at a time, as above */
+static void vector_expand_S_x4(COEFF_FROM_NIBBLE_FUNC *coef_from_nibble,
+                               const uint8_t *seed, VECTOR *s1, VECTOR *s2)
+{
+    uint8_t seeds[4][ML_DSA_PRIV_SEED_BYTES + 2];
+    const uint8_t *const s[4] = { seeds[0], seeds[1], seeds[2], seeds[3] };
+    POLY *p[4], spare;
+    size_t l = s1->num_poly, n = l + s2->num_poly, e, i, j;
+
+    for (i = 0; i < n; i += 4) {
+        for (j = 0; j < 4; j++) {
+            e = i + j < n ? i + j : n - 1;
+            memcpy(seeds[j], seed, ML_DSA_PRIV_SEED_BYTES);
+            seeds[j][ML_DSA_PRIV_SEED_BYTES] = (uint8_t)e;
+            seeds[j][ML_DSA_PRIV_SEED_BYTES + 1] = 0;
+            p[j] = i + j >= n ? &spare
+                : e < l ? &s1->poly[e] : &s2->poly[e - l];
+        }
+        rej_poly_x4(256, coef_from_nibble, s, sizeof(seeds[0]), p);
+    }
+    OPENSSL_cleanse(seeds, sizeof(seeds));
+    OPENSSL_cleanse(&spare, sizeof(spare));
 }
+#endif
 
 /**
  * @brief Generate a k * l matrix that has uniformly distributed polynomial
@@ -200,6 +323,10 @@ static int rej_bounded_poly(EVP_MD_CTX *h_ctx, const EVP_MD *md,
 int ossl_ml_dsa_matrix_expand_A(EVP_MD_CTX *g_ctx, const EVP_MD *md,
                                 const uint8_t *rho, MATRIX *out)
 {
+#ifdef ML_DSA_KECCAK_X4
+    matrix_expand_A_x4(rho, out);
+    return 1;
+#else
     int ret = 0;
     size_t i, j;
     uint8_t derived_seed[ML_DSA_RHO_BYTES + 2];
@@ -220,6 +347,7 @@ int ossl_ml_dsa_matrix_expand_A(EVP_MD_CTX *g_ctx, const EVP_MD *md,
     ret = 1;
 err:
     return ret;
+#endif
 }
 
 /**
@@ -243,6 +371,11 @@ err:
 int ossl_ml_dsa_vector_expand_S(EVP_MD_CTX *h_ctx, const EVP_MD *md, int eta,
                                 const uint8_t *seed, VECTOR *s1, VECTOR *s2)
 {
+#ifdef ML_DSA_KECCAK_X4
+    vector_expand_S_x4((eta == ML_DSA_ETA_4) ? coeff_from_nibble_4 : coeff_from_nibble_2,
+                       seed, s1, s2);
+    return 1;
+#else
     int ret = 0;
     size_t i;
     size_t l = s1->num_poly;
@@ -275,6 +408,7 @@ int ossl_ml_dsa_vector_expand_S(EVP_MD_CTX *h_ctx, const EVP_MD *md, int eta,
     ret = 1;
 err:
     return ret;
+#endif
 }
 
 /* See FIPS 204, Algorithm 34, ExpandMask(), Step 4 & 5 */
@@ -311,13 +445,24 @@ int ossl_ml_dsa_poly_sample_in_ball(POLY *out_c, const uint8_t *seed, int seed_l
     uint64_t signs;
     int offset = 8;
     size_t end;
+#ifndef FIPS_MODULE
+    KECCAK1600_CTX kctx;
+#endif
 
     /*
      * Rather than squeeze 8 bytes followed by lots of 1 byte squeezes
      * the SHAKE blocksize is squeezed each time and buffered into 'block'.
+     * Outside the FIPS provider the stream is read directly, see ml_dsa_hash.h.
      */
+#ifndef FIPS_MODULE
+    ossl_sha3_direct_init(&kctx, SHAKE_PAD, 256);
+    if (!ossl_sha3_update(&kctx, seed, seed_len)
+            || !ossl_sha3_squeeze(&kctx, block, sizeof(block)))
+        return 0;
+#else
     if (!shake_xof(h_ctx, md, seed, seed_len, block, sizeof(block)))
         return 0;
+#endif
 
     /*
      * grab the first 64 bits - since tau < 64
@@ -335,8 +480,13 @@ int ossl_ml_dsa_poly_sample_in_ball(POLY *out_c, const uint8_t *seed, int seed_l
         for (;;) {
             if (offset == sizeof(block)) {
                 /* squeeze another block if the bytes from block have been used */
+#ifndef FIPS_MODULE
+                if (!ossl_sha3_squeeze(&kctx, block, sizeof(block)))
+                    return 0;
+#else
                 if (!EVP_DigestSqueeze(h_ctx, block, sizeof(block)))
                     return 0;
+#endif
                 offset = 0;
             }
 
@@ -13,6 +13,7 @@
 #include "internal/common.h"
 #include "internal/constant_time.h"
 #include "internal/sha3.h"
+#include "ml_kem_local.h"
 
 #if defined(OPENSSL_CONSTANT_TIME_VALIDATION)
 #include <valgrind/memcheck.h>
@@ -84,13 +85,27 @@
 # define SCALAR_SAMPLING_BUFSIZE 168
 #endif
 
+/*
+ * Outside the FIPS provider the independent SHAKE streams of matrix expansion
+ * and CBD sampling are computed four at a time, see keccak1600x4.c.  The FIPS
+ * provider keeps using its own SHAKE implementation through EVP.
+ */
+#if !defined(FIPS_MODULE) && defined(SHAKE128_BLOCKSIZE)
+# define ML_KEM_KECCAK_X4
+#endif
+
+/*
+ * Likewise, the single-stream hashes outside the FIPS provider call the Keccak
+ * code directly, as EVP dispatch costs more than hashing a few dozen bytes.
+ */
+#ifndef FIPS_MODULE
+# define ML_KEM_KECCAK_DIRECT
+#endif
+
 /*
  * Structure of keys
  */
-typedef struct ossl_ml_kem_scalar_st {
-    /* On every function entry and exit, 0 <= c[i] < ML_KEM_PRIME. */
-    uint16_t c[ML_KEM_DEGREE];
-} scalar;
+typedef ML_KEM_SCALAR scalar;
 
 /* Key material allocation layout */
 #define DECLARE_ML_KEM_KEYDATA(name, rank, private_sz) \
@@ -239,87 +254,27 @@ static const size_t   kBarrettMultiplier = (1 << BARRETT_SHIFT) / ML_KEM_PRIME;
 static const uint16_t kHalfPrime = (ML_KEM_PRIME - 1) / 2;
 static const uint16_t kInverseDegree = INVERSE_DEGREE;
 
-/*
- * Python helper:
- *
- * p = 3329
- * def bitreverse(i):
- *     ret = 0
- *     for n in range(7):
- *         bit = i & 1
- *         ret <<= 1
- *         ret |= bit
- *         i >>= 1
- *     return ret
- */
-
-/*-
- * First precomputed array from Appendix A of FIPS 203, or else Python:
- * kNTTRoots = [pow(17, bitreverse(i), p) for i in range(128)]
- */
-static const uint16_t kNTTRoots[128] = {
-    1,    1729, 2580, 3289, 2642, 630,  1897, 848,
-    1062, 1919, 193,  797,  2786, 3260, 569,  1746,
-    296,  2447, 1339, 1476, 3046, 56,   2240, 1333,
-    1426, 2094, 535,  2882, 2393, 2879, 1974, 821,
-    289,  331,  3253, 1756, 1197, 2304, 2277, 2055,
-    650,  1977, 2513, 632,  2865, 33,   1320, 1915,
-    2319, 1435, 807,  452,  1438, 2868, 1534, 2402,
-    2647, 2617, 1481, 648,  2474, 3110, 1227, 910,
-    17,   2761, 583,  2649, 1637, 723,  2288, 1100,
-    1409, 2662, 3281, 233,  756,  2156, 3015, 3050,
-    1703, 1651, 2789, 1789, 1847, 952,  1461, 2687,
-    939,  2308, 2437, 2388, 733,  2337, 268,  641,
-    1584, 2298, 2037, 3220, 375,  2549, 2090, 1645,
-    1063, 319,  2773, 757,  2099, 561,  2466, 2594,
-    2804, 1092, 403,  1026, 1143, 2150, 2775, 886,
-    1722, 1212, 1874, 1029, 2110, 2935, 885,  2154,
-};
-
-/*
- * InverseNTTRoots = [pow(17, -bitreverse(i), p) for i in range(128)]
- * Listed in order of use in the inverse NTT loop (index 0 is skipped):
- *
- *  0, 64, 65, ..., 127, 32, 33, ..., 63, 16, 17, ..., 31, 8, 9, ...
- */
-static const uint16_t kInverseNTTRoots[128] = {
-    1,    1175, 2444, 394,  1219, 2300, 1455, 2117,
-    1607, 2443, 554,  1179, 2186, 2303, 2926, 2237,
-    525,  735,  863,  2768, 1230, 2572, 556,  3010,
-    2266, 1684, 1239, 780,  2954, 109,  1292, 1031,
-    1745, 2688, 3061, 992,  2596, 941,  892,  1021,
-    2390, 642,  1868, 2377, 1482, 1540, 540,  1678,
-    1626, 279,  314,  1173, 2573, 3096, 48,   667,
-    1920, 2229, 1041, 2606, 1692, 680,  2746, 568,
-    3312, 2419, 2102, 219,  855,  2681, 1848, 712,
-    682,  927,  1795, 461,  1891, 2877, 2522, 1894,
-    1010, 1414, 2009, 3296, 464,  2697, 816,  1352,
-    2679, 1274, 1052, 1025, 2132, 1573, 76,   2998,
-    3040, 2508, 1355, 450,  936,  447,  2794, 1235,
-    1903, 1996, 1089, 3273, 283,  1853, 1990, 882,
-    3033, 1583, 2760, 69,   543,  2532, 3136, 1410,
-    2267, 2481, 1432, 2699, 687,  40,   749,  1600,
-};
+/* The precomputed roots of unity are in ml_kem_local.h */
 
+#ifdef ML_KEM_KECCAK_DIRECT
 /*
- * Second precomputed array from Appendix A of FIPS 203 (normalised positive),
- * or else Python:
- * ModRoots = [pow(17, 2*bitreverse(i) + 1, p) for i in range(128)]
+ * direct_keccak hashes |len1| bytes from |in1| followed by |len2| bytes from
+ * |in2|, with the given |pad| and strength |bitlen|, and writes |outlen| bytes
+ * of output to |out|.  The state is cleansed, as the inputs are mostly secret.
  */
-static const uint16_t kModRoots[128] = {
-    17,   3312, 2761, 568,  583,  2746, 2649, 680,  1637, 1692, 723,  2606,
-    2288, 1041, 1100, 2229, 1409, 1920, 2662, 667,  3281, 48,   233,  3096,
-    756,  2573, 2156, 1173, 3015, 314,  3050, 279,  1703, 1626, 1651, 1678,
-    2789, 540,  1789, 1540, 1847, 1482, 952,  2377, 1461, 1868, 2687, 642,
-    939,  2390, 2308, 1021, 2437, 892,  2388, 941,  733,  2596, 2337, 992,
-    268,  3061, 641,  2688, 1584, 1745, 2298, 1031, 2037, 1292, 3220, 109,
-    375,  2954, 2549, 780,  2090, 1239, 1645, 1684, 1063, 2266, 319,  3010,
-    2773, 556,  757,  2572, 2099, 1230, 561,  2768, 2466, 863,  2594, 735,
-    2804, 525,  1092, 2237, 403,  2926, 1026, 2303, 1143, 2186, 2150, 1179,
-    2775, 554,  886,  2443, 1722, 1607, 1212, 2117, 1874, 1455, 1029, 2300,
-    2110, 1219, 2935, 394,  885,  2444, 2154, 1175,
-};
+static void direct_keccak(uint8_t *out, size_t outlen, unsigned char pad,
+                          size_t bitlen, const uint8_t *in1, size_t len1,
+                          const uint8_t *in2, size_t len2)
+{
+    KECCAK1600_CTX ctx;
 
+    ossl_sha3_direct_init(&ctx, pad, bitlen);
+    (void)ossl_sha3_update(&ctx, in1, len1);
+    (void)ossl_sha3_update(&ctx, in2, len2);
+    (void)ossl_sha3_final(&ctx, out, outlen);
+    OPENSSL_cleanse(&ctx, sizeof(ctx));
+}
+#else
 /*
  * single_keccak hashes |inlen| bytes from |in| and writes |outlen| bytes of
  * output to |out|. If the |md| specifies a fixed-output function, like
@@ -338,6 +293,7 @@ int single_keccak(uint8_t *out, size_t outlen, const uint8_t *in, size_t inlen,
     return EVP_DigestFinal_ex(mdctx, out, &sz)
         && ossl_assert((size_t) sz == outlen);
 }
+#endif
 
 /*
  * FIPS 203, Section 4.1, equation (4.3): PRF. Takes 32+1 input bytes, and uses
@@ -347,8 +303,14 @@ static __owur
 int prf(uint8_t *out, size_t len, const uint8_t in[ML_KEM_RANDOM_BYTES + 1],
         EVP_MD_CTX *mdctx, const ML_KEM_KEY *key)
 {
+#ifdef ML_KEM_KECCAK_DIRECT
+    direct_keccak(out, len, SHAKE_PAD, 256, in, ML_KEM_RANDOM_BYTES + 1,
+                  NULL, 0);
+    return 1;
+#else
     return EVP_DigestInit_ex(mdctx, key->shake256_md, NULL)
         && single_keccak(out, len, in, ML_KEM_RANDOM_BYTES + 1, mdctx);
+#endif
 }
 
 /*
@@ -359,8 +321,13 @@ static __owur
 int hash_h(uint8_t out[ML_KEM_PKHASH_BYTES], const uint8_t *in, size_t len,
            EVP_MD_CTX *mdctx, const ML_KEM_KEY *key)
 {
+#ifdef ML_KEM_KECCAK_DIRECT
+    direct_keccak(out, ML_KEM_PKHASH_BYTES, SHA3_PAD, 256, in, len, NULL, 0);
+    return 1;
+#else
     return EVP_DigestInit_ex(mdctx, key->sha3_256_md, NULL)
         && single_keccak(out, ML_KEM_PKHASH_BYTES, in, len, mdctx);
+#endif
 }
 
 /* Incremental hash_h of expanded public key */
@@ -370,6 +337,20 @@ hash_h_pubkey(uint8_t pkhash[ML_KEM_PKHASH_BYTES],
 {
     const ML_KEM_VINFO *vinfo = key->vinfo;
     const scalar *t = key->t, *end = t + vinfo->rank;
+#ifdef ML_KEM_KECCAK_DIRECT
+    KECCAK1600_CTX ctx;
+
+    ossl_sha3_direct_init(&ctx, SHA3_PAD, 256);
+    do {
+        uint8_t buf[3 * DEGREE / 2];
+
+        scalar_encode(buf, t++, 12);
+        (void)ossl_sha3_update(&ctx, buf, sizeof(buf));
+    } while (t < end);
+
+    (void)ossl_sha3_update(&ctx, key->rho, ML_KEM_RANDOM_BYTES);
+    return ossl_sha3_final(&ctx, pkhash, ML_KEM_PKHASH_BYTES);
+#else
     unsigned int sz;
 
     if (!EVP_DigestInit_ex(mdctx, key->sha3_256_md, NULL))
@@ -387,6 +368,7 @@ hash_h_pubkey(uint8_t pkhash[ML_KEM_PKHASH_BYTES],
         return 0;
     return EVP_DigestFinal_ex(mdctx, pkhash, &sz)
         && ossl_assert(sz == ML_KEM_PKHASH_BYTES);
+#endif
 }
 
 /*
@@ -398,8 +380,13 @@ static __owur
 int hash_g(uint8_t out[ML_KEM_SEED_BYTES], const uint8_t *in, size_t len,
            EVP_MD_CTX *mdctx, const ML_KEM_KEY *key)
 {
+#ifdef ML_KEM_KECCAK_DIRECT
+    direct_keccak(out, ML_KEM_SEED_BYTES, SHA3_PAD, 512, in, len, NULL, 0);
+    return 1;
+#else
     return EVP_DigestInit_ex(mdctx, key->sha3_512_md, NULL)
         && single_keccak(out, ML_KEM_SEED_BYTES, in, len, mdctx);
+#endif
 }
 
 /*
@@ -414,10 +401,16 @@ int kdf(uint8_t out[ML_KEM_SHARED_SECRET_BYTES],
         const uint8_t *ctext, size_t len,
         EVP_MD_CTX *mdctx, const ML_KEM_KEY *key)
 {
+#ifdef ML_KEM_KECCAK_DIRECT
+    direct_keccak(out, ML_KEM_SHARED_SECRET_BYTES, SHAKE_PAD, 256,
+                  z, ML_KEM_RANDOM_BYTES, ctext, len);
+    return 1;
+#else
     return EVP_DigestInit_ex(mdctx, key->shake256_md, NULL)
         && EVP_DigestUpdate(mdctx, z, ML_KEM_RANDOM_BYTES)
         && EVP_DigestUpdate(mdctx, ctext, len)
         && EVP_DigestFinalXOF(mdctx, out, ML_KEM_SHARED_SECRET_BYTES);
+#endif
 }
 
 /*
@@ -425,36 +418,49 @@ int kdf(uint8_t out[ML_KEM_SHARED_SECRET_BYTES],
  * are performed by the caller). Rejection-samples a Keccak stream to get
  * uniformly distributed elements in the range [0,q). This is used for matrix
  * expansion and only operates on public inputs.
+ *
+ * Fills |curr| up to |endout| from the stream bytes at |in| up to |endin|, a
+ * multiple of 3 bytes, and returns the new value of |curr|.
  */
+static uint16_t *rej_sample(uint16_t *curr, const uint16_t *endout,
+                            const uint8_t *in, const uint8_t *endin)
+{
+    uint16_t d;
+    uint8_t b1, b2, b3;
+
+    do {
+        b1 = *in++;
+        b2 = *in++;
+        b3 = *in++;
+
+        if (curr >= endout)
+            break;
+        if ((d = ((b2 & 0x0f) << 8) + b1) < kPrime)
+            *curr++ = d;
+        if (curr >= endout)
+            break;
+        if ((d = (b3 << 4) + (b2 >> 4)) < kPrime)
+            *curr++ = d;
+    } while (in < endin);
+    return curr;
+}
+
+#ifndef ML_KEM_KECCAK_X4
+/* Draws on the stream in |mdctx| until all of |out| is sampled. */
 static __owur
 int sample_scalar(scalar *out, EVP_MD_CTX *mdctx)
 {
     uint16_t *curr = out->c, *endout = curr + DEGREE;
-    uint8_t buf[SCALAR_SAMPLING_BUFSIZE], *in;
-    uint8_t *endin = buf + sizeof(buf);
-    uint16_t d;
-    uint8_t b1, b2, b3;
+    uint8_t buf[SCALAR_SAMPLING_BUFSIZE];
 
     do {
-        if (!EVP_DigestSqueeze(mdctx, in = buf, sizeof(buf)))
+        if (!EVP_DigestSqueeze(mdctx, buf, sizeof(buf)))
             return 0;
-        do {
-            b1 = *in++;
-            b2 = *in++;
-            b3 = *in++;
-
-            if (curr >= endout)
-                break;
-            if ((d = ((b2 & 0x0f) << 8) + b1) < kPrime)
-                *curr++ = d;
-            if (curr >= endout)
-                break;
-            if ((d = (b3 << 4) + (b2 >> 4)) < kPrime)
-                *curr++ = d;
-        } while (in < endin);
+        curr = rej_sample(curr, endout, buf, buf + sizeof(buf));
     } while (curr < endout);
     return 1;
 }
+#endif
 
 /*-
  * reduce_once reduces 0 <= x < 2*kPrime, mod kPrime.
@@ -506,7 +512,7 @@ static void scalar_mult_const(scalar *s, uint16_t a)
  * elements in GF(3329^2), with the coefficients of the elements being
  * consecutive entries in |s->c|.
  */
-static void scalar_ntt(scalar *s)
+static void scalar_ntt_c(scalar *s)
 {
     const uint16_t *roots = kNTTRoots;
     uint16_t *end = s->c + DEGREE;
@@ -538,7 +544,7 @@ static void scalar_ntt(scalar *s)
  * iFFT to account for the fact that 3329 does not have a 512th root of unity,
  * using the precomputed 128 roots of unity stored in InverseNTTRoots.
  */
-static void scalar_inverse_ntt(scalar *s)
+static void scalar_inverse_ntt_c(scalar *s)
 {
     const uint16_t *roots = kInverseNTTRoots;
     uint16_t *end = s->c + DEGREE;
@@ -592,8 +598,8 @@ static void scalar_sub(scalar *lhs, const scalar *rhs)
  * two reduced numbers together, so we need some intermediate reduction steps,
  * even if an uint64_t could hold 3 multiplied numbers.
  */
-static void scalar_mult(scalar *out, const scalar *lhs,
-                        const scalar *rhs)
+static void scalar_mult_c(scalar *out, const scalar *lhs,
+                          const scalar *rhs)
 {
     uint16_t *curr = out->c, *end = curr + DEGREE;
     const uint16_t *lc = lhs->c, *rc = rhs->c;
@@ -610,9 +616,8 @@ static void scalar_mult(scalar *out, const scalar *lhs,
 }
 
 /* Above, but add the result to an existing scalar */
-static ossl_inline
-void scalar_mult_add(scalar *out, const scalar *lhs,
-                     const scalar *rhs)
+static void scalar_mult_add_c(scalar *out, const scalar *lhs,
+                              const scalar *rhs)
 {
     uint16_t *curr = out->c, *end = curr + DEGREE;
     const uint16_t *lc = lhs->c, *rc = rhs->c;
@@ -850,7 +855,7 @@ static __owur uint16_t decompress(uint16_t x, int bits)
  * FIPS 203, Section 4.2.1, Equation (4.7): "Compress_d".
  * In-place lossy rounding of scalars to 2^d bits.
  */
-static void scalar_compress(scalar *s, int bits)
+static void scalar_compress_c(scalar *s, int bits)
 {
     int i;
 
@@ -862,7 +867,7 @@ static void scalar_compress(scalar *s, int bits)
  * FIPS 203, Section 4.2.1, Equation (4.8): "Decompress_d".
  * In-place approximate recovery of scalars from 2^d bit compression.
  */
-static void scalar_decompress(scalar *s, int bits)
+static void scalar_decompress_c(scalar *s, int bits)
 {
     int i;
 
@@ -870,6 +875,82 @@ static void scalar_decompress(scalar *s, int bits)
         s->c[i] = decompress(s->c[i], bits);
 }
 
+/*
+ * The vectorised implementation of the above, where the CPU supports it,
+ * otherwise the portable one.  Both give the same results.
+ */
+#if defined(ML_KEM_SIMD)
+# define simd_ops() ossl_ml_kem_scalar_ops_simd()
+#else
+# define simd_ops() NULL
+
+const ML_KEM_SCALAR_OPS *ossl_ml_kem_scalar_ops_simd(void)
+{
+    return NULL;
+}
+#endif
+
+static void scalar_ntt(scalar *s)
+{
+    const ML_KEM_SCALAR_OPS *ops = simd_ops();
+
+    if (ops != NULL)
+        ops->ntt(s);
+    else
+        scalar_ntt_c(s);
+}
+
+static void scalar_inverse_ntt(scalar *s)
+{
+    const ML_KEM_SCALAR_OPS *ops = simd_ops();
+
+    if (ops != NULL)
+        ops->inverse_ntt(s);
+    else
+        scalar_inverse_ntt_c(s);
+}
+
+static void scalar_mult(scalar *out, const scalar *lhs, const scalar *rhs)
+{
+    const ML_KEM_SCALAR_OPS *ops = simd_ops();
+
+    if (ops != NULL)
+        ops->mult(out, lhs, rhs);
+    else
+        scalar_mult_c(out, lhs, rhs);
+}
+
+static ossl_inline
+void scalar_mult_add(scalar *out, const scalar *lhs, const scalar *rhs)
+{
+    const ML_KEM_SCALAR_OPS *ops = simd_ops();
+
+    if (ops != NULL)
+        ops->mult_add(out, lhs, rhs);
+    else
+        scalar_mult_add_c(out, lhs, rhs);
+}
+
+static void scalar_compress(scalar *s, int bits)
+{
+    const ML_KEM_SCALAR_OPS *ops = simd_ops();
+
+    if (ops != NULL)
+        ops->compress(s, bits);
+    else
+        scalar_compress_c(s, bits);
+}
+
+static void scalar_decompress(scalar *s, int bits)
+{
+    const ML_KEM_SCALAR_OPS *ops = simd_ops();
+
+    if (ops != NULL)
+        ops->decompress(s, bits);
+    else
+        scalar_decompress_c(s, bits);
+}
+
 /* Addition updating the LHS vector in-place. */
 static void vector_add(scalar *lhs, const scalar *rhs, int rank)
 {
@@ -973,6 +1054,50 @@ matrix_mult_transpose_add(scalar *out, const scalar *m, const scalar *a, int ran
     }
 }
 
+#ifdef ML_KEM_KECCAK_X4
+/*
+ * matrix_expand() with four matrix entries sampled at a time from parallel
+ * SHAKE128 streams.  A last incomplete batch is filled up with a repeat of
+ * its final entry, whose result is discarded.
+ */
+static void matrix_expand_x4(ML_KEM_KEY *key)
+{
+    KECCAK1600_X4_CTX ctx;
+    uint8_t input[4][ML_KEM_RANDOM_BYTES + 2];
+    uint8_t buf[4][SHAKE128_BLOCKSIZE];
+    const uint8_t *const in[4] = { input[0], input[1], input[2], input[3] };
+    uint8_t *const out[4] = { buf[0], buf[1], buf[2], buf[3] };
+    uint16_t *curr[4], *endout[4];
+    scalar spare;
+    int rank = key->vinfo->rank, n = rank * rank;
+    int i, k, done;
+
+    for (i = 0; i < n; i += 4) {
+        for (k = 0; k < 4; k++) {
+            int e = i + k < n ? i + k : n - 1;
+            scalar *s = i + k < n ? &key->m[e] : &spare;
+
+            memcpy(input[k], key->rho, ML_KEM_RANDOM_BYTES);
+            input[k][ML_KEM_RANDOM_BYTES] = (uint8_t)(e / rank);
+            input[k][ML_KEM_RANDOM_BYTES + 1] = (uint8_t)(e % rank);
+            curr[k] = s->c;
+            endout[k] = curr[k] + DEGREE;
+        }
+        ossl_shake_x4_init(&ctx, 128);
+        ossl_shake_x4_absorb(&ctx, in, sizeof(input[0]));
+        do {
+            ossl_shake_x4_squeeze(&ctx, out, sizeof(buf[0]));
+            done = 1;
+            for (k = 0; k < 4; k++) {
+                curr[k] = rej_sample(curr[k], endout[k], buf[k],
+                                     buf[k] + sizeof(buf[k]));
+                done &= curr[k] >= endout[k];
+            }
+        } while (!done);
+    }
+}
+#endif
+
 /*-
  * Expands the matrix from a seed for key generation and for encaps-CPA.
  * NOTE: FIPS 203 matrix "A" is the transpose of this matrix, computed
@@ -983,6 +1108,10 @@ matrix_mult_transpose_add(scalar *out, const scalar *m, const scalar *a, int ran
 static __owur
 int matrix_expand(EVP_MD_CTX *mdctx, ML_KEM_KEY *key)
 {
+#ifdef ML_KEM_KECCAK_X4
+    matrix_expand_x4(key);
+    return 1;
+#else
     scalar *out = key->m;
     uint8_t input[ML_KEM_RANDOM_BYTES + 2];
     int rank = key->vinfo->rank;
@@ -1000,28 +1129,23 @@ int matrix_expand(EVP_MD_CTX *mdctx, ML_KEM_KEY *key)
         }
     }
     return 1;
+#endif
 }
 
 /*
- * Algorithm 7 from the spec, with eta fixed to two and the PRF call
- * included. Creates binominally distributed elements by sampling 2*|eta| bits,
+ * Algorithm 7 from the spec, with eta fixed to two. Creates binominally
+ * distributed elements by sampling 2*|eta| bits of the PRF output |r|,
  * and setting the coefficient to the count of the first bits minus the count of
  * the second bits, resulting in a centered binomial distribution. Since eta is
  * two this gives -2/2 with a probability of 1/16, -1/1 with probability 1/4,
  * and 0 with probability 3/8.
  */
-static __owur
-int cbd_2(scalar *out, uint8_t in[ML_KEM_RANDOM_BYTES + 1],
-          EVP_MD_CTX *mdctx, const ML_KEM_KEY *key)
+static void cbd_2_c(scalar *out, const uint8_t r[4 * DEGREE / 8])
 {
     uint16_t *curr = out->c, *end = curr + DEGREE;
-    uint8_t randbuf[4 * DEGREE / 8], *r = randbuf;  /* 64 * eta slots */
     uint16_t value, mask;
     uint8_t b;
 
-    if (!prf(randbuf, sizeof(randbuf), in, mdctx, key))
-        return 0;
-
     do {
         b = *r++;
 
@@ -1042,27 +1166,20 @@ int cbd_2(scalar *out, uint8_t in[ML_KEM_RANDOM_BYTES + 1],
         mask = constish_time_non_zero(value >> 15);
         *curr++ = value + (kPrime & mask);
     } while (curr < end);
-    return 1;
 }
 
 /*
- * Algorithm 7 from the spec, with eta fixed to three and the PRF call
- * included. Creates binominally distributed elements by sampling 3*|eta| bits,
+ * Algorithm 7 from the spec, with eta fixed to three. Creates binominally
+ * distributed elements by sampling 3*|eta| bits of the PRF output |r|,
  * and setting the coefficient to the count of the first bits minus the count of
  * the second bits, resulting in a centered binomial distribution.
  */
-static __owur
-int cbd_3(scalar *out, uint8_t in[ML_KEM_RANDOM_BYTES + 1],
-          EVP_MD_CTX *mdctx, const ML_KEM_KEY *key)
+static void cbd_3_c(scalar *out, const uint8_t r[6 * DEGREE / 8])
 {
     uint16_t *curr = out->c, *end = curr + DEGREE;
-    uint8_t randbuf[6 * DEGREE / 8], *r = randbuf;  /* 64 * eta slots */
     uint8_t b1, b2, b3;
     uint16_t value, mask;
 
-    if (!prf(randbuf, sizeof(randbuf), in, mdctx, key))
-        return 0;
-
     do {
         b1 = *r++;
         b2 = *r++;
@@ -1095,18 +1212,106 @@ int cbd_3(scalar *out, uint8_t in[ML_KEM_RANDOM_BYTES + 1],
         mask = constish_time_non_zero(value >> 15);
         *curr++ = value + (kPrime & mask);
     } while (curr < end);
+}
+
+static const ML_KEM_SCALAR_OPS generic_ops = {
+    scalar_ntt_c,
+    scalar_inverse_ntt_c,
+    scalar_mult_c,
+    scalar_mult_add_c,
+    scalar_compress_c,
+    scalar_decompress_c,
+    cbd_2_c,
+    cbd_3_c
+};
+
+const ML_KEM_SCALAR_OPS *ossl_ml_kem_scalar_ops_generic(void)
+{
+    return &generic_ops;
+}
+
+/* SamplePolyCBD_eta of the PRF output |randbuf|, with |eta| 2 or 3. */
+static void cbd_sample(scalar *out, int eta, const uint8_t *randbuf)
+{
+    const ML_KEM_SCALAR_OPS *ops = simd_ops();
+
+    if (eta == 3) {
+        if (ops != NULL)
+            ops->cbd_3(out, randbuf);
+        else
+            cbd_3_c(out, randbuf);
+    } else {
+        if (ops != NULL)
+            ops->cbd_2(out, randbuf);
+        else
+            cbd_2_c(out, randbuf);
+    }
+}
+
+/* cbd_2_c() with the PRF call included. */
+static __owur
+int cbd_2(scalar *out, uint8_t in[ML_KEM_RANDOM_BYTES + 1],
+          EVP_MD_CTX *mdctx, const ML_KEM_KEY *key)
+{
+    uint8_t randbuf[4 * DEGREE / 8];    /* 64 * eta slots */
+
+    if (!prf(randbuf, sizeof(randbuf), in, mdctx, key))
+        return 0;
+    cbd_sample(out, 2, randbuf);
     return 1;
 }
 
+#ifndef ML_KEM_KECCAK_X4
+/* cbd_3_c() with the PRF call included. */
+static __owur
+int cbd_3(scalar *out, uint8_t in[ML_KEM_RANDOM_BYTES + 1],
+          EVP_MD_CTX *mdctx, const ML_KEM_KEY *key)
+{
+    uint8_t randbuf[6 * DEGREE / 8];    /* 64 * eta slots */
+
+    if (!prf(randbuf, sizeof(randbuf), in, mdctx, key))
+        return 0;
+    cbd_sample(out, 3, randbuf);
+    return 1;
+}
+#endif
+
 /*
- * Generates a secret vector by using |cbd| with the given seed to generate
- * scalar elements and incrementing |counter| for each slot of the vector.
+ * Generates a secret vector by sampling with the given |eta| from the PRF of
+ * the given seed, incrementing |counter| for each slot of the vector.  The PRF
+ * instances are independent, so outside the FIPS provider they are computed
+ * four at a time.
  */
 static __owur
-int gencbd_vector(scalar *out, CBD_FUNC cbd, uint8_t *counter,
+int gencbd_vector(scalar *out, int eta, uint8_t *counter,
                   const uint8_t seed[ML_KEM_RANDOM_BYTES], int rank,
                   EVP_MD_CTX *mdctx, const ML_KEM_KEY *key)
 {
+#ifdef ML_KEM_KECCAK_X4
+    KECCAK1600_X4_CTX ctx;
+    uint8_t input[4][ML_KEM_RANDOM_BYTES + 1];
+    uint8_t randbuf[4][6 * DEGREE / 8];
+    const uint8_t *const in[4] = { input[0], input[1], input[2], input[3] };
+    uint8_t *const rand[4] = { randbuf[0], randbuf[1], randbuf[2], randbuf[3] };
+    int i, k;
+
+    for (i = 0; i < rank; i += 4) {
+        for (k = 0; k < 4; k++) {
+            memcpy(input[k], seed, ML_KEM_RANDOM_BYTES);
+            input[k][ML_KEM_RANDOM_BYTES] = (uint8_t)(*counter + k);
+        }
+        ossl_shake_x4_init(&ctx, 256);
+        ossl_shake_x4_absorb(&ctx, in, sizeof(input[0]));
+        ossl_shake_x4_squeeze(&ctx, rand, 64 * eta);
+        for (k = 0; k < 4 && i + k < rank; k++)
+            cbd_sample(out++, eta, randbuf[k]);
+        *counter += (uint8_t)k;
+    }
+    OPENSSL_cleanse(&ctx, sizeof(ctx));
+    OPENSSL_cleanse(randbuf, sizeof(randbuf));
+    return 1;
+#else
+    CBD_FUNC cbd = eta == 3 ? cbd_3 : cbd_2;
     uint8_t input[ML_KEM_RANDOM_BYTES + 1];
 
     memcpy(input, seed, ML_KEM_RANDOM_BYTES);
@@ -1116,30 +1321,28 @@ int gencbd_vector(scalar *out, CBD_FUNC cbd, uint8_t *counter,
             return 0;
     } while (--rank > 0);
     return 1;
+#endif
 }
 
 /*
  * As above plus NTT transform.
  */
 static __owur
-int gencbd_vector_ntt(scalar *out, CBD_FUNC cbd, uint8_t *counter,
+int gencbd_vector_ntt(scalar *out, int eta, uint8_t *counter,
                       const uint8_t seed[ML_KEM_RANDOM_BYTES], int rank,
                       EVP_MD_CTX *mdctx, const ML_KEM_KEY *key)
 {
-    uint8_t input[ML_KEM_RANDOM_BYTES + 1];
-
-    memcpy(input, seed, ML_KEM_RANDOM_BYTES);
+    if (!gencbd_vector(out, eta, counter, seed, rank, mdctx, key))
+        return 0;
     do {
-        input[ML_KEM_RANDOM_BYTES] = (*counter)++;
-        if (!cbd(out, input, mdctx, key))
-            return 0;
         scalar_ntt(out++);
     } while (--rank > 0);
     return 1;
 }
 
 /* The |ETA1| value for ML-KEM-512 is 3, the rest and all ETA2 values are 2. */
-#define CBD1(evp_type)  ((evp_type) == EVP_PKEY_ML_KEM_512 ? cbd_3 : cbd_2)
+#define ETA1(evp_type)  ((evp_type) == EVP_PKEY_ML_KEM_512 ? 3 : 2)
+#define ETA2            2
 
 /*
  * FIPS 203, Section 5.2, Algorithm 14: K-PKE.Encrypt.
@@ -1164,7 +1367,7 @@ int encrypt_cpa(uint8_t out[ML_KEM_SHARED_SECRET_BYTES],
                 EVP_MD_CTX *mdctx, const ML_KEM_KEY *key)
 {
     const ML_KEM_VINFO *vinfo = key->vinfo;
-    CBD_FUNC cbd_1 = CBD1(vinfo->evp_type);
+    int eta1 = ETA1(vinfo->evp_type);
     int rank = vinfo->rank;
     /* We can use tmp[0..rank-1] as storage for |y|, then |e1|, ... */
     scalar *y = &tmp[0], *e1 = y, *e2 = y;
@@ -1177,7 +1380,7 @@ int encrypt_cpa(uint8_t out[ML_KEM_SHARED_SECRET_BYTES],
     int dv = vinfo->dv;
 
     /* FIPS 203 "y" vector */
-    if (!gencbd_vector_ntt(y, cbd_1, &counter, r, rank, mdctx, key))
+    if (!gencbd_vector_ntt(y, eta1, &counter, r, rank, mdctx, key))
         return 0;
     /* FIPS 203 "v" scalar */
     inner_product(&v, key->t, y, rank);
@@ -1186,7 +1389,7 @@ int encrypt_cpa(uint8_t out[ML_KEM_SHARED_SECRET_BYTES],
     matrix_mult_intt(u, key->m, y, rank);
 
     /* All done with |y|, now free to reuse tmp[0] for FIPS 203 |e1| */
-    if (!gencbd_vector(e1, cbd_2, &counter, r, rank, mdctx, key))
+    if (!gencbd_vector(e1, ETA2, &counter, r, rank, mdctx, key))
         return 0;
     vector_add(u, e1, rank);
     vector_compress(u, du, rank);
@@ -1351,7 +1554,7 @@ int genkey(const uint8_t seed[ML_KEM_SEED_BYTES],
     const uint8_t *const sigma = hashed + ML_KEM_RANDOM_BYTES;
     uint8_t augmented_seed[ML_KEM_RANDOM_BYTES + 1];
     const ML_KEM_VINFO *vinfo = key->vinfo;
-    CBD_FUNC cbd_1 = CBD1(vinfo->evp_type);
+    int eta1 = ETA1(vinfo->evp_type);
     int rank = vinfo->rank;
     uint8_t counter = 0;
     int ret = 0;
@@ -1370,8 +1573,8 @@ int genkey(const uint8_t seed[ML_KEM_SEED_BYTES],
 
     /* FIPS 203 |e| vector is initial value of key->t */
     if (!matrix_expand(mdctx, key)
-        || !gencbd_vector_ntt(key->s, cbd_1, &counter, sigma, rank, mdctx, key)
-        || !gencbd_vector_ntt(key->t, cbd_1, &counter, sigma, rank, mdctx, key))
+        || !gencbd_vector_ntt(key->s, eta1, &counter, sigma, rank, mdctx, key)
+        || !gencbd_vector_ntt(key->t, eta1, &counter, sigma, rank, mdctx, key))
         goto end;
 
     /* To |e| we now add the product of transpose |m| and |s|, giving |t|. */
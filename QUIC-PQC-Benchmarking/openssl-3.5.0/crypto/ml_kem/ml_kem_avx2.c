@@ -0,0 +1,470 @@
+/*
+ * Copyright 2025 The OpenSSL Project Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License 2.0 (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://www.openssl.org/source/license.html
+ */
+
+/*
+ * AVX2 implementation of the ML-KEM scalar arithmetic, 16 coefficients per
+ * 256-bit register.  Every function gives exactly the same result as its
+ * portable counterpart in ml_kem.c: all intermediate values are kept as
+ * exact residues and fully reduced before they are stored.
+ */
+
+#include "internal/cryptlib.h"
+#include "ml_kem_local.h"
+
+#if (defined(__x86_64) || defined(__x86_64__) || defined(_M_AMD64) \
+     || defined(_M_X64)) && (defined(__GNUC__) || defined(_MSC_VER))
+
+# include <immintrin.h>
+
+# if defined(__GNUC__)
+#  define TARGET_AVX2 __attribute__((target("avx2")))
+# else
+#  define TARGET_AVX2
+# endif
+
+# define PRIME          ML_KEM_PRIME
+# define HALF_PRIME     ((ML_KEM_PRIME - 1) / 2)
+/* (n/2)^-1 mod q, the final scaling of the inverse NTT, and its Shoup form */
+# define INVERSE_DEGREE         (ML_KEM_PRIME - 2 * 13)
+# define INVERSE_DEGREE_SHOUP   65024
+
+typedef __m256i vec;
+
+# define load(p)        _mm256_loadu_si256((const __m256i *)(p))
+# define store(p, v)    _mm256_storeu_si256((__m256i *)(p), (v))
+# define set1(x)        _mm256_set1_epi16((short)(x))
+
+/* 0 <= x < 2q to 0 <= x < q: x - q wraps around to more than x unless x >= q */
+static ossl_inline TARGET_AVX2 vec reduce_once(vec x)
+{
+    return _mm256_min_epu16(x, _mm256_sub_epi16(x, set1(PRIME)));
+}
+
+/* -q < x < q to 0 <= x < q */
+static ossl_inline TARGET_AVX2 vec reduce_signed(vec x)
+{
+    return _mm256_add_epi16(x, _mm256_and_si256(_mm256_srai_epi16(x, 15),
+                                                set1(PRIME)));
+}
+
+/*
+ * x * w mod q for 0 <= x < 2^16 and a fixed 0 <= w < q, with |ws| the Shoup
+ * form of |w| (see ml_kem_local.h).  The estimated quotient is at most one
+ * too small, so the product is fully reduced with one conditional
+ * subtraction.
+ */
+static ossl_inline TARGET_AVX2 vec mul_shoup(vec x, vec w, vec ws)
+{
+    vec quot = _mm256_mulhi_epu16(x, ws);
+
+    return reduce_once(_mm256_sub_epi16(_mm256_mullo_epi16(x, w),
+                                        _mm256_mullo_epi16(quot, set1(PRIME))));
+}
+
+/*
+ * Montgomery multiplication: a * b * 2^-16 mod q in (-q, q), for signed
+ * |a * b| < q * 2^15.  The low halves of a * b and t * q are equal, so the
+ * difference of the high halves is exact.
+ */
+static ossl_inline TARGET_AVX2 vec mul_mont(vec a, vec b)
+{
+    vec t = _mm256_mullo_epi16(_mm256_mullo_epi16(a, b),
+                               set1(ML_KEM_PRIME_INV16));
+
+    return _mm256_sub_epi16(_mm256_mulhi_epi16(a, b),
+                            _mm256_mulhi_epi16(t, set1(PRIME)));
+}
+
+/*-
+ * The last three layers of the NTT (and the first three of the inverse)
+ * pair coefficients within one register.  They work on two registers |a|
+ * and |b| holding 32 consecutive coefficients, which are rearranged into
+ * |lo| and |hi| so that each butterfly pairs lo[i] with hi[i]:
+ *
+ *  len 8: 128-bit halves,  blocks (lanes of 8)  0, 1
+ *  len 4: 64-bit quarters, blocks (lanes of 4)  0, 2, 1, 3
+ *  len 2: 32-bit words,    blocks (lanes of 2)  0, 4, 1, 5, 2, 6, 3, 7
+ *
+ * The roots for each block are broadcast to the lanes of the block in that
+ * order by the root_* functions, from consecutive entries of a root table.
+ */
+static ossl_inline TARGET_AVX2 void split_8(vec *lo, vec *hi, vec a, vec b)
+{
+    *lo = _mm256_permute2x128_si256(a, b, 0x20);
+    *hi = _mm256_permute2x128_si256(a, b, 0x31);
+}
+
+static ossl_inline TARGET_AVX2 void split_4(vec *lo, vec *hi, vec a, vec b)
+{
+    *lo = _mm256_unpacklo_epi64(a, b);
+    *hi = _mm256_unpackhi_epi64(a, b);
+}
+
+static ossl_inline TARGET_AVX2 void split_2(vec *lo, vec *hi, vec a, vec b)
+{
+    *lo = _mm256_blend_epi16(a, _mm256_slli_epi64(b, 32), 0xcc);
+    *hi = _mm256_blend_epi16(_mm256_srli_epi64(a, 32), b, 0xcc);
+}
+
+/* Each split is undone by applying it again */
+# define join_8 split_8
+# define join_4 split_4
+# define join_2 split_2
+
+static ossl_inline TARGET_AVX2 vec root_8(const uint16_t *w)
+{
+    return _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_set1_epi16((short)w[0])),
+                                   _mm_set1_epi16((short)w[1]), 1);
+}
+
+static ossl_inline TARGET_AVX2 vec root_4(const uint16_t *w)
+{
+    vec r = _mm256_cvtepu16_epi64(_mm_loadl_epi64((const __m128i *)w));
+
+    r = _mm256_permute4x64_epi64(r, 0xd8);
+    r = _mm256_or_si256(r, _mm256_slli_epi64(r, 16));
+    return _mm256_or_si256(r, _mm256_slli_epi64(r, 32));
+}
+
+static ossl_inline TARGET_AVX2 vec root_2(const uint16_t *w)
+{
+    vec r = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *)w));
+
+    r = _mm256_permutevar8x32_epi32(r, _mm256_setr_epi32(0, 4, 1, 5,
+                                                         2, 6, 3, 7));
+    return _mm256_or_si256(r, _mm256_slli_epi32(r, 16));
+}
+
+/* The forward butterfly of scalar_ntt_c() */
+static ossl_inline TARGET_AVX2
+void ntt_butterfly(vec *even, vec *odd, vec w, vec ws)
+{
+    vec t = mul_shoup(*odd, w, ws);
+
+    *odd = reduce_once(_mm256_add_epi16(_mm256_sub_epi16(*even, t),
+                                        set1(PRIME)));
+    *even = reduce_once(_mm256_add_epi16(*even, t));
+}
+
+/* The inverse butterfly of scalar_inverse_ntt_c() */
+static ossl_inline TARGET_AVX2
+void intt_butterfly(vec *even, vec *odd, vec w, vec ws)
+{
+    vec d = _mm256_add_epi16(_mm256_sub_epi16(*even, *odd), set1(PRIME));
+
+    *even = reduce_once(_mm256_add_epi16(*even, *odd));
+    *odd = mul_shoup(d, w, ws);
+}
+
+static TARGET_AVX2 void ntt_avx2(ML_KEM_SCALAR *s)
+{
+    uint16_t *c = s->c;
+    const uint16_t *w = kNTTRoots + 1, *ws = kNTTRootsShoup + 1;
+    vec a, b, lo, hi;
+    int len, i, j;
+
+    /* Layers with whole registers on both sides of the butterfly */
+    for (len = ML_KEM_DEGREE / 2; len >= 16; len >>= 1) {
+        for (i = 0; i < ML_KEM_DEGREE; i += 2 * len, w++, ws++) {
+            for (j = i; j < i + len; j += 16) {
+                a = load(c + j);
+                b = load(c + j + len);
+                ntt_butterfly(&a, &b, set1(*w), set1(*ws));
+                store(c + j, a);
+                store(c + j + len, b);
+            }
+        }
+    }
+
+    /* Layers of length 8, 4 and 2, roots from index 16, 32 and 64 */
+    for (i = 0; i < 8; i++) {
+        a = load(c + 32 * i);
+        b = load(c + 32 * i + 16);
+
+        split_8(&lo, &hi, a, b);
+        ntt_butterfly(&lo, &hi, root_8(kNTTRoots + 16 + 2 * i),
+                      root_8(kNTTRootsShoup + 16 + 2 * i));
+        join_8(&a, &b, lo, hi);
+
+        split_4(&lo, &hi, a, b);
+        ntt_butterfly(&lo, &hi, root_4(kNTTRoots + 32 + 4 * i),
+                      root_4(kNTTRootsShoup + 32 + 4 * i));
+        join_4(&a, &b, lo, hi);
+
+        split_2(&lo, &hi, a, b);
+        ntt_butterfly(&lo, &hi, root_2(kNTTRoots + 64 + 8 * i),
+                      root_2(kNTTRootsShoup + 64 + 8 * i));
+        join_2(&a, &b, lo, hi);
+
+        store(c + 32 * i, a);
+        store(c + 32 * i + 16, b);
+    }
+}
+
+static TARGET_AVX2 void inverse_ntt_avx2(ML_KEM_SCALAR *s)
+{
+    uint16_t *c = s->c;
+    const uint16_t *w, *ws;
+    vec a, b, lo, hi;
+    int len, i, j;
+
+    /* Layers of length 2, 4 and 8, roots from index 1, 65 and 97 */
+    for (i = 0; i < 8; i++) {
+        a = load(c + 32 * i);
+        b = load(c + 32 * i + 16);
+
+        split_2(&lo, &hi, a, b);
+        intt_butterfly(&lo, &hi, root_2(kInverseNTTRoots + 1 + 8 * i),
+                       root_2(kInverseNTTRootsShoup + 1 + 8 * i));
+        join_2(&a, &b, lo, hi);
+
+        split_4(&lo, &hi, a, b);
+        intt_butterfly(&lo, &hi, root_4(kInverseNTTRoots + 65 + 4 * i),
+                       root_4(kInverseNTTRootsShoup + 65 + 4 * i));
+        join_4(&a, &b, lo, hi);
+
+        split_8(&lo, &hi, a, b);
+        intt_butterfly(&lo, &hi, root_8(kInverseNTTRoots + 97 + 2 * i),
+                       root_8(kInverseNTTRootsShoup + 97 + 2 * i));
+        join_8(&a, &b, lo, hi);
+
+        store(c + 32 * i, a);
+        store(c + 32 * i + 16, b);
+    }
+
+    w = kInverseNTTRoots + 113;
+    ws = kInverseNTTRootsShoup + 113;
+    for (len = 16; len < ML_KEM_DEGREE; len <<= 1) {
+        for (i = 0; i < ML_KEM_DEGREE; i += 2 * len, w++, ws++) {
+            for (j = i; j < i + len; j += 16) {
+                a = load(c + j);
+                b = load(c + j + len);
+                intt_butterfly(&a, &b, set1(*w), set1(*ws));
+                store(c + j, a);
+                store(c + j + len, b);
+            }
+        }
+    }
+
+    for (i = 0; i < ML_KEM_DEGREE; i += 16)
+        store(c + i, mul_shoup(load(c + i), set1(INVERSE_DEGREE),
+                               set1(INVERSE_DEGREE_SHOUP)));
+}
+
+/*
+ * The products of scalar_mult_c() for 16 coefficient pairs held in two
+ * registers.  The even and odd coefficients are separated first; their
+ * pairs end up in the order 0-3, 8-11, 4-7, 12-15, which is also the order
+ * the Montgomery form roots are permuted to.  All three products carry a
+ * factor 2^-16, which the final multiplication by 2^32 mod q cancels.
+ */
+static ossl_inline TARGET_AVX2
+void basemul(vec *out0, vec *out1, const uint16_t *lhs, const uint16_t *rhs,
+             const int16_t *roots)
+{
+    const vec mask = _mm256_set1_epi32(0xffff);
+    vec la = load(lhs), lb = load(lhs + 16), ra = load(rhs), rb = load(rhs + 16);
+    vec l0, l1, r0, r1, w, even, odd;
+
+    l0 = _mm256_packus_epi32(_mm256_and_si256(la, mask), _mm256_and_si256(lb, mask));
+    l1 = _mm256_packus_epi32(_mm256_srli_epi32(la, 16), _mm256_srli_epi32(lb, 16));
+    r0 = _mm256_packus_epi32(_mm256_and_si256(ra, mask), _mm256_and_si256(rb, mask));
+    r1 = _mm256_packus_epi32(_mm256_srli_epi32(ra, 16), _mm256_srli_epi32(rb, 16));
+    w = _mm256_permute4x64_epi64(load(roots), 0xd8);
+
+    even = _mm256_add_epi16(mul_mont(l0, r0), mul_mont(mul_mont(l1, r1), w));
+    odd = _mm256_add_epi16(mul_mont(l0, r1), mul_mont(l1, r0));
+    even = reduce_signed(mul_mont(even, set1(ML_KEM_MONT_R2)));
+    odd = reduce_signed(mul_mont(odd, set1(ML_KEM_MONT_R2)));
+
+    *out0 = _mm256_unpacklo_epi16(even, odd);
+    *out1 = _mm256_unpackhi_epi16(even, odd);
+}
+
+static TARGET_AVX2
+void mult_avx2(ML_KEM_SCALAR *out, const ML_KEM_SCALAR *lhs,
+               const ML_KEM_SCALAR *rhs)
+{
+    vec a, b;
+    int i;
+
+    for (i = 0; i < ML_KEM_DEGREE; i += 32) {
+        basemul(&a, &b, lhs->c + i, rhs->c + i, kModRootsMont + i / 2);
+        store(out->c + i, a);
+        store(out->c + i + 16, b);
+    }
+}
+
+static TARGET_AVX2
+void mult_add_avx2(ML_KEM_SCALAR *out, const ML_KEM_SCALAR *lhs,
+                   const ML_KEM_SCALAR *rhs)
+{
+    vec a, b;
+    int i;
+
+    for (i = 0; i < ML_KEM_DEGREE; i += 32) {
+        basemul(&a, &b, lhs->c + i, rhs->c + i, kModRootsMont + i / 2);
+        store(out->c + i, reduce_once(_mm256_add_epi16(a, load(out->c + i))));
+        store(out->c + i + 16,
+              reduce_once(_mm256_add_epi16(b, load(out->c + i + 16))));
+    }
+}
+
+/*
+ * round(2^bits * x / q) mod 2^bits.  With r = 2^bits * x mod q, the
+ * difference 2^bits * x - r is an exact multiple of q, so the quotient is
+ * obtained by multiplying with q^-1 mod 2^16.  It is rounded up when
+ * r > (q - 1) / 2; as q is odd there are no ties.
+ */
+static TARGET_AVX2 void compress_avx2(ML_KEM_SCALAR *s, int bits)
+{
+    const uint16_t w = (uint16_t)(1 << bits);
+    const vec ws = set1(((uint32_t)w << 16) / PRIME);
+    const vec mask = set1((1 << bits) - 1);
+    const __m128i shift = _mm_cvtsi32_si128(bits);
+    vec x, r, quot;
+    int i;
+
+    for (i = 0; i < ML_KEM_DEGREE; i += 16) {
+        x = load(s->c + i);
+        r = mul_shoup(x, set1(w), ws);
+        quot = _mm256_sub_epi16(_mm256_sll_epi16(x, shift), r);
+        quot = _mm256_mullo_epi16(quot, set1(ML_KEM_PRIME_INV16));
+        quot = _mm256_sub_epi16(quot, _mm256_cmpgt_epi16(r, set1(HALF_PRIME)));
+        store(s->c + i, _mm256_and_si256(quot, mask));
+    }
+}
+
+/*
+ * round(q * x / 2^bits), rounding halves up: with x shifted up to 15 bits,
+ * the rounding high multiply (x * q + 2^14) >> 15 does exactly that.
+ */
+static TARGET_AVX2 void decompress_avx2(ML_KEM_SCALAR *s, int bits)
+{
+    const __m128i shift = _mm_cvtsi32_si128(15 - bits);
+    int i;
+
+    for (i = 0; i < ML_KEM_DEGREE; i += 16)
+        store(s->c + i, _mm256_mulhrs_epi16(_mm256_sll_epi16(load(s->c + i), shift),
+                                            set1(PRIME)));
+}
+
+/* -eta <= x <= eta, biased by eta, to 0 <= x < q */
+static ossl_inline TARGET_AVX2 vec cbd_finish(__m128i biased, int eta)
+{
+    return reduce_signed(_mm256_sub_epi16(_mm256_cvtepu8_epi16(biased),
+                                          set1(eta)));
+}
+
+/*
+ * Each byte gives two coefficients.  The 2-bit sums of adjacent bits are
+ * formed for all bytes at once, then each nibble holds (a + 2) - b for its
+ * coefficient, which cannot borrow from the next one.
+ */
+static TARGET_AVX2
+void cbd_2_avx2(ML_KEM_SCALAR *out, const uint8_t in[4 * ML_KEM_DEGREE / 8])
+{
+    const __m128i m55 = _mm_set1_epi8(0x55), m33 = _mm_set1_epi8(0x33);
+    const __m128i m0f = _mm_set1_epi8(0x0f);
+    __m128i x, t, lo, hi;
+    int i;
+
+    for (i = 0; i < 4 * ML_KEM_DEGREE / 8; i += 16) {
+        x = _mm_loadu_si128((const __m128i *)(in + i));
+        t = _mm_add_epi8(_mm_and_si128(x, m55),
+                         _mm_and_si128(_mm_srli_epi16(x, 1), m55));
+        t = _mm_sub_epi8(_mm_add_epi8(_mm_and_si128(t, m33), _mm_set1_epi8(0x22)),
+                         _mm_and_si128(_mm_srli_epi16(t, 2), m33));
+        lo = _mm_and_si128(t, m0f);
+        hi = _mm_and_si128(_mm_srli_epi16(t, 4), m0f);
+        store(out->c + 2 * i, cbd_finish(_mm_unpacklo_epi8(lo, hi), 2));
+        store(out->c + 2 * i + 16, cbd_finish(_mm_unpackhi_epi8(lo, hi), 2));
+    }
+}
+
+/*
+ * Each 3 bytes give four coefficients.  Groups of 3 bytes are spread into
+ * 32-bit words, where the 3-bit sums of adjacent bits are formed and each
+ * 6-bit field is set to (a + 3) - b for its coefficient.  The loads are
+ * placed so that they never read past the end of |in|.
+ */
+static TARGET_AVX2
+void cbd_3_avx2(ML_KEM_SCALAR *out, const uint8_t in[6 * ML_KEM_DEGREE / 8])
+{
+    const __m128i spread0 = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1,
+                                          6, 7, 8, -1, 9, 10, 11, -1);
+    const __m128i spread4 = _mm_setr_epi8(4, 5, 6, -1, 7, 8, 9, -1,
+                                          10, 11, 12, -1, 13, 14, 15, -1);
+    const vec m249 = _mm256_set1_epi32(0x249249);
+    const vec m1c7 = _mm256_set1_epi32(0x1c71c7);
+    const vec m3f = _mm256_set1_epi32(0x3f);
+    const vec m3f0000 = _mm256_set1_epi32(0x3f0000);
+    __m128i x0, x1;
+    vec x, t, c01, c23, lo, hi;
+    int i;
+
+    for (i = 0; i < 6 * ML_KEM_DEGREE / 8; i += 24) {
+        x0 = i == 0
+            ? _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)in), spread0)
+            : _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(in + i - 4)),
+                               spread4);
+        x1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(in + i + 8)),
+                              spread4);
+        x = _mm256_inserti128_si256(_mm256_castsi128_si256(x0), x1, 1);
+
+        t = _mm256_add_epi32(_mm256_and_si256(x, m249),
+                             _mm256_and_si256(_mm256_srli_epi32(x, 1), m249));
+        t = _mm256_add_epi32(t, _mm256_and_si256(_mm256_srli_epi32(x, 2), m249));
+        t = _mm256_sub_epi32(_mm256_add_epi32(_mm256_and_si256(t, m1c7),
+                                              _mm256_set1_epi32(0xc30c3)),
+                             _mm256_and_si256(_mm256_srli_epi32(t, 3), m1c7));
+
+        /* Coefficients 0, 1 and 2, 3 of each group into 16-bit halves */
+        c01 = _mm256_or_si256(_mm256_and_si256(t, m3f),
+                              _mm256_and_si256(_mm256_slli_epi32(t, 10), m3f0000));
+        c23 = _mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(t, 12), m3f),
+                              _mm256_and_si256(_mm256_srli_epi32(t, 2), m3f0000));
+        lo = _mm256_unpacklo_epi32(c01, c23);
+        hi = _mm256_unpackhi_epi32(c01, c23);
+        store(out->c + 4 * i / 3,
+              reduce_signed(_mm256_sub_epi16(_mm256_permute2x128_si256(lo, hi, 0x20),
+                                             set1(3))));
+        store(out->c + 4 * i / 3 + 16,
+              reduce_signed(_mm256_sub_epi16(_mm256_permute2x128_si256(lo, hi, 0x31),
+                                             set1(3))));
+    }
+}
+
+static const ML_KEM_SCALAR_OPS avx2_ops = {
+    ntt_avx2,
+    inverse_ntt_avx2,
+    mult_avx2,
+    mult_add_avx2,
+    compress_avx2,
+    decompress_avx2,
+    cbd_2_avx2,
+    cbd_3_avx2
+};
+
+const ML_KEM_SCALAR_OPS *ossl_ml_kem_scalar_ops_simd(void)
+{
+    /* AVX2, CPUID.(EAX=7):EBX bit 5, cleared if the OS lacks YMM support */
+    if ((OPENSSL_ia32cap_P[2] & (1 << 5)) != 0)
+        return &avx2_ops;
+    return NULL;
+}
+
+#else
+
+const ML_KEM_SCALAR_OPS *ossl_ml_kem_scalar_ops_simd(void)
+{
+    return NULL;
+}
+
+#endif
@@ -0,0 +1,204 @@
+/*
+ * Copyright 2025 The OpenSSL Project Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License 2.0 (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://www.openssl.org/source/license.html
+ */
+
+#ifndef OSSL_CRYPTO_ML_KEM_LOCAL_H
+# define OSSL_CRYPTO_ML_KEM_LOCAL_H
+
+# include "crypto/ml_kem.h"
+
+typedef struct ossl_ml_kem_scalar_st {
+    /* On every function entry and exit, 0 <= c[i] < ML_KEM_PRIME. */
+    uint16_t c[ML_KEM_DEGREE];
+} ML_KEM_SCALAR;
+
+/*
+ * The polynomial arithmetic of ML-KEM that is worth vectorising.  The
+ * portable C implementation is always available, the SIMD one (AVX2 on
+ * x86_64, NEON on aarch64) only when built for such a target and when the
+ * CPU supports it.  Both produce identical results for inputs in the
+ * documented ranges, i.e. fully reduced coefficients, 0 <= x < 2^bits for
+ * |decompress| and |bits| one of 1, 4, 5, 10 or 11.
+ *
+ * |cbd_2| and |cbd_3| take the 128 or 192 bytes of PRF output and produce a
+ * centred binomially distributed scalar with eta 2 or 3.
+ */
+typedef struct ml_kem_scalar_ops_st {
+    void (*ntt)(ML_KEM_SCALAR *s);
+    void (*inverse_ntt)(ML_KEM_SCALAR *s);
+    void (*mult)(ML_KEM_SCALAR *out, const ML_KEM_SCALAR *lhs,
+                 const ML_KEM_SCALAR *rhs);
+    void (*mult_add)(ML_KEM_SCALAR *out, const ML_KEM_SCALAR *lhs,
+                     const ML_KEM_SCALAR *rhs);
+    void (*compress)(ML_KEM_SCALAR *s, int bits);
+    void (*decompress)(ML_KEM_SCALAR *s, int bits);
+    void (*cbd_2)(ML_KEM_SCALAR *out, const uint8_t in[4 * ML_KEM_DEGREE / 8]);
+    void (*cbd_3)(ML_KEM_SCALAR *out, const uint8_t in[6 * ML_KEM_DEGREE / 8]);
+} ML_KEM_SCALAR_OPS;
+
+const ML_KEM_SCALAR_OPS *ossl_ml_kem_scalar_ops_generic(void);
+/* Returns NULL when there is no SIMD implementation usable on this CPU */
+const ML_KEM_SCALAR_OPS *ossl_ml_kem_scalar_ops_simd(void);
+
+/* q^-1 mod 2^16, for the Montgomery reduction of 16-bit words */
+# define ML_KEM_PRIME_INV16     62209
+/* 2^32 mod q, undoes the two factors of 2^-16 of a Montgomery product */
+# define ML_KEM_MONT_R2         1353
+
+/*
+ * Python helper:
+ *
+ * p = 3329
+ * def bitreverse(i):
+ *     ret = 0
+ *     for n in range(7):
+ *         bit = i & 1
+ *         ret <<= 1
+ *         ret |= bit
+ *         i >>= 1
+ *     return ret
+ */
+
+/*-
+ * First precomputed array from Appendix A of FIPS 203, or else Python:
+ * kNTTRoots = [pow(17, bitreverse(i), p) for i in range(128)]
+ */
+static const uint16_t kNTTRoots[128] = {
+    1,    1729, 2580, 3289, 2642, 630,  1897, 848,
+    1062, 1919, 193,  797,  2786, 3260, 569,  1746,
+    296,  2447, 1339, 1476, 3046, 56,   2240, 1333,
+    1426, 2094, 535,  2882, 2393, 2879, 1974, 821,
+    289,  331,  3253, 1756, 1197, 2304, 2277, 2055,
+    650,  1977, 2513, 632,  2865, 33,   1320, 1915,
+    2319, 1435, 807,  452,  1438, 2868, 1534, 2402,
+    2647, 2617, 1481, 648,  2474, 3110, 1227, 910,
+    17,   2761, 583,  2649, 1637, 723,  2288, 1100,
+    1409, 2662, 3281, 233,  756,  2156, 3015, 3050,
+    1703, 1651, 2789, 1789, 1847, 952,  1461, 2687,
+    939,  2308, 2437, 2388, 733,  2337, 268,  641,
+    1584, 2298, 2037, 3220, 375,  2549, 2090, 1645,
+    1063, 319,  2773, 757,  2099, 561,  2466, 2594,
+    2804, 1092, 403,  1026, 1143, 2150, 2775, 886,
+    1722, 1212, 1874, 1029, 2110, 2935, 885,  2154,
+};
+
+/*
+ * InverseNTTRoots = [pow(17, -bitreverse(i), p) for i in range(128)]
+ * Listed in order of use in the inverse NTT loop (index 0 is skipped):
+ *
+ *  0, 64, 65, ..., 127, 32, 33, ..., 63, 16, 17, ..., 31, 8, 9, ...
+ */
+static const uint16_t kInverseNTTRoots[128] = {
+    1,    1175, 2444, 394,  1219, 2300, 1455, 2117,
+    1607, 2443, 554,  1179, 2186, 2303, 2926, 2237,
+    525,  735,  863,  2768, 1230, 2572, 556,  3010,
+    2266, 1684, 1239, 780,  2954, 109,  1292, 1031,
+    1745, 2688, 3061, 992,  2596, 941,  892,  1021,
+    2390, 642,  1868, 2377, 1482, 1540, 540,  1678,
+    1626, 279,  314,  1173, 2573, 3096, 48,   667,
+    1920, 2229, 1041, 2606, 1692, 680,  2746, 568,
+    3312, 2419, 2102, 219,  855,  2681, 1848, 712,
+    682,  927,  1795, 461,  1891, 2877, 2522, 1894,
+    1010, 1414, 2009, 3296, 464,  2697, 816,  1352,
+    2679, 1274, 1052, 1025, 2132, 1573, 76,   2998,
+    3040, 2508, 1355, 450,  936,  447,  2794, 1235,
+    1903, 1996, 1089, 3273, 283,  1853, 1990, 882,
+    3033, 1583, 2760, 69,   543,  2532, 3136, 1410,
+    2267, 2481, 1432, 2699, 687,  40,   749,  1600,
+};
+
+/*
+ * Second precomputed array from Appendix A of FIPS 203 (normalised positive),
+ * or else Python:
+ * ModRoots = [pow(17, 2*bitreverse(i) + 1, p) for i in range(128)]
+ */
+static const uint16_t kModRoots[128] = {
+    17,   3312, 2761, 568,  583,  2746, 2649, 680,  1637, 1692, 723,  2606,
+    2288, 1041, 1100, 2229, 1409, 1920, 2662, 667,  3281, 48,   233,  3096,
+    756,  2573, 2156, 1173, 3015, 314,  3050, 279,  1703, 1626, 1651, 1678,
+    2789, 540,  1789, 1540, 1847, 1482, 952,  2377, 1461, 1868, 2687, 642,
+    939,  2390, 2308, 1021, 2437, 892,  2388, 941,  733,  2596, 2337, 992,
+    268,  3061, 641,  2688, 1584, 1745, 2298, 1031, 2037, 1292, 3220, 109,
+    375,  2954, 2549, 780,  2090, 1239, 1645, 1684, 1063, 2266, 319,  3010,
+    2773, 556,  757,  2572, 2099, 1230, 561,  2768, 2466, 863,  2594, 735,
+    2804, 525,  1092, 2237, 403,  2926, 1026, 2303, 1143, 2186, 2150, 1179,
+    2775, 554,  886,  2443, 1722, 1607, 1212, 2117, 1874, 1455, 1029, 2300,
+    2110, 1219, 2935, 394,  885,  2444, 2154, 1175,
+};
+
+/*-
+ * Precomputed constants of the SIMD implementations.
+ *
+ * Shoup's multiplication by a fixed |w| computes x * w mod q, up to one
+ * final subtraction of q, as x * w - q * ((x * w') >> 16) in 16-bit words,
+ * with w' = floor(w * 2^16 / q):
+ * kNTTRootsShoup = [(w << 16) // p for w in kNTTRoots]
+ * kInverseNTTRootsShoup = [(w << 16) // p for w in kInverseNTTRoots]
+ *
+ * The pairwise products use Montgomery multiplication, with the roots in
+ * Montgomery form:
+ * kModRootsMont = [(w << 16) % p for w in kModRoots]
+ */
+static const uint16_t kNTTRootsShoup[128] = {
+    19,    34037, 50790, 64748, 52011, 12402, 37345, 16694,
+    20906, 37778, 3799,  15690, 54846, 64177, 11201, 34372,
+    5827,  48172, 26360, 29057, 59964, 1102,  44097, 26241,
+    28072, 41223, 10532, 56736, 47109, 56677, 38860, 16162,
+    5689,  6516,  64039, 34569, 23564, 45357, 44825, 40455,
+    12796, 38919, 49471, 12441, 56401, 649,   25986, 37699,
+    45652, 28249, 15886, 8898,  28309, 56460, 30198, 47286,
+    52109, 51519, 29155, 12756, 48704, 61224, 24155, 17914,
+    334,   54354, 11477, 52149, 32226, 14233, 45042, 21655,
+    27738, 52405, 64591, 4586,  14882, 42443, 59354, 60043,
+    33525, 32502, 54905, 35218, 36360, 18741, 28761, 52897,
+    18485, 45436, 47975, 47011, 14430, 46007, 5275,  12618,
+    31183, 45239, 40101, 63390, 7382,  50180, 41144, 32384,
+    20926, 6279,  54590, 14902, 41321, 11044, 48546, 51066,
+    55200, 21497, 7933,  20198, 22501, 42325, 54629, 17442,
+    33899, 23859, 36892, 20257, 41538, 57779, 17422, 42404,
+};
+
+static const uint16_t kInverseNTTRootsShoup[128] = {
+    19,    23131, 48113, 7756,  23997, 45278, 28643, 41676,
+    31636, 48093, 10906, 23210, 43034, 45337, 57602, 44038,
+    10335, 14469, 16989, 54491, 24214, 50633, 10945, 59256,
+    44609, 33151, 24391, 15355, 58153, 2145,  25434, 20296,
+    34352, 52917, 60260, 19528, 51105, 18524, 17560, 20099,
+    47050, 12638, 36774, 46794, 29175, 30317, 10630, 33033,
+    32010, 5492,  6181,  23092, 50653, 60949, 944,   13130,
+    37797, 43880, 20493, 51302, 33309, 13386, 54058, 11181,
+    65201, 47621, 41380, 4311,  16831, 52779, 36380, 14016,
+    13426, 18249, 35337, 9075,  37226, 56637, 49649, 37286,
+    19883, 27836, 39549, 64886, 9134,  53094, 16064, 26616,
+    52739, 25080, 20710, 20178, 41971, 30966, 1496,  59019,
+    59846, 49373, 26675, 8858,  18426, 8799,  55003, 24312,
+    37463, 39294, 21438, 64433, 5571,  36478, 39175, 17363,
+    59708, 31163, 54334, 1358,  10689, 49845, 61736, 27757,
+    44629, 48841, 28190, 53133, 13524, 787,   14745, 31498,
+};
+
+static const int16_t kModRootsMont[128] = {
+    2226, 1103, 430,  2899, 555,  2774, 843,  2486,
+    2078, 1251, 871,  2458, 1550, 1779, 105,  3224,
+    422,  2907, 587,  2742, 177,  3152, 3094, 235,
+    3038, 291,  2869, 460,  1574, 1755, 1653, 1676,
+    3083, 246,  778,  2551, 1159, 2170, 3182, 147,
+    2552, 777,  1483, 1846, 2727, 602,  1119, 2210,
+    1739, 1590, 644,  2685, 2457, 872,  349,  2980,
+    418,  2911, 329,  3000, 3173, 156,  3254, 75,
+    817,  2512, 1097, 2232, 603,  2726, 610,  2719,
+    1322, 2007, 2044, 1285, 1864, 1465, 384,  2945,
+    2114, 1215, 3193, 136,  1218, 2111, 1994, 1335,
+    2455, 874,  220,  3109, 2142, 1187, 1670, 1659,
+    2144, 1185, 1799, 1530, 2051, 1278, 794,  2535,
+    1819, 1510, 2475, 854,  2459, 870,  478,  2851,
+    3221, 108,  3021, 308,  996,  2333, 991,  2338,
+    958,  2371, 1869, 1460, 1522, 1807, 1628, 1701,
+};
+
+#endif
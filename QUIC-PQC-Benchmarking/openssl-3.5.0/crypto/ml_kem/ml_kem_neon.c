@@ -0,0 +1,407 @@
+/*
+ * Copyright 2025 The OpenSSL Project Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License 2.0 (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://www.openssl.org/source/license.html
+ */
+
+/*
+ * NEON implementation of the ML-KEM scalar arithmetic, 8 coefficients per
+ * 128-bit register.  It follows ml_kem_avx2.c operation for operation and
+ * likewise gives exactly the same results as the portable code in ml_kem.c.
+ */
+
+#include "internal/cryptlib.h"
+#include "ml_kem_local.h"
+
+#if defined(__aarch64__) && !defined(__AARCH64EB__)
+
+# include <arm_neon.h>
+# include "crypto/arm_arch.h"
+
+# define PRIME          ML_KEM_PRIME
+# define HALF_PRIME     ((ML_KEM_PRIME - 1) / 2)
+/* (n/2)^-1 mod q, the final scaling of the inverse NTT, and its Shoup form */
+# define INVERSE_DEGREE         (ML_KEM_PRIME - 2 * 13)
+# define INVERSE_DEGREE_SHOUP   65024
+
+typedef uint16x8_t vec;
+
+# define load(p)        vld1q_u16(p)
+# define store(p, v)    vst1q_u16((p), (v))
+# define set1(x)        vdupq_n_u16((uint16_t)(x))
+
+/* The high halves of the unsigned and signed 16x16-bit products */
+static ossl_inline vec mulhi_u16(vec a, vec b)
+{
+    return vuzp2q_u16(vreinterpretq_u16_u32(vmull_u16(vget_low_u16(a),
+                                                      vget_low_u16(b))),
+                      vreinterpretq_u16_u32(vmull_high_u16(a, b)));
+}
+
+static ossl_inline int16x8_t mulhi_s16(int16x8_t a, int16x8_t b)
+{
+    return vuzp2q_s16(vreinterpretq_s16_s32(vmull_s16(vget_low_s16(a),
+                                                      vget_low_s16(b))),
+                      vreinterpretq_s16_s32(vmull_high_s16(a, b)));
+}
+
+/* 0 <= x < 2q to 0 <= x < q */
+static ossl_inline vec reduce_once(vec x)
+{
+    return vminq_u16(x, vsubq_u16(x, set1(PRIME)));
+}
+
+/* -q < x < q to 0 <= x < q */
+static ossl_inline vec reduce_signed(int16x8_t x)
+{
+    return vreinterpretq_u16_s16(
+        vaddq_s16(x, vandq_s16(vshrq_n_s16(x, 15), vdupq_n_s16(PRIME))));
+}
+
+/* x * w mod q for 0 <= x < 2^16, see mul_shoup() in ml_kem_avx2.c */
+static ossl_inline vec mul_shoup(vec x, vec w, vec ws)
+{
+    return reduce_once(vmlsq_u16(vmulq_u16(x, w), mulhi_u16(x, ws),
+                                 set1(PRIME)));
+}
+
+/* Montgomery multiplication: a * b * 2^-16 mod q in (-q, q) */
+static ossl_inline int16x8_t mul_mont(int16x8_t a, int16x8_t b)
+{
+    int16x8_t t = vmulq_s16(vmulq_s16(a, b), vdupq_n_s16((int16_t)ML_KEM_PRIME_INV16));
+
+    return vsubq_s16(mulhi_s16(a, b), mulhi_s16(t, vdupq_n_s16(PRIME)));
+}
+
+/*-
+ * The last two layers of the NTT (and the first two of the inverse) pair
+ * coefficients within one register.  They work on two registers |a| and |b|
+ * holding 16 consecutive coefficients, which are rearranged into |lo| and
+ * |hi| so that each butterfly pairs lo[i] with hi[i]:
+ *
+ *  len 4: 64-bit halves, blocks (lanes of 4)  0, 1
+ *  len 2: 32-bit words,  blocks (lanes of 2)  0, 1, 2, 3
+ *
+ * i.e. the blocks stay in their natural order, and so do their roots.
+ */
+static ossl_inline void split_4(vec *lo, vec *hi, vec a, vec b)
+{
+    *lo = vreinterpretq_u16_u64(vtrn1q_u64(vreinterpretq_u64_u16(a),
+                                           vreinterpretq_u64_u16(b)));
+    *hi = vreinterpretq_u16_u64(vtrn2q_u64(vreinterpretq_u64_u16(a),
+                                           vreinterpretq_u64_u16(b)));
+}
+
+/* Undone by applying it again */
+# define join_4 split_4
+
+static ossl_inline void split_2(vec *lo, vec *hi, vec a, vec b)
+{
+    *lo = vreinterpretq_u16_u32(vuzp1q_u32(vreinterpretq_u32_u16(a),
+                                           vreinterpretq_u32_u16(b)));
+    *hi = vreinterpretq_u16_u32(vuzp2q_u32(vreinterpretq_u32_u16(a),
+                                           vreinterpretq_u32_u16(b)));
+}
+
+static ossl_inline void join_2(vec *a, vec *b, vec lo, vec hi)
+{
+    *a = vreinterpretq_u16_u32(vzip1q_u32(vreinterpretq_u32_u16(lo),
+                                          vreinterpretq_u32_u16(hi)));
+    *b = vreinterpretq_u16_u32(vzip2q_u32(vreinterpretq_u32_u16(lo),
+                                          vreinterpretq_u32_u16(hi)));
+}
+
+static ossl_inline vec root_4(const uint16_t *w)
+{
+    return vcombine_u16(vdup_n_u16(w[0]), vdup_n_u16(w[1]));
+}
+
+static ossl_inline vec root_2(const uint16_t *w)
+{
+    uint16x4_t r = vld1_u16(w);
+
+    return vcombine_u16(vzip1_u16(r, r), vzip2_u16(r, r));
+}
+
+/* The forward butterfly of scalar_ntt_c() */
+static ossl_inline void ntt_butterfly(vec *even, vec *odd, vec w, vec ws)
+{
+    vec t = mul_shoup(*odd, w, ws);
+
+    *odd = reduce_once(vaddq_u16(vsubq_u16(*even, t), set1(PRIME)));
+    *even = reduce_once(vaddq_u16(*even, t));
+}
+
+/* The inverse butterfly of scalar_inverse_ntt_c() */
+static ossl_inline void intt_butterfly(vec *even, vec *odd, vec w, vec ws)
+{
+    vec d = vaddq_u16(vsubq_u16(*even, *odd), set1(PRIME));
+
+    *even = reduce_once(vaddq_u16(*even, *odd));
+    *odd = mul_shoup(d, w, ws);
+}
+
+static void ntt_neon(ML_KEM_SCALAR *s)
+{
+    uint16_t *c = s->c;
+    const uint16_t *w = kNTTRoots + 1, *ws = kNTTRootsShoup + 1;
+    vec a, b, lo, hi;
+    int len, i, j;
+
+    /* Layers with whole registers on both sides of the butterfly */
+    for (len = ML_KEM_DEGREE / 2; len >= 8; len >>= 1) {
+        for (i = 0; i < ML_KEM_DEGREE; i += 2 * len, w++, ws++) {
+            for (j = i; j < i + len; j += 8) {
+                a = load(c + j);
+                b = load(c + j + len);
+                ntt_butterfly(&a, &b, set1(*w), set1(*ws));
+                store(c + j, a);
+                store(c + j + len, b);
+            }
+        }
+    }
+
+    /* Layers of length 4 and 2, roots from index 32 and 64 */
+    for (i = 0; i < 16; i++) {
+        a = load(c + 16 * i);
+        b = load(c + 16 * i + 8);
+
+        split_4(&lo, &hi, a, b);
+        ntt_butterfly(&lo, &hi, root_4(kNTTRoots + 32 + 2 * i),
+                      root_4(kNTTRootsShoup + 32 + 2 * i));
+        join_4(&a, &b, lo, hi);
+
+        split_2(&lo, &hi, a, b);
+        ntt_butterfly(&lo, &hi, root_2(kNTTRoots + 64 + 4 * i),
+                      root_2(kNTTRootsShoup + 64 + 4 * i));
+        join_2(&a, &b, lo, hi);
+
+        store(c + 16 * i, a);
+        store(c + 16 * i + 8, b);
+    }
+}
+
+static void inverse_ntt_neon(ML_KEM_SCALAR *s)
+{
+    uint16_t *c = s->c;
+    const uint16_t *w, *ws;
+    vec a, b, lo, hi;
+    int len, i, j;
+
+    /* Layers of length 2 and 4, roots from index 1 and 65 */
+    for (i = 0; i < 16; i++) {
+        a = load(c + 16 * i);
+        b = load(c + 16 * i + 8);
+
+        split_2(&lo, &hi, a, b);
+        intt_butterfly(&lo, &hi, root_2(kInverseNTTRoots + 1 + 4 * i),
+                       root_2(kInverseNTTRootsShoup + 1 + 4 * i));
+        join_2(&a, &b, lo, hi);
+
+        split_4(&lo, &hi, a, b);
+        intt_butterfly(&lo, &hi, root_4(kInverseNTTRoots + 65 + 2 * i),
+                       root_4(kInverseNTTRootsShoup + 65 + 2 * i));
+        join_4(&a, &b, lo, hi);
+
+        store(c + 16 * i, a);
+        store(c + 16 * i + 8, b);
+    }
+
+    w = kInverseNTTRoots + 97;
+    ws = kInverseNTTRootsShoup + 97;
+    for (len = 8; len < ML_KEM_DEGREE; len <<= 1) {
+        for (i = 0; i < ML_KEM_DEGREE; i += 2 * len, w++, ws++) {
+            for (j = i; j < i + len; j += 8) {
+                a = load(c + j);
+                b = load(c + j + len);
+                intt_butterfly(&a, &b, set1(*w), set1(*ws));
+                store(c + j, a);
+                store(c + j + len, b);
+            }
+        }
+    }
+
+    for (i = 0; i < ML_KEM_DEGREE; i += 8)
+        store(c + i, mul_shoup(load(c + i), set1(INVERSE_DEGREE),
+                               set1(INVERSE_DEGREE_SHOUP)));
+}
+
+/*
+ * The products of scalar_mult_c() for 8 coefficient pairs, which the
+ * structure loads separate into even and odd coefficients.  As in
+ * ml_kem_avx2.c the factors 2^-16 are cancelled by a final multiplication
+ * by 2^32 mod q.
+ */
+static ossl_inline uint16x8x2_t basemul(const uint16_t *lhs,
+                                        const uint16_t *rhs,
+                                        const int16_t *roots)
+{
+    int16x8x2_t l = vld2q_s16((const int16_t *)lhs);
+    int16x8x2_t r = vld2q_s16((const int16_t *)rhs);
+    int16x8_t even, odd;
+    uint16x8x2_t out;
+
+    even = vaddq_s16(mul_mont(l.val[0], r.val[0]),
+                     mul_mont(mul_mont(l.val[1], r.val[1]), vld1q_s16(roots)));
+    odd = vaddq_s16(mul_mont(l.val[0], r.val[1]), mul_mont(l.val[1], r.val[0]));
+    out.val[0] = reduce_signed(mul_mont(even, vdupq_n_s16(ML_KEM_MONT_R2)));
+    out.val[1] = reduce_signed(mul_mont(odd, vdupq_n_s16(ML_KEM_MONT_R2)));
+    return out;
+}
+
+static void mult_neon(ML_KEM_SCALAR *out, const ML_KEM_SCALAR *lhs,
+                      const ML_KEM_SCALAR *rhs)
+{
+    int i;
+
+    for (i = 0; i < ML_KEM_DEGREE; i += 16)
+        vst2q_u16(out->c + i, basemul(lhs->c + i, rhs->c + i,
+                                      kModRootsMont + i / 2));
+}
+
+static void mult_add_neon(ML_KEM_SCALAR *out, const ML_KEM_SCALAR *lhs,
+                          const ML_KEM_SCALAR *rhs)
+{
+    uint16x8x2_t p, acc;
+    int i;
+
+    for (i = 0; i < ML_KEM_DEGREE; i += 16) {
+        p = basemul(lhs->c + i, rhs->c + i, kModRootsMont + i / 2);
+        acc = vld2q_u16(out->c + i);
+        acc.val[0] = reduce_once(vaddq_u16(acc.val[0], p.val[0]));
+        acc.val[1] = reduce_once(vaddq_u16(acc.val[1], p.val[1]));
+        vst2q_u16(out->c + i, acc);
+    }
+}
+
+/* round(2^bits * x / q) mod 2^bits, see compress_avx2() */
+static void compress_neon(ML_KEM_SCALAR *s, int bits)
+{
+    const uint16_t w = (uint16_t)(1 << bits);
+    const vec ws = set1(((uint32_t)w << 16) / PRIME);
+    const vec mask = set1((1 << bits) - 1);
+    const int16x8_t shift = vdupq_n_s16((int16_t)bits);
+    vec x, r, quot;
+    int i;
+
+    for (i = 0; i < ML_KEM_DEGREE; i += 8) {
+        x = load(s->c + i);
+        r = mul_shoup(x, set1(w), ws);
+        quot = vsubq_u16(vshlq_u16(x, shift), r);
+        quot = vmulq_u16(quot, set1(ML_KEM_PRIME_INV16));
+        quot = vsubq_u16(quot, vcgtq_u16(r, set1(HALF_PRIME)));
+        store(s->c + i, vandq_u16(quot, mask));
+    }
+}
+
+/*
+ * round(q * x / 2^bits), rounding halves up: the doubling rounding high
+ * multiply of x shifted up to 15 bits computes (x * q + 2^14) >> 15.
+ */
+static void decompress_neon(ML_KEM_SCALAR *s, int bits)
+{
+    const int16x8_t shift = vdupq_n_s16((int16_t)(15 - bits));
+    int16x8_t x;
+    int i;
+
+    for (i = 0; i < ML_KEM_DEGREE; i += 8) {
+        x = vshlq_s16(vld1q_s16((const int16_t *)s->c + i), shift);
+        vst1q_s16((int16_t *)s->c + i, vqrdmulhq_s16(x, vdupq_n_s16(PRIME)));
+    }
+}
+
+/* The number of bits set in |x & m| */
+static ossl_inline int8x16_t popcnt(uint8x16_t x, uint8_t m)
+{
+    return vreinterpretq_s8_u8(vcntq_u8(vandq_u8(x, vdupq_n_u8(m))));
+}
+
+/* -eta <= x <= eta for the 8 low or high bytes of |x| to 0 <= x < q */
+# define cbd_finish_lo(x)   reduce_signed(vmovl_s8(vget_low_s8(x)))
+# define cbd_finish_hi(x)   reduce_signed(vmovl_high_s8(x))
+
+/* Each byte gives two coefficients, from its low and its high nibble */
+static void cbd_2_neon(ML_KEM_SCALAR *out,
+                       const uint8_t in[4 * ML_KEM_DEGREE / 8])
+{
+    uint8x16_t b;
+    int8x16_t c0, c1;
+    uint16x8x2_t o;
+    int i;
+
+    for (i = 0; i < 4 * ML_KEM_DEGREE / 8; i += 16) {
+        b = vld1q_u8(in + i);
+        c0 = vsubq_s8(popcnt(b, 0x03), popcnt(b, 0x0c));
+        c1 = vsubq_s8(popcnt(b, 0x30), popcnt(b, 0xc0));
+
+        o.val[0] = cbd_finish_lo(c0);
+        o.val[1] = cbd_finish_lo(c1);
+        vst2q_u16(out->c + 2 * i, o);
+        o.val[0] = cbd_finish_hi(c0);
+        o.val[1] = cbd_finish_hi(c1);
+        vst2q_u16(out->c + 2 * i + 16, o);
+    }
+}
+
+/*
+ * Each 3 bytes give four coefficients, from bit fields of 3 bits which
+ * partly straddle the byte boundaries.  The structure load puts the first,
+ * second and third bytes of 16 groups in separate registers.
+ */
+static void cbd_3_neon(ML_KEM_SCALAR *out,
+                       const uint8_t in[6 * ML_KEM_DEGREE / 8])
+{
+    uint8x16x3_t b;
+    int8x16_t c[4];
+    uint16x8x4_t o;
+    int i, j;
+
+    for (i = 0; i < 6 * ML_KEM_DEGREE / 8; i += 48) {
+        b = vld3q_u8(in + i);
+        c[0] = vsubq_s8(popcnt(b.val[0], 0x07), popcnt(b.val[0], 0x38));
+        c[1] = vsubq_s8(vaddq_s8(popcnt(b.val[0], 0xc0),
+                                 popcnt(b.val[1], 0x01)),
+                        popcnt(b.val[1], 0x0e));
+        c[2] = vsubq_s8(vsubq_s8(popcnt(b.val[1], 0x70),
+                                 popcnt(b.val[1], 0x80)),
+                        popcnt(b.val[2], 0x03));
+        c[3] = vsubq_s8(popcnt(b.val[2], 0x1c), popcnt(b.val[2], 0xe0));
+
+        for (j = 0; j < 4; j++)
+            o.val[j] = cbd_finish_lo(c[j]);
+        vst4q_u16(out->c + 4 * i / 3, o);
+        for (j = 0; j < 4; j++)
+            o.val[j] = cbd_finish_hi(c[j]);
+        vst4q_u16(out->c + 4 * i / 3 + 32, o);
+    }
+}
+
+static const ML_KEM_SCALAR_OPS neon_ops = {
+    ntt_neon,
+    inverse_ntt_neon,
+    mult_neon,
+    mult_add_neon,
+    compress_neon,
+    decompress_neon,
+    cbd_2_neon,
+    cbd_3_neon
+};
+
+const ML_KEM_SCALAR_OPS *ossl_ml_kem_scalar_ops_simd(void)
+{
+    if ((OPENSSL_armcap_P & ARMV7_NEON) != 0)
+        return &neon_ops;
+    return NULL;
+}
+
+#else
+
+const ML_KEM_SCALAR_OPS *ossl_ml_kem_scalar_ops_simd(void)
+{
+    return NULL;
+}
+
+#endif
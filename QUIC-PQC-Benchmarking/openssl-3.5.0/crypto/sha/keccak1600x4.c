@@ -0,0 +1,206 @@
+/*
+ * Copyright 2025 The OpenSSL Project Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License 2.0 (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://www.openssl.org/source/license.html
+ */
+
+#include <string.h>
+#include "internal/cryptlib.h"
+#include "internal/sha3.h"
+
+void SHA3_squeeze(uint64_t A[5][5], unsigned char *out, size_t len, size_t r,
+                  int next);
+
+#if (defined(__x86_64) || defined(__x86_64__) || defined(_M_AMD64) \
+     || defined(_M_X64)) && (defined(__GNUC__) || defined(_MSC_VER))
+# define KECCAK1600_X4_AVX2
+#endif
+
+#ifdef KECCAK1600_X4_AVX2
+
+# include <immintrin.h>
+
+# if defined(__GNUC__)
+#  define TARGET_AVX2 __attribute__((target("avx2")))
+# else
+#  define TARGET_AVX2
+# endif
+
+static const uint64_t iotas[24] = {
+    0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808aULL,
+    0x8000000080008000ULL, 0x000000000000808bULL, 0x0000000080000001ULL,
+    0x8000000080008081ULL, 0x8000000000008009ULL, 0x000000000000008aULL,
+    0x0000000000000088ULL, 0x0000000080008009ULL, 0x000000008000000aULL,
+    0x000000008000808bULL, 0x800000000000008bULL, 0x8000000000008089ULL,
+    0x8000000000008003ULL, 0x8000000000008002ULL, 0x8000000000000080ULL,
+    0x000000000000800aULL, 0x800000008000000aULL, 0x8000000080008081ULL,
+    0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL
+};
+
+# define ROL64(x, n) \
+    _mm256_or_si256(_mm256_slli_epi64((x), (n)), _mm256_srli_epi64((x), 64 - (n)))
+
+/*
+ * Keccak-f[1600] on four states at once, each 256-bit register holding the
+ * same lane of the four states.  Lane x + 5 * y is at index x + 5 * y, as
+ * in keccak1600.c.
+ */
+static TARGET_AVX2 void KeccakF1600_x4(uint64_t L[25][4])
+{
+    __m256i A[25], B[25], C[5], D;
+    size_t i, x, y;
+
+    for (i = 0; i < 25; i++)
+        A[i] = _mm256_loadu_si256((const __m256i *)L[i]);
+
+    for (i = 0; i < 24; i++) {
+        /* Theta */
+        for (x = 0; x < 5; x++)
+            C[x] = _mm256_xor_si256(_mm256_xor_si256(A[x], A[x + 5]),
+                                    _mm256_xor_si256(_mm256_xor_si256(A[x + 10],
+                                                                      A[x + 15]),
+                                                     A[x + 20]));
+        for (x = 0; x < 5; x++) {
+            D = _mm256_xor_si256(C[(x + 4) % 5], ROL64(C[(x + 1) % 5], 1));
+            for (y = 0; y < 25; y += 5)
+                A[x + y] = _mm256_xor_si256(A[x + y], D);
+        }
+
+        /* Rho and Pi */
+        B[ 0] = A[ 0];
+        B[ 1] = ROL64(A[ 6], 44);
+        B[ 2] = ROL64(A[12], 43);
+        B[ 3] = ROL64(A[18], 21);
+        B[ 4] = ROL64(A[24], 14);
+        B[ 5] = ROL64(A[ 3], 28);
+        B[ 6] = ROL64(A[ 9], 20);
+        B[ 7] = ROL64(A[10],  3);
+        B[ 8] = ROL64(A[16], 45);
+        B[ 9] = ROL64(A[22], 61);
+        B[10] = ROL64(A[ 1],  1);
+        B[11] = ROL64(A[ 7],  6);
+        B[12] = ROL64(A[13], 25);
+        B[13] = ROL64(A[19],  8);
+        B[14] = ROL64(A[20], 18);
+        B[15] = ROL64(A[ 4], 27);
+        B[16] = ROL64(A[ 5], 36);
+        B[17] = ROL64(A[11], 10);
+        B[18] = ROL64(A[17], 15);
+        B[19] = ROL64(A[23], 56);
+        B[20] = ROL64(A[ 2], 62);
+        B[21] = ROL64(A[ 8], 55);
+        B[22] = ROL64(A[14], 39);
+        B[23] = ROL64(A[15], 41);
+        B[24] = ROL64(A[21],  2);
+
+        /* Chi */
+        for (y = 0; y < 25; y += 5)
+            for (x = 0; x < 5; x++)
+                A[x + y] = _mm256_xor_si256(B[x + y],
+                                            _mm256_andnot_si256(B[(x + 1) % 5 + y],
+                                                                B[(x + 2) % 5 + y]));
+
+        /* Iota */
+        A[0] = _mm256_xor_si256(A[0], _mm256_set1_epi64x((long long)iotas[i]));
+    }
+
+    for (i = 0; i < 25; i++)
+        _mm256_storeu_si256((__m256i *)L[i], A[i]);
+}
+
+/* XOR a whole block of each input into the interleaved states */
+static void absorb_block_x4(KECCAK1600_X4_CTX *ctx,
+                            const unsigned char *const in[4], size_t off)
+{
+    size_t i, j;
+    uint64_t w;
+
+    for (i = 0; i < ctx->block_size / 8; i++) {
+        for (j = 0; j < 4; j++) {
+            memcpy(&w, in[j] + off + 8 * i, 8);
+            ctx->st.L[i][j] ^= w;
+        }
+    }
+    KeccakF1600_x4(ctx->st.L);
+}
+
+#endif
+
+void ossl_shake_x4_init(KECCAK1600_X4_CTX *ctx, size_t bitlen)
+{
+    memset(&ctx->st, 0, sizeof(ctx->st));
+    ctx->block_size = SHA3_BLOCKSIZE(bitlen);
+    ctx->next = 0;
+#ifdef KECCAK1600_X4_AVX2
+    /* AVX2, CPUID.(EAX=7):EBX bit 5 */
+    ctx->simd = (OPENSSL_ia32cap_P[2] & (1 << 5)) != 0;
+#else
+    ctx->simd = 0;
+#endif
+}
+
+void ossl_shake_x4_absorb(KECCAK1600_X4_CTX *ctx,
+                          const unsigned char *const in[4], size_t len)
+{
+    size_t bsz = ctx->block_size, rem = len % bsz;
+    unsigned char last[4][KECCAK1600_WIDTH / 8];
+    size_t j;
+
+    /* The padded final block of each input */
+    for (j = 0; j < 4; j++) {
+        memset(last[j], 0, bsz);
+        memcpy(last[j], in[j] + len - rem, rem);
+        last[j][rem] = SHAKE_PAD;
+        last[j][bsz - 1] |= 0x80;
+    }
+
+#ifdef KECCAK1600_X4_AVX2
+    if (ctx->simd) {
+        const unsigned char *const p[4] = { last[0], last[1], last[2], last[3] };
+        size_t off;
+
+        for (off = 0; off < len - rem; off += bsz)
+            absorb_block_x4(ctx, in, off);
+        absorb_block_x4(ctx, p, 0);
+        return;
+    }
+#endif
+    for (j = 0; j < 4; j++) {
+        (void)SHA3_absorb(ctx->st.A[j], in[j], len - rem, bsz);
+        (void)SHA3_absorb(ctx->st.A[j], last[j], bsz, bsz);
+    }
+}
+
+void ossl_shake_x4_squeeze(KECCAK1600_X4_CTX *ctx, unsigned char *const out[4],
+                           size_t len)
+{
+    size_t bsz = ctx->block_size;
+    size_t j;
+
+#ifdef KECCAK1600_X4_AVX2
+    if (ctx->simd) {
+        size_t off = 0, n, i, k;
+
+        while (off < len) {
+            if (ctx->next)
+                KeccakF1600_x4(ctx->st.L);
+            ctx->next = 1;
+            n = len - off < bsz ? len - off : bsz;
+            for (j = 0; j < 4; j++) {
+                for (i = 0; i < n / 8; i++)
+                    memcpy(out[j] + off + 8 * i, &ctx->st.L[i][j], 8);
+                for (k = 8 * i; k < n; k++)
+                    out[j][off + k] = (unsigned char)(ctx->st.L[i][j] >> (8 * (k % 8)));
+            }
+            off += n;
+        }
+        return;
+    }
+#endif
+    for (j = 0; j < 4; j++)
+        SHA3_squeeze(ctx->st.A[j], out[j], len, bsz, ctx->next);
+    ctx->next = 1;
+}
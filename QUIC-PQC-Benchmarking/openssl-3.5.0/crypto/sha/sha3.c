@@ -40,6 +40,21 @@ int ossl_sha3_init(KECCAK1600_CTX *ctx, unsigned char pad, size_t bitlen)
     return 0;
 }
 
+/*
+ * Unlike ossl_sha3_init() this always clears the state, as the s390x KIMD
+ * path which relies on it not being cleared is only used by the provider.
+ */
+void ossl_sha3_direct_init(KECCAK1600_CTX *ctx, unsigned char pad,
+                           size_t bitlen)
+{
+    memset(ctx->A, 0, sizeof(ctx->A));
+    ctx->bufsz = 0;
+    ctx->xof_state = XOF_STATE_INIT;
+    ctx->block_size = SHA3_BLOCKSIZE(bitlen);
+    ctx->md_size = bitlen / 8;
+    ctx->pad = pad;
+}
+
 int ossl_keccak_init(KECCAK1600_CTX *ctx, unsigned char pad, size_t bitlen, size_t mdlen)
 {
     int ret = ossl_sha3_init(ctx, pad, bitlen);
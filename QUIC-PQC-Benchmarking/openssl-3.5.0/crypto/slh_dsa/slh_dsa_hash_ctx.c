@@ -6,12 +6,40 @@
  * in the file LICENSE in the source distribution or at
  * https://www.openssl.org/source/license.html
  */
+#include "internal/deprecated.h" /* SHA256_CTX and SHA512_CTX */
+
 #include <stddef.h>
 #include <openssl/crypto.h>
+#include <openssl/sha.h>
 #include "slh_dsa_local.h"
 #include "slh_dsa_key.h"
 #include <openssl/evp.h>
 
+/*
+ * Allocates the SHA2 states after the PK.seed block, see slh_dsa_local.h.
+ * They are always computed on first use, including for a duplicate.
+ */
+static int seeded_ctx_new(SLH_DSA_HASH_CTX *ctx)
+{
+    const SLH_DSA_KEY *key = ctx->key;
+
+    ctx->seeded = 0;
+#ifndef FIPS_MODULE
+    if ((ctx->sha256_seeded = OPENSSL_malloc(sizeof(SHA256_CTX))) == NULL)
+        return 0;
+    if (key->md_big != key->md
+            && (ctx->sha512_seeded = OPENSSL_malloc(sizeof(SHA512_CTX))) == NULL)
+        return 0;
+#else
+    if ((ctx->md_seeded_ctx = EVP_MD_CTX_new()) == NULL)
+        return 0;
+    if (key->md_big != key->md
+            && (ctx->md_big_seeded_ctx = EVP_MD_CTX_new()) == NULL)
+        return 0;
+#endif
+    return 1;
+}
+
 /**
  * @brief Create a SLH_DSA_HASH_CTX that contains parameters, functions, and
  * pre-fetched HASH related objects for a SLH_DSA algorithm.This context is passed
@@ -53,6 +81,8 @@ SLH_DSA_HASH_CTX *ossl_slh_dsa_hash_ctx_new(const SLH_DSA_KEY *key)
             if (ret->hmac_ctx == NULL)
                 goto err;
         }
+        if (!seeded_ctx_new(ret))
+            goto err;
     }
     return ret;
  err:
@@ -90,6 +120,8 @@ SLH_DSA_HASH_CTX *ossl_slh_dsa_hash_ctx_dup(const SLH_DSA_HASH_CTX *src)
     if (src->hmac_ctx != NULL
             && (ret->hmac_ctx = EVP_MAC_CTX_dup(src->hmac_ctx)) == NULL)
         goto err;
+    if (src->key->md_big != NULL && !seeded_ctx_new(ret))
+        goto err;
     return ret;
  err:
     ossl_slh_dsa_hash_ctx_free(ret);
@@ -109,5 +141,12 @@ void ossl_slh_dsa_hash_ctx_free(SLH_DSA_HASH_CTX *ctx)
     if (ctx->md_big_ctx != ctx->md_ctx)
         EVP_MD_CTX_free(ctx->md_big_ctx);
     EVP_MAC_CTX_free(ctx->hmac_ctx);
+#ifndef FIPS_MODULE
+    OPENSSL_free(ctx->sha256_seeded);
+    OPENSSL_free(ctx->sha512_seeded);
+#else
+    EVP_MD_CTX_free(ctx->md_seeded_ctx);
+    EVP_MD_CTX_free(ctx->md_big_seeded_ctx);
+#endif
     OPENSSL_free(ctx);
 }
@@ -24,6 +24,11 @@
  * by 3 Integers for the checksum of these values.
  */
 #define SLH_WOTS_LEN(n) (2 * (n) + 3)
+/*
+ * Merkle subtrees up to this height are computed a level at a time, so that
+ * the independent hashes within a level can be batched (see SLH_HASH_BATCH).
+ */
+#define SLH_TREE_BATCH_HEIGHT 4
 
 /*
  * FIPS 205 SLH-DSA algorithms have many different parameters which includes
@@ -51,6 +56,22 @@ struct slh_dsa_hash_ctx_st {
     EVP_MD_CTX *md_big_ctx; /* Either SHA-512 or points to |md_ctx| for SHA-256*/
     EVP_MAC_CTX *hmac_ctx;  /* required by SHA algorithms for PRFmsg() */
     int hmac_digest_used;   /* Used for lazy init of hmac_ctx digest */
+    /*
+     * For SHA2 the first block hashed by F, H, T and PRF is PK.seed padded
+     * with zeros, so the state after it is computed once, on first use, for
+     * the PK.seed held in |seeded_pk_seed|.  Outside the FIPS provider the
+     * SHA-2 code is called directly, within it the EVP_MD_CTX is copied.  The
+     * big state is only allocated when it is SHA-512.
+     */
+    int seeded;
+    uint8_t seeded_pk_seed[SLH_MAX_N];
+#ifndef FIPS_MODULE
+    struct SHA256state_st *sha256_seeded;
+    struct SHA512state_st *sha512_seeded;
+#else
+    EVP_MD_CTX *md_seeded_ctx;
+    EVP_MD_CTX *md_big_seeded_ctx;
+#endif
 };
 
 __owur int ossl_slh_wots_pk_gen(SLH_DSA_HASH_CTX *ctx, const uint8_t *sk_seed,
@@ -64,6 +85,9 @@ __owur int ossl_slh_wots_pk_from_sig(SLH_DSA_HASH_CTX *ctx,
                                      const uint8_t *pk_seed, uint8_t *adrs,
                                      uint8_t *pk_out, size_t pk_out_len);
 
+__owur int ossl_slh_tree_reduce(SLH_DSA_HASH_CTX *ctx, const uint8_t *pk_seed,
+                               const uint8_t *adrs, uint8_t *nodes,
+                               uint32_t node_id, uint32_t height);
 __owur int ossl_slh_xmss_node(SLH_DSA_HASH_CTX *ctx, const uint8_t *sk_seed,
                               uint32_t node_id, uint32_t height,
                               const uint8_t *pk_seed, uint8_t *adrs,
@@ -14,11 +14,6 @@
 
 /* k = 14, 17, 22, 33, 35 (number of trees) */
 #define SLH_MAX_K           35
-/* a = 6, 8, 9, 12 or 14  - There are (2^a) merkle trees */
-#define SLH_MAX_A           9
-
-#define SLH_MAX_K_TIMES_A      (SLH_MAX_A * SLH_MAX_K)
-#define SLH_MAX_ROOTS          (SLH_MAX_K_TIMES_A * SLH_MAX_N)
 
 static void slh_base_2b(const uint8_t *in, uint32_t b, uint32_t *out, size_t out_len);
 
@@ -53,13 +48,83 @@ static int slh_fors_sk_gen(SLH_DSA_HASH_CTX *ctx, const uint8_t *sk_seed,
     return key->hash_func->PRF(ctx, pk_seed, sk_seed, sk_adrs, pk_out, pk_out_len);
 }
 
+/**
+ * @brief Computes a node of a Merkle tree a level at a time.
+ *
+ * The secret values and leaves of the subtree are generated in batches, and
+ * the levels above them are then reduced to the target node.
+ *
+ * @param ctx Contains SLH_DSA algorithm functions and constants.
+ * @param sk_seed A SLH_DSA private key seed of size |n|
+ * @param pk_seed A SLH_DSA public key seed of size |n|
+ * @param adrs The same FORS_TREE ADRS object as for slh_fors_node()
+ * @param node_id The target node index
+ * @param height The target node height, which is <= SLH_TREE_BATCH_HEIGHT
+ * @param node The returned hash for a node of size|n|
+ * @param node_len The maximum size of |node|
+ * @returns 1 on success, or 0 on error.
+ */
+static int slh_fors_subtree(SLH_DSA_HASH_CTX *ctx, const uint8_t *sk_seed,
+                            const uint8_t *pk_seed, const uint8_t *adrs,
+                            uint32_t node_id, uint32_t height,
+                            uint8_t *node, size_t node_len)
+{
+    int ret = 0;
+    const SLH_DSA_KEY *key = ctx->key;
+    uint32_t n = key->params->n;
+    uint32_t i, j, num, count = 1U << height, first = node_id << height;
+    uint8_t nodes[(1 << SLH_TREE_BATCH_HEIGHT) * SLH_MAX_N];
+    uint8_t lane_adrs[SLH_HASH_BATCH][SLH_ADRS_SIZE_MAX];
+    const uint8_t *adrs_in[SLH_HASH_BATCH], *m[SLH_HASH_BATCH];
+    uint8_t *out[SLH_HASH_BATCH];
+
+    SLH_HASH_FUNC_DECLARE(key, hashf);
+    SLH_ADRS_FUNC_DECLARE(key, adrsf);
+    SLH_ADRS_DECLARE(sk_adrs);
+
+    adrsf->copy(sk_adrs, adrs);
+    adrsf->set_type_and_clear(sk_adrs, SLH_ADRS_TYPE_FORS_PRF);
+    adrsf->copy_keypair_address(sk_adrs, adrs);
+
+    /* Generate the secret values, and then hash them in place to get the leaves */
+    for (i = 0; i < count; i += num) {
+        num = count - i < SLH_HASH_BATCH ? count - i : SLH_HASH_BATCH;
+        for (j = 0; j < num; ++j) {
+            adrsf->copy(lane_adrs[j], sk_adrs);
+            adrsf->set_tree_index(lane_adrs[j], first + i + j);
+            adrs_in[j] = lane_adrs[j];
+            m[j] = sk_seed;
+            out[j] = nodes + (i + j) * n;
+        }
+        if (!hashf->F_BATCH(ctx, pk_seed, adrs_in, m, out, num))
+            goto err;
+        for (j = 0; j < num; ++j) {
+            adrsf->copy(lane_adrs[j], adrs);
+            adrsf->set_tree_height(lane_adrs[j], 0);
+            adrsf->set_tree_index(lane_adrs[j], first + i + j);
+            m[j] = out[j];
+        }
+        if (!hashf->F_BATCH(ctx, pk_seed, adrs_in, m, out, num))
+            goto err;
+    }
+    if (!ossl_slh_tree_reduce(ctx, pk_seed, adrs, nodes, node_id, height)
+            || node_len < n)
+        goto err;
+    memcpy(node, nodes, n);
+    ret = 1;
+ err:
+    OPENSSL_cleanse(nodes, sizeof(nodes));
+    return ret;
+}
+
 /**
  * @brief Computes the nodes of a Merkle tree.
  * See FIPS 205 Section 8.2 Algorithm 18
  *
  * The leaf nodes are hashes of FORS secret values.
  * Each parent node is a hash of its 2 children.
- * Note this is a recursive function.
+ * Note this is a recursive function, down to subtrees of height
+ * SLH_TREE_BATCH_HEIGHT which are computed by slh_fors_subtree().
  *
  * @param ctx Contains SLH_DSA algorithm functions and constants.
  * @param sk_seed A SLH_DSA private key seed of size |n|
@@ -78,34 +143,23 @@ static int slh_fors_node(SLH_DSA_HASH_CTX *ctx, const uint8_t *sk_seed,
                          const uint8_t *pk_seed, uint8_t *adrs, uint32_t node_id,
                          uint32_t height, uint8_t *node, size_t node_len)
 {
-    int ret = 0;
     const SLH_DSA_KEY *key = ctx->key;
-    uint8_t sk[SLH_MAX_N], lnode[SLH_MAX_N], rnode[SLH_MAX_N];
-    uint32_t n = key->params->n;
+    uint8_t lnode[SLH_MAX_N], rnode[SLH_MAX_N];
 
     SLH_ADRS_FUNC_DECLARE(key, adrsf);
 
-    if (height == 0) {
-        /* Gets here for leaf nodes */
-        if (!slh_fors_sk_gen(ctx, sk_seed, pk_seed, adrs, node_id, sk, sizeof(sk)))
-            return 0;
-        adrsf->set_tree_height(adrs, 0);
-        adrsf->set_tree_index(adrs, node_id);
-        ret = key->hash_func->F(ctx, pk_seed, adrs, sk, n, node, node_len);
-        OPENSSL_cleanse(sk, n);
-        return ret;
-    } else {
-        if (!slh_fors_node(ctx, sk_seed, pk_seed, adrs, 2 * node_id, height - 1,
-                           lnode, sizeof(rnode))
-                || !slh_fors_node(ctx, sk_seed, pk_seed, adrs, 2 * node_id + 1,
-                                  height - 1, rnode, sizeof(rnode)))
-            return 0;
-        adrsf->set_tree_height(adrs, height);
-        adrsf->set_tree_index(adrs, node_id);
-        if (!key->hash_func->H(ctx, pk_seed, adrs, lnode, rnode, node, node_len))
-            return 0;
-    }
-    return 1;
+    if (height <= SLH_TREE_BATCH_HEIGHT)
+        return slh_fors_subtree(ctx, sk_seed, pk_seed, adrs, node_id, height,
+                                node, node_len);
+
+    if (!slh_fors_node(ctx, sk_seed, pk_seed, adrs, 2 * node_id, height - 1,
+                       lnode, sizeof(lnode))
+            || !slh_fors_node(ctx, sk_seed, pk_seed, adrs, 2 * node_id + 1,
+                              height - 1, rnode, sizeof(rnode)))
+        return 0;
+    adrsf->set_tree_height(adrs, height);
+    adrsf->set_tree_index(adrs, node_id);
+    return key->hash_func->H(ctx, pk_seed, adrs, lnode, rnode, node, node_len);
 }
 
 /**
@@ -212,83 +266,83 @@ int ossl_slh_fors_pk_from_sig(SLH_DSA_HASH_CTX *ctx, PACKET *fors_sig_rpkt,
                               uint8_t *adrs, uint8_t *pk_out, size_t pk_out_len)
 {
     const SLH_DSA_KEY *key = ctx->key;
-    int ret = 0;
-    uint32_t i, j, aoff = 0;
+    uint32_t i, j, l, num;
     uint32_t ids[SLH_MAX_K];
     const SLH_DSA_PARAMS *params = key->params;
     uint32_t a = params->a;
     uint32_t k = params->k;
     uint32_t n = params->n;
-    uint32_t two_power_a = (1 << a);
-    const uint8_t *sk, *authj; /* Pointers to |sig| buffer inside fors_sig_rpkt */
-    uint8_t roots[SLH_MAX_ROOTS];
-    size_t roots_len = 0; /* The size of |roots| */
-    uint8_t *node0, *node1; /* Pointers into roots[] */
-    WPACKET root_pkt, *wroot_pkt = &root_pkt; /* Points to |roots| buffer */
+    size_t tree_len = (a + 1) * n; /* The sk value and auth path of a tree */
+    const uint8_t *sig; /* Pointer to the |sig| buffer inside fors_sig_rpkt */
+    uint8_t roots[SLH_MAX_K * SLH_MAX_N];
+    uint8_t lane_adrs[SLH_HASH_BATCH][SLH_ADRS_SIZE_MAX];
+    const uint8_t *adrs_in[SLH_HASH_BATCH];
+    const uint8_t *m1[SLH_HASH_BATCH], *m2[SLH_HASH_BATCH];
+    uint8_t *out[SLH_HASH_BATCH];
 
     SLH_ADRS_DECLARE(pk_adrs);
     SLH_ADRS_FUNC_DECLARE(key, adrsf);
     SLH_ADRS_FN_DECLARE(adrsf, set_tree_index);
     SLH_ADRS_FN_DECLARE(adrsf, set_tree_height);
     SLH_HASH_FUNC_DECLARE(key, hashf);
-    SLH_HASH_FN_DECLARE(hashf, F);
-    SLH_HASH_FN_DECLARE(hashf, H);
+    SLH_HASH_FN_DECLARE(hashf, F_BATCH);
+    SLH_HASH_FN_DECLARE(hashf, H_BATCH);
 
-    if (!WPACKET_init_static_len(wroot_pkt, roots, sizeof(roots), 0))
+    if (!PACKET_get_bytes(fors_sig_rpkt, &sig, k * tree_len))
         return 0;
 
     /* Split md into k a-bit values e.g ids[0..k-1] = 12 bits each of md */
     slh_base_2b(md, a, ids, k);
 
-    /* Compute the roots of k Merkle trees */
-    for (i = 0; i < k; ++i) {
-        uint32_t id = ids[i];
-        uint32_t node_id = id + aoff;
+    for (i = 0; i < SLH_HASH_BATCH; ++i)
+        adrs_in[i] = lane_adrs[i];
 
-        set_tree_height(adrs, 0);
-        set_tree_index(adrs, node_id);
+    /*
+     * Compute the roots of the k Merkle trees. The trees are independent, so
+     * each level is computed for up to SLH_HASH_BATCH trees at a time.
+     * Tree i uses the node indexes (i << (a - height)) + (0..) at each height.
+     * This omits the copying of the nodes that the FIPS 205 code does.
+     */
+    for (i = 0; i < k; i += num) {
+        num = k - i < SLH_HASH_BATCH ? k - i : SLH_HASH_BATCH;
 
-        /* Regenerate the public key of the leaf */
-        if (!PACKET_get_bytes(fors_sig_rpkt, &sk, n)
-                || !WPACKET_allocate_bytes(wroot_pkt, n, &node0)
-                || !F(ctx, pk_seed, adrs, sk, n, node0, n))
-            goto err;
+        /* Regenerate the public keys of the leaves */
+        for (l = 0; l < num; ++l) {
+            adrsf->copy(lane_adrs[l], adrs);
+            set_tree_height(lane_adrs[l], 0);
+            set_tree_index(lane_adrs[l], ((i + l) << a) + ids[i + l]);
+            m1[l] = sig + (i + l) * tree_len;
+            out[l] = roots + (i + l) * n;
+        }
+        if (!F_BATCH(ctx, pk_seed, adrs_in, m1, out, num))
+            return 0;
 
-        /* This omits the copying of the nodes that the FIPS 205 code does */
-        node1 = node0;
+        /* Hash each node with the other child from the authentication path */
         for (j = 0; j < a; ++j) {
-            /* Get this layers other child public key */
-            if (!PACKET_get_bytes(fors_sig_rpkt, &authj, n))
-                goto err;
-            /* Hash the children together to get the parent nodes public key */
-            set_tree_height(adrs, j + 1);
-            if ((id & 1) == 0) {
-                node_id >>= 1;
-                set_tree_index(adrs, node_id);
-                if (!H(ctx, pk_seed, adrs, node0, authj, node1, n))
-                    goto err;
-            } else {
-                node_id = (node_id - 1) >> 1;
-                set_tree_index(adrs, node_id);
-                if (!H(ctx, pk_seed, adrs, authj, node0, node1, n))
-                    goto err;
+            for (l = 0; l < num; ++l) {
+                uint32_t node_id = ((i + l) << a) + ids[i + l];
+                const uint8_t *authj = sig + (i + l) * tree_len + (j + 1) * n;
+
+                set_tree_height(lane_adrs[l], j + 1);
+                set_tree_index(lane_adrs[l], node_id >> (j + 1));
+                if (((node_id >> j) & 1) == 0) {
+                    m1[l] = out[l];
+                    m2[l] = authj;
+                } else {
+                    m1[l] = authj;
+                    m2[l] = out[l];
+                }
             }
-            id >>= 1;
+            if (!H_BATCH(ctx, pk_seed, adrs_in, m1, m2, out, num))
+                return 0;
         }
-        aoff += two_power_a;
     }
-    if (!WPACKET_get_total_written(wroot_pkt, &roots_len))
-        goto err;
 
     /* The public key is the hash of all the roots of the k trees */
     adrsf->copy(pk_adrs, adrs);
     adrsf->set_type_and_clear(pk_adrs, SLH_ADRS_TYPE_FORS_ROOTS);
     adrsf->copy_keypair_address(pk_adrs, adrs);
-    ret = hashf->T(ctx, pk_seed, pk_adrs, roots, roots_len, pk_out, pk_out_len);
- err:
-    if (!WPACKET_finish(wroot_pkt))
-        ret = 0;
-    return ret;
+    return hashf->T(ctx, pk_seed, pk_adrs, roots, k * n, pk_out, pk_out_len);
 }
 
 /**
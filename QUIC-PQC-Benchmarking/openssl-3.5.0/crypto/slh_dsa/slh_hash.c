@@ -10,20 +10,53 @@
 #include "internal/deprecated.h" /* PKCS1_MGF1() */
 
 #include <string.h>
+#include <openssl/byteorder.h>
 #include <openssl/evp.h>
 #include <openssl/core_names.h>
 #include <openssl/rsa.h> /* PKCS1_MGF1() */
+#include <openssl/sha.h>
+#include "internal/cryptlib.h"
+#include "internal/sha3.h"
 #include "slh_dsa_local.h"
 #include "slh_dsa_key.h"
 
 #define MAX_DIGEST_SIZE 64 /* SHA-512 is used for security category 3 & 5 */
 
+/*
+ * Outside the FIPS provider batches of F and H are computed several at a
+ * time: for SHAKE four at once with keccak1600x4.c, and for SHA-256 with the
+ * multi-buffer code of sha256-mb-x86_64.pl.  The FIPS provider computes them
+ * one after the other.
+ */
+#ifndef FIPS_MODULE
+# define SLH_SHAKE_X4
+# if defined(SHA256_ASM) && (defined(__x86_64) || defined(__x86_64__) \
+                             || defined(_M_AMD64) || defined(_M_X64))
+#  define SLH_SHA256_MB
+# endif
+#endif
+
+#ifdef SLH_SHA256_MB
+/* The lanes of word i of the state are h[i][0..7], see sha256-mb-x86_64.pl */
+typedef struct {
+    unsigned int h[8][8];
+} SHA256_MB_CTX;
+typedef struct {
+    const unsigned char *ptr;
+    int blocks;
+} HASH_DESC;
+
+void sha256_multi_block(SHA256_MB_CTX *, const HASH_DESC *, int);
+#endif
+
 static OSSL_SLH_HASHFUNC_H_MSG slh_hmsg_sha2;
 static OSSL_SLH_HASHFUNC_PRF slh_prf_sha2;
 static OSSL_SLH_HASHFUNC_PRF_MSG slh_prf_msg_sha2;
 static OSSL_SLH_HASHFUNC_F slh_f_sha2;
 static OSSL_SLH_HASHFUNC_H slh_h_sha2;
 static OSSL_SLH_HASHFUNC_T slh_t_sha2;
+static OSSL_SLH_HASHFUNC_F_BATCH slh_f_batch_sha2;
+static OSSL_SLH_HASHFUNC_H_BATCH slh_h_batch_sha2;
 
 static OSSL_SLH_HASHFUNC_H_MSG slh_hmsg_shake;
 static OSSL_SLH_HASHFUNC_PRF slh_prf_shake;
@@ -31,18 +64,38 @@ static OSSL_SLH_HASHFUNC_PRF_MSG slh_prf_msg_shake;
 static OSSL_SLH_HASHFUNC_F slh_f_shake;
 static OSSL_SLH_HASHFUNC_H slh_h_shake;
 static OSSL_SLH_HASHFUNC_T slh_t_shake;
+static OSSL_SLH_HASHFUNC_F_BATCH slh_f_batch_shake;
+static OSSL_SLH_HASHFUNC_H_BATCH slh_h_batch_shake;
 
+/*
+ * Outside the FIPS provider SHAKE256 is computed by calling the Keccak code
+ * directly, as EVP dispatch costs more than hashing the short inputs of F, H,
+ * T and PRF.  The state is cleansed, since it can hold secret seeds or chain
+ * values.
+ */
 static ossl_inline int xof_digest_3(EVP_MD_CTX *ctx,
                                     const uint8_t *in1, size_t in1_len,
                                     const uint8_t *in2, size_t in2_len,
                                     const uint8_t *in3, size_t in3_len,
                                     uint8_t *out, size_t out_len)
 {
+#ifndef FIPS_MODULE
+    KECCAK1600_CTX kctx;
+
+    ossl_sha3_direct_init(&kctx, SHAKE_PAD, 256);
+    (void)ossl_sha3_update(&kctx, in1, in1_len);
+    (void)ossl_sha3_update(&kctx, in2, in2_len);
+    (void)ossl_sha3_update(&kctx, in3, in3_len);
+    (void)ossl_sha3_final(&kctx, out, out_len);
+    OPENSSL_cleanse(&kctx, sizeof(kctx));
+    return 1;
+#else
     return (EVP_DigestInit_ex2(ctx, NULL, NULL) == 1
             && EVP_DigestUpdate(ctx, in1, in1_len) == 1
             && EVP_DigestUpdate(ctx, in2, in2_len) == 1
             && EVP_DigestUpdate(ctx, in3, in3_len) == 1
             && EVP_DigestFinalXOF(ctx, out, out_len) == 1);
+#endif
 }
 
 static ossl_inline int xof_digest_4(EVP_MD_CTX *ctx,
@@ -52,12 +105,25 @@ static ossl_inline int xof_digest_4(EVP_MD_CTX *ctx,
                                     const uint8_t *in4, size_t in4_len,
                                     uint8_t *out, size_t out_len)
 {
+#ifndef FIPS_MODULE
+    KECCAK1600_CTX kctx;
+
+    ossl_sha3_direct_init(&kctx, SHAKE_PAD, 256);
+    (void)ossl_sha3_update(&kctx, in1, in1_len);
+    (void)ossl_sha3_update(&kctx, in2, in2_len);
+    (void)ossl_sha3_update(&kctx, in3, in3_len);
+    (void)ossl_sha3_update(&kctx, in4, in4_len);
+    (void)ossl_sha3_final(&kctx, out, out_len);
+    OPENSSL_cleanse(&kctx, sizeof(kctx));
+    return 1;
+#else
     return (EVP_DigestInit_ex2(ctx, NULL, NULL) == 1
             && EVP_DigestUpdate(ctx, in1, in1_len) == 1
             && EVP_DigestUpdate(ctx, in2, in2_len) == 1
             && EVP_DigestUpdate(ctx, in3, in3_len) == 1
             && EVP_DigestUpdate(ctx, in4, in4_len) == 1
             && EVP_DigestFinalXOF(ctx, out, out_len) == 1);
+#endif
 }
 
 /* See FIPS 205 Section 11.1 */
@@ -205,16 +271,97 @@ slh_prf_msg_sha2(SLH_DSA_HASH_CTX *hctx,
     return ret;
 }
 
+/*
+ * Sets the SHA2 states after PK.seed || toByte(0, b - n) for both block sizes
+ * |b|, unless they are already set for this |pk_seed|.  PK.seed is normally
+ * fixed for the context, but key generation only creates it after the context.
+ */
+static int sha2_seed(SLH_DSA_HASH_CTX *hctx, const uint8_t *pk_seed, size_t n)
+{
+    static const uint8_t zeros[128] = { 0 };
+
+    if (hctx->seeded && memcmp(hctx->seeded_pk_seed, pk_seed, n) == 0)
+        return 1;
+    hctx->seeded = 0;
+#ifndef FIPS_MODULE
+    if (!SHA256_Init(hctx->sha256_seeded)
+            || !SHA256_Update(hctx->sha256_seeded, pk_seed, n)
+            || !SHA256_Update(hctx->sha256_seeded, zeros, SHA256_CBLOCK - n))
+        return 0;
+    if (hctx->sha512_seeded != NULL
+            && (!SHA512_Init(hctx->sha512_seeded)
+                || !SHA512_Update(hctx->sha512_seeded, pk_seed, n)
+                || !SHA512_Update(hctx->sha512_seeded, zeros,
+                                  SHA512_CBLOCK - n)))
+        return 0;
+#else
+    if (EVP_DigestInit_ex2(hctx->md_seeded_ctx, hctx->key->md, NULL) != 1
+            || EVP_DigestUpdate(hctx->md_seeded_ctx, pk_seed, n) != 1
+            || EVP_DigestUpdate(hctx->md_seeded_ctx, zeros,
+                                OSSL_SLH_DSA_SHA2_NUM_ZEROS_H_AND_T_BOUND1 - n) != 1)
+        return 0;
+    if (hctx->md_big_seeded_ctx != NULL
+            && (EVP_DigestInit_ex2(hctx->md_big_seeded_ctx, hctx->key->md_big,
+                                   NULL) != 1
+                || EVP_DigestUpdate(hctx->md_big_seeded_ctx, pk_seed, n) != 1
+                || EVP_DigestUpdate(hctx->md_big_seeded_ctx, zeros,
+                                    hctx->key->params->sha2_h_and_t_bound - n) != 1))
+        return 0;
+#endif
+    memcpy(hctx->seeded_pk_seed, pk_seed, n);
+    hctx->seeded = 1;
+    return 1;
+}
+
+/*
+ * Computes Trunc_n(SHA-X(PK.seed || toByte(0, b - n) || ADRSc || M)) where
+ * SHA-X is SHA-256 for a block size |b| of 64 and SHA-512 for 128, resuming
+ * from the state after the first block.
+ */
 static ossl_inline int
-do_hash(EVP_MD_CTX *ctx, size_t n, const uint8_t *pk_seed, const uint8_t *adrs,
-        const uint8_t *m, size_t m_len, size_t b, uint8_t *out, size_t out_len)
+do_hash(SLH_DSA_HASH_CTX *hctx, size_t n, const uint8_t *pk_seed,
+        const uint8_t *adrs, const uint8_t *m, size_t m_len, size_t b,
+        uint8_t *out, size_t out_len)
 {
     int ret;
-    uint8_t zeros[128] = { 0 };
     uint8_t digest[MAX_DIGEST_SIZE];
-
-    ret = digest_4(ctx, pk_seed, n, zeros, b - n, adrs, SLH_ADRSC_SIZE,
-                   m, m_len, digest);
+#ifndef FIPS_MODULE
+    union {
+        SHA256_CTX sha256;
+        SHA512_CTX sha512;
+    } c;
+
+    if (!sha2_seed(hctx, pk_seed, n))
+        return 0;
+    if (b == OSSL_SLH_DSA_SHA2_NUM_ZEROS_H_AND_T_BOUND1) {
+        c.sha256 = *hctx->sha256_seeded;
+        ret = SHA256_Update(&c.sha256, adrs, SLH_ADRSC_SIZE)
+            && SHA256_Update(&c.sha256, m, m_len)
+            && SHA256_Final(digest, &c.sha256);
+    } else {
+        c.sha512 = *hctx->sha512_seeded;
+        ret = SHA512_Update(&c.sha512, adrs, SLH_ADRSC_SIZE)
+            && SHA512_Update(&c.sha512, m, m_len)
+            && SHA512_Final(digest, &c.sha512);
+    }
+    /* The message can be a secret seed or chain value */
+    OPENSSL_cleanse(&c, sizeof(c));
+#else
+    EVP_MD_CTX *ctx, *seeded;
+
+    if (b == OSSL_SLH_DSA_SHA2_NUM_ZEROS_H_AND_T_BOUND1) {
+        ctx = hctx->md_ctx;
+        seeded = hctx->md_seeded_ctx;
+    } else {
+        ctx = hctx->md_big_ctx;
+        seeded = hctx->md_big_seeded_ctx;
+    }
+    ret = sha2_seed(hctx, pk_seed, n)
+        && EVP_MD_CTX_copy_ex(ctx, seeded) == 1
+        && EVP_DigestUpdate(ctx, adrs, SLH_ADRSC_SIZE) == 1
+        && EVP_DigestUpdate(ctx, m, m_len) == 1
+        && EVP_DigestFinal_ex(ctx, digest, NULL) == 1;
+#endif
     /* Truncated returned value is n = 16 bytes */
     memcpy(out, digest, n);
     return ret;
@@ -227,7 +374,7 @@ slh_prf_sha2(SLH_DSA_HASH_CTX *hctx, const uint8_t *pk_seed,
 {
     size_t n = hctx->key->params->n;
 
-    return do_hash(hctx->md_ctx, n, pk_seed, adrs, sk_seed, n,
+    return do_hash(hctx, n, pk_seed, adrs, sk_seed, n,
                    OSSL_SLH_DSA_SHA2_NUM_ZEROS_H_AND_T_BOUND1, out, out_len);
 }
 
@@ -235,7 +382,7 @@ static int
 slh_f_sha2(SLH_DSA_HASH_CTX *hctx, const uint8_t *pk_seed, const uint8_t *adrs,
            const uint8_t *m1, size_t m1_len, uint8_t *out, size_t out_len)
 {
-    return do_hash(hctx->md_ctx, hctx->key->params->n, pk_seed, adrs, m1, m1_len,
+    return do_hash(hctx, hctx->key->params->n, pk_seed, adrs, m1, m1_len,
                    OSSL_SLH_DSA_SHA2_NUM_ZEROS_H_AND_T_BOUND1, out, out_len);
 }
 
@@ -249,7 +396,7 @@ slh_h_sha2(SLH_DSA_HASH_CTX *hctx, const uint8_t *pk_seed, const uint8_t *adrs,
 
     memcpy(m, m1, n);
     memcpy(m + n, m2, n);
-    return do_hash(hctx->md_big_ctx, n, pk_seed, adrs, m, 2 * n,
+    return do_hash(hctx, n, pk_seed, adrs, m, 2 * n,
                    prms->sha2_h_and_t_bound, out, out_len);
 }
 
@@ -259,10 +406,195 @@ slh_t_sha2(SLH_DSA_HASH_CTX *hctx, const uint8_t *pk_seed, const uint8_t *adrs,
 {
     const SLH_DSA_PARAMS *prms = hctx->key->params;
 
-    return do_hash(hctx->md_big_ctx, prms->n, pk_seed, adrs, ml, ml_len,
+    return do_hash(hctx, prms->n, pk_seed, adrs, ml, ml_len,
                    prms->sha2_h_and_t_bound, out, out_len);
 }
 
+/* Computes a batch of F one call at a time */
+static ossl_unused int
+f_serial(SLH_DSA_HASH_CTX *ctx, OSSL_SLH_HASHFUNC_F *F, const uint8_t *pk_seed,
+         const uint8_t *const adrs[], const uint8_t *const m1[],
+         uint8_t *const out[], size_t num)
+{
+    size_t i, n = ctx->key->params->n;
+
+    for (i = 0; i < num; i++)
+        if (!F(ctx, pk_seed, adrs[i], m1[i], n, out[i], n))
+            return 0;
+    return 1;
+}
+
+/* Computes a batch of H one call at a time */
+static ossl_unused int
+h_serial(SLH_DSA_HASH_CTX *ctx, OSSL_SLH_HASHFUNC_H *H, const uint8_t *pk_seed,
+         const uint8_t *const adrs[], const uint8_t *const m1[],
+         const uint8_t *const m2[], uint8_t *const out[], size_t num)
+{
+    size_t i, n = ctx->key->params->n;
+
+    for (i = 0; i < num; i++)
+        if (!H(ctx, pk_seed, adrs[i], m1[i], m2[i], out[i], n))
+            return 0;
+    return 1;
+}
+
+#ifdef SLH_SHAKE_X4
+/*
+ * SHAKE256(PK.seed || ADRS || M1 [|| M2]) for a batch, four at a time.  Any
+ * unused instances of the last group repeat the first input.
+ */
+static int shake_x4(SLH_DSA_HASH_CTX *ctx, const uint8_t *pk_seed,
+                    const uint8_t *const adrs[], const uint8_t *const m1[],
+                    const uint8_t *const m2[], uint8_t *const out[], size_t num)
+{
+    size_t n = ctx->key->params->n;
+    size_t in_len = n + SLH_ADRS_SIZE + (m2 == NULL ? n : 2 * n);
+    KECCAK1600_X4_CTX kctx;
+    uint8_t in[4][SLH_ADRS_SIZE + 3 * SLH_MAX_N], spare[SLH_MAX_N];
+    const unsigned char *const inp[4] = { in[0], in[1], in[2], in[3] };
+    unsigned char *outp[4];
+    size_t i, j, k;
+
+    for (i = 0; i < num; i += 4) {
+        for (j = 0; j < 4; j++) {
+            k = i + j < num ? i + j : i;
+            memcpy(in[j], pk_seed, n);
+            memcpy(in[j] + n, adrs[k], SLH_ADRS_SIZE);
+            memcpy(in[j] + n + SLH_ADRS_SIZE, m1[k], n);
+            if (m2 != NULL)
+                memcpy(in[j] + 2 * n + SLH_ADRS_SIZE, m2[k], n);
+            outp[j] = i + j < num ? out[i + j] : spare;
+        }
+        ossl_shake_x4_init(&kctx, 256);
+        ossl_shake_x4_absorb(&kctx, inp, in_len);
+        ossl_shake_x4_squeeze(&kctx, outp, n);
+    }
+    OPENSSL_cleanse(&kctx, sizeof(kctx));
+    OPENSSL_cleanse(in, sizeof(in));
+    OPENSSL_cleanse(spare, sizeof(spare));
+    return 1;
+}
+#endif
+
+static int
+slh_f_batch_shake(SLH_DSA_HASH_CTX *ctx, const uint8_t *pk_seed,
+                  const uint8_t *const adrs[], const uint8_t *const m1[],
+                  uint8_t *const out[], size_t num)
+{
+#ifdef SLH_SHAKE_X4
+    return shake_x4(ctx, pk_seed, adrs, m1, NULL, out, num);
+#else
+    return f_serial(ctx, slh_f_shake, pk_seed, adrs, m1, out, num);
+#endif
+}
+
+static int
+slh_h_batch_shake(SLH_DSA_HASH_CTX *ctx, const uint8_t *pk_seed,
+                  const uint8_t *const adrs[], const uint8_t *const m1[],
+                  const uint8_t *const m2[], uint8_t *const out[], size_t num)
+{
+#ifdef SLH_SHAKE_X4
+    return shake_x4(ctx, pk_seed, adrs, m1, m2, out, num);
+#else
+    return h_serial(ctx, slh_h_shake, pk_seed, adrs, m1, m2, out, num);
+#endif
+}
+
+#ifdef SLH_SHA256_MB
+/*
+ * The plain SSE code path of sha256_multi_block() uses SSSE3 instructions, so
+ * like e_aes_cbc_hmac_sha256.c only use it on SHAEXT or AVX capable CPUs.
+ */
+static int sha256_mb_capable(void)
+{
+    return (OPENSSL_ia32cap_P[2] & (1 << 29))                /* SHAEXT? */
+        || ((OPENSSL_ia32cap_P[1] & (1 << (60 - 32)))        /* AVX? */
+            && ((OPENSSL_ia32cap_P[1] & (1 << (43 - 32)))    /* XOP? */
+                | (OPENSSL_ia32cap_P[0] & (1 << 30))));      /* "Intel CPU"? */
+}
+
+/*
+ * Trunc_n(SHA-256(PK.seed || toByte(0, 64 - n) || ADRSc || M1 [|| M2])) for
+ * a batch.  Each lane resumes from the PK.seed state of sha2_seed(), and the
+ * rest, padding included, fits in one more block.  Four lanes are hashed at
+ * a time, or eight with AVX2.
+ */
+static int sha256_mb(SLH_DSA_HASH_CTX *ctx, const uint8_t *pk_seed,
+                     const uint8_t *const adrs[], const uint8_t *const m1[],
+                     const uint8_t *const m2[], uint8_t *const out[],
+                     size_t num)
+{
+    size_t n = ctx->key->params->n;
+    size_t len = SLH_ADRSC_SIZE + (m2 == NULL ? n : 2 * n);
+    uint64_t bits = (uint64_t)(SHA256_CBLOCK + len) * 8;
+    /* AVX2, CPUID.(EAX=7):EBX bit 5 */
+    int n4x = num > 4 && (OPENSSL_ia32cap_P[2] & (1 << 5)) != 0 ? 2 : 1;
+    size_t lanes = 4 * (size_t)n4x;
+    SHA256_MB_CTX mb;
+    HASH_DESC desc[8];
+    unsigned char blocks[8][SHA256_CBLOCK];
+    const SHA256_CTX *seeded;
+    size_t i, j, w;
+
+    if (!sha2_seed(ctx, pk_seed, n))
+        return 0;
+    seeded = ctx->sha256_seeded;
+
+    memset(blocks, 0, sizeof(blocks));
+    for (i = 0; i < num; i += lanes) {
+        for (j = 0; j < lanes; j++) {
+            unsigned char *b = blocks[j];
+
+            for (w = 0; w < 8; w++)
+                mb.h[w][j] = seeded->h[w];
+            desc[j].ptr = b;
+            desc[j].blocks = i + j < num;
+            if (i + j >= num)
+                continue;
+            memcpy(b, adrs[i + j], SLH_ADRSC_SIZE);
+            memcpy(b + SLH_ADRSC_SIZE, m1[i + j], n);
+            if (m2 != NULL)
+                memcpy(b + SLH_ADRSC_SIZE + n, m2[i + j], n);
+            b[len] = 0x80;
+            for (w = 0; w < 8; w++)
+                b[SHA256_CBLOCK - 1 - w] = (unsigned char)(bits >> (8 * w));
+        }
+        sha256_multi_block(&mb, desc, n4x);
+        for (j = 0; j < lanes && i + j < num; j++)
+            for (w = 0; w < n / 4; w++)
+                OPENSSL_store_u32_be(out[i + j] + 4 * w, mb.h[w][j]);
+    }
+    OPENSSL_cleanse(blocks, sizeof(blocks));
+    OPENSSL_cleanse(&mb, sizeof(mb));
+    return 1;
+}
+#endif
+
+static int
+slh_f_batch_sha2(SLH_DSA_HASH_CTX *ctx, const uint8_t *pk_seed,
+                 const uint8_t *const adrs[], const uint8_t *const m1[],
+                 uint8_t *const out[], size_t num)
+{
+#ifdef SLH_SHA256_MB
+    if (sha256_mb_capable())
+        return sha256_mb(ctx, pk_seed, adrs, m1, NULL, out, num);
+#endif
+    return f_serial(ctx, slh_f_sha2, pk_seed, adrs, m1, out, num);
+}
+
+static int
+slh_h_batch_sha2(SLH_DSA_HASH_CTX *ctx, const uint8_t *pk_seed,
+                 const uint8_t *const adrs[], const uint8_t *const m1[],
+                 const uint8_t *const m2[], uint8_t *const out[], size_t num)
+{
+#ifdef SLH_SHA256_MB
+    /* H is SHA-512 for security categories 3 and 5 */
+    if (ctx->sha512_seeded == NULL && sha256_mb_capable())
+        return sha256_mb(ctx, pk_seed, adrs, m1, m2, out, num);
+#endif
+    return h_serial(ctx, slh_h_sha2, pk_seed, adrs, m1, m2, out, num);
+}
+
 const SLH_HASH_FUNC *ossl_slh_get_hash_fn(int is_shake)
 {
     static const SLH_HASH_FUNC methods[] = {
@@ -272,7 +604,9 @@ const SLH_HASH_FUNC *ossl_slh_get_hash_fn(int is_shake)
             slh_prf_msg_shake,
             slh_f_shake,
             slh_h_shake,
-            slh_t_shake
+            slh_t_shake,
+            slh_f_batch_shake,
+            slh_h_batch_shake
         },
         {
             slh_hmsg_sha2,
@@ -280,7 +614,9 @@ const SLH_HASH_FUNC *ossl_slh_get_hash_fn(int is_shake)
             slh_prf_msg_sha2,
             slh_f_sha2,
             slh_h_sha2,
-            slh_t_sha2
+            slh_t_sha2,
+            slh_f_batch_sha2,
+            slh_h_batch_sha2
         }
     };
     return &methods[is_shake ? 0 : 1];
@@ -52,6 +52,28 @@ typedef int (OSSL_SLH_HASHFUNC_T)(SLH_DSA_HASH_CTX *ctx, const uint8_t *pk_seed,
                                   const uint8_t *m1, size_t m1_len,
                                   uint8_t *out, size_t out_len);
 
+/*
+ * Batched forms of F and H, which compute up to SLH_HASH_BATCH independent
+ * values with the same PK.seed, each with its own ADRS and |n| byte messages,
+ * e.g. for the steps of different WOTS+ chains or for sibling tree nodes.
+ * |out[i]| may be the same as |m1[i]| (or |m2[i]|).  PRF has the same form as
+ * F, with SK.seed as the message, so batches of PRF values also use F_BATCH.
+ */
+# define SLH_HASH_BATCH 8
+
+typedef int (OSSL_SLH_HASHFUNC_F_BATCH)(SLH_DSA_HASH_CTX *ctx,
+                                        const uint8_t *pk_seed,
+                                        const uint8_t *const adrs[],
+                                        const uint8_t *const m1[],
+                                        uint8_t *const out[], size_t num);
+
+typedef int (OSSL_SLH_HASHFUNC_H_BATCH)(SLH_DSA_HASH_CTX *ctx,
+                                        const uint8_t *pk_seed,
+                                        const uint8_t *const adrs[],
+                                        const uint8_t *const m1[],
+                                        const uint8_t *const m2[],
+                                        uint8_t *const out[], size_t num);
+
 typedef struct slh_hash_func_st {
     OSSL_SLH_HASHFUNC_H_MSG *H_MSG;
     OSSL_SLH_HASHFUNC_PRF *PRF;
@@ -59,6 +81,8 @@ typedef struct slh_hash_func_st {
     OSSL_SLH_HASHFUNC_F *F;
     OSSL_SLH_HASHFUNC_H *H;
     OSSL_SLH_HASHFUNC_T *T;
+    OSSL_SLH_HASHFUNC_F_BATCH *F_BATCH;
+    OSSL_SLH_HASHFUNC_H_BATCH *H_BATCH;
 } SLH_HASH_FUNC;
 
 const SLH_HASH_FUNC *ossl_slh_get_hash_fn(int is_shake);
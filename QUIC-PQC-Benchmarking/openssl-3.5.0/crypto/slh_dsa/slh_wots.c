@@ -70,53 +70,111 @@ static ossl_inline void compute_checksum_nibbles(const uint8_t *in, size_t in_le
 }
 
 /**
- * @brief WOTS+ Chaining function
+ * @brief WOTS+ Chaining function, applied to all the chains of a key
  * See FIPS 205 Section 5 Algorithm 5
  *
- * Iterates using a hash function on the input |steps| times starting at index
- * |start|. (Internally the |adrs| hash address is used to update the chaining
- * index).
+ * Chain i iterates a hash function on the |n| bytes at |in| + i * |n| from
+ * index |start|[i] up to index |end|[i], writing the result to |out| + i * |n|.
+ * The chains are independent, so steps of up to SLH_HASH_BATCH different
+ * chains are hashed together.
  *
  * @param ctx Contains SLH_DSA algorithm functions and constants.
- * @param in An input string of |n| bytes
- * @param start_index The chaining start index
- * @param steps The number of iterations starting from |start_index|
- *              Note |start_index| + |steps| < w
- *              (where w = 16 indicates the length of the hash chains)
+ * @param in The |len| chain inputs of |n| bytes each. This may equal |out|.
+ * @param start The chaining start indexes, or NULL for 0
+ * @param end The chaining end indexes, or NULL for w - 1 = 15
+ *            Note |start|[i] <= |end|[i] < w
+ * @param len The number of chains
  * @param pk_seed A public key seed (which is added to the hash)
  * @param adrs An ADRS object which has a type of WOTS_HASH, and has a layer
- *             address, tree address, key pair address and chain address
- * @params wpkt A WPACKET object to write the hash chain to (n bytes are written)
+ *             address, tree address and key pair address. It is not modified.
+ * @param out The |len| chain outputs of |n| bytes each.
  * @returns 1 on success, or 0 on error.
  */
-static int slh_wots_chain(SLH_DSA_HASH_CTX *ctx, const uint8_t *in,
-                          uint8_t start_index, uint8_t steps,
-                          const uint8_t *pk_seed, uint8_t *adrs, WPACKET *wpkt)
+static int slh_wots_chains(SLH_DSA_HASH_CTX *ctx, const uint8_t *in,
+                           const uint8_t *start, const uint8_t *end, size_t len,
+                           const uint8_t *pk_seed, const uint8_t *adrs,
+                           uint8_t *out)
 {
     const SLH_DSA_KEY *key = ctx->key;
     SLH_HASH_FUNC_DECLARE(key, hashf);
     SLH_ADRS_FUNC_DECLARE(key, adrsf);
-    SLH_HASH_FN_DECLARE(hashf, F);
+    SLH_HASH_FN_DECLARE(hashf, F_BATCH);
+    SLH_ADRS_FN_DECLARE(adrsf, set_chain_address);
     SLH_ADRS_FN_DECLARE(adrsf, set_hash_address);
-    size_t j = start_index, end_index;
     size_t n = key->params->n;
-    uint8_t *tmp; /* Pointer into the |wpkt| buffer */
-    size_t tmp_len = n;
+    size_t i, num;
+    uint8_t pos[SLH_WOTS_LEN_MAX];
+    uint8_t lane_adrs[SLH_HASH_BATCH][SLH_ADRS_SIZE_MAX];
+    const uint8_t *adrs_in[SLH_HASH_BATCH], *m[SLH_HASH_BATCH];
+    uint8_t *m_out[SLH_HASH_BATCH];
 
-    if (steps == 0)
-        return WPACKET_memcpy(wpkt, in, n);
+    if (in != out)
+        memcpy(out, in, len * n);
+    for (i = 0; i < len; ++i)
+        pos[i] = start == NULL ? 0 : start[i];
+    for (i = 0; i < SLH_HASH_BATCH; ++i)
+        adrs_in[i] = lane_adrs[i];
 
-    if (!WPACKET_allocate_bytes(wpkt, tmp_len, &tmp))
-        return 0;
+    /* Each round advances up to SLH_HASH_BATCH unfinished chains by a step */
+    for (;;) {
+        for (i = 0, num = 0; i < len && num < SLH_HASH_BATCH; ++i) {
+            if (pos[i] == (end == NULL ? NIBBLE_MASK : end[i]))
+                continue;
+            adrsf->copy(lane_adrs[num], adrs);
+            set_chain_address(lane_adrs[num], (uint32_t)i);
+            set_hash_address(lane_adrs[num], pos[i]++);
+            m[num] = m_out[num] = out + i * n;
+            ++num;
+        }
+        if (num == 0)
+            return 1;
+        if (!F_BATCH(ctx, pk_seed, adrs_in, m, m_out, num))
+            return 0;
+    }
+}
 
-    set_hash_address(adrs, j++);
-    if (!F(ctx, pk_seed, adrs, in, n, tmp, tmp_len))
-        return 0;
+/**
+ * @brief Generate the WOTS+ private key values
+ * See FIPS 205 Section 5.1 Algorithm 6 steps 6 & 7 (and Algorithm 7 steps 10 & 11)
+ *
+ * @param ctx Contains SLH_DSA algorithm functions and constants.
+ * @param sk_seed A private key seed of size |n|
+ * @param pk_seed A public key seed of size |n|
+ * @param adrs An ADRS object containing the layer address, tree address and
+ *             keypair address of the WOTS+ key. It is not modified.
+ * @param sk_out The |len| private key values of |n| bytes each
+ * @param len The number of chains
+ * @returns 1 on success, or 0 on error.
+ */
+static int slh_wots_sk_gen(SLH_DSA_HASH_CTX *ctx, const uint8_t *sk_seed,
+                           const uint8_t *pk_seed, const uint8_t *adrs,
+                           uint8_t *sk_out, size_t len)
+{
+    const SLH_DSA_KEY *key = ctx->key;
+    SLH_HASH_FUNC_DECLARE(key, hashf);
+    SLH_ADRS_FUNC_DECLARE(key, adrsf);
+    SLH_ADRS_DECLARE(sk_adrs);
+    size_t n = key->params->n;
+    size_t i, j, num;
+    uint8_t lane_adrs[SLH_HASH_BATCH][SLH_ADRS_SIZE_MAX];
+    const uint8_t *adrs_in[SLH_HASH_BATCH], *m[SLH_HASH_BATCH];
+    uint8_t *m_out[SLH_HASH_BATCH];
 
-    end_index = start_index + steps;
-    for (; j < end_index; ++j) {
-        set_hash_address(adrs, j);
-        if (!F(ctx, pk_seed, adrs, tmp, n, tmp, tmp_len))
+    adrsf->copy(sk_adrs, adrs);
+    adrsf->set_type_and_clear(sk_adrs, SLH_ADRS_TYPE_WOTS_PRF);
+    adrsf->copy_keypair_address(sk_adrs, adrs);
+
+    /* PRF has the same form as F, with SK.seed as the message */
+    for (i = 0; i < len; i += num) {
+        num = len - i < SLH_HASH_BATCH ? len - i : SLH_HASH_BATCH;
+        for (j = 0; j < num; ++j) {
+            adrsf->copy(lane_adrs[j], sk_adrs);
+            adrsf->set_chain_address(lane_adrs[j], (uint32_t)(i + j));
+            adrs_in[j] = lane_adrs[j];
+            m[j] = sk_seed;
+            m_out[j] = sk_out + (i + j) * n;
+        }
+        if (!hashf->F_BATCH(ctx, pk_seed, adrs_in, m, m_out, num))
             return 0;
     }
     return 1;
@@ -142,45 +200,24 @@ int ossl_slh_wots_pk_gen(SLH_DSA_HASH_CTX *ctx,
     int ret = 0;
     const SLH_DSA_KEY *key = ctx->key;
     size_t n = key->params->n;
-    size_t i, len = SLH_WOTS_LEN(n); /* 2 * n + 3 */
-    uint8_t sk[SLH_MAX_N];
+    size_t len = SLH_WOTS_LEN(n); /* 2 * n + 3 */
     uint8_t tmp[SLH_WOTS_LEN_MAX * SLH_MAX_N];
-    WPACKET pkt, *tmp_wpkt = &pkt; /* Points to the |tmp| buffer */
-    size_t tmp_len = 0;
 
     SLH_HASH_FUNC_DECLARE(key, hashf);
     SLH_ADRS_FUNC_DECLARE(key, adrsf);
-    SLH_HASH_FN_DECLARE(hashf, PRF);
-    SLH_ADRS_FN_DECLARE(adrsf, set_chain_address);
-    SLH_ADRS_DECLARE(sk_adrs);
     SLH_ADRS_DECLARE(wots_pk_adrs);
 
-    if (!WPACKET_init_static_len(tmp_wpkt, tmp, sizeof(tmp), 0))
-        return 0;
-    adrsf->copy(sk_adrs, adrs);
-    adrsf->set_type_and_clear(sk_adrs, SLH_ADRS_TYPE_WOTS_PRF);
-    adrsf->copy_keypair_address(sk_adrs, adrs);
-
-    for (i = 0; i < len; ++i) { /* len = 2n + 3 */
-        set_chain_address(sk_adrs, i);
-        if (!PRF(ctx, pk_seed, sk_seed, sk_adrs, sk, sizeof(sk)))
-            goto end;
-
-        set_chain_address(adrs, i);
-        if (!slh_wots_chain(ctx, sk, 0, NIBBLE_MASK, pk_seed, adrs, tmp_wpkt))
-            goto end;
-    }
-
-    if (!WPACKET_get_total_written(tmp_wpkt, &tmp_len)) /* should be n * (2 * n + 3) */
+    /* Generate the private key values and run each chain to its end */
+    if (!slh_wots_sk_gen(ctx, sk_seed, pk_seed, adrs, tmp, len)
+            || !slh_wots_chains(ctx, tmp, NULL, NULL, len, pk_seed, adrs, tmp))
         goto end;
+
     adrsf->copy(wots_pk_adrs, adrs);
     adrsf->set_type_and_clear(wots_pk_adrs, SLH_ADRS_TYPE_WOTS_PK);
     adrsf->copy_keypair_address(wots_pk_adrs, adrs);
-    ret = hashf->T(ctx, pk_seed, wots_pk_adrs, tmp, tmp_len, pk_out, pk_out_len);
+    ret = hashf->T(ctx, pk_seed, wots_pk_adrs, tmp, len * n, pk_out, pk_out_len);
 end:
-    WPACKET_finish(tmp_wpkt);
     OPENSSL_cleanse(tmp, sizeof(tmp));
-    OPENSSL_cleanse(sk, n);
     return ret;
 }
 
@@ -204,21 +241,13 @@ int ossl_slh_wots_sign(SLH_DSA_HASH_CTX *ctx, const uint8_t *msg,
                        const uint8_t *sk_seed, const uint8_t *pk_seed,
                        uint8_t *adrs, WPACKET *sig_wpkt)
 {
-    int ret = 0;
     const SLH_DSA_KEY *key = ctx->key;
     uint8_t msg_and_csum_nibbles[SLH_WOTS_LEN_MAX]; /* size is >= 2 * n + 3 */
-    uint8_t sk[SLH_MAX_N];
-    size_t i;
+    uint8_t *sig; /* Pointer into the |sig_wpkt| buffer */
     size_t n = key->params->n;
     size_t len1 = SLH_WOTS_LEN1(n); /* 2 * n = the msg length in nibbles */
     size_t len = len1 + SLH_WOTS_LEN2;  /* 2 * n + 3 (3 checksum nibbles) */
 
-    SLH_ADRS_DECLARE(sk_adrs);
-    SLH_HASH_FUNC_DECLARE(key, hashf);
-    SLH_ADRS_FUNC_DECLARE(key, adrsf);
-    SLH_HASH_FN_DECLARE(hashf, PRF);
-    SLH_ADRS_FN_DECLARE(adrsf, set_chain_address);
-
     /*
      * Convert n message bytes to 2*n base w=16 integers
      * i.e. Convert message to an array of 2*n nibbles.
@@ -227,24 +256,14 @@ int ossl_slh_wots_sign(SLH_DSA_HASH_CTX *ctx, const uint8_t *msg,
     /* Compute a 12 bit checksum and add it to the end */
     compute_checksum_nibbles(msg_and_csum_nibbles, len1, msg_and_csum_nibbles + len1);
 
-    adrsf->copy(sk_adrs, adrs);
-    adrsf->set_type_and_clear(sk_adrs, SLH_ADRS_TYPE_WOTS_PRF);
-    adrsf->copy_keypair_address(sk_adrs, adrs);
-
-    for (i = 0; i < len; ++i) {
-        set_chain_address(sk_adrs, i);
-        /* compute chain i secret */
-        if (!PRF(ctx, pk_seed, sk_seed, sk_adrs, sk, sizeof(sk)))
-            goto err;
-        set_chain_address(adrs, i);
-        /* compute chain i signature */
-        if (!slh_wots_chain(ctx, sk, 0, msg_and_csum_nibbles[i],
-                            pk_seed, adrs, sig_wpkt))
-            goto err;
-    }
-    ret = 1;
-err:
-    return ret;
+    /*
+     * Compute the chain secrets in place in the signature, and then chain
+     * each of them as far as its message nibble
+     */
+    return WPACKET_allocate_bytes(sig_wpkt, len * n, &sig)
+        && slh_wots_sk_gen(ctx, sk_seed, pk_seed, adrs, sig, len)
+        && slh_wots_chains(ctx, sig, NULL, msg_and_csum_nibbles, len,
+                           pk_seed, adrs, sig);
 }
 
 /**
@@ -268,48 +287,31 @@ int ossl_slh_wots_pk_from_sig(SLH_DSA_HASH_CTX *ctx,
                               const uint8_t *pk_seed, uint8_t *adrs,
                               uint8_t *pk_out, size_t pk_out_len)
 {
-    int ret = 0;
     const SLH_DSA_KEY *key = ctx->key;
     uint8_t msg_and_csum_nibbles[SLH_WOTS_LEN_MAX];
-    size_t i;
     size_t n = key->params->n;
     size_t len1 = SLH_WOTS_LEN1(n);
     size_t len = len1 + SLH_WOTS_LEN2; /* 2n + 3 */
-    const uint8_t *sig_i;  /* Pointer into |sig_rpkt| buffer */
+    const uint8_t *sig;  /* Pointer into |sig_rpkt| buffer */
     uint8_t tmp[SLH_WOTS_LEN_MAX * SLH_MAX_N];
-    WPACKET pkt, *tmp_pkt = &pkt;
-    size_t tmp_len = 0;
 
     SLH_HASH_FUNC_DECLARE(key, hashf);
     SLH_ADRS_FUNC_DECLARE(key, adrsf);
-    SLH_ADRS_FN_DECLARE(adrsf, set_chain_address);
     SLH_ADRS_DECLARE(wots_pk_adrs);
 
-    if (!WPACKET_init_static_len(tmp_pkt, tmp, sizeof(tmp), 0))
-        return 0;
-
     slh_bytes_to_nibbles(msg, n, msg_and_csum_nibbles);
     compute_checksum_nibbles(msg_and_csum_nibbles, len1, msg_and_csum_nibbles + len1);
 
     /* Compute the end nodes for each of the chains */
-    for (i = 0; i < len; ++i) {
-        set_chain_address(adrs, i);
-        if (!PACKET_get_bytes(sig_rpkt, &sig_i, n)
-                || !slh_wots_chain(ctx, sig_i, msg_and_csum_nibbles[i],
-                                   NIBBLE_MASK - msg_and_csum_nibbles[i],
-                                   pk_seed, adrs, tmp_pkt))
-            goto err;
-    }
+    if (!PACKET_get_bytes(sig_rpkt, &sig, len * n)
+            || !slh_wots_chains(ctx, sig, msg_and_csum_nibbles, NULL, len,
+                                pk_seed, adrs, tmp))
+        return 0;
+
     /* compress the computed public key value */
     adrsf->copy(wots_pk_adrs, adrs);
     adrsf->set_type_and_clear(wots_pk_adrs, SLH_ADRS_TYPE_WOTS_PK);
     adrsf->copy_keypair_address(wots_pk_adrs, adrs);
-    if (!WPACKET_get_total_written(tmp_pkt, &tmp_len))
-        goto err;
-    ret = hashf->T(ctx, pk_seed, wots_pk_adrs, tmp, tmp_len,
-                   pk_out, pk_out_len);
- err:
-    if (!WPACKET_finish(tmp_pkt))
-        ret = 0;
-    return ret;
+    return hashf->T(ctx, pk_seed, wots_pk_adrs, tmp, len * n,
+                    pk_out, pk_out_len);
 }
@@ -11,11 +11,66 @@
 #include "slh_dsa_local.h"
 #include "slh_dsa_key.h"
 
+/**
+ * @brief Reduce the bottom level of a Merkle subtree to its root.
+ *
+ * Each parent node is a hash of its 2 children. All of the parents within a
+ * level are independent, so they are computed SLH_HASH_BATCH at a time.
+ *
+ * @param ctx Contains SLH_DSA algorithm functions and constants.
+ * @param pk_seed A SLH-DSA public key seed of size |n|
+ * @param adrs An ADRS object with the type set to TREE or FORS_TREE, which
+ *             is used as a template for the parent node addresses.
+ *             It is not modified.
+ * @param nodes The 2^|height| bottom level nodes of size |n| each, which are
+ *              overwritten. On return the root node is at the start.
+ * @param node_id The index of the subtree root node.
+ * @param height The height of the subtree root node above the bottom level,
+ *               which must be <= SLH_TREE_BATCH_HEIGHT.
+ * @returns 1 on success, or 0 on error.
+ */
+int ossl_slh_tree_reduce(SLH_DSA_HASH_CTX *ctx, const uint8_t *pk_seed,
+                         const uint8_t *adrs, uint8_t *nodes,
+                         uint32_t node_id, uint32_t height)
+{
+    const SLH_DSA_KEY *key = ctx->key;
+    SLH_HASH_FUNC_DECLARE(key, hashf);
+    SLH_ADRS_FUNC_DECLARE(key, adrsf);
+    size_t n = key->params->n;
+    uint32_t h, i, j, num, count;
+    uint8_t lane_adrs[SLH_HASH_BATCH][SLH_ADRS_SIZE_MAX];
+    uint8_t parents[SLH_HASH_BATCH * SLH_MAX_N];
+    const uint8_t *adrs_in[SLH_HASH_BATCH], *l[SLH_HASH_BATCH], *r[SLH_HASH_BATCH];
+    uint8_t *out[SLH_HASH_BATCH];
+
+    for (h = 1; h <= height; ++h) {
+        count = 1U << (height - h);
+        for (i = 0; i < count; i += num) {
+            num = count - i < SLH_HASH_BATCH ? count - i : SLH_HASH_BATCH;
+            for (j = 0; j < num; ++j) {
+                adrsf->copy(lane_adrs[j], adrs);
+                adrsf->set_tree_height(lane_adrs[j], h);
+                adrsf->set_tree_index(lane_adrs[j],
+                                      (node_id << (height - h)) + i + j);
+                adrs_in[j] = lane_adrs[j];
+                l[j] = nodes + 2 * (i + j) * n;
+                r[j] = l[j] + n;
+                out[j] = parents + j * n;
+            }
+            if (!hashf->H_BATCH(ctx, pk_seed, adrs_in, l, r, out, num))
+                return 0;
+            memcpy(nodes + i * n, parents, num * n);
+        }
+    }
+    return 1;
+}
+
 /**
  * @brief Compute the root Public key of a XMSS tree.
  * See FIPS 205 Section 6.1 Algorithm 9.
  * This is a recursive function that starts at an leaf index, that calculates
- * the hash of each parent using 2 child nodes.
+ * the hash of each parent using 2 child nodes. Subtrees of height
+ * SLH_TREE_BATCH_HEIGHT or less are computed a level at a time instead.
  *
  * @param ctx Contains SLH_DSA algorithm functions and constants.
  * @param sk_seed A SLH-DSA private key seed of size |n|
@@ -39,14 +94,25 @@ int ossl_slh_xmss_node(SLH_DSA_HASH_CTX *ctx, const uint8_t *sk_seed,
 {
     const SLH_DSA_KEY *key = ctx->key;
     SLH_ADRS_FUNC_DECLARE(key, adrsf);
+    size_t n = key->params->n;
+
+    if (h <= SLH_TREE_BATCH_HEIGHT) {
+        uint8_t nodes[(1 << SLH_TREE_BATCH_HEIGHT) * SLH_MAX_N];
+        uint32_t i, first = node_id << h;
 
-    if (h == 0) {
-        /* For leaf nodes generate the public key */
+        /* Generate the public key of each leaf, then hash them together */
         adrsf->set_type_and_clear(adrs, SLH_ADRS_TYPE_WOTS_HASH);
-        adrsf->set_keypair_address(adrs, node_id);
-        if (!ossl_slh_wots_pk_gen(ctx, sk_seed, pk_seed, adrs,
-                                  pk_out, pk_out_len))
+        for (i = 0; i < (1U << h); ++i) {
+            adrsf->set_keypair_address(adrs, first + i);
+            if (!ossl_slh_wots_pk_gen(ctx, sk_seed, pk_seed, adrs,
+                                      nodes + i * n, n))
+                return 0;
+        }
+        adrsf->set_type_and_clear(adrs, SLH_ADRS_TYPE_TREE);
+        if (!ossl_slh_tree_reduce(ctx, pk_seed, adrs, nodes, node_id, h)
+                || pk_out_len < n)
             return 0;
+        memcpy(pk_out, nodes, n);
     } else {
         uint8_t lnode[SLH_MAX_N], rnode[SLH_MAX_N];
 
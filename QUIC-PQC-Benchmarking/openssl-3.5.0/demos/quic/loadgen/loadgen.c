@@ -0,0 +1,938 @@
+/*
+ * Copyright 2024-2025 The OpenSSL Project Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License 2.0 (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://www.openssl.org/source/license.html
+ */
+
+/*
+ * In-process QUIC handshake load generator.
+ *
+ * All client connections are created from one client-only listener
+ * (SSL_new_listener() on an OSSL_QUIC_client_method() context), so they share
+ * a single UDP socket and QUIC engine. The connections are non-blocking and
+ * use explicit event handling: one SSL_handle_events() call on the listener
+ * services every connection, and SSL_do_handshake() is only used to start a
+ * connection and to poll its state.
+ *
+ * Two load models are supported:
+ *
+ *   closed  - keep --concurrency handshakes in flight; a new one starts as
+ *             soon as one finishes (optionally paced to --rate per second).
+ *   open    - handshakes arrive at --rate per second (fixed spacing or
+ *             Poisson), independent of how fast earlier ones complete. If
+ *             --concurrency handshakes are already in flight new arrivals
+ *             wait, and their latency is measured from the scheduled arrival
+ *             so that a saturated server is not hidden (coordinated omission).
+ *
+ * With --resume a share of the connections offers a session ticket from an
+ * earlier connection, like s_client -sess_out/-sess_in but within the
+ * process: every ticket received replaces the cached session. A resumed
+ * handshake skips the certificate chain and the CertificateVerify signature,
+ * but still performs the (PQC) key exchange. Full and resumed handshakes are
+ * reported separately.
+ *
+ * One CSV row is written per connection; a summary with the achieved
+ * handshakes per second and latency percentiles is printed to stdout.
+ */
+#include <openssl/err.h>
+#include <openssl/ssl.h>
+#include <openssl/quic.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <errno.h>
+#include <math.h>
+#include <poll.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* ------------------------------ Defaults -------------------------------- */
+
+#define DEFAULT_COUNT        1000
+#define DEFAULT_CONCURRENCY  1
+#define DEFAULT_TIMEOUT_MS   10000
+#define OPEN_LOOP_MAX_INFLIGHT 1000
+
+/* ALPN string for TLS handshake, "\x08ossltest" as in the demo server */
+static const unsigned char alpn_ossltest[] = {
+    0x08, 0x6f, 0x73, 0x73, 0x6c, 0x74, 0x65, 0x73, 0x74
+};
+
+/* ----------------------------- Data types ------------------------------- */
+
+enum {
+    ST_QUEUED = 0,  /* Scheduled, not started yet */
+    ST_HANDSHAKE,   /* SSL_do_handshake() in progress */
+    ST_DONE,        /* Handshake completed */
+    ST_FAILED,      /* Handshake failed or connection was closed */
+    ST_TIMEOUT      /* No result within --timeout */
+};
+
+static const char *status_names[] = {
+    "queued", "handshake", "ok", "failed", "timeout"
+};
+
+/* What became of the session a connection offered, if any */
+enum {
+    SESS_FULL = 0,  /* No session offered */
+    SESS_RESUMED,   /* Session offered and accepted */
+    SESS_REFUSED    /* Session offered, but the server did a full handshake */
+};
+
+static const char *session_names[] = {
+    "full", "resumed", "refused"
+};
+
+/* Per-connection timings, all in microseconds since the start of the run. */
+typedef struct {
+    uint64_t scheduled_us;
+    uint64_t start_us;
+    uint64_t done_us;
+    uint64_t rtt_us;        /* SSL_get_handshake_rtt(): ClientHello -> ServerHello */
+    int warmup;
+    int status;
+    int offered;            /* a cached session was offered */
+    int session;            /* SESS_* once the handshake is done */
+    char group[32];
+} conn_rec;
+
+/* One in-flight connection. */
+typedef struct {
+    SSL *ssl;
+    size_t rec;
+} conn_slot;
+
+/*
+ * A finished connection that still has to be closed. It no longer occupies
+ * a slot.
+ */
+typedef struct {
+    SSL *ssl;
+    uint64_t deadline_us;   /* close even if not confirmed by then */
+    int close_sent;
+} closing_conn;
+
+typedef struct {
+    const char *host;
+    const char *port;
+    const char *groups;
+    const char *sigalgs;
+    const char *out_path;
+    int open_loop;
+    int poisson;
+    double rate;
+    double duration_s;
+    long count;
+    long warmup;
+    int concurrency;
+    long timeout_ms;
+    unsigned int seed;
+    double resume;          /* share of connections offering a session */
+    const char *sess_in;
+    const char *sess_out;
+} loadgen_opts;
+
+/*
+ * The most recent session ticket received on any connection. All connections
+ * are driven from the one thread, so no locking is needed.
+ */
+static SSL_SESSION *cached_session;
+
+/* ------------------------------- Helpers -------------------------------- */
+
+static uint64_t now_us(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + (uint64_t)ts.tv_nsec / 1000;
+}
+
+/* Microseconds until the next arrival: fixed spacing or exponential. */
+static double next_interval_us(const loadgen_opts *o)
+{
+    double mean = 1e6 / o->rate;
+
+    if (!o->poisson)
+        return mean;
+    /* drand48() is in [0, 1); 1 - u is in (0, 1] */
+    return -mean * log(1.0 - drand48());
+}
+
+static int cmp_double(const void *a, const void *b)
+{
+    double x = *(const double *)a, y = *(const double *)b;
+
+    return (x > y) - (x < y);
+}
+
+/* Nearest-rank percentile of a sorted array. */
+static double percentile(const double *v, size_t n, double p)
+{
+    size_t rank;
+
+    if (n == 0)
+        return 0.0;
+    rank = (size_t)(p / 100.0 * n + 0.999999);
+    if (rank < 1)
+        rank = 1;
+    if (rank > n)
+        rank = n;
+    return v[rank - 1];
+}
+
+/* Append one queued record; the array grows as needed in --duration mode. */
+static conn_rec *add_rec(conn_rec **recs, size_t *nrecs, size_t *cap,
+                         uint64_t scheduled_us, int warmup)
+{
+    conn_rec *r;
+
+    if (*nrecs == *cap) {
+        size_t ncap = *cap ? *cap * 2 : 1024;
+        conn_rec *n = realloc(*recs, ncap * sizeof(*n));
+
+        if (n == NULL) {
+            fprintf(stderr, "out of memory\n");
+            return NULL;
+        }
+        *recs = n;
+        *cap = ncap;
+    }
+    r = &(*recs)[(*nrecs)++];
+    memset(r, 0, sizeof(*r));
+    r->scheduled_us = scheduled_us;
+    r->warmup = warmup;
+    r->status = ST_QUEUED;
+    return r;
+}
+
+/* ------------------------- TLS/QUIC helpers ----------------------------- */
+
+/* Keeps the newest ticket; called for every NewSessionTicket received. */
+static int new_session_cb(SSL *ssl, SSL_SESSION *sess)
+{
+    SSL_SESSION_free(cached_session);
+    cached_session = sess;
+    return 1; /* we own the reference now */
+}
+
+/*
+ * Whether connection number i offers the cached session. Spreading the offers
+ * evenly instead of drawing random numbers keeps --poisson arrivals the same
+ * with and without --resume.
+ */
+static int want_resume(const loadgen_opts *o, size_t i)
+{
+    return (long)((i + 1) * o->resume) > (long)(i * o->resume);
+}
+
+/* Loads the session for --sess-in, as s_client -sess_in does. */
+static int load_session(const char *path)
+{
+    BIO *in = BIO_new_file(path, "r");
+
+    if (in == NULL) {
+        fprintf(stderr, "couldn't open %s\n", path);
+        return 0;
+    }
+    cached_session = PEM_read_bio_SSL_SESSION(in, NULL, NULL, NULL);
+    BIO_free(in);
+    if (cached_session == NULL) {
+        fprintf(stderr, "couldn't read a session from %s\n", path);
+        return 0;
+    }
+    return 1;
+}
+
+/* Writes the newest session for --sess-out, as s_client -sess_out does. */
+static int save_session(const char *path)
+{
+    BIO *out;
+    int ok;
+
+    if (cached_session == NULL) {
+        fprintf(stderr, "no session ticket was received, %s not written\n",
+                path);
+        return 0;
+    }
+    if ((out = BIO_new_file(path, "w")) == NULL) {
+        fprintf(stderr, "couldn't open %s\n", path);
+        return 0;
+    }
+    ok = PEM_write_bio_SSL_SESSION(out, cached_session);
+    BIO_free(out);
+    return ok;
+}
+
+static SSL_CTX *create_ctx(const loadgen_opts *o)
+{
+    SSL_CTX *ctx;
+
+    ctx = SSL_CTX_new(OSSL_QUIC_client_method());
+    if (ctx == NULL)
+        goto err;
+
+    /* Like s_client without -verify: the handshake is measured, not the PKI. */
+    SSL_CTX_set_verify(ctx, SSL_VERIFY_NONE, NULL);
+
+    if (o->groups != NULL && !SSL_CTX_set1_groups_list(ctx, o->groups)) {
+        fprintf(stderr, "failed to set key exchange groups: %s\n", o->groups);
+        goto err;
+    }
+
+    /* The server picks the certificate matching the offered algorithms. */
+    if (o->sigalgs != NULL && !SSL_CTX_set1_sigalgs_list(ctx, o->sigalgs)) {
+        fprintf(stderr, "failed to set signature algorithms: %s\n",
+                o->sigalgs);
+        goto err;
+    }
+
+    /*
+     * Tickets are handed to new_session_cb() only; sessions are offered
+     * explicitly with SSL_set_session().
+     */
+    if (o->resume > 0 || o->sess_out != NULL) {
+        SSL_CTX_set_session_cache_mode(ctx, SSL_SESS_CACHE_CLIENT
+                                            | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+        SSL_CTX_sess_set_new_cb(ctx, new_session_cb);
+    }
+
+    return ctx;
+
+err:
+    SSL_CTX_free(ctx);
+    return NULL;
+}
+
+/* Resolve the server address and create the shared, unconnected UDP socket. */
+static int create_socket(const loadgen_opts *o, BIO_ADDR **peer)
+{
+    BIO_ADDRINFO *res = NULL;
+    int fd = -1;
+
+    if (!BIO_lookup_ex(o->host, o->port, BIO_LOOKUP_CLIENT, AF_UNSPEC,
+                       SOCK_DGRAM, IPPROTO_UDP, &res)) {
+        fprintf(stderr, "couldn't resolve %s:%s\n", o->host, o->port);
+        goto err;
+    }
+
+    fd = BIO_socket(BIO_ADDRINFO_family(res), SOCK_DGRAM, IPPROTO_UDP, 0);
+    if (fd < 0) {
+        fd = -1;
+        goto err;
+    }
+
+    if (!BIO_socket_nbio(fd, 1))
+        goto err;
+
+    if ((*peer = BIO_ADDR_dup(BIO_ADDRINFO_address(res))) == NULL)
+        goto err;
+
+    BIO_ADDRINFO_free(res);
+    return fd;
+
+err:
+    if (fd >= 0)
+        BIO_closesocket(fd);
+    BIO_ADDRINFO_free(res);
+    return -1;
+}
+
+/*
+ * Create a connection on the shared listener and send its Initial. If sess is
+ * not NULL it is offered for resumption.
+ */
+static int start_conn(SSL *listener, const BIO_ADDR *peer, const char *host,
+                      SSL_SESSION *sess, conn_slot *slot)
+{
+    SSL *ssl;
+    int ret;
+
+    if ((ssl = SSL_new_from_listener(listener, 0)) == NULL)
+        return 0;
+
+    if (!SSL_set_blocking_mode(ssl, 0)
+        || !SSL_set_event_handling_mode(ssl, SSL_VALUE_EVENT_HANDLING_MODE_EXPLICIT)
+        || !SSL_set1_initial_peer_addr(ssl, peer)
+        || !SSL_set_tlsext_host_name(ssl, host)
+        || SSL_set_alpn_protos(ssl, alpn_ossltest, sizeof(alpn_ossltest)) != 0
+        || (sess != NULL && !SSL_set_session(ssl, sess))) {
+        SSL_free(ssl);
+        return 0;
+    }
+
+    /* Queue the ClientHello; it goes out with the next SSL_handle_events(). */
+    ret = SSL_do_handshake(ssl);
+    if (ret <= 0) {
+        int err = SSL_get_error(ssl, ret);
+
+        if (err != SSL_ERROR_WANT_READ && err != SSL_ERROR_WANT_WRITE) {
+            SSL_free(ssl);
+            return 0;
+        }
+    }
+
+    slot->ssl = ssl;
+    return 1;
+}
+
+/*
+ * Check an in-flight handshake after event processing. Returns the new
+ * status of the connection.
+ */
+static int poll_conn(conn_slot *slot, conn_rec *r, uint64_t t0)
+{
+    SSL *ssl = slot->ssl;
+    int ret = SSL_do_handshake(ssl), err;
+    uint64_t t = now_us() - t0;
+
+    if (ret == 1) {
+        int nid = SSL_get_negotiated_group(ssl);
+        const char *name = nid > 0 ? SSL_group_to_name(ssl, nid) : NULL;
+
+        r->done_us = t;
+        if (!SSL_get_handshake_rtt(ssl, &r->rtt_us))
+            r->rtt_us = 0;
+        if (r->offered)
+            r->session = SSL_session_reused(ssl) ? SESS_RESUMED : SESS_REFUSED;
+        snprintf(r->group, sizeof(r->group), "%s", name != NULL ? name : "");
+        return ST_DONE;
+    }
+
+    err = SSL_get_error(ssl, ret);
+    if (err == SSL_ERROR_WANT_READ || err == SSL_ERROR_WANT_WRITE)
+        return ST_HANDSHAKE;
+
+    r->done_us = t;
+    ERR_clear_error();
+    return ST_FAILED;
+}
+
+/*
+ * Whether the server has confirmed the handshake (HANDSHAKE_DONE received).
+ * Until then the client may only be able to send its CONNECTION_CLOSE in a
+ * Handshake packet, which a server that has completed the handshake already
+ * discards: the server would keep the connection until its idle timeout.
+ */
+static int conn_confirmed(const SSL *ssl)
+{
+    const SSL_HANDSHAKE_TIMELINE *tl = SSL_get0_handshake_timeline(ssl);
+
+    return tl != NULL && tl->event[SSL_HANDSHAKE_EVENT_CONFIRMED] != 0;
+}
+
+/*
+ * Move a finished connection out of its slot. Successful handshakes are
+ * closed once confirmed, failed ones right away.
+ */
+static int add_closing(closing_conn **cl, size_t *ncl, size_t *cap, SSL *ssl,
+                       uint64_t deadline_us)
+{
+    if (*ncl == *cap) {
+        size_t ncap = *cap == 0 ? 64 : *cap * 2;
+        closing_conn *n = realloc(*cl, ncap * sizeof(*n));
+
+        if (n == NULL)
+            return 0;
+        *cl = n;
+        *cap = ncap;
+    }
+    (*cl)[*ncl].ssl = ssl;
+    (*cl)[*ncl].deadline_us = deadline_us;
+    (*cl)[*ncl].close_sent = 0;
+    (*ncl)++;
+    return 1;
+}
+
+/*
+ * Wait for network activity or until the next timer (QUIC event timeout or
+ * next scheduled start) expires.
+ */
+static void wait_for_events(SSL *listener, int fd, uint64_t wake_us)
+{
+    struct pollfd pfd;
+    struct timeval tv;
+    int is_infinite = 1, timeout_ms = -1;
+    uint64_t now = now_us();
+
+    if (SSL_get_event_timeout(listener, &tv, &is_infinite) && !is_infinite)
+        timeout_ms = (int)(tv.tv_sec * 1000 + (tv.tv_usec + 999) / 1000);
+
+    if (wake_us != UINT64_MAX) {
+        int wake_ms = wake_us > now ? (int)((wake_us - now + 999) / 1000) : 0;
+
+        if (timeout_ms < 0 || wake_ms < timeout_ms)
+            timeout_ms = wake_ms;
+    }
+
+    pfd.fd = fd;
+    pfd.events = POLLIN;
+    if (SSL_net_write_desired(listener))
+        pfd.events |= POLLOUT;
+    pfd.revents = 0;
+
+    if (poll(&pfd, 1, timeout_ms) < 0 && errno != EINTR)
+        perror("poll");
+}
+
+/* ----------------------------- Reporting -------------------------------- */
+
+static int write_csv(const char *path, const conn_rec *recs, size_t n)
+{
+    FILE *f = fopen(path, "w");
+    size_t i;
+
+    if (f == NULL) {
+        perror(path);
+        return 0;
+    }
+    fprintf(f, "Conn,Phase,ScheduledUs,StartUs,DoneUs,QueueMs,HandshakeMs,"
+               "LatencyMs,RttMs,Group,Status,Session\n");
+    for (i = 0; i < n; i++) {
+        const conn_rec *r = &recs[i];
+        int finished = r->status == ST_DONE;
+
+        fprintf(f, "%zu,%s,%llu,%llu,%llu,%.3f,", i,
+                r->warmup ? "warmup" : "measure",
+                (unsigned long long)r->scheduled_us,
+                (unsigned long long)r->start_us,
+                (unsigned long long)r->done_us,
+                r->status != ST_QUEUED
+                    ? (r->start_us - r->scheduled_us) / 1000.0 : 0.0);
+        if (finished)
+            fprintf(f, "%.3f,%.3f,%.3f,", (r->done_us - r->start_us) / 1000.0,
+                    (r->done_us - r->scheduled_us) / 1000.0, r->rtt_us / 1000.0);
+        else
+            fprintf(f, ",,,");
+        fprintf(f, "%s,%s,%s\n", r->group, status_names[r->status],
+                finished ? session_names[r->session] : "");
+    }
+    fclose(f);
+    return 1;
+}
+
+/* Prints the handshake time percentiles of one kind of session. */
+static void print_session_kind(const conn_rec *recs, size_t n, int session,
+                               double *hs)
+{
+    size_t i, k = 0;
+    char label[32];
+
+    for (i = 0; i < n; i++)
+        if (!recs[i].warmup && recs[i].status == ST_DONE
+                && recs[i].session == session)
+            hs[k++] = (recs[i].done_us - recs[i].start_us) / 1000.0;
+    if (k == 0)
+        return;
+    qsort(hs, k, sizeof(double), cmp_double);
+
+    snprintf(label, sizeof(label), "%s (%zu):", session_names[session], k);
+    printf("  %-15s p50 %.3f  p90 %.3f  p99 %.3f  max %.3f\n", label,
+           percentile(hs, k, 50), percentile(hs, k, 90),
+           percentile(hs, k, 99), hs[k - 1]);
+}
+
+static void print_summary(const loadgen_opts *o, const conn_rec *recs,
+                          size_t n)
+{
+    double *hs = malloc((n + 1) * sizeof(double));
+    double *lat = malloc((n + 1) * sizeof(double));
+    size_t i, ok = 0, failed = 0, timedout = 0, measured = 0;
+    uint64_t first = UINT64_MAX, last = 0;
+    double span;
+    int s;
+
+    if (hs == NULL || lat == NULL) {
+        free(hs);
+        free(lat);
+        return;
+    }
+
+    for (i = 0; i < n; i++) {
+        const conn_rec *r = &recs[i];
+
+        if (r->warmup || r->status == ST_QUEUED)
+            continue;
+        measured++;
+        if (r->start_us < first)
+            first = r->start_us;
+        if (r->done_us > last)
+            last = r->done_us;
+        if (r->status == ST_FAILED) {
+            failed++;
+        } else if (r->status == ST_TIMEOUT) {
+            timedout++;
+        } else if (r->status == ST_DONE) {
+            hs[ok] = (r->done_us - r->start_us) / 1000.0;
+            lat[ok] = (r->done_us - r->scheduled_us) / 1000.0;
+            ok++;
+        }
+    }
+    qsort(hs, ok, sizeof(double), cmp_double);
+    qsort(lat, ok, sizeof(double), cmp_double);
+    span = last > first ? (last - first) / 1e6 : 0.0;
+
+    printf("Mode:           %s", o->open_loop ? "open" : "closed");
+    if (o->rate > 0)
+        printf(", %.1f/s%s", o->rate, o->poisson ? " (Poisson)" : "");
+    printf(", concurrency %d\n", o->concurrency);
+    printf("Handshakes:     %zu ok, %zu failed, %zu timed out (%ld warm-up)\n",
+           ok, failed, timedout, o->warmup);
+    printf("Duration:       %.3f s\n", span);
+    printf("Throughput:     %.1f handshakes/s\n", span > 0 ? ok / span : 0.0);
+    printf("Handshake ms:   p50 %.3f  p90 %.3f  p99 %.3f  max %.3f\n",
+           percentile(hs, ok, 50), percentile(hs, ok, 90),
+           percentile(hs, ok, 99), ok ? hs[ok - 1] : 0.0);
+    if (o->open_loop)
+        printf("Latency ms:     p50 %.3f  p90 %.3f  p99 %.3f  max %.3f "
+               "(from scheduled arrival)\n",
+               percentile(lat, ok, 50), percentile(lat, ok, 90),
+               percentile(lat, ok, 99), ok ? lat[ok - 1] : 0.0);
+    if (o->resume > 0 || o->sess_in != NULL)
+        for (s = SESS_FULL; s <= SESS_REFUSED; s++)
+            print_session_kind(recs, n, s, hs);
+
+    free(hs);
+    free(lat);
+}
+
+/* ------------------------------ Main loop ------------------------------- */
+
+/*
+ * Whether another connection may be scheduled at time t. --duration bounds
+ * the measured phase, counted from the first measured arrival; warm-up
+ * handshakes come on top of --count or --duration.
+ */
+static int more_arrivals(const loadgen_opts *o, size_t nrecs, uint64_t t,
+                         uint64_t measure_start)
+{
+    if ((long)nrecs < o->warmup)
+        return 1;
+    if (o->duration_s <= 0)
+        return (long)nrecs < o->warmup + o->count;
+    return measure_start == UINT64_MAX
+        || t < measure_start + (uint64_t)(o->duration_s * 1e6);
+}
+
+static int run_load(const loadgen_opts *o, SSL *listener, int fd,
+                    const BIO_ADDR *peer, conn_rec **precs, size_t *pnrecs)
+{
+    conn_slot *slots = calloc(o->concurrency, sizeof(*slots));
+    conn_rec *recs = NULL;
+    closing_conn *cl = NULL;
+    size_t nrecs = 0, cap = 0, next_start = 0, ncl = 0, clcap = 0, j, k;
+    int inflight = 0, i, ok = 0;
+    uint64_t t0 = now_us(), next_arrival = 0, measure_start = UINT64_MAX;
+    uint64_t timeout_us = (uint64_t)o->timeout_ms * 1000;
+
+    if (slots == NULL)
+        goto err;
+
+    for (;;) {
+        uint64_t now = now_us() - t0, wake = UINT64_MAX;
+        int more;
+
+        /* --- Schedule arrivals --- */
+        if (o->open_loop) {
+            /* Arrivals follow the clock, whether or not a slot is free */
+            while ((more = more_arrivals(o, nrecs, next_arrival, measure_start))
+                   && next_arrival <= now) {
+                if ((long)nrecs == o->warmup)
+                    measure_start = next_arrival;
+                if (add_rec(&recs, &nrecs, &cap, next_arrival,
+                            (long)nrecs < o->warmup) == NULL)
+                    goto err;
+                next_arrival += (uint64_t)next_interval_us(o);
+            }
+            if (more)
+                wake = t0 + next_arrival;
+        } else {
+            /* Closed loop: every free slot is an arrival, optionally paced */
+            while ((more = more_arrivals(o, nrecs, now, measure_start))
+                   && inflight + (int)(nrecs - next_start) < o->concurrency) {
+                if (o->rate > 0 && next_arrival > now) {
+                    wake = t0 + next_arrival;
+                    break;
+                }
+                if ((long)nrecs == o->warmup)
+                    measure_start = now;
+                if (add_rec(&recs, &nrecs, &cap, now,
+                            (long)nrecs < o->warmup) == NULL)
+                    goto err;
+                if (o->rate > 0)
+                    next_arrival = (next_arrival > now ? next_arrival : now)
+                                   + (uint64_t)next_interval_us(o);
+            }
+        }
+
+        /* --- Start queued connections while slots are free --- */
+        for (i = 0; i < o->concurrency && next_start < nrecs; i++) {
+            conn_rec *r = &recs[next_start];
+            SSL_SESSION *sess = NULL;
+
+            if (slots[i].ssl != NULL)
+                continue;
+            if (cached_session != NULL && want_resume(o, next_start)) {
+                sess = cached_session;
+                r->offered = 1;
+            }
+            r->start_us = now_us() - t0;
+            if (!start_conn(listener, peer, o->host, sess, &slots[i])) {
+                r->done_us = r->start_us;
+                r->status = ST_FAILED;
+                ERR_print_errors_fp(stderr);
+            } else {
+                r->status = ST_HANDSHAKE;
+                slots[i].rec = next_start;
+                inflight++;
+            }
+            next_start++;
+        }
+
+        if (!more && inflight == 0 && next_start == nrecs && ncl == 0)
+            break;
+
+        for (i = 0; i < o->concurrency; i++) {
+            uint64_t deadline;
+
+            if (slots[i].ssl == NULL)
+                continue;
+            deadline = t0 + recs[slots[i].rec].start_us + timeout_us;
+            if (deadline < wake)
+                wake = deadline;
+        }
+
+        /* A sent close is freed after the next tick, so do not sleep then */
+        for (j = 0; j < ncl; j++) {
+            uint64_t deadline = cl[j].close_sent ? 0 : cl[j].deadline_us;
+
+            if (deadline < wake)
+                wake = deadline;
+        }
+
+        /* --- Drive the engine: one tick serves every connection --- */
+        if (inflight > 0 || wake != UINT64_MAX)
+            wait_for_events(listener, fd, wake);
+        SSL_handle_events(listener);
+
+        now = now_us() - t0;
+        for (j = k = 0; j < ncl; j++) {
+            closing_conn *c = &cl[j];
+
+            /* The CONNECTION_CLOSE went out with the tick above */
+            if (c->close_sent) {
+                SSL_free(c->ssl);
+                continue;
+            }
+            if (conn_confirmed(c->ssl) || now_us() >= c->deadline_us) {
+                /* The connection is freed whether or not this completes. */
+                if (SSL_shutdown_ex(c->ssl, SSL_SHUTDOWN_FLAG_RAPID, NULL, 0) != 1)
+                    ERR_clear_error();
+                c->close_sent = 1;
+            }
+            cl[k++] = *c;
+        }
+        ncl = k;
+
+        for (i = 0; i < o->concurrency; i++) {
+            conn_slot *s = &slots[i];
+            conn_rec *r;
+
+            if (s->ssl == NULL)
+                continue;
+
+            r = &recs[s->rec];
+            r->status = poll_conn(s, r, t0);
+            if (r->status == ST_HANDSHAKE && now - r->start_us > timeout_us) {
+                r->done_us = now;
+                r->status = ST_TIMEOUT;
+            }
+            if (r->status != ST_HANDSHAKE) {
+                /* The slot is free again; the close happens in the background */
+                if (!add_closing(&cl, &ncl, &clcap, s->ssl,
+                                 r->status == ST_DONE ? now_us() + timeout_us
+                                                      : 0))
+                    goto err;
+                s->ssl = NULL;
+                inflight--;
+            }
+        }
+    }
+
+    ok = 1;
+err:
+    for (i = 0; slots != NULL && i < o->concurrency; i++)
+        SSL_free(slots[i].ssl);
+    for (j = 0; j < ncl; j++)
+        SSL_free(cl[j].ssl);
+    free(slots);
+    free(cl);
+    *precs = recs;
+    *pnrecs = nrecs;
+    return ok;
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "usage: %s [options] <host> <port>\n"
+            "  --mode closed|open   load model (default closed)\n"
+            "  --concurrency N      handshakes in flight; in open mode the cap\n"
+            "                       on in-flight handshakes (default 1 / %d)\n"
+            "  --rate R             arrivals per second (open mode, required)\n"
+            "                       or pacing limit (closed mode)\n"
+            "  --poisson            exponential inter-arrival times\n"
+            "  --count N            measured handshakes (default %d)\n"
+            "  --duration S         measure for S seconds instead of --count\n"
+            "  --warmup N           extra handshakes before the measured ones\n"
+            "  --groups LIST        key exchange groups, e.g. X25519MLKEM768\n"
+            "  --sigalgs LIST       signature algorithms, e.g. mldsa65\n"
+            "  --timeout MS         per-handshake timeout (default %d)\n"
+            "  --seed N             seed for --poisson (default 1)\n"
+            "  --resume FRACTION    share of connections resuming the newest\n"
+            "                       session ticket, 0 to 1 (default 0)\n"
+            "  --sess-in FILE       session to resume before a ticket arrives\n"
+            "  --sess-out FILE      write the newest session ticket on exit\n"
+            "  --out FILE           per-connection CSV (default handshakes.csv)\n",
+            prog, OPEN_LOOP_MAX_INFLIGHT, DEFAULT_COUNT, DEFAULT_TIMEOUT_MS);
+}
+
+/* ------------------------------ main() ---------------------------------- */
+int main(int argc, char **argv)
+{
+    int rc = 1, fd = -1, concurrency = 0, argi;
+    SSL_CTX *ctx = NULL;
+    SSL *listener = NULL;
+    BIO_ADDR *peer = NULL;
+    conn_rec *recs = NULL;
+    size_t nrecs = 0;
+    loadgen_opts o;
+
+    memset(&o, 0, sizeof(o));
+    o.count = DEFAULT_COUNT;
+    o.timeout_ms = DEFAULT_TIMEOUT_MS;
+    o.seed = 1;
+    o.out_path = "handshakes.csv";
+
+    /* Options take one value each, except --poisson. */
+    for (argi = 1; argi < argc && strncmp(argv[argi], "--", 2) == 0; argi++) {
+        const char *opt = argv[argi], *val;
+
+        if (strcmp(opt, "--poisson") == 0) {
+            o.poisson = 1;
+            continue;
+        }
+        if (argi + 1 >= argc) {
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+        val = argv[++argi];
+
+        if (strcmp(opt, "--mode") == 0 && strcmp(val, "open") == 0) {
+            o.open_loop = 1;
+        } else if (strcmp(opt, "--mode") == 0 && strcmp(val, "closed") == 0) {
+            o.open_loop = 0;
+        } else if (strcmp(opt, "--concurrency") == 0) {
+            concurrency = atoi(val);
+        } else if (strcmp(opt, "--rate") == 0) {
+            o.rate = strtod(val, NULL);
+        } else if (strcmp(opt, "--count") == 0) {
+            o.count = strtol(val, NULL, 0);
+        } else if (strcmp(opt, "--duration") == 0) {
+            o.duration_s = strtod(val, NULL);
+        } else if (strcmp(opt, "--warmup") == 0) {
+            o.warmup = strtol(val, NULL, 0);
+        } else if (strcmp(opt, "--groups") == 0) {
+            o.groups = val;
+        } else if (strcmp(opt, "--sigalgs") == 0) {
+            o.sigalgs = val;
+        } else if (strcmp(opt, "--timeout") == 0) {
+            o.timeout_ms = strtol(val, NULL, 0);
+        } else if (strcmp(opt, "--seed") == 0) {
+            o.seed = (unsigned int)strtoul(val, NULL, 0);
+        } else if (strcmp(opt, "--resume") == 0) {
+            o.resume = strtod(val, NULL);
+        } else if (strcmp(opt, "--sess-in") == 0) {
+            o.sess_in = val;
+        } else if (strcmp(opt, "--sess-out") == 0) {
+            o.sess_out = val;
+        } else if (strcmp(opt, "--out") == 0) {
+            o.out_path = val;
+        } else {
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (argc - argi != 2) {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    o.host = argv[argi];
+    o.port = argv[argi + 1];
+
+    o.concurrency = concurrency > 0 ? concurrency
+                    : o.open_loop ? OPEN_LOOP_MAX_INFLIGHT : DEFAULT_CONCURRENCY;
+    if ((o.open_loop && o.rate <= 0) || o.rate < 0 || o.count <= 0
+            || o.warmup < 0 || o.timeout_ms <= 0 || o.resume < 0
+            || o.resume > 1) {
+        fprintf(stderr, "invalid option values (open mode needs --rate > 0)\n");
+        return EXIT_FAILURE;
+    }
+    srand48(o.seed);
+    /* A session given with --sess-in is meant to be resumed */
+    if (o.sess_in != NULL && o.resume == 0)
+        o.resume = 1;
+
+    if (o.sess_in != NULL && !load_session(o.sess_in))
+        goto err;
+
+    /* Create SSL_CTX. */
+    if ((ctx = create_ctx(&o)) == NULL)
+        goto err;
+
+    /* Create the UDP socket shared by all connections. */
+    if ((fd = create_socket(&o, &peer)) < 0)
+        goto err;
+
+    /* Client-only listener: never accepts, only hosts outgoing connections. */
+    if ((listener = SSL_new_listener(ctx, 0)) == NULL)
+        goto err;
+
+    if (!SSL_set_fd(listener, fd))
+        goto err;
+
+    if (!SSL_set_blocking_mode(listener, 0))
+        goto err;
+
+    if (!run_load(&o, listener, fd, peer, &recs, &nrecs))
+        goto err;
+
+    if (!write_csv(o.out_path, recs, nrecs))
+        goto err;
+
+    print_summary(&o, recs, nrecs);
+
+    if (o.sess_out != NULL && !save_session(o.sess_out))
+        goto err;
+    rc = 0;
+err:
+    if (rc != 0)
+        ERR_print_errors_fp(stderr);
+
+    free(recs);
+    SSL_SESSION_free(cached_session);
+    SSL_free(listener);
+    SSL_CTX_free(ctx);
+    BIO_ADDR_free(peer);
+
+    if (fd != -1)
+        BIO_closesocket(fd);
+
+    return rc;
+}
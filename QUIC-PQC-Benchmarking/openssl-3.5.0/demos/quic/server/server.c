@@ -13,11 +13,16 @@
 #ifdef _WIN32 /* Windows */
 # include <winsock2.h>
 #else /* Linux/Unix */
+# include <sys/socket.h>
 # include <netinet/in.h>
 # include <unistd.h>
 # include <signal.h>
+# include <pthread.h>
+# include <poll.h>
+# include <time.h>
 #endif
 #include <assert.h>
+#include <errno.h>
 #include <string.h> /* For strcmp */
 #include <stdio.h>
 #include <stdlib.h>
@@ -27,6 +32,28 @@
 /* Default: close stream right after sending "hello" (original demo). */
 #define DEFAULT_CLOSE_AFTER_HELLO 1
 
+/* Upper bound for --threads. */
+#define MAX_THREADS 256
+
+/* Upper bound for certificate/key pairs. */
+#define MAX_CERTS 8
+
+/* Longest time a worker sleeps before checking for Ctrl+C. */
+#define POOL_POLL_INTERVAL_MS 100
+
+/* Server configuration from the command line. */
+typedef struct server_opts_st {
+    const char *cert_paths[MAX_CERTS];
+    const char *key_paths[MAX_CERTS];
+    int num_certs, num_keys;
+    const char *groups;         /* key exchange groups, NULL for default */
+    const char *sigalgs;        /* signature algorithms, NULL for default */
+    const char *ciphersuites;   /* TLSv1.3 ciphersuites, NULL for default */
+    int threads;
+    int stats_interval;         /* seconds between stats lines, 0 for none */
+    int close_after_hello;
+} server_opts;
+
 /* ----------------------------- Globals ---------------------------------- */
 
 /* Flag is set when the user presses Ctrl+\ (SIGQUIT) to close the *current* connection. */
@@ -38,6 +65,17 @@ static void handle_sigquit(int sig)
     g_quit_received = 1; /* handled inside the echo loop */
 }
 
+#ifndef _WIN32
+/* Set on Ctrl+C / SIGTERM in pool mode; the workers finish and report. */
+static volatile sig_atomic_t g_stop = 0;
+
+static void handle_stop(int sig)
+{
+    (void)sig;
+    g_stop = 1;
+}
+#endif
+
 /* ------------------------- TLS/QUIC helpers ----------------------------- */
 
 /* ALPN string for TLS handshake */
@@ -62,41 +100,94 @@ static int select_alpn(SSL *ssl,
     return SSL_TLSEXT_ERR_OK;
 }
 
-/* Create SSL_CTX. */
-static SSL_CTX *create_ctx(const char *cert_path, const char *key_path)
+/*
+ * Load one certificate chain and its private key. OpenSSL keeps one chain per
+ * key type and picks the one matching the client's signature_algorithms
+ * during the handshake; a second chain of the same key type replaces the
+ * first.
+ */
+static int load_cert_and_key(SSL_CTX *ctx, const char *cert_path,
+                             const char *key_path)
 {
-    SSL_CTX *ctx;
-
-    ctx = SSL_CTX_new(OSSL_QUIC_server_method());
-    if (ctx == NULL)
-        goto err;
-
-    /* Load certificate and corresponding private key. */
     if (SSL_CTX_use_certificate_chain_file(ctx, cert_path) <= 0) {
         fprintf(stderr, "couldn't load certificate file: %s\n", cert_path);
-        goto err;
+        return 0;
     }
 
     if (SSL_CTX_use_PrivateKey_file(ctx, key_path, SSL_FILETYPE_PEM) <= 0) {
         fprintf(stderr, "couldn't load key file: %s\n", key_path);
-        goto err;
+        return 0;
     }
 
+    /* Checks the chain just loaded, which is now the current one. */
     if (!SSL_CTX_check_private_key(ctx)) {
-        fprintf(stderr, "private key check failed\n");
-        goto err;
+        fprintf(stderr, "private key check failed: %s\n", key_path);
+        return 0;
+    }
+
+    return 1;
+}
+
+/* Print the key type of every loaded certificate chain. */
+static int print_certs(SSL_CTX *ctx)
+{
+    int n = 0;
+    long ok;
+
+    for (ok = SSL_CTX_set_current_cert(ctx, SSL_CERT_SET_FIRST); ok == 1;
+         ok = SSL_CTX_set_current_cert(ctx, SSL_CERT_SET_NEXT)) {
+        X509 *x = SSL_CTX_get0_certificate(ctx);
+        EVP_PKEY *pkey = x != NULL ? X509_get0_pubkey(x) : NULL;
+        const char *name = pkey != NULL ? EVP_PKEY_get0_type_name(pkey) : NULL;
+
+        fprintf(stderr, "=> Certificate %d: %s\n", ++n,
+                name != NULL ? name : "unknown key type");
     }
 
+    return n;
+}
+
+/* Create SSL_CTX. */
+static SSL_CTX *create_ctx(const server_opts *o)
+{
+    SSL_CTX *ctx;
+    int i;
+
+    ctx = SSL_CTX_new(OSSL_QUIC_server_method());
+    if (ctx == NULL)
+        goto err;
+
+    /* Load certificates and corresponding private keys. */
+    for (i = 0; i < o->num_certs; i++)
+        if (!load_cert_and_key(ctx, o->cert_paths[i], o->key_paths[i]))
+            goto err;
+
+    if (print_certs(ctx) < o->num_certs)
+        fprintf(stderr, "warning: certificates with the same key type "
+                "replace each other, only the last one is used\n");
+
     /* Setup ALPN negotiation callback. */
     SSL_CTX_set_alpn_select_cb(ctx, select_alpn, NULL);
 
     /* Optionally set key exchange. */
-    /*
-    if (!SSL_CTX_set1_groups_list(ctx, "x25519:MLKEM512:MLKEM768:MLKEM1024")) {
-        fprintf(stderr, "failed to set key exchange group\n");
+    if (o->groups != NULL && !SSL_CTX_set1_groups_list(ctx, o->groups)) {
+        fprintf(stderr, "failed to set key exchange groups: %s\n", o->groups);
+        goto err;
+    }
+
+    /* Optionally restrict the signature algorithms (and thus certificates). */
+    if (o->sigalgs != NULL && !SSL_CTX_set1_sigalgs_list(ctx, o->sigalgs)) {
+        fprintf(stderr, "failed to set signature algorithms: %s\n",
+                o->sigalgs);
+        goto err;
+    }
+
+    /* Optionally set the TLSv1.3 ciphersuites, i.e. the packet protection. */
+    if (o->ciphersuites != NULL
+            && !SSL_CTX_set_ciphersuites(ctx, o->ciphersuites)) {
+        fprintf(stderr, "failed to set ciphersuites: %s\n", o->ciphersuites);
         goto err;
     }
-    */
 
     return ctx;
 
@@ -105,8 +196,12 @@ err:
     return NULL;
 }
 
-/* Create UDP socket using given port. */
-static int create_socket(uint16_t port)
+/*
+ * Create UDP socket using given port. With \p reuse_port set, several sockets
+ * can be bound to the same port (SO_REUSEPORT) and the kernel spreads the
+ * clients over them by source address and port.
+ */
+static int create_socket(uint16_t port, int reuse_port)
 {
     int fd = -1;
     struct sockaddr_in sa = {0};
@@ -116,6 +211,20 @@ static int create_socket(uint16_t port)
         goto err;
     }
 
+    if (reuse_port) {
+#ifdef SO_REUSEPORT
+        int on = 1;
+
+        if (setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on)) < 0) {
+            perror("setsockopt(SO_REUSEPORT)");
+            goto err;
+        }
+#else
+        fprintf(stderr, "SO_REUSEPORT is not supported on this platform\n");
+        goto err;
+#endif
+    }
+
     sa.sin_family  = AF_INET;
     sa.sin_port    = htons(port);
 
@@ -133,6 +242,62 @@ err:
     return -1;
 }
 
+/* ------------------------ Handshake CPU stats --------------------------- */
+
+/*
+ * CPU time the server thread spent on the cryptography of completed
+ * handshakes, summed over connections (see SSL_get_handshake_cpu_stats()).
+ */
+typedef struct cpu_totals_st {
+    uint64_t handshakes;
+    uint64_t keyshare_ns;       /* key share: (EC)DH, KEM encapsulation */
+    uint64_t sign_ns;           /* CertificateVerify signature */
+    uint64_t record_ns;         /* QUIC packet protection */
+    uint64_t verify_ns;         /* client certificate chain and CertificateVerify */
+} cpu_totals;
+
+static void cpu_totals_add(cpu_totals *t, SSL *conn)
+{
+    SSL_HANDSHAKE_CPU_STATS st;
+
+    if (SSL_get_handshake_cpu_stats(conn, &st) != 1)
+        return;
+
+    t->handshakes++;
+    t->keyshare_ns += st.keyshare_ns;
+    t->sign_ns += st.sign_ns;
+    t->record_ns += st.record_ns;
+    t->verify_ns += st.verify_ns;
+}
+
+/*
+ * Print the average CPU time per handshake in \p t. With \p secs > 0 the
+ * handshake rate and the share of one core spent on these operations over
+ * that period are printed as well.
+ */
+static void print_cpu_totals(const char *label, const cpu_totals *t,
+                             double secs)
+{
+    double n = (double)t->handshakes;
+    double total_ns = (double)(t->keyshare_ns + t->sign_ns + t->record_ns
+                               + t->verify_ns);
+
+    if (t->handshakes == 0) {
+        fprintf(stderr, "%s: 0 handshakes\n", label);
+        return;
+    }
+
+    fprintf(stderr, "%s: %llu handshakes, CPU ms/handshake: key share %.3f, "
+            "signing %.3f, record %.3f, verify %.3f", label,
+            (unsigned long long)t->handshakes, t->keyshare_ns / n / 1e6,
+            t->sign_ns / n / 1e6, t->record_ns / n / 1e6,
+            t->verify_ns / n / 1e6);
+    if (secs > 0)
+        fprintf(stderr, " | %.1f handshakes/s, %.1f%% of a core",
+                n / secs, total_ns / (secs * 1e9) * 100);
+    fputc('\n', stderr);
+}
+
 /* Gracefully conclude the default stream by sending a FIN (no payload). */
 static int conclude_default_stream(SSL *conn)
 {
@@ -237,11 +402,39 @@ static int run_quic_conn(SSL *conn, int close_after_hello)
     return 1;
 }
 
+/* Prints the bytes and datagrams a connection used per encryption level. */
+static void print_level_stats(SSL *conn)
+{
+    static const char *const names[SSL_QUIC_LEVEL_NUM] = {
+        "Initial", "Handshake", "1-RTT"
+    };
+    SSL_QUIC_LEVEL_STATS st;
+    const SSL_QUIC_LEVEL_COUNTERS *c;
+    int i;
+
+    if (SSL_get_quic_level_stats(conn, &st) != 1)
+        return;
+
+    for (i = 0; i < SSL_QUIC_LEVEL_NUM; i++) {
+        c = &st.level[i];
+        fprintf(stderr, "=> %-9s sent %llu bytes in %llu datagrams (padding "
+                "%llu, retransmitted %llu), received %llu bytes in %llu "
+                "datagrams\n", names[i],
+                (unsigned long long)c->bytes_sent,
+                (unsigned long long)c->dgrams_sent,
+                (unsigned long long)c->padding_sent,
+                (unsigned long long)c->retx_bytes_sent,
+                (unsigned long long)c->bytes_received,
+                (unsigned long long)c->dgrams_received);
+    }
+}
+
 /* Main loop for server to accept QUIC connections. */
 static int run_quic_server(SSL_CTX *ctx, int fd, int close_after_hello)
 {
     int ok = 0;
     SSL *listener = NULL, *conn = NULL;
+    SSL_HANDSHAKE_CPU_STATS st;
 
     if ((listener = SSL_new_listener(ctx, 0)) == NULL)
         goto err;
@@ -264,10 +457,17 @@ static int run_quic_server(SSL_CTX *ctx, int fd, int close_after_hello)
             goto err;
         }
 
-        if (!run_quic_conn(conn, close_after_hello)) {
-            SSL_free(conn);
-            goto err;
-        }
+        /* A failed connection, e.g. closed early by the client, is not fatal. */
+        if (!run_quic_conn(conn, close_after_hello))
+            ERR_clear_error();
+
+        if (SSL_is_init_finished(conn)
+                && SSL_get_handshake_cpu_stats(conn, &st) == 1)
+            fprintf(stderr, "=> Handshake CPU: key share %.3f ms, "
+                    "signing %.3f ms, record %.3f ms, verify %.3f ms\n",
+                    st.keyshare_ns / 1e6, st.sign_ns / 1e6,
+                    st.record_ns / 1e6, st.verify_ns / 1e6);
+        print_level_stats(conn);
 
         SSL_free(conn);
     }
@@ -281,26 +481,542 @@ err:
     return ok;
 }
 
+/* ------------------------- Worker pool mode ------------------------------ */
+
+#ifndef _WIN32
+/*
+ * In pool mode every worker thread owns a complete server: its own UDP socket
+ * (all bound to the same port with SO_REUSEPORT), its own listener and thus
+ * its own QUIC engine. A worker never blocks on a single connection; it
+ * SSL_poll()s its listener and all of its connections at once and does
+ * whatever work is ready.
+ *
+ * Handing connections accepted on one listener over to other threads would
+ * not spread the handshake work: all connections of a listener share one
+ * engine, and that engine (including every handshake's key exchange and
+ * signature) is only ever driven by one thread at a time. Separate engines
+ * let the kernel's SO_REUSEPORT distribution keep all cores busy.
+ */
+
+enum pool_conn_state {
+    POOL_CONN_HELLO,    /* accepted, "hello" not sent yet */
+    POOL_CONN_CLOSING,  /* "hello" sent, shutdown in progress */
+    POOL_CONN_DONE      /* terminating, freed after the next tick */
+};
+
+typedef struct pool_conn_st {
+    SSL *ssl;
+    SSL *stream;
+    enum pool_conn_state state;
+} pool_conn;
+
+typedef struct worker_st {
+    int id;
+    SSL_CTX *ctx;
+    uint16_t port;
+    int fd;
+    SSL *listener;
+    pthread_t thread;
+    int started;
+
+    pool_conn *conns;
+    size_t num_conns, conns_cap;
+    SSL_POLL_ITEM *items;
+    size_t items_cap;
+
+    /* Counters, only written by the worker itself. */
+    uint64_t accepted;      /* connections accepted */
+    uint64_t handshakes;    /* connections that completed the handshake */
+    uint64_t failed;        /* connections closed before handshake completion */
+    int ok;
+
+    /* Handshake CPU time, also read by the main thread for --stats. */
+    pthread_mutex_t cpu_lock;
+    cpu_totals cpu;
+} worker;
+
+static void pool_conn_free(worker *w, pool_conn *c)
+{
+    if (SSL_is_init_finished(c->ssl)) {
+        w->handshakes++;
+        pthread_mutex_lock(&w->cpu_lock);
+        cpu_totals_add(&w->cpu, c->ssl);
+        pthread_mutex_unlock(&w->cpu_lock);
+    } else {
+        w->failed++;
+    }
+
+    SSL_free(c->stream);
+    SSL_free(c->ssl);
+}
+
+/*
+ * Advance one connection; \p revents are the events SSL_poll() reported for
+ * it. Returns 0 once the connection is finished and can be freed.
+ *
+ * This does the same as the single-connection mode, send "hello\n" with FIN
+ * and shut down, but never waits. A QUIC server cannot write before the
+ * handshake is complete and there is no poll event for that, so connections
+ * that still handshake are simply retried on every wake-up; every step of a
+ * handshake is a datagram arriving, which wakes the worker anyway.
+ */
+static int pool_conn_step(pool_conn *c, uint64_t revents)
+{
+    size_t written = 0;
+    int ret;
+
+    /*
+     * The connection is terminating: closed by the peer or the idle timeout,
+     * the handshake failed or our own shutdown got that far. Keep it for one
+     * more tick so that a pending CONNECTION_CLOSE still goes out.
+     */
+    if (c->state == POOL_CONN_DONE)
+        return 0;
+    if ((revents & SSL_POLL_EVENT_EC) != 0) {
+        c->state = POOL_CONN_DONE;
+        return 1;
+    }
+
+    if (c->state == POOL_CONN_HELLO) {
+        if (!SSL_is_init_finished(c->ssl))
+            return 1;
+
+        /* Keep the stream until the end so that it is not reset. */
+        if (c->stream == NULL
+                && (c->stream = SSL_new_stream(c->ssl, 0)) == NULL)
+            goto err;
+
+        ret = SSL_write_ex2(c->stream, "hello\n", 6, SSL_WRITE_FLAG_CONCLUDE,
+                            &written);
+        if (ret == 0) {
+            switch (SSL_get_error(c->stream, ret)) {
+            case SSL_ERROR_WANT_READ:
+            case SSL_ERROR_WANT_WRITE:
+                return 1;
+            default:
+                goto err;
+            }
+        }
+        c->state = POOL_CONN_CLOSING;
+    }
+
+    /* POOL_CONN_CLOSING: flush the stream, then send CONNECTION_CLOSE. */
+    ret = SSL_shutdown(c->ssl);
+    if (ret < 0)
+        goto err;
+    if (ret == 1)
+        c->state = POOL_CONN_DONE;
+    return 1;
+
+err:
+    ERR_clear_error();
+    /* The connection is dropped whether or not the shutdown completes. */
+    if (SSL_shutdown_ex(c->ssl, SSL_SHUTDOWN_FLAG_RAPID
+                        | SSL_SHUTDOWN_FLAG_NO_STREAM_FLUSH, NULL, 0) != 1)
+        ERR_clear_error();
+    c->state = POOL_CONN_DONE;
+    return 1;
+}
+
+/* Accept all queued connections on the worker's listener. */
+static int pool_accept(worker *w)
+{
+    SSL *conn;
+
+    while ((conn = SSL_accept_connection(w->listener,
+                                         SSL_ACCEPT_CONNECTION_NO_BLOCK)) != NULL) {
+        if (w->num_conns == w->conns_cap) {
+            size_t cap = w->conns_cap == 0 ? 64 : w->conns_cap * 2;
+            pool_conn *conns = realloc(w->conns, cap * sizeof(*conns));
+
+            if (conns == NULL) {
+                SSL_free(conn);
+                return 0;
+            }
+            w->conns = conns;
+            w->conns_cap = cap;
+        }
+
+        if (!SSL_set_blocking_mode(conn, 0)) {
+            SSL_free(conn);
+            return 0;
+        }
+
+        w->conns[w->num_conns].ssl = conn;
+        w->conns[w->num_conns].stream = NULL;
+        w->conns[w->num_conns].state = POOL_CONN_HELLO;
+        w->num_conns++;
+        w->accepted++;
+    }
+
+    return 1;
+}
+
+/* Create the worker's socket and listener. */
+static int worker_init(worker *w)
+{
+    if ((w->fd = create_socket(w->port, /*reuse_port=*/1)) < 0)
+        return 0;
+
+    if ((w->listener = SSL_new_listener(w->ctx, 0)) == NULL
+            || !SSL_set_fd(w->listener, w->fd)
+            || !SSL_set_blocking_mode(w->listener, 0)
+            || !SSL_listen(w->listener)) {
+        ERR_print_errors_fp(stderr);
+        return 0;
+    }
+
+    return 1;
+}
+
+/*
+ * Wait until the worker's socket is readable (or writable, if the engine has
+ * datagrams queued) or the engine's next timer expires.
+ */
+static void worker_wait(worker *w)
+{
+    struct pollfd pfd;
+    struct timeval tv;
+    int is_infinite = 1, timeout_ms = POOL_POLL_INTERVAL_MS;
+
+    if (SSL_get_event_timeout(w->listener, &tv, &is_infinite) && !is_infinite) {
+        int t = (int)(tv.tv_sec * 1000 + (tv.tv_usec + 999) / 1000);
+
+        if (t < timeout_ms)
+            timeout_ms = t;
+    }
+
+    pfd.fd = w->fd;
+    pfd.events = POLLIN;
+    if (SSL_net_write_desired(w->listener))
+        pfd.events |= POLLOUT;
+    pfd.revents = 0;
+
+    if (poll(&pfd, 1, timeout_ms) < 0 && errno != EINTR)
+        perror("poll");
+}
+
+static void *worker_main(void *arg)
+{
+    worker *w = arg;
+    size_t i, j, num_items, result_count;
+    static const struct timeval immediate = {0, 0};
+
+    while (!g_stop) {
+        /* One tick of the worker's engine serves all of its connections. */
+        worker_wait(w);
+        SSL_handle_events(w->listener);
+
+        num_items = w->num_conns + 1;
+        if (num_items > w->items_cap) {
+            size_t cap = num_items * 2;
+            SSL_POLL_ITEM *items = realloc(w->items, cap * sizeof(*items));
+
+            if (items == NULL)
+                goto err;
+            w->items = items;
+            w->items_cap = cap;
+        }
+
+        /* Item 0 is the listener, item i + 1 is connection i. */
+        memset(w->items, 0, num_items * sizeof(*w->items));
+        w->items[0].desc = SSL_as_poll_descriptor(w->listener);
+        w->items[0].events = SSL_POLL_EVENT_IC | SSL_POLL_EVENT_EL;
+        for (i = 0; i < w->num_conns; i++) {
+            w->items[i + 1].desc = SSL_as_poll_descriptor(w->conns[i].ssl);
+            w->items[i + 1].events = w->conns[i].state == POOL_CONN_DONE
+                ? 0 : SSL_POLL_EVENT_EC;
+        }
+
+        /* The engine was just ticked; only read out the readiness state. */
+        if (!SSL_poll(w->items, num_items, sizeof(*w->items), &immediate,
+                      SSL_POLL_FLAG_NO_HANDLE_EVENTS, &result_count)) {
+            fprintf(stderr, "worker %d: SSL_poll failed\n", w->id);
+            goto err;
+        }
+
+        if ((w->items[0].revents & SSL_POLL_EVENT_EL) != 0) {
+            fprintf(stderr, "worker %d: listener failed\n", w->id);
+            goto err;
+        }
+
+        /* Serve the connections first; accepting grows w->conns. */
+        for (i = j = 0; i < w->num_conns; i++) {
+            if (pool_conn_step(&w->conns[i], w->items[i + 1].revents))
+                w->conns[j++] = w->conns[i];
+            else
+                pool_conn_free(w, &w->conns[i]);
+        }
+        w->num_conns = j;
+
+        if ((w->items[0].revents & SSL_POLL_EVENT_IC) != 0 && !pool_accept(w))
+            goto err;
+    }
+
+    w->ok = 1;
+err:
+    if (!w->ok) {
+        ERR_print_errors_fp(stderr);
+        g_stop = 1;
+    }
+
+    for (i = 0; i < w->num_conns; i++)
+        pool_conn_free(w, &w->conns[i]);
+    w->num_conns = 0;
+    return NULL;
+}
+
+static double monotonic_secs(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* Sum the handshake CPU counters of all workers. */
+static void pool_cpu_totals(worker *workers, int num_threads, cpu_totals *t)
+{
+    int i;
+
+    memset(t, 0, sizeof(*t));
+    for (i = 0; i < num_threads; i++) {
+        pthread_mutex_lock(&workers[i].cpu_lock);
+        t->handshakes += workers[i].cpu.handshakes;
+        t->keyshare_ns += workers[i].cpu.keyshare_ns;
+        t->sign_ns += workers[i].cpu.sign_ns;
+        t->record_ns += workers[i].cpu.record_ns;
+        t->verify_ns += workers[i].cpu.verify_ns;
+        pthread_mutex_unlock(&workers[i].cpu_lock);
+    }
+}
+
+/*
+ * Until Ctrl+C, print the handshakes completed in every \p interval seconds
+ * and the average CPU time they took, over all workers.
+ */
+static void pool_stats_loop(worker *workers, int num_threads, int interval)
+{
+    cpu_totals last = {0}, now, delta;
+    double start = monotonic_secs(), prev = start, t;
+    char label[32];
+
+    while (!g_stop) {
+        poll(NULL, 0, POOL_POLL_INTERVAL_MS);
+        t = monotonic_secs();
+        if (t - prev < interval)
+            continue;
+
+        pool_cpu_totals(workers, num_threads, &now);
+        delta.handshakes = now.handshakes - last.handshakes;
+        delta.keyshare_ns = now.keyshare_ns - last.keyshare_ns;
+        delta.sign_ns = now.sign_ns - last.sign_ns;
+        delta.record_ns = now.record_ns - last.record_ns;
+        delta.verify_ns = now.verify_ns - last.verify_ns;
+
+        snprintf(label, sizeof(label), "stats %7.1fs", t - start);
+        print_cpu_totals(label, &delta, t - prev);
+        last = now;
+        prev = t;
+    }
+}
+
+/*
+ * Run \p num_threads workers until Ctrl+C / SIGTERM, then print what each
+ * of them handled. With \p stats_interval > 0 the handshake rate and CPU
+ * time are printed every \p stats_interval seconds meanwhile.
+ */
+static int run_quic_server_pool(SSL_CTX *ctx, uint16_t port, int num_threads,
+                                int stats_interval)
+{
+    int ok = 0, i;
+    worker *workers;
+    uint64_t accepted = 0, handshakes = 0, failed = 0;
+    cpu_totals cpu;
+    struct sigaction sa = {0};
+
+    if ((workers = calloc(num_threads, sizeof(*workers))) == NULL)
+        return 0;
+
+    for (i = 0; i < num_threads; i++)
+        pthread_mutex_init(&workers[i].cpu_lock, NULL);
+
+    sa.sa_handler = handle_stop;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+
+    /* Bind all sockets before any worker runs so none misses a client. */
+    for (i = 0; i < num_threads; i++) {
+        workers[i].id = i;
+        workers[i].ctx = ctx;
+        workers[i].port = port;
+        workers[i].fd = -1;
+        if (!worker_init(&workers[i]))
+            goto err;
+    }
+
+    for (i = 0; i < num_threads; i++) {
+        if (pthread_create(&workers[i].thread, NULL, worker_main,
+                           &workers[i]) != 0) {
+            fprintf(stderr, "couldn't start worker %d\n", i);
+            g_stop = 1;
+            goto err;
+        }
+        workers[i].started = 1;
+    }
+
+    fprintf(stderr, "=> Serving on port %u with %d worker thread(s), "
+            "Ctrl+C to stop\n", (unsigned int)port, num_threads);
+
+    if (stats_interval > 0)
+        pool_stats_loop(workers, num_threads, stats_interval);
+
+    ok = 1;
+err:
+    for (i = 0; i < num_threads; i++) {
+        if (workers[i].started) {
+            pthread_join(workers[i].thread, NULL);
+            ok = ok && workers[i].ok;
+        }
+    }
+
+    for (i = 0; i < num_threads; i++) {
+        if (workers[i].started)
+            fprintf(stderr,
+                    "worker %2d: accepted %llu, handshakes %llu, failed %llu\n",
+                    i, (unsigned long long)workers[i].accepted,
+                    (unsigned long long)workers[i].handshakes,
+                    (unsigned long long)workers[i].failed);
+        accepted += workers[i].accepted;
+        handshakes += workers[i].handshakes;
+        failed += workers[i].failed;
+
+        SSL_free(workers[i].listener);
+        if (workers[i].fd >= 0)
+            BIO_closesocket(workers[i].fd);
+        free(workers[i].conns);
+        free(workers[i].items);
+    }
+    fprintf(stderr, "total    : accepted %llu, handshakes %llu, failed %llu\n",
+            (unsigned long long)accepted, (unsigned long long)handshakes,
+            (unsigned long long)failed);
+
+    pool_cpu_totals(workers, num_threads, &cpu);
+    print_cpu_totals("total    ", &cpu, 0);
+
+    for (i = 0; i < num_threads; i++)
+        pthread_mutex_destroy(&workers[i].cpu_lock);
+    free(workers);
+    return ok;
+}
+#endif
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "usage: %s [options] <port> [<server.crt> <server.key>] [--keep-open]\n"
+            "  --cert FILE         certificate chain; may be repeated (max %d), the\n"
+            "                      chain matching the client's signature_algorithms\n"
+            "                      is used\n"
+            "  --key FILE          private key for the preceding --cert\n"
+            "  --groups LIST       key exchange groups, e.g. X25519MLKEM768:MLKEM512\n"
+            "  --sigalgs LIST      signature algorithms, e.g. mldsa44:ecdsa_secp256r1_sha256\n"
+            "  --ciphersuites LIST TLSv1.3 ciphersuites, e.g. TLS_AES_128_GCM_SHA256\n"
+            "  --threads N         serve many connections at once with N worker\n"
+            "                      threads (pool mode, max %d)\n"
+            "  --stats SECONDS     print the handshake rate and CPU time per\n"
+            "                      handshake every SECONDS seconds (pool mode)\n"
+            "  --keep-open         keep the stream open and echo what the client\n"
+            "                      sends (single-connection mode only)\n",
+            prog, MAX_CERTS, MAX_THREADS);
+}
+
 /* ------------------------------ main() ---------------------------------- */
 int main(int argc, char **argv)
 {
-    int rc = 1;
+    int rc = 1, argi, npos;
     SSL_CTX *ctx = NULL;
     int fd = -1;
     unsigned long port;
+    server_opts o;
+
+    memset(&o, 0, sizeof(o));
+    o.close_after_hello = DEFAULT_CLOSE_AFTER_HELLO;
+
+    /* Options take one value each, except --keep-open. */
+    for (argi = 1; argi < argc && strncmp(argv[argi], "--", 2) == 0; argi++) {
+        const char *opt = argv[argi], *val;
+
+        if (strcmp(opt, "--keep-open") == 0) {
+            o.close_after_hello = 0;
+            continue;
+        }
+        if (argi + 1 >= argc) {
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+        val = argv[++argi];
+
+        if (strcmp(opt, "--cert") == 0 && o.num_certs < MAX_CERTS) {
+            o.cert_paths[o.num_certs++] = val;
+        } else if (strcmp(opt, "--key") == 0 && o.num_keys < o.num_certs) {
+            o.key_paths[o.num_keys++] = val;
+        } else if (strcmp(opt, "--groups") == 0) {
+            o.groups = val;
+        } else if (strcmp(opt, "--sigalgs") == 0) {
+            o.sigalgs = val;
+        } else if (strcmp(opt, "--ciphersuites") == 0) {
+            o.ciphersuites = val;
+        } else if (strcmp(opt, "--threads") == 0) {
+            o.threads = atoi(val);
+        } else if (strcmp(opt, "--stats") == 0) {
+            o.stats_interval = atoi(val);
+        } else {
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
 
-    int close_after_hello = DEFAULT_CLOSE_AFTER_HELLO;
+    /* Optional behaviour flag, also accepted after the positional arguments. */
+    npos = argc - argi;
+    if (npos > 1 && strcmp(argv[argc - 1], "--keep-open") == 0) {
+        o.close_after_hello = 0;
+        npos--;
+    }
 
-    if (argc < 4) {
-        fprintf(stderr,
-                "usage: %s <port> <server.crt> <server.key> [--keep-open]\n",
-                argv[0]);
+    /* The positional certificate and key are one more pair. */
+    if (npos == 3 && o.num_certs < MAX_CERTS) {
+        o.cert_paths[o.num_certs++] = argv[argi + 1];
+        o.key_paths[o.num_keys++] = argv[argi + 2];
+    } else if (npos != 1) {
+        usage(argv[0]);
         return EXIT_FAILURE;
     }
 
-    /* Optional behaviour flag. */
-    if (argc >= 5 && strcmp(argv[4], "--keep-open") == 0)
-        close_after_hello = 0;
+    if (o.num_certs == 0 || o.num_keys != o.num_certs) {
+        fprintf(stderr, "every certificate needs a key\n");
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    if (o.threads < 0 || o.threads > MAX_THREADS) {
+        fprintf(stderr, "invalid thread count: %d\n", o.threads);
+        return EXIT_FAILURE;
+    }
+    if (o.stats_interval < 0 || (o.stats_interval > 0 && o.threads == 0)) {
+        fprintf(stderr, "--stats needs a positive interval and --threads\n");
+        return EXIT_FAILURE;
+    }
+    if (o.threads > 0 && !o.close_after_hello) {
+        fprintf(stderr, "--keep-open needs the single-connection mode\n");
+        return EXIT_FAILURE;
+    }
+#ifdef _WIN32
+    if (o.threads > 0) {
+        fprintf(stderr, "--threads is not supported on Windows\n");
+        return EXIT_FAILURE;
+    }
+#endif
 
     /* Install Ctrl+C handler (only on non‑Windows). */
 #ifndef _WIN32
@@ -311,23 +1027,32 @@ int main(int argc, char **argv)
 #endif
 
     /* Create SSL_CTX. */
-    if ((ctx = create_ctx(argv[2], argv[3])) == NULL)
+    if ((ctx = create_ctx(&o)) == NULL)
         goto err;
 
     /* Parse port number. */
-    port = strtoul(argv[1], NULL, 0);
+    port = strtoul(argv[argi], NULL, 0);
     if (port == 0 || port > UINT16_MAX) {
         fprintf(stderr, "invalid port: %lu\n", port);
         goto err;
     }
 
-    /* Create UDP socket. */
-    if ((fd = create_socket((uint16_t)port)) < 0)
-        goto err;
+    if (o.threads > 0) {
+#ifndef _WIN32
+        /* Pool mode: each worker creates its own socket and listener. */
+        if (!run_quic_server_pool(ctx, (uint16_t)port, o.threads,
+                                  o.stats_interval))
+            goto err;
+#endif
+    } else {
+        /* Create UDP socket. */
+        if ((fd = create_socket((uint16_t)port, /*reuse_port=*/0)) < 0)
+            goto err;
 
-    /* Run the QUIC server loop. */
-    if (!run_quic_server(ctx, fd, close_after_hello))
-        goto err;
+        /* Run the QUIC server loop. */
+        if (!run_quic_server(ctx, fd, o.close_after_hello))
+            goto err;
+    }
 
     rc = 0;
 err:
@@ -319,6 +319,23 @@ OSSL_STATM *ossl_quic_channel_get_statm(QUIC_CHANNEL *ch);
 /* Gets the TLS handshake layer used with the channel. */
 SSL *ossl_quic_channel_get0_tls(QUIC_CHANNEL *ch);
 
+/*
+ * Gets the thread CPU time in nanoseconds spent on packet protection in both
+ * directions until the handshake was confirmed.
+ */
+uint64_t ossl_quic_channel_get_handshake_protect_cpu_ns(QUIC_CHANNEL *ch);
+
+/*
+ * Gets the number of packet generation attempts of a server that the 3x
+ * anti-amplification limit blocked so far, before the client address was
+ * validated. This is not a count of the packets that were held back.
+ */
+uint64_t ossl_quic_channel_get_amplification_blocked(QUIC_CHANNEL *ch);
+
+/* Gets the traffic counters per encryption level, see SSL_get_quic_level_stats(3) */
+void ossl_quic_channel_get_level_stats(QUIC_CHANNEL *ch,
+                                       SSL_QUIC_LEVEL_STATS *stats);
+
 /* Gets the channels short header connection id length */
 size_t ossl_quic_channel_get_short_header_conn_id_len(QUIC_CHANNEL *ch);
 
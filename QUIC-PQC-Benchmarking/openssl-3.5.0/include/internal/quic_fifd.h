@@ -48,6 +48,8 @@ struct quic_fifd_st {
     void           *sstream_updated_arg;
     QLOG         *(*get_qlog_cb)(void *arg);
     void           *get_qlog_cb_arg;
+    /* Stream and CRYPTO bytes sent again after loss, per PN space */
+    uint64_t        retx_bytes[QUIC_PN_SPACE_NUM];
 };
 
 int ossl_quic_fifd_init(QUIC_FIFD *fifd,
@@ -83,6 +85,12 @@ int ossl_quic_fifd_pkt_commit(QUIC_FIFD *fifd, QUIC_TXPIM_PKT *pkt);
 void ossl_quic_fifd_set_qlog_cb(QUIC_FIFD *fifd, QLOG *(*get_qlog_cb)(void *arg),
                                 void *arg);
 
+/*
+ * Returns the number of stream and CRYPTO frame bytes committed in the given
+ * PN space which had been transmitted before.
+ */
+uint64_t ossl_quic_fifd_get_retx_bytes(const QUIC_FIFD *fifd, uint32_t pn_space);
+
 # endif
 
 #endif
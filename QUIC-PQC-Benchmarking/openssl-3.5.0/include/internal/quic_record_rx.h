@@ -496,6 +496,21 @@ void ossl_qrx_allow_1rtt_processing(OSSL_QRX *qrx);
  */
 uint64_t ossl_qrx_get_key_epoch(OSSL_QRX *qrx);
 
+/*
+ * Enables or disables accounting of the thread CPU time spent on removing
+ * packet protection. ossl_qrx_get_protect_cpu_ns() returns the time accumulated
+ * while accounting was enabled, in nanoseconds.
+ */
+void ossl_qrx_set_cpu_accounting(OSSL_QRX *qrx, int enable);
+uint64_t ossl_qrx_get_protect_cpu_ns(OSSL_QRX *qrx);
+
+/*
+ * Gets the counters of packets successfully decrypted at the given encryption
+ * level. Returns 0 if enc_level is invalid.
+ */
+int ossl_qrx_get_level_stats(OSSL_QRX *qrx, uint32_t enc_level,
+                             OSSL_QRL_LEVEL_STATS *stats);
+
 /*
  * Sets an optional callback which will be called when the key epoch changes.
  *
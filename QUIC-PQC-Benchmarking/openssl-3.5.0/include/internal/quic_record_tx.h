@@ -388,6 +388,21 @@ uint64_t ossl_qtx_get_max_epoch_pkt_count(OSSL_QTX *qtx, uint32_t enc_level);
  */
 uint64_t ossl_qtx_get_key_epoch(OSSL_QTX *qtx);
 
+/*
+ * Enables or disables accounting of the thread CPU time spent on packet
+ * protection. ossl_qtx_get_protect_cpu_ns() returns the time accumulated while
+ * accounting was enabled, in nanoseconds.
+ */
+void ossl_qtx_set_cpu_accounting(OSSL_QTX *qtx, int enable);
+uint64_t ossl_qtx_get_protect_cpu_ns(OSSL_QTX *qtx);
+
+/*
+ * Gets the counters of packets written at the given encryption level. Returns 0
+ * if enc_level is invalid.
+ */
+int ossl_qtx_get_level_stats(OSSL_QTX *qtx, uint32_t enc_level,
+                             OSSL_QRL_LEVEL_STATS *stats);
+
 # endif
 
 #endif
@@ -111,6 +111,17 @@ uint64_t ossl_qrl_get_suite_max_pkt(uint32_t suite_id);
  */
 uint64_t ossl_qrl_get_suite_max_forged_pkt(uint32_t suite_id);
 
+/*
+ * Per encryption level traffic counters kept by the QTX and QRX. Byte counts
+ * are of protected packets as they appear on the wire, a datagram is counted
+ * once for every encryption level it carries a packet of.
+ */
+typedef struct ossl_qrl_level_stats_st {
+    uint64_t pkts;
+    uint64_t bytes;
+    uint64_t dgrams;
+} OSSL_QRL_LEVEL_STATS;
+
 # endif
 
 #endif
@@ -164,6 +164,12 @@ int ossl_quic_sstream_mark_transmitted(QUIC_SSTREAM *qss,
                                        uint64_t start,
                                        uint64_t end);
 
+/*
+ * Returns one past the highest logical offset ever marked as transmitted, i.e.
+ * bytes below this offset which are transmitted again are retransmissions.
+ */
+uint64_t ossl_quic_sstream_get_tx_end(QUIC_SSTREAM *qss);
+
 /*
  * (For TX packetizer use.) Marks a STREAM frame with the FIN bit set as having
  * been transmitted. final_size is the final size of the stream (i.e., the value
@@ -73,6 +73,11 @@ void ossl_quic_tx_packetiser_consume_unvalidated_credit(OSSL_QUIC_TX_PACKETISER
                                                         size_t credit);
 int ossl_quic_tx_packetiser_check_unvalidated_credit(OSSL_QUIC_TX_PACKETISER *txp,
                                                      size_t req_credit);
+uint64_t ossl_quic_tx_packetiser_get_amplification_blocked(const OSSL_QUIC_TX_PACKETISER *txp);
+uint64_t ossl_quic_tx_packetiser_get_padding_sent(const OSSL_QUIC_TX_PACKETISER *txp,
+                                                  uint32_t enc_level);
+uint64_t ossl_quic_tx_packetiser_get_retx_bytes(const OSSL_QUIC_TX_PACKETISER *txp,
+                                                uint32_t pn_space);
 
 typedef void (ossl_quic_initial_token_free_fn)(const unsigned char *buf,
                                                size_t buf_len, void *arg);
@@ -56,7 +56,42 @@ int ossl_sha3_update(KECCAK1600_CTX *ctx, const void *_inp, size_t len);
 int ossl_sha3_final(KECCAK1600_CTX *ctx, unsigned char *out, size_t outlen);
 int ossl_sha3_squeeze(KECCAK1600_CTX *ctx, unsigned char *out, size_t outlen);
 
+/*
+ * Internal users, such as the post-quantum algorithms, which hash many short
+ * inputs may call the functions above directly rather than through EVP.  Such
+ * a context is set up with ossl_sha3_direct_init() and one of these pads.
+ */
+# define SHA3_PAD   0x06
+# define SHAKE_PAD  0x1f
+
+void ossl_sha3_direct_init(KECCAK1600_CTX *ctx, unsigned char pad,
+                           size_t bitlen);
+
 size_t SHA3_absorb(uint64_t A[5][5], const unsigned char *inp, size_t len,
                    size_t r);
 
+/*
+ * Four SHAKE instances of the same strength run side by side, for the
+ * independent streams of the ML-KEM and ML-DSA samplers.  Each instance
+ * absorbs one input, all of the same length, and is then squeezed.  Only the
+ * last squeeze may be for a length which is not a multiple of the block size.
+ * With AVX2 the four Keccak states are permuted together, otherwise they are
+ * processed one after the other by SHA3_absorb() and SHA3_squeeze().
+ */
+typedef struct keccak1600_x4_st {
+    union {
+        uint64_t A[4][5][5];    /* Four separate states */
+        uint64_t L[25][4];      /* Interleaved by lane, for SIMD */
+    } st;
+    size_t block_size;
+    int next;
+    int simd;
+} KECCAK1600_X4_CTX;
+
+void ossl_shake_x4_init(KECCAK1600_X4_CTX *ctx, size_t bitlen);
+void ossl_shake_x4_absorb(KECCAK1600_X4_CTX *ctx,
+                          const unsigned char *const in[4], size_t len);
+void ossl_shake_x4_squeeze(KECCAK1600_X4_CTX *ctx, unsigned char *const out[4],
+                           size_t len);
+
 #endif /* OSSL_INTERNAL_SHA3_H */
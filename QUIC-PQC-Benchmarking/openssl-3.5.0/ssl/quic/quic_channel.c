@@ -91,6 +91,7 @@ static int ch_discard_el(QUIC_CHANNEL *ch,
 static void ch_on_idle_timeout(QUIC_CHANNEL *ch);
 static void ch_update_idle(QUIC_CHANNEL *ch);
 static void ch_update_ping_deadline(QUIC_CHANNEL *ch);
+static void ch_timeline_mark(QUIC_CHANNEL *ch, int event);
 static void ch_on_terminating_timeout(QUIC_CHANNEL *ch);
 static void ch_start_terminating(QUIC_CHANNEL *ch,
                                  const QUIC_TERMINATE_CAUSE *tcause,
@@ -191,6 +192,9 @@ static int ch_init(QUIC_CHANNEL *ch)
     if (ch->qtx == NULL)
         goto err;
 
+    /* Packet protection CPU time is accounted until handshake confirmation. */
+    ossl_qtx_set_cpu_accounting(ch->qtx, 1);
+
     ch->txpim = ossl_quic_txpim_new();
     if (ch->txpim == NULL)
         goto err;
@@ -331,6 +335,8 @@ static int ch_init(QUIC_CHANNEL *ch)
                                         rxku_detected,
                                         ch))
             goto err;
+
+        ossl_qrx_set_cpu_accounting(ch->qrx, 1);
     }
 
 
@@ -455,6 +461,8 @@ void ossl_quic_channel_bind_qrx(QUIC_CHANNEL *tserver_ch, OSSL_QRX *qrx)
                                         tserver_ch);
         ossl_qrx_set_key_update_cb(tserver_ch->qrx, rxku_detected,
                                    tserver_ch);
+        ossl_qrx_set_cpu_accounting(tserver_ch->qrx,
+                                    !tserver_ch->handshake_confirmed);
     }
 }
 
@@ -546,6 +554,58 @@ QUIC_STREAM_MAP *ossl_quic_channel_get_qsm(QUIC_CHANNEL *ch)
     return &ch->qsm;
 }
 
+uint64_t ossl_quic_channel_get_handshake_protect_cpu_ns(QUIC_CHANNEL *ch)
+{
+    uint64_t ns = ossl_qtx_get_protect_cpu_ns(ch->qtx);
+
+    if (ch->qrx != NULL)
+        ns += ossl_qrx_get_protect_cpu_ns(ch->qrx);
+
+    return ns;
+}
+
+uint64_t ossl_quic_channel_get_amplification_blocked(QUIC_CHANNEL *ch)
+{
+    return ossl_quic_tx_packetiser_get_amplification_blocked(ch->txp);
+}
+
+void ossl_quic_channel_get_level_stats(QUIC_CHANNEL *ch,
+                                       SSL_QUIC_LEVEL_STATS *stats)
+{
+    uint32_t enc_level, pn_space;
+    OSSL_QRL_LEVEL_STATS tx, rx;
+    SSL_QUIC_LEVEL_COUNTERS *c;
+
+    memset(stats, 0, sizeof(*stats));
+
+    /*
+     * The reported levels are numbered like the PN spaces, so 0-RTT and 1-RTT
+     * packets are both counted as application data.
+     */
+    for (enc_level = 0; enc_level < QUIC_ENC_LEVEL_NUM; ++enc_level) {
+        c = &stats->level[ossl_quic_enc_level_to_pn_space(enc_level)];
+
+        if (ossl_qtx_get_level_stats(ch->qtx, enc_level, &tx)) {
+            c->dgrams_sent  += tx.dgrams;
+            c->pkts_sent    += tx.pkts;
+            c->bytes_sent   += tx.bytes;
+        }
+        c->padding_sent += ossl_quic_tx_packetiser_get_padding_sent(ch->txp,
+                                                                    enc_level);
+
+        if (ch->qrx != NULL
+            && ossl_qrx_get_level_stats(ch->qrx, enc_level, &rx)) {
+            c->dgrams_received  += rx.dgrams;
+            c->pkts_received    += rx.pkts;
+            c->bytes_received   += rx.bytes;
+        }
+    }
+
+    for (pn_space = 0; pn_space < QUIC_PN_SPACE_NUM; ++pn_space)
+        stats->level[pn_space].retx_bytes_sent
+            = ossl_quic_tx_packetiser_get_retx_bytes(ch->txp, pn_space);
+}
+
 OSSL_STATM *ossl_quic_channel_get_statm(QUIC_CHANNEL *ch)
 {
     return &ch->statm;
@@ -2694,6 +2754,8 @@ static int ch_tx(QUIC_CHANNEL *ch, int *notify_other_threads)
         */
         res = ossl_quic_tx_packetiser_generate(ch->txp, &status);
         if (status.sent_pkt > 0) {
+            if (!ch->have_sent_any_pkt)
+                ch_timeline_mark(ch, SSL_HANDSHAKE_EVENT_FIRST_INITIAL_SENT);
             ch->have_sent_any_pkt = 1; /* Packet(s) were sent */
             ch->port->have_sent_any_pkt = 1;
 
@@ -3066,6 +3128,15 @@ static int ch_discard_el(QUIC_CHANNEL *ch,
     return 1;
 }
 
+/* Record a transport-level event in the TLS handshake timeline. */
+static void ch_timeline_mark(QUIC_CHANNEL *ch, int event)
+{
+    SSL_CONNECTION *sc;
+
+    if (ch->tls != NULL && (sc = SSL_CONNECTION_FROM_SSL(ch->tls)) != NULL)
+        ossl_ssl_timeline_mark(sc, event);
+}
+
 /* Intended to be called by the RXDP. */
 int ossl_quic_channel_on_handshake_confirmed(QUIC_CHANNEL *ch)
 {
@@ -3086,6 +3157,9 @@ int ossl_quic_channel_on_handshake_confirmed(QUIC_CHANNEL *ch)
 
     ch_discard_el(ch, QUIC_ENC_LEVEL_HANDSHAKE);
     ch->handshake_confirmed = 1;
+    ch_timeline_mark(ch, SSL_HANDSHAKE_EVENT_CONFIRMED);
+    ossl_qtx_set_cpu_accounting(ch->qtx, 0);
+    ossl_qrx_set_cpu_accounting(ch->qrx, 0);
     ch_record_state_transition(ch, ch->state);
     ossl_ackm_on_handshake_confirmed(ch->ackm);
     return 1;
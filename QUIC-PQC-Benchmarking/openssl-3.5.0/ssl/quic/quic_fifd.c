@@ -56,6 +56,7 @@ int ossl_quic_fifd_init(QUIC_FIFD *fifd,
     fifd->sstream_updated_arg   = sstream_updated_arg;
     fifd->get_qlog_cb           = get_qlog_cb;
     fifd->get_qlog_cb_arg       = get_qlog_cb_arg;
+    memset(fifd->retx_bytes, 0, sizeof(fifd->retx_bytes));
     return 1;
 }
 
@@ -255,6 +256,7 @@ int ossl_quic_fifd_pkt_commit(QUIC_FIFD *fifd, QUIC_TXPIM_PKT *pkt)
     const QUIC_TXPIM_CHUNK *chunks;
     size_t i, num_chunks;
     QUIC_SSTREAM *sstream;
+    uint64_t tx_end;
 
     pkt->fifd                   = fifd;
 
@@ -288,6 +290,13 @@ int ossl_quic_fifd_pkt_commit(QUIC_FIFD *fifd, QUIC_TXPIM_PKT *pkt)
         if (sstream == NULL)
             continue;
 
+        /* Count the part of the chunk which was transmitted before. */
+        tx_end = ossl_quic_sstream_get_tx_end(sstream);
+        if (chunks[i].end >= chunks[i].start && chunks[i].start < tx_end)
+            fifd->retx_bytes[pkt->ackm_pkt.pkt_space]
+                += (chunks[i].end < tx_end ? chunks[i].end + 1 : tx_end)
+                   - chunks[i].start;
+
         if (chunks[i].end >= chunks[i].start
             && !ossl_quic_sstream_mark_transmitted(sstream,
                                                    chunks[i].start,
@@ -310,3 +319,11 @@ void ossl_quic_fifd_set_qlog_cb(QUIC_FIFD *fifd, QLOG *(*get_qlog_cb)(void *arg)
     fifd->get_qlog_cb       = get_qlog_cb;
     fifd->get_qlog_cb_arg   = get_qlog_cb_arg;
 }
+
+uint64_t ossl_quic_fifd_get_retx_bytes(const QUIC_FIFD *fifd, uint32_t pn_space)
+{
+    if (pn_space >= QUIC_PN_SPACE_NUM)
+        return 0;
+
+    return fifd->retx_bytes[pn_space];
+}
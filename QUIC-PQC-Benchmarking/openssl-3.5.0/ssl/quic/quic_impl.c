@@ -1647,6 +1647,37 @@ long ossl_quic_ctrl(SSL *s, int cmd, long larg, void *parg)
         /* For legacy compatibility with DTLS calls. */
         return ossl_quic_handle_events(s) == 1 ? 1 : -1;
 
+    case SSL_CTRL_GET_HANDSHAKE_CPU_STATS:
+        {
+            long ret;
+
+            if (ctx.is_listener)
+                return QUIC_RAISE_NON_NORMAL_ERROR(&ctx, ERR_R_UNSUPPORTED, NULL);
+
+            /* Key share and signing times are kept by the handshake layer. */
+            ret = SSL_ctrl(ctx.qc->tls, cmd, larg, parg);
+            if (ret <= 0)
+                return ret;
+
+            qctx_lock(&ctx);
+            ((SSL_HANDSHAKE_CPU_STATS *)parg)->record_ns
+                = ossl_quic_channel_get_handshake_protect_cpu_ns(ctx.qc->ch);
+            qctx_unlock(&ctx);
+            return ret;
+        }
+
+    case SSL_CTRL_GET_QUIC_LEVEL_STATS:
+        if (ctx.is_listener)
+            return QUIC_RAISE_NON_NORMAL_ERROR(&ctx, ERR_R_UNSUPPORTED, NULL);
+
+        if (parg == NULL)
+            return 0;
+
+        qctx_lock(&ctx);
+        ossl_quic_channel_get_level_stats(ctx.qc->ch, parg);
+        qctx_unlock(&ctx);
+        return 1;
+
         /* Mask ctrls we shouldn't support for QUIC. */
     case SSL_CTRL_GET_READ_AHEAD:
     case SSL_CTRL_SET_READ_AHEAD:
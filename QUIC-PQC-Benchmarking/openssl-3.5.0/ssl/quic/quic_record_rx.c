@@ -61,6 +61,9 @@ struct rxe_st {
     /* Total length of the datagram which contained this packet. */
     size_t              datagram_len;
 
+    /* Length of the packet as received, i.e. still protected. */
+    size_t              pkt_len;
+
     /*
      * The key epoch the packet was received with. Always 0 for non-1-RTT
      * packets.
@@ -167,6 +170,20 @@ struct ossl_qrx_st {
     /* Are we allowed to process 1-RTT packets yet? */
     unsigned char                   allow_1rtt;
 
+    /*
+     * Thread CPU time spent removing packet protection (header protection and
+     * AEAD) while CPU accounting is enabled.
+     */
+    uint64_t                        protect_cpu_ns;
+    unsigned char                   cpu_accounting;
+
+    /*
+     * Traffic counters per encryption level, and the set of encryption levels
+     * (bit mask) of which a packet was processed in the current datagram.
+     */
+    OSSL_QRL_LEVEL_STATS            level_stats[QUIC_ENC_LEVEL_NUM];
+    uint32_t                        cur_dgram_levels;
+
     /* Message callback related arguments */
     ossl_msg_cb msg_callback;
     void *msg_callback_arg;
@@ -274,14 +291,26 @@ void ossl_qrx_inject_urxe(OSSL_QRX *qrx, QUIC_URXE *urxe)
 void ossl_qrx_inject_pkt(OSSL_QRX *qrx, OSSL_QRX_PKT *pkt)
 {
     RXE *rxe = (RXE *)pkt;
+    uint32_t enc_level = ossl_quic_pkt_type_to_enc_level(rxe->hdr.type);
 
     /*
      * port_default_packet_handler() uses ossl_qrx_read_pkt()
      * to get pkt. Such packet has refcount 1.
      */
     ossl_qrx_pkt_orphan(pkt);
-    if (ossl_assert(rxe->refcount == 0))
+    if (ossl_assert(rxe->refcount == 0)) {
         ossl_list_rxe_insert_tail(&qrx->rx_pending, rxe);
+
+        /*
+         * The packet comes from a QRX used to validate the first packet of a
+         * datagram, see ossl_qrx_validate_initial_packet().
+         */
+        if (enc_level < QUIC_ENC_LEVEL_NUM) {
+            ++qrx->level_stats[enc_level].pkts;
+            qrx->level_stats[enc_level].bytes += rxe->pkt_len;
+            ++qrx->level_stats[enc_level].dgrams;
+        }
+    }
 }
 
 /*
@@ -424,6 +453,15 @@ static int qrx_validate_initial_pkt(OSSL_QRX *qrx, QUIC_URXE *urxe,
 
     pkt_mark(&urxe->processed, 0);
 
+    /*
+     * The packet ends where its payload ends, hdr.len still being the length
+     * of the protected payload.
+     */
+    rxe->pkt_len        = rxe->hdr.data + rxe->hdr.len - sop;
+    ++qrx->level_stats[QUIC_ENC_LEVEL_INITIAL].pkts;
+    qrx->level_stats[QUIC_ENC_LEVEL_INITIAL].bytes += rxe->pkt_len;
+    ++qrx->level_stats[QUIC_ENC_LEVEL_INITIAL].dgrams;
+
     /*
      * Update header to point to the decrypted buffer, which may be shorter
      * due to AEAD tags, block padding, etc.
@@ -1011,6 +1049,7 @@ static int qrx_process_pkt(OSSL_QRX *qrx, QUIC_URXE *urxe,
     uint32_t pn_space, enc_level;
     OSSL_QRL_ENC_LEVEL *el = NULL;
     uint64_t rx_key_epoch = UINT64_MAX;
+    uint64_t cpu_start = 0;
 
     /*
      * Get a free RXE. If we need to allocate a new one, use the packet length
@@ -1154,6 +1193,9 @@ static int qrx_process_pkt(OSSL_QRX *qrx, QUIC_URXE *urxe,
     /* Now remove header protection. */
     *pkt = orig_pkt;
 
+    if (qrx->cpu_accounting)
+        cpu_start = ossl_ssl_thread_cpu_ns();
+
     el = ossl_qrl_enc_level_set_get(&qrx->el_set, enc_level, 1);
     assert(el != NULL); /* Already checked above */
 
@@ -1219,6 +1261,9 @@ static int qrx_process_pkt(OSSL_QRX *qrx, QUIC_URXE *urxe,
                               rxe->hdr.key_phase, &rx_key_epoch))
         goto malformed;
 
+    if (qrx->cpu_accounting)
+        qrx->protect_cpu_ns += ossl_ssl_thread_cpu_ns() - cpu_start;
+
     /*
      * -----------------------------------------------------
      *   IMPORTANT: ANYTHING ABOVE THIS LINE IS UNVERIFIED
@@ -1255,6 +1300,11 @@ static int qrx_process_pkt(OSSL_QRX *qrx, QUIC_URXE *urxe,
      */
     pkt_mark(&urxe->processed, pkt_idx);
 
+    rxe->pkt_len = eop - sop;
+    ++qrx->level_stats[enc_level].pkts;
+    qrx->level_stats[enc_level].bytes += rxe->pkt_len;
+    qrx->cur_dgram_levels |= 1U << enc_level;
+
     /*
      * Update header to point to the decrypted buffer, which may be shorter
      * due to AEAD tags, block padding, etc.
@@ -1335,8 +1385,10 @@ static int qrx_process_datagram(OSSL_QRX *qrx, QUIC_URXE *e,
     PACKET pkt;
     size_t pkt_idx = 0;
     QUIC_CONN_ID first_dcid = { 255 };
+    uint32_t enc_level;
 
     qrx->bytes_received += data_len;
+    qrx->cur_dgram_levels = 0;
 
     if (!PACKET_buf_init(&pkt, data, data_len))
         return 0;
@@ -1368,6 +1420,14 @@ static int qrx_process_datagram(OSSL_QRX *qrx, QUIC_URXE *e,
             have_deferred = 1;
     }
 
+    /*
+     * A deferred datagram is processed again later, but then only the packets
+     * of other encryption levels remain.
+     */
+    for (enc_level = 0; enc_level < QUIC_ENC_LEVEL_NUM; ++enc_level)
+        if ((qrx->cur_dgram_levels & (1U << enc_level)) != 0)
+            ++qrx->level_stats[enc_level].dgrams;
+
     /* Only report whether there were any deferrals. */
     return have_deferred;
 }
@@ -1522,6 +1582,26 @@ int ossl_qrx_set_key_update_cb(OSSL_QRX *qrx,
     return 1;
 }
 
+void ossl_qrx_set_cpu_accounting(OSSL_QRX *qrx, int enable)
+{
+    qrx->cpu_accounting = (enable != 0);
+}
+
+uint64_t ossl_qrx_get_protect_cpu_ns(OSSL_QRX *qrx)
+{
+    return qrx->protect_cpu_ns;
+}
+
+int ossl_qrx_get_level_stats(OSSL_QRX *qrx, uint32_t enc_level,
+                             OSSL_QRL_LEVEL_STATS *stats)
+{
+    if (enc_level >= QUIC_ENC_LEVEL_NUM)
+        return 0;
+
+    *stats = qrx->level_stats[enc_level];
+    return 1;
+}
+
 uint64_t ossl_qrx_get_key_epoch(OSSL_QRX *qrx)
 {
     OSSL_QRL_ENC_LEVEL *el = ossl_qrl_enc_level_set_get(&qrx->el_set,
@@ -99,6 +99,20 @@ struct ossl_qtx_st {
     /* Datagram counter. Increases monotonically per datagram (not per packet). */
     uint64_t                    datagram_count;
 
+    /*
+     * Thread CPU time spent on packet protection (AEAD and header protection)
+     * while CPU accounting is enabled.
+     */
+    uint64_t                    protect_cpu_ns;
+    unsigned char               cpu_accounting;
+
+    /*
+     * Traffic counters per encryption level, and the set of encryption levels
+     * (bit mask) with a packet in the datagram under construction.
+     */
+    OSSL_QRL_LEVEL_STATS        level_stats[QUIC_ENC_LEVEL_NUM];
+    uint32_t                    cons_levels;
+
     ossl_mutate_packet_cb mutatecb;
     ossl_finish_mutate_cb finishmutatecb;
     void *mutatearg;
@@ -704,6 +718,11 @@ static int qtx_write(OSSL_QTX *qtx, const OSSL_QTX_PKT *pkt, TXE *txe,
             txe->data_len += src_len;
         }
     } else {
+        uint64_t cpu_start = 0;
+
+        if (qtx->cpu_accounting)
+            cpu_start = ossl_ssl_thread_cpu_ns();
+
         /* Encrypt into TXE. */
         if (!qtx_encrypt_into_txe(qtx, &cur, txe, enc_level, pkt->pn,
                                   hdr_start, hdr_len, &ptrs)) {
@@ -711,6 +730,9 @@ static int qtx_write(OSSL_QTX *qtx, const OSSL_QTX_PKT *pkt, TXE *txe,
             goto err;
         }
 
+        if (qtx->cpu_accounting)
+            qtx->protect_cpu_ns += ossl_ssl_thread_cpu_ns() - cpu_start;
+
         assert(txe->data_len - orig_data_len == pkt_len);
     }
 
@@ -797,6 +819,7 @@ int ossl_qtx_write_pkt(OSSL_QTX *qtx, const OSSL_QTX_PKT *pkt)
     int was_coalescing;
     TXE *txe;
     uint32_t enc_level;
+    size_t orig_len;
 
     /* Must have EL configured, must have header. */
     if (pkt->hdr == NULL)
@@ -857,6 +880,7 @@ int ossl_qtx_write_pkt(OSSL_QTX *qtx, const OSSL_QTX_PKT *pkt)
             }
         }
 
+        orig_len = txe->data_len;
         ret = qtx_mutate_write(qtx, pkt, txe, enc_level);
         if (ret == 1) {
             break;
@@ -883,6 +907,12 @@ int ossl_qtx_write_pkt(OSSL_QTX *qtx, const OSSL_QTX_PKT *pkt)
 
     ++qtx->cons_count;
 
+    if (enc_level < QUIC_ENC_LEVEL_NUM) {
+        ++qtx->level_stats[enc_level].pkts;
+        qtx->level_stats[enc_level].bytes += txe->data_len - orig_len;
+        qtx->cons_levels |= 1U << enc_level;
+    }
+
     /*
      * Some packet types cannot have another packet come after them.
      */
@@ -902,6 +932,7 @@ int ossl_qtx_write_pkt(OSSL_QTX *qtx, const OSSL_QTX_PKT *pkt)
 void ossl_qtx_finish_dgram(OSSL_QTX *qtx)
 {
     TXE *txe = qtx->cons;
+    uint32_t enc_level;
 
     if (txe == NULL)
         return;
@@ -915,8 +946,13 @@ void ossl_qtx_finish_dgram(OSSL_QTX *qtx)
     else
         qtx_add_to_pending(qtx, txe);
 
+    for (enc_level = 0; enc_level < QUIC_ENC_LEVEL_NUM; ++enc_level)
+        if ((qtx->cons_levels & (1U << enc_level)) != 0)
+            ++qtx->level_stats[enc_level].dgrams;
+
     qtx->cons       = NULL;
     qtx->cons_count = 0;
+    qtx->cons_levels = 0;
     ++qtx->datagram_count;
 }
 
@@ -1093,6 +1129,26 @@ void ossl_qtx_set_msg_callback_arg(OSSL_QTX *qtx, void *msg_callback_arg)
     qtx->msg_callback_arg = msg_callback_arg;
 }
 
+void ossl_qtx_set_cpu_accounting(OSSL_QTX *qtx, int enable)
+{
+    qtx->cpu_accounting = (enable != 0);
+}
+
+uint64_t ossl_qtx_get_protect_cpu_ns(OSSL_QTX *qtx)
+{
+    return qtx->protect_cpu_ns;
+}
+
+int ossl_qtx_get_level_stats(OSSL_QTX *qtx, uint32_t enc_level,
+                             OSSL_QRL_LEVEL_STATS *stats)
+{
+    if (enc_level >= QUIC_ENC_LEVEL_NUM)
+        return 0;
+
+    *stats = qtx->level_stats[enc_level];
+    return 1;
+}
+
 uint64_t ossl_qtx_get_key_epoch(OSSL_QTX *qtx)
 {
     OSSL_QRL_ENC_LEVEL *el;
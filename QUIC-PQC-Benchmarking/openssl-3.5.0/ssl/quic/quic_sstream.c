@@ -45,6 +45,9 @@ struct quic_sstream_st {
      */
     UINT_SET        new_set, acked_set;
 
+    /* One past the highest logical offset transmitted so far. */
+    uint64_t        tx_end;
+
     /*
      * The current size of the stream is ring_buf.head_offset. If
      * have_final_size is true, this is also the final size of the stream.
@@ -189,9 +192,17 @@ int ossl_quic_sstream_mark_transmitted(QUIC_SSTREAM *qss,
     if (!ossl_uint_set_remove(&qss->new_set, &r))
         return 0;
 
+    if (end + 1 > qss->tx_end)
+        qss->tx_end = end + 1;
+
     return 1;
 }
 
+uint64_t ossl_quic_sstream_get_tx_end(QUIC_SSTREAM *qss)
+{
+    return qss->tx_end;
+}
+
 int ossl_quic_sstream_mark_transmitted_fin(QUIC_SSTREAM *qss,
                                            uint64_t final_size)
 {
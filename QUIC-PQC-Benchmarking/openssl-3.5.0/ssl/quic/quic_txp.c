@@ -68,6 +68,8 @@ struct ossl_quic_tx_packetiser_st {
     OSSL_TIME       last_tx_time;               /* Last time a packet was generated, or 0. */
 
     size_t          unvalidated_credit;         /* Limit of data we can send until validated */
+    uint64_t        amp_blocked_attempts;       /* Generations blocked by the limit */
+    uint64_t        padding_sent[QUIC_ENC_LEVEL_NUM]; /* PADDING frame bytes sent */
 
     /* Internal state - frame (re)generation flags. */
     unsigned int    want_handshake_done     : 1;
@@ -415,6 +417,7 @@ struct txp_pkt {
     QUIC_PKT_HDR        phdr;
     struct txp_pkt_geom geom;
     int                 force_pad;
+    size_t              padding;
 };
 
 static QUIC_SSTREAM *get_sstream_by_id(uint64_t stream_id, uint32_t pn_space,
@@ -535,6 +538,60 @@ int ossl_quic_tx_packetiser_check_unvalidated_credit(OSSL_QUIC_TX_PACKETISER *tx
     return (txp->unvalidated_credit > req_credit);
 }
 
+/**
+ * Gets the number of generate() attempts of a QUIC TX packetiser which were
+ * blocked by the anti-amplification limit.
+ *
+ * An attempt is counted when the unvalidated credit, i.e. the 3x
+ * anti-amplification limit of a server whose peer address is not validated
+ * yet, is too small for the datagram it assembled, so nothing is sent. The
+ * same data is assembled again on a later attempt, so this is not a count of
+ * distinct packets.
+ *
+ * @param txp A pointer to the OSSL_QUIC_TX_PACKETISER structure to query.
+ *
+ * @return The number of generate() attempts blocked by the limit.
+ */
+uint64_t ossl_quic_tx_packetiser_get_amplification_blocked(const OSSL_QUIC_TX_PACKETISER *txp)
+{
+    return txp->amp_blocked_attempts;
+}
+
+/**
+ * Gets the number of PADDING frame bytes a QUIC TX packetiser has sent.
+ *
+ * This includes the padding which brings datagrams with Initial packets to
+ * 1200 bytes.
+ *
+ * @param txp       A pointer to the OSSL_QUIC_TX_PACKETISER structure to query.
+ * @param enc_level The encryption level of the packets to count.
+ *
+ * @return The number of padding bytes, 0 for an invalid enc_level.
+ */
+uint64_t ossl_quic_tx_packetiser_get_padding_sent(const OSSL_QUIC_TX_PACKETISER *txp,
+                                                  uint32_t enc_level)
+{
+    if (enc_level >= QUIC_ENC_LEVEL_NUM)
+        return 0;
+
+    return txp->padding_sent[enc_level];
+}
+
+/**
+ * Gets the number of stream and CRYPTO frame bytes a QUIC TX packetiser has
+ * retransmitted.
+ *
+ * @param txp      A pointer to the OSSL_QUIC_TX_PACKETISER structure to query.
+ * @param pn_space The packet number space of the packets to count.
+ *
+ * @return The number of retransmitted bytes, 0 for an invalid pn_space.
+ */
+uint64_t ossl_quic_tx_packetiser_get_retx_bytes(const OSSL_QUIC_TX_PACKETISER *txp,
+                                                uint32_t pn_space)
+{
+    return ossl_quic_fifd_get_retx_bytes(&txp->fifd, pn_space);
+}
+
 OSSL_QUIC_TX_PACKETISER *ossl_quic_tx_packetiser_new(const OSSL_QUIC_TX_PACKETISER_ARGS *args)
 {
     OSSL_QUIC_TX_PACKETISER *txp;
@@ -993,6 +1050,7 @@ int ossl_quic_tx_packetiser_generate(OSSL_QUIC_TX_PACKETISER *txp,
 
         if (!ossl_quic_tx_packetiser_check_unvalidated_credit(txp,
                                                               pkt[enc_level].h.bytes_appended)) {
+            ++txp->amp_blocked_attempts;
             res = TXP_ERR_SPACE;
             goto out;
         }
@@ -1733,6 +1791,7 @@ static int txp_pkt_init(struct txp_pkt *pkt, OSSL_QUIC_TX_PACKETISER *txp,
     pkt->tpkt               = NULL;
     pkt->stream_head        = NULL;
     pkt->force_pad          = 0;
+    pkt->padding            = 0;
     return 1;
 }
 
@@ -1859,6 +1918,7 @@ static int txp_pkt_append_padding(struct txp_pkt *pkt,
         return 0;
 
     pkt->tpkt->ackm_pkt.num_bytes      += num_bytes;
+    pkt->padding                        += num_bytes;
     /* Cannot be non-inflight if we have a PADDING frame */
     pkt->tpkt->ackm_pkt.is_inflight     = 1;
     return 1;
@@ -3051,6 +3111,8 @@ static int txp_pkt_commit(OSSL_QUIC_TX_PACKETISER *txp,
     if (!ossl_qtx_write_pkt(txp->args.qtx, &txpkt))
         return 0;
 
+    txp->padding_sent[enc_level] += pkt->padding;
+
     /*
      * Record FC and stream abort frames as sent; deactivate streams which no
      * longer have anything to do.
@@ -3850,6 +3850,12 @@ long ssl3_ctrl(SSL *s, int cmd, long larg, void *parg)
         *(int *)parg = sc->s3.tmp.sigalg->hash;
         return 1;
 
+    case SSL_CTRL_GET_HANDSHAKE_CPU_STATS:
+        if (parg == NULL)
+            return 0;
+        *(SSL_HANDSHAKE_CPU_STATS *)parg = sc->hs_cpu;
+        return 1;
+
     case SSL_CTRL_GET_PEER_TMP_KEY:
         if (sc->session == NULL || sc->s3.peer_tmp == NULL) {
             return 0;
@@ -4886,9 +4892,11 @@ EVP_PKEY *ssl_generate_pkey(SSL_CONNECTION *s, EVP_PKEY *pm)
     EVP_PKEY_CTX *pctx = NULL;
     EVP_PKEY *pkey = NULL;
     SSL_CTX *sctx = SSL_CONNECTION_GET_CTX(s);
+    uint64_t cpu_start;
 
     if (pm == NULL)
         return NULL;
+    cpu_start = ossl_ssl_thread_cpu_ns();
     pctx = EVP_PKEY_CTX_new_from_pkey(sctx->libctx, pm, sctx->propq);
     if (pctx == NULL)
         goto err;
@@ -4897,6 +4905,9 @@ EVP_PKEY *ssl_generate_pkey(SSL_CONNECTION *s, EVP_PKEY *pm)
     if (EVP_PKEY_keygen(pctx, &pkey) <= 0) {
         EVP_PKEY_free(pkey);
         pkey = NULL;
+    } else {
+        s->hs_cpu.keyshare_ns += ossl_ssl_thread_cpu_ns() - cpu_start;
+        ossl_ssl_timeline_mark(s, SSL_HANDSHAKE_EVENT_KEYSHARE_GENERATED);
     }
 
     err:
@@ -4911,6 +4922,7 @@ EVP_PKEY *ssl_generate_pkey_group(SSL_CONNECTION *s, uint16_t id)
     const TLS_GROUP_INFO *ginf = tls1_group_id_lookup(sctx, id);
     EVP_PKEY_CTX *pctx = NULL;
     EVP_PKEY *pkey = NULL;
+    uint64_t cpu_start = ossl_ssl_thread_cpu_ns();
 
     if (ginf == NULL) {
         SSLfatal(s, SSL_AD_INTERNAL_ERROR, ERR_R_INTERNAL_ERROR);
@@ -4936,6 +4948,9 @@ EVP_PKEY *ssl_generate_pkey_group(SSL_CONNECTION *s, uint16_t id)
         SSLfatal(s, SSL_AD_INTERNAL_ERROR, ERR_R_EVP_LIB);
         EVP_PKEY_free(pkey);
         pkey = NULL;
+    } else {
+        s->hs_cpu.keyshare_ns += ossl_ssl_thread_cpu_ns() - cpu_start;
+        ossl_ssl_timeline_mark(s, SSL_HANDSHAKE_EVENT_KEYSHARE_GENERATED);
     }
 
  err:
@@ -5011,6 +5026,7 @@ int ssl_derive(SSL_CONNECTION *s, EVP_PKEY *privkey, EVP_PKEY *pubkey, int gense
     size_t pmslen = 0;
     EVP_PKEY_CTX *pctx;
     SSL_CTX *sctx = SSL_CONNECTION_GET_CTX(s);
+    uint64_t cpu_start = ossl_ssl_thread_cpu_ns();
 
     if (privkey == NULL || pubkey == NULL) {
         SSLfatal(s, SSL_AD_INTERNAL_ERROR, ERR_R_INTERNAL_ERROR);
@@ -5039,6 +5055,8 @@ int ssl_derive(SSL_CONNECTION *s, EVP_PKEY *privkey, EVP_PKEY *pubkey, int gense
         SSLfatal(s, SSL_AD_INTERNAL_ERROR, ERR_R_INTERNAL_ERROR);
         goto err;
     }
+    s->hs_cpu.keyshare_ns += ossl_ssl_thread_cpu_ns() - cpu_start;
+    ossl_ssl_timeline_mark(s, SSL_HANDSHAKE_EVENT_KEY_EXCHANGE_DONE);
 
     if (gensecret) {
         /* SSLfatal() called as appropriate in the below functions */
@@ -5067,6 +5085,7 @@ int ssl_decapsulate(SSL_CONNECTION *s, EVP_PKEY *privkey,
     size_t pmslen = 0;
     EVP_PKEY_CTX *pctx;
     SSL_CTX *sctx = SSL_CONNECTION_GET_CTX(s);
+    uint64_t cpu_start = ossl_ssl_thread_cpu_ns();
 
     if (privkey == NULL) {
         SSLfatal(s, SSL_AD_INTERNAL_ERROR, ERR_R_INTERNAL_ERROR);
@@ -5091,6 +5110,8 @@ int ssl_decapsulate(SSL_CONNECTION *s, EVP_PKEY *privkey,
         SSLfatal(s, SSL_AD_INTERNAL_ERROR, ERR_R_INTERNAL_ERROR);
         goto err;
     }
+    s->hs_cpu.keyshare_ns += ossl_ssl_thread_cpu_ns() - cpu_start;
+    ossl_ssl_timeline_mark(s, SSL_HANDSHAKE_EVENT_KEY_EXCHANGE_DONE);
 
     if (gensecret) {
         /* SSLfatal() called as appropriate in the below functions */
@@ -5118,6 +5139,7 @@ int ssl_encapsulate(SSL_CONNECTION *s, EVP_PKEY *pubkey,
     size_t pmslen = 0, ctlen = 0;
     EVP_PKEY_CTX *pctx;
     SSL_CTX *sctx = SSL_CONNECTION_GET_CTX(s);
+    uint64_t cpu_start = ossl_ssl_thread_cpu_ns();
 
     if (pubkey == NULL) {
         SSLfatal(s, SSL_AD_INTERNAL_ERROR, ERR_R_INTERNAL_ERROR);
@@ -5144,6 +5166,8 @@ int ssl_encapsulate(SSL_CONNECTION *s, EVP_PKEY *pubkey,
         SSLfatal(s, SSL_AD_INTERNAL_ERROR, ERR_R_INTERNAL_ERROR);
         goto err;
     }
+    s->hs_cpu.keyshare_ns += ossl_ssl_thread_cpu_ns() - cpu_start;
+    ossl_ssl_timeline_mark(s, SSL_HANDSHAKE_EVENT_KEY_EXCHANGE_DONE);
 
     if (gensecret) {
         /* SSLfatal() called as appropriate in the below functions */
@@ -551,7 +551,12 @@ int ssl_verify_rpk(SSL_CONNECTION *s, EVP_PKEY *rpk)
  */
 int ssl_verify_cert_chain(SSL_CONNECTION *s, STACK_OF(X509) *sk)
 {
-    return ssl_verify_internal(s, sk, NULL);
+    uint64_t cpu_start = ossl_ssl_thread_cpu_ns();
+    int ret = ssl_verify_internal(s, sk, NULL);
+
+    /* Counted even on failure, the verify mode may let the handshake go on */
+    s->hs_cpu.verify_ns += ossl_ssl_thread_cpu_ns() - cpu_start;
+    return ret;
 }
 
 static void set0_CA_list(STACK_OF(X509_NAME) **ca_list,
@@ -13,6 +13,7 @@
 #include "internal/e_winsock.h"
 #include "ssl_local.h"
 
+#include <time.h>
 #include <openssl/objects.h>
 #include <openssl/x509v3.h>
 #include <openssl/rand.h>
@@ -599,6 +600,8 @@ int ossl_ssl_connection_reset(SSL *s)
     sc->error = 0;
     sc->hit = 0;
     sc->shutdown = 0;
+    memset(&sc->hs_timeline, 0, sizeof(sc->hs_timeline));
+    memset(&sc->hs_cpu, 0, sizeof(sc->hs_cpu));
 
     if (sc->renegotiate) {
         ERR_raise(ERR_LIB_SSL, ERR_R_INTERNAL_ERROR);
@@ -5084,6 +5087,52 @@ __owur int SSL_get_handshake_rtt(const SSL *s, uint64_t *rtt)
     return 1;
 }
 
+/*
+ * Record the time of a handshake timeline event. Events that can repeat
+ * (e.g. the ClientHello after a HelloRetryRequest) keep the latest time;
+ * the start and the first QUIC Initial keep the first one.
+ */
+void ossl_ssl_timeline_mark(SSL_CONNECTION *s, int event)
+{
+    uint64_t *t;
+
+    if (event < 0 || event >= SSL_HANDSHAKE_EVENT_NUM)
+        return;
+
+    t = &s->hs_timeline.event[event];
+    if (*t != 0 && (event == SSL_HANDSHAKE_EVENT_START
+                    || event == SSL_HANDSHAKE_EVENT_FIRST_INITIAL_SENT))
+        return;
+
+    *t = ossl_time2ticks(ossl_time_now());
+}
+
+/*
+ * CPU time used by the calling thread in nanoseconds, for the handshake CPU
+ * accounting. Returns 0 on platforms without a per-thread CPU clock, which
+ * leaves the counters at 0.
+ */
+uint64_t ossl_ssl_thread_cpu_ns(void)
+{
+#ifdef CLOCK_THREAD_CPUTIME_ID
+    struct timespec ts;
+
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) == 0)
+        return (uint64_t)ts.tv_sec * 1000000000 + (uint64_t)ts.tv_nsec;
+#endif
+    return 0;
+}
+
+const SSL_HANDSHAKE_TIMELINE *SSL_get0_handshake_timeline(const SSL *s)
+{
+    const SSL_CONNECTION *sc = SSL_CONNECTION_FROM_CONST_SSL(s);
+
+    if (sc == NULL)
+        return NULL;
+
+    return &sc->hs_timeline;
+}
+
 static int dup_ca_names(STACK_OF(X509_NAME) **dst, STACK_OF(X509_NAME) *src)
 {
     STACK_OF(X509_NAME) *sk;
@@ -1296,6 +1296,10 @@ struct ssl_connection_st {
     /* Timestamps used to calculate the handshake RTT */
     OSSL_TIME ts_msg_write;
     OSSL_TIME ts_msg_read;
+    /* Per-phase timestamps, see SSL_get0_handshake_timeline() */
+    SSL_HANDSHAKE_TIMELINE hs_timeline;
+    /* Thread CPU time per operation, see SSL_get_handshake_cpu_stats() */
+    SSL_HANDSHAKE_CPU_STATS hs_cpu;
     /* where we are */
     OSSL_STATEM statem;
     SSL_EARLY_DATA_STATE early_data_state;
@@ -2561,6 +2565,8 @@ __owur int ossl_bytes_to_cipher_list(SSL_CONNECTION *s, PACKET *cipher_suites,
                                      STACK_OF(SSL_CIPHER) **scsvs, int sslv2format,
                                      int fatal);
 void ssl_update_cache(SSL_CONNECTION *s, int mode);
+void ossl_ssl_timeline_mark(SSL_CONNECTION *s, int event);
+uint64_t ossl_ssl_thread_cpu_ns(void);
 __owur int ssl_cipher_get_evp_cipher(SSL_CTX *ctx, const SSL_CIPHER *sslc,
                                      const EVP_CIPHER **enc);
 __owur int ssl_cipher_get_evp_md_mac(SSL_CTX *ctx, const SSL_CIPHER *sslc,
@@ -402,6 +402,7 @@ static int state_machine(SSL_CONNECTION *s, int server)
         }
 
         s->server = server;
+        ossl_ssl_timeline_mark(s, SSL_HANDSHAKE_EVENT_START);
         if (cb != NULL) {
             if (SSL_IS_FIRST_HANDSHAKE(s) || !SSL_CONNECTION_IS_TLS13(s))
                 cb(ussl, SSL_CB_HANDSHAKE_START, 1);
@@ -824,6 +824,7 @@ WORK_STATE ossl_statem_client_post_work(SSL_CONNECTION *s, WORK_STATE wst)
         } else if (!statem_flush(s)) {
             return WORK_MORE_A;
         }
+        ossl_ssl_timeline_mark(s, SSL_HANDSHAKE_EVENT_CLIENT_HELLO);
 
         if (SSL_CONNECTION_IS_DTLS(s)) {
             /* Treat the next message as the first packet */
@@ -1471,6 +1472,8 @@ MSG_PROCESS_RETURN tls_process_server_hello(SSL_CONNECTION *s, PACKET *pkt)
     SSL_COMP *comp;
 #endif
 
+    ossl_ssl_timeline_mark(s, SSL_HANDSHAKE_EVENT_SERVER_HELLO);
+
     if (!PACKET_get_net_2(pkt, &sversion)) {
         SSLfatal(s, SSL_AD_DECODE_ERROR, SSL_R_LENGTH_MISMATCH);
         goto err;
@@ -1984,6 +1987,8 @@ MSG_PROCESS_RETURN tls_process_server_certificate(SSL_CONNECTION *s,
     unsigned int context = 0;
     SSL_CTX *sctx = SSL_CONNECTION_GET_CTX(s);
 
+    ossl_ssl_timeline_mark(s, SSL_HANDSHAKE_EVENT_CERT_RECEIVED);
+
     if (s->ext.server_cert_type == TLSEXT_cert_type_rpk)
         return tls_process_server_rpk(s, pkt);
     if (s->ext.server_cert_type != TLSEXT_cert_type_x509) {
@@ -2110,6 +2115,7 @@ WORK_STATE tls_post_process_server_certificate(SSL_CONNECTION *s,
     ERR_pop_to_mark();      /* but we keep s->verify_result */
     if (i > 0 && s->rwstate == SSL_RETRY_VERIFY)
         return WORK_MORE_A;
+    ossl_ssl_timeline_mark(s, SSL_HANDSHAKE_EVENT_CERT_CHAIN_VERIFIED);
 
     /*
      * Inconsistency alert: cert_chain does include the peer's certificate,
@@ -320,6 +320,7 @@ CON_FUNC_RETURN tls_construct_cert_verify(SSL_CONNECTION *s, WPACKET *pkt)
     unsigned char tls13tbs[TLS13_TBS_PREAMBLE_SIZE + EVP_MAX_MD_SIZE];
     const SIGALG_LOOKUP *lu = s->s3.tmp.sigalg;
     SSL_CTX *sctx = SSL_CONNECTION_GET_CTX(s);
+    uint64_t cpu_start;
 
     if (lu == NULL || s->s3.tmp.cert == NULL) {
         SSLfatal(s, SSL_AD_INTERNAL_ERROR, ERR_R_INTERNAL_ERROR);
@@ -349,6 +350,7 @@ CON_FUNC_RETURN tls_construct_cert_verify(SSL_CONNECTION *s, WPACKET *pkt)
         goto err;
     }
 
+    cpu_start = ossl_ssl_thread_cpu_ns();
     if (EVP_DigestSignInit_ex(mctx, &pctx,
                               md == NULL ? NULL : EVP_MD_get0_name(md),
                               sctx->libctx, sctx->propq, pkey,
@@ -401,6 +403,7 @@ CON_FUNC_RETURN tls_construct_cert_verify(SSL_CONNECTION *s, WPACKET *pkt)
             goto err;
         }
     }
+    s->hs_cpu.sign_ns += ossl_ssl_thread_cpu_ns() - cpu_start;
 
 #ifndef OPENSSL_NO_GOST
     {
@@ -450,6 +453,9 @@ MSG_PROCESS_RETURN tls_process_cert_verify(SSL_CONNECTION *s, PACKET *pkt)
     EVP_MD_CTX *mctx = EVP_MD_CTX_new();
     EVP_PKEY_CTX *pctx = NULL;
     SSL_CTX *sctx = SSL_CONNECTION_GET_CTX(s);
+    uint64_t cpu_start;
+
+    ossl_ssl_timeline_mark(s, SSL_HANDSHAKE_EVENT_CERT_VERIFY_RECEIVED);
 
     if (mctx == NULL) {
         SSLfatal(s, SSL_AD_INTERNAL_ERROR, ERR_R_EVP_LIB);
@@ -531,6 +537,7 @@ MSG_PROCESS_RETURN tls_process_cert_verify(SSL_CONNECTION *s, PACKET *pkt)
     OSSL_TRACE1(TLS, "Using client verify alg %s\n",
                 md == NULL ? "n/a" : EVP_MD_get0_name(md));
 
+    cpu_start = ossl_ssl_thread_cpu_ns();
     if (EVP_DigestVerifyInit_ex(mctx, &pctx,
                                 md == NULL ? NULL : EVP_MD_get0_name(md),
                                 sctx->libctx, sctx->propq, pkey,
@@ -584,6 +591,7 @@ MSG_PROCESS_RETURN tls_process_cert_verify(SSL_CONNECTION *s, PACKET *pkt)
             goto err;
         }
     }
+    s->hs_cpu.verify_ns += ossl_ssl_thread_cpu_ns() - cpu_start;
 
     /*
      * In TLSv1.3 on the client side we make sure we prepare the client
@@ -593,6 +601,7 @@ MSG_PROCESS_RETURN tls_process_cert_verify(SSL_CONNECTION *s, PACKET *pkt)
      * want to make sure that SSL_get1_peer_certificate() will return the actual
      * server certificate from the client_cert_cb callback.
      */
+    ossl_ssl_timeline_mark(s, SSL_HANDSHAKE_EVENT_CERT_VERIFY_DONE);
     if (!s->server && SSL_CONNECTION_IS_TLS13(s) && s->s3.tmp.cert_req == 1)
         ret = MSG_PROCESS_CONTINUE_PROCESSING;
     else
@@ -686,6 +695,7 @@ CON_FUNC_RETURN tls_construct_finished(SSL_CONNECTION *s, WPACKET *pkt)
         s->s3.previous_server_finished_len = finish_md_len;
     }
 
+    ossl_ssl_timeline_mark(s, SSL_HANDSHAKE_EVENT_FINISHED_SENT);
     return CON_FUNC_SUCCESS;
 }
 
@@ -950,6 +960,7 @@ MSG_PROCESS_RETURN tls_process_finished(SSL_CONNECTION *s, PACKET *pkt)
             && s->rlayer.rrlmethod->set_first_handshake != NULL)
         s->rlayer.rrlmethod->set_first_handshake(s->rlayer.rrl, 0);
 
+    ossl_ssl_timeline_mark(s, SSL_HANDSHAKE_EVENT_FINISHED_RECEIVED);
     return MSG_PROCESS_FINISHED_READING;
 }
 
@@ -1460,6 +1471,11 @@ WORK_STATE tls_finish_handshake(SSL_CONNECTION *s, ossl_unused WORK_STATE wst,
 
         ssl3_cleanup_key_block(s);
 
+        /* QUIC confirms the handshake later, see ossl_quic_channel */
+        ossl_ssl_timeline_mark(s, SSL_HANDSHAKE_EVENT_COMPLETE);
+        if (!SSL_IS_QUIC_HANDSHAKE(s))
+            ossl_ssl_timeline_mark(s, SSL_HANDSHAKE_EVENT_CONFIRMED);
+
         if (s->server) {
             /*
              * In TLSv1.3 we update the cache as part of constructing the
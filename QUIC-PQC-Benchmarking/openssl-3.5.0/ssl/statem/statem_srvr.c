@@ -932,6 +932,7 @@ WORK_STATE ossl_statem_server_post_work(SSL_CONNECTION *s, WORK_STATE wst)
                 return WORK_MORE_A;
             break;
         }
+        ossl_ssl_timeline_mark(s, SSL_HANDSHAKE_EVENT_SERVER_HELLO);
 #ifndef OPENSSL_NO_SCTP
         if (SSL_CONNECTION_IS_DTLS(s) && s->hit) {
             unsigned char sctpauthkey[64];
@@ -1492,6 +1493,8 @@ MSG_PROCESS_RETURN tls_process_client_hello(SSL_CONNECTION *s, PACKET *pkt)
     static const unsigned char null_compression = 0;
     CLIENTHELLO_MSG *clienthello = NULL;
 
+    ossl_ssl_timeline_mark(s, SSL_HANDSHAKE_EVENT_CLIENT_HELLO);
+
     /* Check if this is actually an unexpected renegotiation ClientHello */
     if (s->renegotiate == 0 && !SSL_IS_FIRST_HANDSHAKE(s)) {
         if (!ossl_assert(!SSL_CONNECTION_IS_TLS13(s))) {
@@ -3629,6 +3632,8 @@ MSG_PROCESS_RETURN tls_process_client_certificate(SSL_CONNECTION *s,
     SSL_SESSION *new_sess = NULL;
     SSL_CTX *sctx = SSL_CONNECTION_GET_CTX(s);
 
+    ossl_ssl_timeline_mark(s, SSL_HANDSHAKE_EVENT_CERT_RECEIVED);
+
     /*
      * To get this far we must have read encrypted data from the client. We no
      * longer tolerate unencrypted alerts. This is ignored if less than TLSv1.3
@@ -3743,6 +3748,7 @@ MSG_PROCESS_RETURN tls_process_client_certificate(SSL_CONNECTION *s,
                      SSL_R_CERTIFICATE_VERIFY_FAILED);
             goto err;
         }
+        ossl_ssl_timeline_mark(s, SSL_HANDSHAKE_EVENT_CERT_CHAIN_VERIFIED);
         pkey = X509_get0_pubkey(sk_X509_value(sk, 0));
         if (pkey == NULL) {
             SSLfatal(s, SSL_AD_HANDSHAKE_FAILURE,
@@ -0,0 +1,433 @@
+/*
+ * Copyright 2025 The OpenSSL Project Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License 2.0 (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://www.openssl.org/source/license.html
+ */
+
+#include <string.h>
+#include <openssl/bio.h>
+#include <openssl/err.h>
+#include <openssl/crypto.h>
+#include "netembio.h"
+
+/* IPv4 and UDP header, counted against the MTU and the link rate */
+#define NETEM_IP_UDP_OVERHEAD   28
+
+/* Used when the parameters do not give a seed */
+#define NETEM_DEFAULT_SEED      0x6e6574656d62696fULL
+
+struct netem_dgram_st {
+    OSSL_TIME arrival;
+    uint64_t seq;               /* value of dgrams_sent when written */
+    unsigned char *data;
+    size_t data_len;
+    BIO_ADDR *peer, *local;
+};
+
+struct netem_st {
+    NETEM_PARAMS params;
+    NETEM_STATS stats;
+    uint64_t rand_state;
+    int ge_bad;                 /* Gilbert-Elliott chain is in the bad state */
+    int hold;                   /* do not deliver anything */
+    OSSL_TIME link_free;        /* when the link has sent the last datagram */
+
+    /* Queued datagrams, sorted by arrival time */
+    struct netem_dgram_st *queue;
+    size_t queue_len, queue_alloc;
+
+    OSSL_TIME (*now_cb)(void *arg);
+    void *now_cb_arg;
+};
+
+static OSSL_TIME netem_now(struct netem_st *data)
+{
+    return data->now_cb != NULL ? data->now_cb(data->now_cb_arg)
+                                : ossl_time_now();
+}
+
+/* splitmix64, good enough for a link model and reproducible by seed */
+static uint64_t netem_rand(struct netem_st *data)
+{
+    uint64_t z = (data->rand_state += 0x9e3779b97f4a7c15ULL);
+
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+/* Uniform in [0, 1) */
+static double netem_rand_unit(struct netem_st *data)
+{
+    return (double)(netem_rand(data) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+static int netem_should_drop(struct netem_st *data)
+{
+    const NETEM_PARAMS *p = &data->params;
+
+    switch (p->loss_model) {
+    case NETEM_LOSS_BERNOULLI:
+        return netem_rand_unit(data) < p->loss;
+    case NETEM_LOSS_GILBERT_ELLIOTT:
+        if (data->ge_bad) {
+            if (netem_rand_unit(data) < p->ge_r)
+                data->ge_bad = 0;
+        } else {
+            if (netem_rand_unit(data) < p->ge_p)
+                data->ge_bad = 1;
+        }
+        return netem_rand_unit(data)
+            < (data->ge_bad ? p->ge_loss_bad : p->ge_loss_good);
+    default:
+        return 0;
+    }
+}
+
+static void netem_dgram_cleanup(struct netem_dgram_st *d)
+{
+    OPENSSL_free(d->data);
+    BIO_ADDR_free(d->peer);
+    BIO_ADDR_free(d->local);
+}
+
+static BIO_ADDR *netem_addr_dup(const BIO_ADDR *addr)
+{
+    BIO_ADDR *dup;
+
+    if (addr == NULL)
+        return NULL;
+    if ((dup = BIO_ADDR_new()) == NULL)
+        return NULL;
+    if (!BIO_ADDR_copy(dup, addr)) {
+        BIO_ADDR_free(dup);
+        return NULL;
+    }
+    return dup;
+}
+
+/* Takes a copy of |msg| and queues it for delivery at |arrival| */
+static int netem_enqueue(struct netem_st *data, const BIO_MSG *msg,
+                         OSSL_TIME arrival)
+{
+    struct netem_dgram_st d, *q;
+    size_t i;
+
+    if (data->queue_len == data->queue_alloc) {
+        size_t n = data->queue_alloc == 0 ? 16 : data->queue_alloc * 2;
+
+        q = OPENSSL_realloc(data->queue, n * sizeof(*q));
+        if (q == NULL)
+            return 0;
+        data->queue = q;
+        data->queue_alloc = n;
+    }
+
+    memset(&d, 0, sizeof(d));
+    d.arrival = arrival;
+    d.seq = data->stats.dgrams_sent - 1;
+    d.data_len = msg->data_len;
+    d.data = OPENSSL_memdup(msg->data, msg->data_len > 0 ? msg->data_len : 1);
+    if (d.data == NULL
+            || (msg->peer != NULL && (d.peer = netem_addr_dup(msg->peer)) == NULL)
+            || (msg->local != NULL
+                && (d.local = netem_addr_dup(msg->local)) == NULL)) {
+        netem_dgram_cleanup(&d);
+        return 0;
+    }
+
+    /* Jitter can reorder datagrams, keep FIFO order for equal times */
+    for (i = data->queue_len; i > 0; i--)
+        if (ossl_time_compare(data->queue[i - 1].arrival, arrival) <= 0)
+            break;
+    memmove(&data->queue[i + 1], &data->queue[i],
+            (data->queue_len - i) * sizeof(*data->queue));
+    data->queue[i] = d;
+    data->queue_len++;
+    return 1;
+}
+
+static void netem_delay_queued(struct netem_st *data,
+                               const struct bio_netem_delay_st *delay)
+{
+    struct netem_dgram_st d;
+    size_t i, j;
+    int any = 0;
+
+    for (i = 0; i < data->queue_len; i++) {
+        if (data->queue[i].seq < delay->first_dgram)
+            continue;
+        data->queue[i].arrival = ossl_time_add(data->queue[i].arrival,
+                                               delay->delay);
+        any = 1;
+    }
+    if (!any)
+        return;
+    data->link_free = ossl_time_add(data->link_free, delay->delay);
+
+    /* Restore the order, the queue is short */
+    for (i = 1; i < data->queue_len; i++) {
+        d = data->queue[i];
+        for (j = i; j > 0; j--) {
+            if (ossl_time_compare(data->queue[j - 1].arrival, d.arrival) <= 0)
+                break;
+            data->queue[j] = data->queue[j - 1];
+        }
+        data->queue[j] = d;
+    }
+}
+
+/* Passes all datagrams which have arrived by now to the next BIO */
+static size_t netem_flush(BIO *bio, struct netem_st *data)
+{
+    BIO *next = BIO_next(bio);
+    OSSL_TIME now = netem_now(data);
+    size_t n = 0, processed;
+
+    if (next == NULL || data->hold)
+        return 0;
+
+    while (n < data->queue_len
+           && ossl_time_compare(data->queue[n].arrival, now) <= 0) {
+        struct netem_dgram_st *d = &data->queue[n];
+        BIO_MSG msg;
+
+        msg.data = d->data;
+        msg.data_len = d->data_len;
+        msg.peer = d->peer;
+        msg.local = d->local;
+        msg.flags = 0;
+
+        ERR_set_mark();
+        if (!BIO_sendmmsg(next, &msg, sizeof(msg), 1, 0, &processed)
+                || processed == 0) {
+            /* The next BIO is full, try again later */
+            ERR_pop_to_mark();
+            break;
+        }
+        ERR_clear_last_mark();
+
+        data->stats.dgrams_delivered++;
+        data->stats.bytes_delivered += d->data_len;
+        netem_dgram_cleanup(d);
+        n++;
+    }
+
+    if (n > 0) {
+        data->queue_len -= n;
+        memmove(data->queue, data->queue + n,
+                data->queue_len * sizeof(*data->queue));
+    }
+    return n;
+}
+
+static long netem_dgram_ctrl(BIO *bio, int cmd, long num, void *ptr)
+{
+    long ret;
+    BIO *next = BIO_next(bio);
+    struct netem_st *data = BIO_get_data(bio);
+
+    if (next == NULL || data == NULL)
+        return 0;
+
+    switch (cmd) {
+    case BIO_CTRL_DUP:
+        ret = 0L;
+        break;
+    case BIO_CTRL_NETEM_SET_PARAMS: {
+            const NETEM_PARAMS *params = ptr;
+
+            if (params == NULL)
+                return 0;
+            data->params = *params;
+            data->rand_state = params->seed != 0 ? params->seed
+                                                 : NETEM_DEFAULT_SEED;
+            data->ge_bad = 0;
+            ret = 1;
+            break;
+        }
+    case BIO_CTRL_NETEM_SET_NOW_CB: {
+            struct bio_netem_now_cb_st *now_cb = ptr;
+
+            if (now_cb == NULL)
+                return 0;
+            data->now_cb = now_cb->now_cb;
+            data->now_cb_arg = now_cb->now_cb_arg;
+            ret = 1;
+            break;
+        }
+    case BIO_CTRL_NETEM_FLUSH:
+        ret = (long)netem_flush(bio, data);
+        break;
+    case BIO_CTRL_NETEM_GET_NEXT_DEADLINE:
+        if (ptr == NULL || data->queue_len == 0)
+            return 0;
+        *(OSSL_TIME *)ptr = data->queue[0].arrival;
+        ret = 1;
+        break;
+    case BIO_CTRL_NETEM_GET_STATS:
+        if (ptr == NULL)
+            return 0;
+        *(NETEM_STATS *)ptr = data->stats;
+        ret = 1;
+        break;
+    case BIO_CTRL_NETEM_SET_HOLD:
+        data->hold = num != 0;
+        ret = 1;
+        break;
+    case BIO_CTRL_NETEM_DELAY_QUEUED:
+        if (ptr == NULL)
+            return 0;
+        netem_delay_queued(data, ptr);
+        ret = 1;
+        break;
+    default:
+        ret = BIO_ctrl(next, cmd, num, ptr);
+        break;
+    }
+    return ret;
+}
+
+static int netem_dgram_sendmmsg(BIO *bio, BIO_MSG *msg, size_t stride,
+                                size_t num_msg, uint64_t flags,
+                                size_t *msgs_processed)
+{
+    BIO *next = BIO_next(bio);
+    struct netem_st *data = BIO_get_data(bio);
+    const NETEM_PARAMS *p;
+    OSSL_TIME now;
+    size_t i;
+
+    *msgs_processed = 0;
+    if (next == NULL || data == NULL)
+        return 0;
+
+    p = &data->params;
+    now = netem_now(data);
+
+    for (i = 0; i < num_msg; i++) {
+        BIO_MSG *m = (BIO_MSG *)((unsigned char *)msg + i * stride);
+        size_t wire_len = m->data_len + NETEM_IP_UDP_OVERHEAD;
+        OSSL_TIME departure, arrival;
+
+        data->stats.dgrams_sent++;
+        data->stats.bytes_sent += m->data_len;
+
+        /* Like UDP, a datagram which is lost still counts as sent */
+        if (p->mtu != 0 && wire_len > p->mtu) {
+            data->stats.dgrams_too_big++;
+            continue;
+        }
+        if (netem_should_drop(data)) {
+            data->stats.dgrams_lost++;
+            continue;
+        }
+
+        /* Serialisation on the link queues behind earlier datagrams */
+        departure = ossl_time_max(now, data->link_free);
+        if (p->rate_bps != 0)
+            departure = ossl_time_add(departure,
+                                      ossl_ticks2time(wire_len * 8
+                                                      * OSSL_TIME_SECOND
+                                                      / p->rate_bps));
+        data->link_free = departure;
+
+        arrival = ossl_time_add(departure, p->delay);
+        if (!ossl_time_is_zero(p->jitter)) {
+            uint64_t j = ossl_time2ticks(p->jitter);
+            uint64_t r = netem_rand(data) % (2 * j + 1);
+
+            arrival = r >= j ? ossl_time_add(arrival, ossl_ticks2time(r - j))
+                             : ossl_time_subtract(arrival,
+                                                  ossl_ticks2time(j - r));
+            arrival = ossl_time_max(arrival, departure);
+        }
+
+        if (!netem_enqueue(data, m, arrival)) {
+            if (i == 0)
+                return 0;
+            break;
+        }
+    }
+    *msgs_processed = i;
+
+    netem_flush(bio, data);
+    return 1;
+}
+
+static int netem_dgram_recvmmsg(BIO *bio, BIO_MSG *msg, size_t stride,
+                                size_t num_msg, uint64_t flags,
+                                size_t *msgs_processed)
+{
+    BIO *next = BIO_next(bio);
+    struct netem_st *data = BIO_get_data(bio);
+
+    if (next == NULL || data == NULL)
+        return 0;
+
+    /* The emulation applies in the send direction, just take the chance */
+    netem_flush(bio, data);
+    return BIO_recvmmsg(next, msg, stride, num_msg, flags, msgs_processed);
+}
+
+static int netem_dgram_new(BIO *bio)
+{
+    struct netem_st *data = OPENSSL_zalloc(sizeof(*data));
+
+    if (data == NULL)
+        return 0;
+
+    data->rand_state = NETEM_DEFAULT_SEED;
+    BIO_set_data(bio, data);
+    BIO_set_init(bio, 1);
+
+    return 1;
+}
+
+static int netem_dgram_free(BIO *bio)
+{
+    struct netem_st *data = BIO_get_data(bio);
+    size_t i;
+
+    if (data != NULL) {
+        for (i = 0; i < data->queue_len; i++)
+            netem_dgram_cleanup(&data->queue[i]);
+        OPENSSL_free(data->queue);
+        OPENSSL_free(data);
+    }
+    BIO_set_data(bio, NULL);
+    BIO_set_init(bio, 0);
+
+    return 1;
+}
+
+/* Distinct from the other custom filters in test/helpers */
+#define BIO_TYPE_NETEM_DGRAM_FILTER  (0x82 | BIO_TYPE_FILTER)
+
+static BIO_METHOD *method_netem_dgram = NULL;
+
+/* Note: Not thread safe! */
+const BIO_METHOD *bio_f_netem_dgram_filter(void)
+{
+    if (method_netem_dgram == NULL) {
+        method_netem_dgram = BIO_meth_new(BIO_TYPE_NETEM_DGRAM_FILTER,
+                                          "Network emulation datagram filter");
+        if (method_netem_dgram == NULL
+            || !BIO_meth_set_ctrl(method_netem_dgram, netem_dgram_ctrl)
+            || !BIO_meth_set_sendmmsg(method_netem_dgram, netem_dgram_sendmmsg)
+            || !BIO_meth_set_recvmmsg(method_netem_dgram, netem_dgram_recvmmsg)
+            || !BIO_meth_set_create(method_netem_dgram, netem_dgram_new)
+            || !BIO_meth_set_destroy(method_netem_dgram, netem_dgram_free))
+            return NULL;
+    }
+    return method_netem_dgram;
+}
+
+void bio_f_netem_dgram_filter_free(void)
+{
+    BIO_meth_free(method_netem_dgram);
+    method_netem_dgram = NULL;
+}
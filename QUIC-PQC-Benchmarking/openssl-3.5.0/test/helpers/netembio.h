@@ -0,0 +1,124 @@
+/*
+ * Copyright 2025 The OpenSSL Project Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License 2.0 (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://www.openssl.org/source/license.html
+ */
+
+#ifndef OSSL_TEST_HELPERS_NETEMBIO_H
+# define OSSL_TEST_HELPERS_NETEMBIO_H
+
+# include <openssl/bio.h>
+# include "internal/time.h"
+
+/*
+ * Network emulation datagram BIO filter
+ * =====================================
+ *
+ * A filter pushed on top of a datagram BIO (typically one end of a
+ * BIO_s_dgram_pair()) which emulates the link in the sending direction, like
+ * tc/netem does on an interface: every datagram written is dropped or held
+ * back and only passed to the next BIO once its arrival time has come.
+ * Reads are passed through unchanged. Use one filter per endpoint for a
+ * bidirectional link.
+ *
+ * All times come from the now callback, so with a fake clock the emulation
+ * is fully deterministic: the random numbers for jitter and loss come from a
+ * PRNG seeded through the parameters.
+ *
+ * The filter delivers due datagrams whenever it is written to or read from.
+ * A driver advancing a fake clock calls BIO_CTRL_NETEM_FLUSH after each step
+ * and uses BIO_CTRL_NETEM_GET_NEXT_DEADLINE to find the next point in time at
+ * which something arrives.
+ *
+ * To model the time an endpoint spends computing, a driver can hold delivery
+ * while the endpoint runs and afterwards push the datagrams it sent meanwhile
+ * back by the time it took (BIO_CTRL_NETEM_SET_HOLD and
+ * BIO_CTRL_NETEM_DELAY_QUEUED).
+ */
+
+/* Loss models */
+# define NETEM_LOSS_NONE             0
+/* Every datagram is lost with probability loss */
+# define NETEM_LOSS_BERNOULLI        1
+/*
+ * Gilbert-Elliott: a two state Markov chain which switches from the good to
+ * the bad state with probability ge_p and back with ge_r per datagram; in the
+ * good state datagrams are lost with probability ge_loss_good, in the bad
+ * state with ge_loss_bad. Models bursty loss.
+ */
+# define NETEM_LOSS_GILBERT_ELLIOTT  2
+
+typedef struct netem_params_st {
+    /* One-way delay and maximum jitter (uniform in +/- jitter) */
+    OSSL_TIME delay;
+    OSSL_TIME jitter;
+
+    /* Link rate in bits per second, 0 for unlimited */
+    uint64_t rate_bps;
+
+    /*
+     * Largest IP packet (datagram plus IPv4/UDP headers) the link carries;
+     * larger datagrams are dropped. 0 for unlimited.
+     */
+    size_t mtu;
+
+    /* Loss model, one of NETEM_LOSS_* */
+    int loss_model;
+    double loss;
+    double ge_p, ge_r, ge_loss_good, ge_loss_bad;
+
+    /* Seed for jitter and loss, 0 selects a fixed default */
+    uint64_t seed;
+} NETEM_PARAMS;
+
+typedef struct netem_stats_st {
+    uint64_t dgrams_sent;       /* datagrams written to the filter */
+    uint64_t bytes_sent;
+    uint64_t dgrams_delivered;  /* datagrams passed to the next BIO */
+    uint64_t bytes_delivered;
+    uint64_t dgrams_lost;       /* dropped by the loss model */
+    uint64_t dgrams_too_big;    /* dropped because of the MTU */
+} NETEM_STATS;
+
+/* Sets the link parameters (ptr: const NETEM_PARAMS *) and resets the PRNG */
+# define BIO_CTRL_NETEM_SET_PARAMS          1101
+/* Sets the time source (ptr: struct bio_netem_now_cb_st *) */
+# define BIO_CTRL_NETEM_SET_NOW_CB          1102
+/* Delivers due datagrams, returns the number delivered */
+# define BIO_CTRL_NETEM_FLUSH               1103
+/*
+ * Gets the arrival time of the next queued datagram (ptr: OSSL_TIME *).
+ * Returns 0 if nothing is queued.
+ */
+# define BIO_CTRL_NETEM_GET_NEXT_DEADLINE   1104
+/* Gets the counters (ptr: NETEM_STATS *) */
+# define BIO_CTRL_NETEM_GET_STATS           1105
+/* Stops (num: 1) or resumes (num: 0) delivery of datagrams */
+# define BIO_CTRL_NETEM_SET_HOLD            1106
+/*
+ * Delays the queued datagrams which were written as the first_dgram'th
+ * datagram or later (counting from 0 as in dgrams_sent) by delay
+ * (ptr: struct bio_netem_delay_st *). The link is busy for longer as well.
+ */
+# define BIO_CTRL_NETEM_DELAY_QUEUED        1107
+
+struct bio_netem_now_cb_st {
+    OSSL_TIME (*now_cb)(void *);
+    void *now_cb_arg;
+};
+
+struct bio_netem_delay_st {
+    uint64_t first_dgram;
+    OSSL_TIME delay;
+};
+
+/* BIO filter emulating a network link, see above */
+const BIO_METHOD *bio_f_netem_dgram_filter(void);
+
+/* Free the BIO filter method object */
+void bio_f_netem_dgram_filter_free(void);
+
+#endif
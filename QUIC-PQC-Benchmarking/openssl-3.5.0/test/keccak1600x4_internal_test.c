@@ -0,0 +1,91 @@
+/*
+ * Copyright 2025 The OpenSSL Project Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License 2.0 (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://www.openssl.org/source/license.html
+ */
+
+/* Internal tests for the four-way SHAKE of keccak1600x4.c */
+
+#include <string.h>
+#include <openssl/evp.h>
+#include "internal/nelem.h"
+#include "internal/sha3.h"
+#include "testutil.h"
+
+static const size_t input_lens[] = {
+    0, 1, 33, 34, 66, 135, 136, 137, 167, 168, 169, 400
+};
+
+/* Two full blocks, then a partial one */
+#define TAIL_LEN    100
+
+/*
+ * Compares each of the four streams with EVP SHAKE, for every input length
+ * above, with the SIMD code when available (|idx| 0) and without (|idx| 1).
+ */
+static int test_shake_x4(int bits, int idx)
+{
+    size_t bsz = SHA3_BLOCKSIZE(bits), out_len = 2 * bsz + TAIL_LEN;
+    EVP_MD *md = EVP_MD_fetch(NULL, bits == 128 ? "SHAKE128" : "SHAKE256", NULL);
+    EVP_MD_CTX *mctx = EVP_MD_CTX_new();
+    KECCAK1600_X4_CTX ctx;
+    unsigned char in[4][400], got[4][2 * 168 + TAIL_LEN], expected[sizeof(got[0])];
+    const unsigned char *const inp[4] = { in[0], in[1], in[2], in[3] };
+    unsigned char *out[4];
+    size_t i, j, k;
+    int ret = 0;
+
+    if (!TEST_ptr(md) || !TEST_ptr(mctx))
+        goto err;
+    for (j = 0; j < 4; j++)
+        for (k = 0; k < sizeof(in[j]); k++)
+            in[j][k] = (unsigned char)(k * 7 + j * 31 + 1);
+
+    for (i = 0; i < OSSL_NELEM(input_lens); i++) {
+        ossl_shake_x4_init(&ctx, bits);
+        if (idx == 1)
+            ctx.simd = 0;
+        ossl_shake_x4_absorb(&ctx, inp, input_lens[i]);
+        for (k = 0; k < out_len; k += bsz) {
+            for (j = 0; j < 4; j++)
+                out[j] = got[j] + k;
+            ossl_shake_x4_squeeze(&ctx, out, k + bsz <= out_len ? bsz : out_len - k);
+        }
+        for (j = 0; j < 4; j++) {
+            if (!TEST_true(EVP_DigestInit_ex2(mctx, md, NULL))
+                || !TEST_true(EVP_DigestUpdate(mctx, in[j], input_lens[i]))
+                || !TEST_true(EVP_DigestFinalXOF(mctx, expected, out_len)))
+                goto err;
+            if (!TEST_mem_eq(got[j], out_len, expected, out_len)) {
+                TEST_note("SHAKE%d, input length %zu, stream %zu", bits,
+                          input_lens[i], j);
+                goto err;
+            }
+        }
+    }
+    ret = 1;
+ err:
+    EVP_MD_CTX_free(mctx);
+    EVP_MD_free(md);
+    return ret;
+}
+
+static int test_shake128_x4(int idx)
+{
+    return test_shake_x4(128, idx);
+}
+
+static int test_shake256_x4(int idx)
+{
+    return test_shake_x4(256, idx);
+}
+
+int setup_tests(void)
+{
+    ADD_ALL_TESTS(test_shake128_x4, 2);
+    ADD_ALL_TESTS(test_shake256_x4, 2);
+    return 1;
+}
@@ -15,6 +15,7 @@
 # include <stdio.h>
 #endif
 #include <crypto/ml_kem.h>
+#include "../crypto/ml_kem/ml_kem_local.h"
 #include "testutil.h"
 #include "testutil/output.h"
 
@@ -258,11 +259,109 @@ static int sanity_test(void)
     return ret == 0;
 }
 
+static void random_scalar(ML_KEM_SCALAR *s)
+{
+    int i;
+
+    for (i = 0; i < ML_KEM_DEGREE; i++)
+        s->c[i] = test_random() % ML_KEM_PRIME;
+}
+
+/*
+ * The SIMD kernels must agree with the portable C code for every
+ * operation, including the rounding of compress and decompress.
+ */
+static int scalar_ops_test(void)
+{
+    static const int bits[] = { 1, 4, 5, 10, 11 };
+    const ML_KEM_SCALAR_OPS *c = ossl_ml_kem_scalar_ops_generic();
+    const ML_KEM_SCALAR_OPS *simd = ossl_ml_kem_scalar_ops_simd();
+    ML_KEM_SCALAR a, b, x, y, acc1, acc2;
+    uint8_t in[6 * ML_KEM_DEGREE / 8];
+    size_t i, j;
+    int n, iter;
+
+    if (simd == NULL)
+        return TEST_skip("no SIMD implementation on this CPU");
+
+    for (iter = 0; iter < 100; iter++) {
+        random_scalar(&a);
+        random_scalar(&b);
+
+        x = a;
+        y = a;
+        c->ntt(&x);
+        simd->ntt(&y);
+        if (!TEST_mem_eq(x.c, sizeof(x.c), y.c, sizeof(y.c)))
+            return 0;
+
+        x = a;
+        y = a;
+        c->inverse_ntt(&x);
+        simd->inverse_ntt(&y);
+        if (!TEST_mem_eq(x.c, sizeof(x.c), y.c, sizeof(y.c)))
+            return 0;
+
+        c->mult(&x, &a, &b);
+        simd->mult(&y, &a, &b);
+        if (!TEST_mem_eq(x.c, sizeof(x.c), y.c, sizeof(y.c)))
+            return 0;
+
+        acc1 = x;
+        acc2 = x;
+        c->mult_add(&acc1, &b, &a);
+        simd->mult_add(&acc2, &b, &a);
+        if (!TEST_mem_eq(acc1.c, sizeof(acc1.c), acc2.c, sizeof(acc2.c)))
+            return 0;
+
+        for (i = 0; i < sizeof(in); i++)
+            in[i] = (uint8_t)test_random();
+        c->cbd_2(&x, in);
+        simd->cbd_2(&y, in);
+        if (!TEST_mem_eq(x.c, sizeof(x.c), y.c, sizeof(y.c)))
+            return 0;
+        c->cbd_3(&x, in);
+        simd->cbd_3(&y, in);
+        if (!TEST_mem_eq(x.c, sizeof(x.c), y.c, sizeof(y.c)))
+            return 0;
+    }
+
+    /* Exhaustively over all inputs */
+    for (j = 0; j < OSSL_NELEM(bits); j++) {
+        for (n = 0; n < ML_KEM_PRIME; n += ML_KEM_DEGREE) {
+            for (i = 0; i < ML_KEM_DEGREE; i++)
+                a.c[i] = (n + i) % ML_KEM_PRIME;
+            x = a;
+            y = a;
+            c->compress(&x, bits[j]);
+            simd->compress(&y, bits[j]);
+            if (!TEST_mem_eq(x.c, sizeof(x.c), y.c, sizeof(y.c))) {
+                TEST_note("compress, bits = %d", bits[j]);
+                return 0;
+            }
+        }
+        for (n = 0; n < (1 << bits[j]); n += ML_KEM_DEGREE) {
+            for (i = 0; i < ML_KEM_DEGREE; i++)
+                a.c[i] = (n + i) & ((1 << bits[j]) - 1);
+            x = a;
+            y = a;
+            c->decompress(&x, bits[j]);
+            simd->decompress(&y, bits[j]);
+            if (!TEST_mem_eq(x.c, sizeof(x.c), y.c, sizeof(y.c))) {
+                TEST_note("decompress, bits = %d", bits[j]);
+                return 0;
+            }
+        }
+    }
+    return 1;
+}
+
 int setup_tests(void)
 {
     if (!TEST_true(RAND_set_DRBG_type(NULL, "TEST-RAND", "fips=no", NULL, NULL)))
         return 0;
 
     ADD_TEST(sanity_test);
+    ADD_TEST(scalar_ops_test);
     return 1;
 }
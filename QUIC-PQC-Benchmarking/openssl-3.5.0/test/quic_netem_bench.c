@@ -0,0 +1,640 @@
+/*
+ * Copyright 2025 The OpenSSL Project Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License 2.0 (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://www.openssl.org/source/license.html
+ */
+
+/*
+ * Sweeps the QUIC handshake time over emulated network conditions.
+ *
+ * A client and a listener run in this process, connected by a
+ * BIO_s_dgram_pair() with a network emulation filter (helpers/netembio.c) in
+ * each direction. Both QUIC engines and both filters share a fake clock which
+ * only advances when nothing else can happen, so the handshake time reported
+ * is the time the protocol needs on the emulated link: round trips, loss
+ * recovery and serialisation of large PQC key shares and certificates.
+ *
+ * The crypto CPU time each endpoint spends in a step, as measured by
+ * SSL_get_handshake_cpu_stats(), is charged to the clock: the endpoint is busy
+ * for that long and what it sent leaves that much later. Everything else the
+ * endpoints do takes no simulated time.
+ *
+ * For every group, certificate, RTT, loss and bandwidth one CSV row is
+ * printed per repetition, optionally with one row per flight in a second
+ * file. A flight is what one endpoint sends before the other one answers; the
+ * number of server flights is the number of round trips of the handshake.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <openssl/e_os2.h>
+
+#ifdef OPENSSL_SYS_UNIX
+# include <unistd.h>
+# include <openssl/ssl.h>
+# include <openssl/err.h>
+# include "internal/sockets.h"
+# include "internal/quic_ssl.h"
+# include "internal/quic_channel.h"
+# include "internal/time.h"
+# include "helpers/netembio.h"
+
+# define MAX_LIST       32
+# define MAX_CERTS      8
+# define MAX_FLIGHTS    64
+
+static char *prog;
+
+/* Simulated clock of both endpoints and filters, and the handshake start */
+static OSSL_TIME sim_now, sim_start;
+
+static OSSL_TIME get_sim_now(void *arg)
+{
+    return sim_now;
+}
+
+static const unsigned char alpn[] = { 8, 'o', 's', 's', 'l', 't', 'e', 's', 't' };
+
+static int select_alpn(SSL *ssl, const unsigned char **out,
+                       unsigned char *out_len, const unsigned char *in,
+                       unsigned int in_len, void *arg)
+{
+    if (SSL_select_next_proto((unsigned char **)out, out_len, alpn,
+                              sizeof(alpn), in, in_len) == OPENSSL_NPN_NEGOTIATED)
+        return SSL_TLSEXT_ERR_OK;
+    return SSL_TLSEXT_ERR_ALERT_FATAL;
+}
+
+struct cert_st {
+    const char *cert, *key;
+    SSL_CTX *ctx;
+};
+
+struct sweep_st {
+    char *groups[MAX_LIST];
+    size_t num_groups;
+    struct cert_st certs[MAX_CERTS];
+    size_t num_certs;
+    double rtt_ms[MAX_LIST], loss_pct[MAX_LIST], bw_kbps[MAX_LIST];
+    size_t num_rtt, num_loss, num_bw;
+    NETEM_PARAMS base;          /* jitter, MTU, loss model and seed */
+    int repeats;
+    int no_validate;            /* no Retry, the 3x limit applies */
+    double cpu_scale;           /* factor for the crypto CPU time charged */
+    uint64_t timeout_ms;
+    FILE *flights_out;
+};
+
+/* One side of the link */
+struct endpoint_st {
+    BIO *netem;                 /* filter for what this endpoint sends */
+    NETEM_STATS stats;          /* counters before the current tick */
+    OSSL_TIME busy_until;       /* computing until then */
+    uint64_t cpu_ns;            /* crypto CPU time charged */
+};
+
+/* Datagrams one endpoint sent before it heard from the other */
+struct flight_st {
+    int server;
+    OSSL_TIME start;
+    uint64_t dgrams, bytes;
+    int amp_limited;            /* the server stopped at the 3x limit */
+};
+
+struct result_st {
+    int ok;
+    OSSL_TIME handshake;
+    NETEM_STATS c2s, s2c;
+    uint64_t client_cpu_ns, server_cpu_ns;
+    struct flight_st flights[MAX_FLIGHTS];
+    size_t num_flights;
+    int round_trips;            /* server flights the client waited for */
+};
+
+static void usage(void)
+{
+    fprintf(stderr,
+            "Usage: %s [options] -c cert:key [-c cert:key...]\n"
+            "  -g LIST    Groups to sweep, comma separated (default X25519)\n"
+            "             a single entry may be a colon separated client list\n"
+            "  -c C:K     Server certificate chain and key, may be repeated\n"
+            "  -r LIST    Round trip times in ms (default 0)\n"
+            "  -l LIST    Loss rates in %% (default 0)\n"
+            "  -b LIST    Bandwidths in kbit/s, 0 for unlimited (default 0)\n"
+            "  -j MS      Jitter in ms, per direction (default 0)\n"
+            "  -m BYTES   Path MTU including IP/UDP headers (default 1500)\n"
+            "  -G P,R,LG,LB\n"
+            "             Gilbert-Elliott loss instead of -l: transition\n"
+            "             probabilities good->bad, bad->good and loss rates\n"
+            "             in the good and bad state, all in %%\n"
+            "  -n N       Repetitions per combination (default 10)\n"
+            "  -s SEED    Seed for jitter and loss (default 1)\n"
+            "  -t MS      Handshake timeout in simulated ms (default 60000)\n"
+            "  -x FACTOR  Scale the crypto CPU time charged to the simulated\n"
+            "             clock, 0 to leave it out (default 1)\n"
+            "  -N         No Retry, the server is bound by the 3x\n"
+            "             anti-amplification limit until the client is\n"
+            "             validated\n"
+            "  -F FILE    Write the datagrams and bytes of every flight to FILE\n",
+            prog);
+    exit(EXIT_FAILURE);
+}
+
+static size_t parse_list(char *arg, double *out)
+{
+    size_t n = 0;
+    char *tok;
+
+    for (tok = strtok(arg, ","); tok != NULL; tok = strtok(NULL, ",")) {
+        if (n == MAX_LIST)
+            usage();
+        out[n++] = atof(tok);
+    }
+    return n;
+}
+
+static SSL_CTX *create_server_ctx(const char *cert, const char *key)
+{
+    SSL_CTX *ctx = SSL_CTX_new(OSSL_QUIC_server_method());
+
+    if (ctx == NULL
+            || SSL_CTX_use_certificate_chain_file(ctx, cert) <= 0
+            || SSL_CTX_use_PrivateKey_file(ctx, key, SSL_FILETYPE_PEM) <= 0) {
+        SSL_CTX_free(ctx);
+        return NULL;
+    }
+    SSL_CTX_set_alpn_select_cb(ctx, select_alpn, NULL);
+    return ctx;
+}
+
+static BIO *create_endpoint_bio(BIO *pair, struct in_addr *ina, int port,
+                                const NETEM_PARAMS *params)
+{
+    struct bio_netem_now_cb_st now_cb = { get_sim_now, NULL };
+    BIO_ADDR *addr = BIO_ADDR_new();
+    BIO *netem = BIO_new(bio_f_netem_dgram_filter());
+
+    if (addr == NULL || netem == NULL
+            || !BIO_ADDR_rawmake(addr, AF_INET, ina, sizeof(*ina), htons(port))
+            || !BIO_dgram_set_caps(pair, BIO_DGRAM_CAP_HANDLES_DST_ADDR
+                                         | BIO_DGRAM_CAP_HANDLES_SRC_ADDR)
+            || BIO_dgram_set0_local_addr(pair, addr) != 1) {
+        BIO_ADDR_free(addr);
+        BIO_free(netem);
+        return NULL;
+    }
+    BIO_push(netem, pair);
+    BIO_ctrl(netem, BIO_CTRL_NETEM_SET_PARAMS, 0, (void *)params);
+    BIO_ctrl(netem, BIO_CTRL_NETEM_SET_NOW_CB, 0, &now_cb);
+    return netem;
+}
+
+/*
+ * When |s| needs to be ticked next, infinite if it does not. A busy endpoint
+ * is ticked when it is done, it may have received something meanwhile.
+ */
+static OSSL_TIME endpoint_deadline(struct endpoint_st *ep, SSL *s)
+{
+    struct timeval tv;
+    int isinf = 0;
+
+    if (ossl_time_compare(ep->busy_until, sim_now) > 0)
+        return ep->busy_until;
+    if (!SSL_get_event_timeout(s, &tv, &isinf) || isinf)
+        return ossl_time_infinite();
+    return ossl_time_add(sim_now, ossl_time_from_timeval(tv));
+}
+
+static OSSL_TIME netem_deadline(BIO *netem)
+{
+    OSSL_TIME t;
+
+    if (BIO_ctrl(netem, BIO_CTRL_NETEM_GET_NEXT_DEADLINE, 0, &t) <= 0)
+        return ossl_time_infinite();
+    return t;
+}
+
+/* Crypto CPU time |s| has used so far, see SSL_get_handshake_cpu_stats() */
+static uint64_t crypto_cpu_ns(SSL *s)
+{
+    SSL_HANDSHAKE_CPU_STATS st;
+
+    if (s == NULL || !SSL_get_handshake_cpu_stats(s, &st))
+        return 0;
+    return st.keyshare_ns + st.sign_ns + st.record_ns + st.verify_ns;
+}
+
+static uint64_t amplification_blocked(SSL *s)
+{
+    QUIC_CHANNEL *ch = s != NULL ? ossl_quic_conn_get_channel(s) : NULL;
+
+    return ch != NULL ? ossl_quic_channel_get_amplification_blocked(ch) : 0;
+}
+
+/*
+ * Stops delivery from |ep| before it runs, so that nothing it sends can
+ * arrive before the time it computes has been charged.
+ */
+static void endpoint_begin(struct endpoint_st *ep)
+{
+    BIO_ctrl(ep->netem, BIO_CTRL_NETEM_GET_STATS, 0, &ep->stats);
+    BIO_ctrl(ep->netem, BIO_CTRL_NETEM_SET_HOLD, 1, NULL);
+}
+
+/*
+ * Charges |cpu_ns| of crypto CPU time to |ep|: it is busy for that long and
+ * everything it sent in the meantime leaves that much later. Datagrams sent
+ * are added to the current flight of |ep| or start a new one.
+ */
+static void endpoint_end(struct endpoint_st *ep, struct result_st *res,
+                         int server, uint64_t cpu_ns, double cpu_scale)
+{
+    struct bio_netem_delay_st delay;
+    NETEM_STATS now;
+    struct flight_st *f;
+
+    ep->cpu_ns += cpu_ns;
+    delay.first_dgram = ep->stats.dgrams_sent;
+    delay.delay = ossl_ticks2time((uint64_t)((double)cpu_ns * cpu_scale));
+    ep->busy_until = ossl_time_add(sim_now, delay.delay);
+    BIO_ctrl(ep->netem, BIO_CTRL_NETEM_DELAY_QUEUED, 0, &delay);
+    BIO_ctrl(ep->netem, BIO_CTRL_NETEM_SET_HOLD, 0, NULL);
+
+    BIO_ctrl(ep->netem, BIO_CTRL_NETEM_GET_STATS, 0, &now);
+    if (now.dgrams_sent == ep->stats.dgrams_sent)
+        return;
+
+    f = res->num_flights > 0 ? &res->flights[res->num_flights - 1] : NULL;
+    if (f == NULL || f->server != server) {
+        if (res->num_flights == MAX_FLIGHTS)
+            return;
+        f = &res->flights[res->num_flights++];
+        memset(f, 0, sizeof(*f));
+        f->server = server;
+        f->start = ossl_time_subtract(ep->busy_until, sim_start);
+        res->round_trips += server;
+    }
+    f->dgrams += now.dgrams_sent - ep->stats.dgrams_sent;
+    f->bytes += now.bytes_sent - ep->stats.bytes_sent;
+}
+
+/* Runs one handshake over a fresh link, returns 0 on a setup error */
+static int run_handshake(SSL_CTX *cctx, SSL_CTX *sctx, const char *groups,
+                         const NETEM_PARAMS *params, int no_validate,
+                         double cpu_scale, uint64_t timeout_ms,
+                         struct result_st *res)
+{
+    BIO *cpair = NULL, *spair = NULL, *cbio = NULL, *sbio = NULL;
+    SSL *client = NULL, *listener = NULL, *sconn = NULL;
+    BIO_ADDR *peer = NULL;
+    struct endpoint_st cep, sep;
+    struct in_addr ina;
+    OSSL_TIME end, next;
+    uint64_t delivered = 0, cpu, blocked;
+    int ret = 0, rv, stuck = 0;
+
+    memset(res, 0, sizeof(*res));
+    memset(&cep, 0, sizeof(cep));
+    memset(&sep, 0, sizeof(sep));
+    ina.s_addr = htonl(0x7f000001);
+    sim_now = sim_start = ossl_seconds2time(1);
+
+    if (!BIO_new_bio_dgram_pair(&cpair, 0, &spair, 0))
+        goto err;
+    if ((cbio = create_endpoint_bio(cpair, &ina, 50000, params)) == NULL)
+        goto err;
+    cpair = NULL;
+    if ((sbio = create_endpoint_bio(spair, &ina, 4433, params)) == NULL)
+        goto err;
+    spair = NULL;
+    /* Owned by the SSL objects below */
+    cep.netem = cbio;
+    sep.netem = sbio;
+
+    if (!SSL_CTX_set1_groups_list(sctx, groups)
+            || (listener = SSL_new_listener(sctx,
+                                            no_validate
+                                            ? SSL_LISTENER_FLAG_NO_VALIDATE
+                                            : 0)) == NULL)
+        goto err;
+    SSL_set_bio(listener, sbio, sbio);
+    sbio = NULL;
+    if (!ossl_quic_set_override_now_cb(listener, get_sim_now, NULL)
+            || !SSL_listen(listener))
+        goto err;
+
+    if ((client = SSL_new(cctx)) == NULL
+            || (peer = BIO_ADDR_new()) == NULL
+            || !BIO_ADDR_rawmake(peer, AF_INET, &ina, sizeof(ina), htons(4433)))
+        goto err;
+    SSL_set_bio(client, cbio, cbio);
+    cbio = NULL;
+    if (!ossl_quic_set_override_now_cb(client, get_sim_now, NULL)
+            || !SSL_set_blocking_mode(client, 0)
+            || !SSL_set1_initial_peer_addr(client, peer)
+            || SSL_set_alpn_protos(client, alpn, sizeof(alpn)) != 0
+            || !SSL_set1_groups_list(client, groups))
+        goto err;
+
+    end = ossl_time_add(sim_start, ossl_ms2time(timeout_ms));
+    for (;;) {
+        uint64_t prev_delivered = delivered;
+
+        BIO_ctrl(cep.netem, BIO_CTRL_NETEM_FLUSH, 0, NULL);
+        BIO_ctrl(sep.netem, BIO_CTRL_NETEM_FLUSH, 0, NULL);
+
+        /* An endpoint which is still computing cannot react yet */
+        if (ossl_time_compare(sim_now, cep.busy_until) >= 0) {
+            endpoint_begin(&cep);
+            cpu = crypto_cpu_ns(client);
+            rv = SSL_do_handshake(client);
+            endpoint_end(&cep, res, 0, crypto_cpu_ns(client) - cpu, cpu_scale);
+            if (rv == 1) {
+                res->ok = 1;
+                sim_now = cep.busy_until;
+                break;
+            }
+            rv = SSL_get_error(client, rv);
+            if (rv != SSL_ERROR_WANT_READ && rv != SSL_ERROR_WANT_WRITE)
+                break;
+        }
+
+        if (ossl_time_compare(sim_now, sep.busy_until) >= 0) {
+            endpoint_begin(&sep);
+            cpu = crypto_cpu_ns(sconn);
+            blocked = amplification_blocked(sconn);
+            SSL_handle_events(listener);
+            if (sconn == NULL)
+                sconn = SSL_accept_connection(listener,
+                                              SSL_ACCEPT_CONNECTION_NO_BLOCK);
+            if (sconn != NULL)
+                SSL_handle_events(sconn);
+            endpoint_end(&sep, res, 1, crypto_cpu_ns(sconn) - cpu, cpu_scale);
+
+            /* The last server flight was cut short by the 3x limit */
+            if (amplification_blocked(sconn) != blocked
+                    && res->num_flights > 0
+                    && res->flights[res->num_flights - 1].server)
+                res->flights[res->num_flights - 1].amp_limited = 1;
+        }
+
+        /*
+         * Datagrams due now are processed before the clock moves on. The
+         * filters also deliver whenever the endpoints read, so look at their
+         * counters rather than at what the flushes above returned.
+         */
+        BIO_ctrl(cep.netem, BIO_CTRL_NETEM_GET_STATS, 0, &res->c2s);
+        BIO_ctrl(sep.netem, BIO_CTRL_NETEM_GET_STATS, 0, &res->s2c);
+        delivered = res->c2s.dgrams_delivered + res->s2c.dgrams_delivered;
+        if (delivered != prev_delivered)
+            continue;
+
+        next = ossl_time_min(ossl_time_min(endpoint_deadline(&cep, client),
+                                           endpoint_deadline(&sep, listener)),
+                             ossl_time_min(netem_deadline(cep.netem),
+                                           netem_deadline(sep.netem)));
+        if (ossl_time_compare(next, sim_now) <= 0) {
+            /* Something is due but did not progress, avoid spinning */
+            if (++stuck < 16)
+                continue;
+            next = ossl_time_add(sim_now, ossl_ms2time(1));
+        }
+        stuck = 0;
+        if (ossl_time_compare(next, end) >= 0)
+            break;
+        sim_now = next;
+    }
+    res->handshake = ossl_time_subtract(sim_now, sim_start);
+    res->client_cpu_ns = cep.cpu_ns;
+    res->server_cpu_ns = sep.cpu_ns;
+
+    BIO_ctrl(cep.netem, BIO_CTRL_NETEM_GET_STATS, 0, &res->c2s);
+    BIO_ctrl(sep.netem, BIO_CTRL_NETEM_GET_STATS, 0, &res->s2c);
+    ret = 1;
+ err:
+    ERR_clear_error();
+    SSL_free(sconn);
+    SSL_free(client);
+    SSL_free(listener);
+    BIO_ADDR_free(peer);
+    BIO_free_all(cbio);
+    BIO_free_all(sbio);
+    BIO_free(cpair);
+    BIO_free(spair);
+    return ret;
+}
+
+static int run_sweep(struct sweep_st *sw)
+{
+    SSL_CTX *cctx = SSL_CTX_new(OSSL_QUIC_client_method());
+    size_t g, c, r, l, b, f;
+    int i, amp;
+
+    if (cctx == NULL)
+        return 0;
+    SSL_CTX_set_verify(cctx, SSL_VERIFY_NONE, NULL);
+
+    printf("Group,Cert,RttMs,LossPct,BwKbps,Run,Status,HandshakeMs,"
+           "ClientDgrams,ClientBytes,ServerDgrams,ServerBytes,Lost,"
+           "RoundTrips,ClientCpuMs,ServerCpuMs,AmpLimited\n");
+    if (sw->flights_out != NULL)
+        fprintf(sw->flights_out, "Group,Cert,RttMs,LossPct,BwKbps,Run,Flight,"
+                "Sender,StartMs,Dgrams,Bytes,AmpLimited\n");
+    for (g = 0; g < sw->num_groups; g++)
+    for (c = 0; c < sw->num_certs; c++)
+    for (r = 0; r < sw->num_rtt; r++)
+    for (l = 0; l < sw->num_loss; l++)
+    for (b = 0; b < sw->num_bw; b++)
+    for (i = 0; i < sw->repeats; i++) {
+        NETEM_PARAMS params = sw->base;
+        struct result_st res;
+
+        params.delay = ossl_us2time((uint64_t)(sw->rtt_ms[r] * 500));
+        params.rate_bps = (uint64_t)(sw->bw_kbps[b] * 1000);
+        if (params.loss_model != NETEM_LOSS_GILBERT_ELLIOTT) {
+            params.loss = sw->loss_pct[l] / 100;
+            params.loss_model = params.loss > 0 ? NETEM_LOSS_BERNOULLI
+                                                : NETEM_LOSS_NONE;
+        }
+        /* Different but reproducible losses for every repetition */
+        params.seed = sw->base.seed + (uint64_t)i;
+
+        if (!run_handshake(cctx, sw->certs[c].ctx, sw->groups[g], &params,
+                           sw->no_validate, sw->cpu_scale, sw->timeout_ms,
+                           &res)) {
+            fprintf(stderr, "%s: cannot set up a handshake with %s and %s\n",
+                    prog, sw->groups[g], sw->certs[c].cert);
+            ERR_print_errors_fp(stderr);
+            SSL_CTX_free(cctx);
+            return 0;
+        }
+        for (f = 0, amp = 0; f < res.num_flights; f++) {
+            amp += res.flights[f].amp_limited;
+            if (sw->flights_out == NULL)
+                continue;
+            fprintf(sw->flights_out,
+                    "%s,%s,%g,%g,%g,%d,%zu,%s,%.3f,%llu,%llu,%d\n",
+                    sw->groups[g], sw->certs[c].cert, sw->rtt_ms[r],
+                    params.loss_model == NETEM_LOSS_GILBERT_ELLIOTT
+                        ? -1.0 : sw->loss_pct[l],
+                    sw->bw_kbps[b], i, f,
+                    res.flights[f].server ? "server" : "client",
+                    (double)ossl_time2us(res.flights[f].start) / 1000,
+                    (unsigned long long)res.flights[f].dgrams,
+                    (unsigned long long)res.flights[f].bytes,
+                    res.flights[f].amp_limited);
+        }
+        printf("%s,%s,%g,%g,%g,%d,%s,%.3f,%llu,%llu,%llu,%llu,%llu,"
+               "%d,%.3f,%.3f,%d\n",
+               sw->groups[g], sw->certs[c].cert, sw->rtt_ms[r],
+               params.loss_model == NETEM_LOSS_GILBERT_ELLIOTT
+                   ? -1.0 : sw->loss_pct[l],
+               sw->bw_kbps[b], i, res.ok ? "ok" : "failed",
+               (double)ossl_time2us(res.handshake) / 1000,
+               (unsigned long long)res.c2s.dgrams_sent,
+               (unsigned long long)res.c2s.bytes_sent,
+               (unsigned long long)res.s2c.dgrams_sent,
+               (unsigned long long)res.s2c.bytes_sent,
+               (unsigned long long)(res.c2s.dgrams_lost + res.c2s.dgrams_too_big
+                                    + res.s2c.dgrams_lost
+                                    + res.s2c.dgrams_too_big),
+               res.round_trips, (double)res.client_cpu_ns / 1e6,
+               (double)res.server_cpu_ns / 1e6, amp);
+        fflush(stdout);
+    }
+    SSL_CTX_free(cctx);
+    return 1;
+}
+
+int main(int ac, char **av)
+{
+    static struct sweep_st sw;
+    static char default_group[] = "X25519";
+    double ge[4];
+    char *tok, *sep, *flights_file = NULL;
+    size_t i;
+    int opt, ret = EXIT_FAILURE;
+
+    prog = av[0];
+    sw.rtt_ms[0] = sw.loss_pct[0] = sw.bw_kbps[0] = 0;
+    sw.num_rtt = sw.num_loss = sw.num_bw = 1;
+    sw.base.mtu = 1500;
+    sw.base.seed = 1;
+    sw.repeats = 10;
+    sw.timeout_ms = 60000;
+    sw.cpu_scale = 1;
+
+    while ((opt = getopt(ac, av, "g:c:r:l:b:j:m:G:n:s:t:x:NF:")) != EOF) {
+        switch (opt) {
+        case 'g':
+            for (tok = strtok(optarg, ","); tok != NULL;
+                 tok = strtok(NULL, ",")) {
+                if (sw.num_groups == MAX_LIST)
+                    usage();
+                sw.groups[sw.num_groups++] = tok;
+            }
+            break;
+        case 'c':
+            if (sw.num_certs == MAX_CERTS
+                    || (sep = strrchr(optarg, ':')) == NULL)
+                usage();
+            *sep = '\0';
+            sw.certs[sw.num_certs].cert = optarg;
+            sw.certs[sw.num_certs++].key = sep + 1;
+            break;
+        case 'r':
+            sw.num_rtt = parse_list(optarg, sw.rtt_ms);
+            break;
+        case 'l':
+            sw.num_loss = parse_list(optarg, sw.loss_pct);
+            break;
+        case 'b':
+            sw.num_bw = parse_list(optarg, sw.bw_kbps);
+            break;
+        case 'j':
+            sw.base.jitter = ossl_us2time((uint64_t)(atof(optarg) * 1000));
+            break;
+        case 'm':
+            sw.base.mtu = (size_t)atol(optarg);
+            break;
+        case 'G':
+            if (parse_list(optarg, ge) != 4)
+                usage();
+            sw.base.loss_model = NETEM_LOSS_GILBERT_ELLIOTT;
+            sw.base.ge_p = ge[0] / 100;
+            sw.base.ge_r = ge[1] / 100;
+            sw.base.ge_loss_good = ge[2] / 100;
+            sw.base.ge_loss_bad = ge[3] / 100;
+            break;
+        case 'n':
+            if ((sw.repeats = atoi(optarg)) <= 0)
+                usage();
+            break;
+        case 's':
+            sw.base.seed = strtoull(optarg, NULL, 0);
+            break;
+        case 't':
+            sw.timeout_ms = strtoull(optarg, NULL, 0);
+            break;
+        case 'x':
+            if ((sw.cpu_scale = atof(optarg)) < 0)
+                usage();
+            break;
+        case 'N':
+            sw.no_validate = 1;
+            break;
+        case 'F':
+            flights_file = optarg;
+            break;
+        default:
+            usage();
+        }
+    }
+    if (optind != ac || sw.num_certs == 0)
+        usage();
+    if (sw.num_groups == 0)
+        sw.groups[sw.num_groups++] = default_group;
+    if (sw.base.loss_model == NETEM_LOSS_GILBERT_ELLIOTT)
+        sw.num_loss = 1;
+
+    for (i = 0; i < sw.num_certs; i++) {
+        sw.certs[i].ctx = create_server_ctx(sw.certs[i].cert, sw.certs[i].key);
+        if (sw.certs[i].ctx == NULL) {
+            fprintf(stderr, "%s: cannot load %s and %s\n", prog,
+                    sw.certs[i].cert, sw.certs[i].key);
+            ERR_print_errors_fp(stderr);
+            goto end;
+        }
+    }
+
+    if (flights_file != NULL
+            && (sw.flights_out = fopen(flights_file, "w")) == NULL) {
+        fprintf(stderr, "%s: cannot open %s\n", prog, flights_file);
+        goto end;
+    }
+
+    if (run_sweep(&sw))
+        ret = EXIT_SUCCESS;
+ end:
+    if (sw.flights_out != NULL)
+        fclose(sw.flights_out);
+    for (i = 0; i < sw.num_certs; i++)
+        SSL_CTX_free(sw.certs[i].ctx);
+    bio_f_netem_dgram_filter_free();
+    return ret;
+}
+
+#else
+
+int main(int ac, char **av)
+{
+    fprintf(stderr, "This program is not supported on this platform\n");
+    return EXIT_FAILURE;
+}
+
+#endif
@@ -9,6 +9,7 @@
 
 #include <stdio.h>
 #include <string.h>
+#include <time.h>
 
 #include <openssl/opensslconf.h>
 #include <openssl/quic.h>
@@ -16,6 +17,7 @@
 
 #include "helpers/ssltestlib.h"
 #include "helpers/quictestlib.h"
+#include "helpers/netembio.h"
 #include "testutil.h"
 #include "testutil/output.h"
 #include "../ssl/ssl_local.h"
@@ -1565,6 +1567,179 @@ static int test_get_shutdown(void)
     return testresult;
 }
 
+/*
+ * The handshake timeline of a QUIC connection also carries the transport
+ * events: the first Initial and handshake confirmation.
+ */
+static int test_handshake_timeline(void)
+{
+    SSL_CTX *cctx = SSL_CTX_new_ex(libctx, NULL, OSSL_QUIC_client_method());
+    SSL *clientquic = NULL;
+    QUIC_TSERVER *qtserv = NULL;
+    const SSL_HANDSHAKE_TIMELINE *tl;
+    int testresult = 0, i;
+
+    if (!TEST_ptr(cctx)
+            || !TEST_true(qtest_create_quic_objects(libctx, cctx, NULL, cert,
+                                                    privkey,
+                                                    QTEST_FLAG_FAKE_TIME,
+                                                    &qtserv, &clientquic,
+                                                    NULL, NULL))
+            || !TEST_true(qtest_create_quic_connection(qtserv, clientquic)))
+        goto err;
+
+    if (!TEST_ptr(tl = SSL_get0_handshake_timeline(clientquic)))
+        goto err;
+
+    /* HANDSHAKE_DONE may still be on its way */
+    for (i = 0; i < 100 && tl->event[SSL_HANDSHAKE_EVENT_CONFIRMED] == 0; i++) {
+        ossl_quic_tserver_tick(qtserv);
+        SSL_handle_events(clientquic);
+        qtest_add_time(1);
+    }
+
+    if (!TEST_uint64_t_ne(tl->event[SSL_HANDSHAKE_EVENT_CLIENT_HELLO], 0)
+            || !TEST_uint64_t_ge(tl->event[SSL_HANDSHAKE_EVENT_FIRST_INITIAL_SENT],
+                                 tl->event[SSL_HANDSHAKE_EVENT_CLIENT_HELLO])
+            || !TEST_uint64_t_ge(tl->event[SSL_HANDSHAKE_EVENT_SERVER_HELLO],
+                                 tl->event[SSL_HANDSHAKE_EVENT_FIRST_INITIAL_SENT])
+            || !TEST_uint64_t_ge(tl->event[SSL_HANDSHAKE_EVENT_COMPLETE],
+                                 tl->event[SSL_HANDSHAKE_EVENT_SERVER_HELLO])
+            || !TEST_uint64_t_ge(tl->event[SSL_HANDSHAKE_EVENT_CONFIRMED],
+                                 tl->event[SSL_HANDSHAKE_EVENT_COMPLETE]))
+        goto err;
+
+    testresult = 1;
+ err:
+    ossl_quic_tserver_free(qtserv);
+    SSL_free(clientquic);
+    SSL_CTX_free(cctx);
+
+    return testresult;
+}
+
+/*
+ * On a QUIC connection the handshake CPU counters include packet protection,
+ * which stops being accounted once the handshake is confirmed.
+ */
+static int test_handshake_cpu_stats(void)
+{
+    SSL_CTX *cctx = SSL_CTX_new_ex(libctx, NULL, OSSL_QUIC_client_method());
+    SSL *clientquic = NULL;
+    QUIC_TSERVER *qtserv = NULL;
+    const SSL_HANDSHAKE_TIMELINE *tl;
+    SSL_HANDSHAKE_CPU_STATS st, st2;
+    int testresult = 0, i;
+
+    if (!TEST_ptr(cctx)
+            || !TEST_true(qtest_create_quic_objects(libctx, cctx, NULL, cert,
+                                                    privkey,
+                                                    QTEST_FLAG_FAKE_TIME,
+                                                    &qtserv, &clientquic,
+                                                    NULL, NULL))
+            || !TEST_true(qtest_create_quic_connection(qtserv, clientquic))
+            || !TEST_ptr(tl = SSL_get0_handshake_timeline(clientquic)))
+        goto err;
+
+    for (i = 0; i < 100 && tl->event[SSL_HANDSHAKE_EVENT_CONFIRMED] == 0; i++) {
+        ossl_quic_tserver_tick(qtserv);
+        SSL_handle_events(clientquic);
+        qtest_add_time(1);
+    }
+
+    if (!TEST_uint64_t_ne(tl->event[SSL_HANDSHAKE_EVENT_CONFIRMED], 0)
+            || !TEST_long_eq(SSL_get_handshake_cpu_stats(clientquic, &st), 1))
+        goto err;
+
+#ifdef CLOCK_THREAD_CPUTIME_ID
+    if (!TEST_uint64_t_gt(st.keyshare_ns, 0)
+            || !TEST_uint64_t_gt(st.record_ns, 0))
+        goto err;
+#endif
+
+    /* Packets after confirmation are not counted */
+    for (i = 0; i < 10; i++) {
+        ossl_quic_tserver_tick(qtserv);
+        SSL_handle_events(clientquic);
+        qtest_add_time(100);
+    }
+
+    if (!TEST_long_eq(SSL_get_handshake_cpu_stats(clientquic, &st2), 1)
+            || !TEST_uint64_t_eq(st2.record_ns, st.record_ns))
+        goto err;
+
+    testresult = 1;
+ err:
+    ossl_quic_tserver_free(qtserv);
+    SSL_free(clientquic);
+    SSL_CTX_free(cctx);
+
+    return testresult;
+}
+
+/*
+ * The per encryption level counters of the two ends must match, and the
+ * client Initial datagrams must be padded to 1200 bytes.
+ */
+static int test_quic_level_stats(void)
+{
+    SSL_CTX *cctx = SSL_CTX_new_ex(libctx, NULL, OSSL_QUIC_client_method());
+    SSL *clientquic = NULL;
+    QUIC_TSERVER *qtserv = NULL;
+    SSL_QUIC_LEVEL_STATS cst, sst;
+    const SSL_QUIC_LEVEL_COUNTERS *ci, *ch, *si;
+    int testresult = 0;
+
+    if (!TEST_ptr(cctx)
+            || !TEST_true(qtest_create_quic_objects(libctx, cctx, NULL, cert,
+                                                    privkey,
+                                                    QTEST_FLAG_FAKE_TIME,
+                                                    &qtserv, &clientquic,
+                                                    NULL, NULL))
+            || !TEST_true(qtest_create_quic_connection(qtserv, clientquic)))
+        goto err;
+
+    ossl_quic_tserver_tick(qtserv);
+    SSL_handle_events(clientquic);
+
+    if (!TEST_long_eq(SSL_get_quic_level_stats(clientquic, &cst), 1))
+        goto err;
+    ossl_quic_channel_get_level_stats(ossl_quic_tserver_get_channel(qtserv),
+                                      &sst);
+
+    ci = &cst.level[SSL_QUIC_LEVEL_INITIAL];
+    ch = &cst.level[SSL_QUIC_LEVEL_HANDSHAKE];
+    si = &sst.level[SSL_QUIC_LEVEL_INITIAL];
+
+    if (!TEST_uint64_t_gt(ci->dgrams_sent, 0)
+            || !TEST_uint64_t_ge(ci->bytes_sent, 1200)
+            || !TEST_uint64_t_gt(ci->padding_sent, 0)
+            || !TEST_uint64_t_lt(ci->retx_bytes_sent, ci->bytes_sent)
+            || !TEST_uint64_t_gt(ci->bytes_received, 0)
+            || !TEST_uint64_t_gt(ch->pkts_sent, 0)
+            || !TEST_uint64_t_gt(ch->bytes_received, ch->bytes_sent)
+            || !TEST_uint64_t_gt(cst.level[SSL_QUIC_LEVEL_APPLICATION].pkts_received, 0)
+            /*
+             * The server may drop a client Initial which arrives before the
+             * connection is set up, but everything it sent was received.
+             */
+            || !TEST_uint64_t_gt(si->pkts_received, 0)
+            || !TEST_uint64_t_le(si->bytes_received, ci->bytes_sent)
+            || !TEST_uint64_t_eq(si->pkts_sent, ci->pkts_received)
+            || !TEST_uint64_t_eq(si->bytes_sent, ci->bytes_received)
+            || !TEST_uint64_t_eq(sst.level[SSL_QUIC_LEVEL_HANDSHAKE].bytes_sent,
+                                 ch->bytes_received))
+        goto err;
+
+    testresult = 1;
+ err:
+    ossl_quic_tserver_free(qtserv);
+    SSL_free(clientquic);
+    SSL_CTX_free(cctx);
+
+    return testresult;
+}
+
 #define MAX_LOOPS   2000
 
 /*
@@ -1820,6 +1995,166 @@ static int test_bw_limit(void)
     return testresult;
 }
 
+static OSSL_TIME netem_fake_now;
+
+static OSSL_TIME netem_get_fake_now(void *arg)
+{
+    return netem_fake_now;
+}
+
+static int netem_send(BIO *bio, unsigned char *buf, size_t len)
+{
+    BIO_MSG msg;
+    size_t processed = 0;
+
+    memset(&msg, 0, sizeof(msg));
+    msg.data = buf;
+    msg.data_len = len;
+    return BIO_sendmmsg(bio, &msg, sizeof(msg), 1, 0, &processed)
+        && processed == 1;
+}
+
+/*
+ * Test the network emulation filter on its own: datagrams arrive after the
+ * serialisation time plus the one-way delay, oversized ones are dropped and
+ * the loss models are reproducible for a given seed.
+ */
+static int test_netem_filter(void)
+{
+    BIO *bio1 = NULL, *bio2 = NULL, *netem = NULL, *netem2 = NULL;
+    NETEM_PARAMS params;
+    NETEM_STATS stats, stats2;
+    struct bio_netem_now_cb_st now_cb = { netem_get_fake_now, NULL };
+    struct bio_netem_delay_st delay;
+    unsigned char buf[1200], rbuf[1200];
+    BIO_MSG rmsg;
+    OSSL_TIME deadline;
+    size_t processed, i;
+    int testresult = 0;
+
+    memset(buf, 0x5a, sizeof(buf));
+    memset(&params, 0, sizeof(params));
+    /* 1 Mbit/s, so a 472 byte datagram (500 on the wire) takes 4ms */
+    params.delay = ossl_ms2time(10);
+    params.rate_bps = 1000000;
+    params.mtu = 1000;
+    netem_fake_now = ossl_ms2time(1000);
+
+    if (!TEST_true(BIO_new_bio_dgram_pair(&bio1, 0, &bio2, 0))
+            || !TEST_ptr(netem = BIO_new(bio_f_netem_dgram_filter()))
+            || !TEST_ptr(netem2 = BIO_new(bio_f_netem_dgram_filter())))
+        goto err;
+    BIO_push(netem, bio1);
+    bio1 = NULL;
+
+    if (!TEST_true(BIO_ctrl(netem, BIO_CTRL_NETEM_SET_PARAMS, 0, &params))
+            || !TEST_true(BIO_ctrl(netem, BIO_CTRL_NETEM_SET_NOW_CB, 0,
+                                   &now_cb)))
+        goto err;
+
+    for (i = 0; i < 3; i++)
+        if (!TEST_true(netem_send(netem, buf, 472)))
+            goto err;
+    /* Too big for the MTU once the IP and UDP headers are added */
+    if (!TEST_true(netem_send(netem, buf, 973)))
+        goto err;
+
+    /* Nothing may arrive before the first datagram has crossed the link */
+    if (!TEST_true(BIO_ctrl(netem, BIO_CTRL_NETEM_GET_NEXT_DEADLINE, 0,
+                            &deadline))
+            || !TEST_uint64_t_eq(ossl_time2ms(deadline), 1014))
+        goto err;
+    netem_fake_now = ossl_ms2time(1013);
+    if (!TEST_long_eq(BIO_ctrl(netem, BIO_CTRL_NETEM_FLUSH, 0, NULL), 0))
+        goto err;
+    netem_fake_now = ossl_ms2time(1014);
+    if (!TEST_long_eq(BIO_ctrl(netem, BIO_CTRL_NETEM_FLUSH, 0, NULL), 1))
+        goto err;
+    netem_fake_now = ossl_ms2time(1022);
+    if (!TEST_long_eq(BIO_ctrl(netem, BIO_CTRL_NETEM_FLUSH, 0, NULL), 2)
+            || !TEST_false(BIO_ctrl(netem, BIO_CTRL_NETEM_GET_NEXT_DEADLINE, 0,
+                                    &deadline)))
+        goto err;
+
+    memset(&rmsg, 0, sizeof(rmsg));
+    rmsg.data = rbuf;
+    rmsg.data_len = sizeof(rbuf);
+    if (!TEST_true(BIO_recvmmsg(bio2, &rmsg, sizeof(rmsg), 1, 0, &processed))
+            || !TEST_mem_eq(rmsg.data, rmsg.data_len, buf, 472))
+        goto err;
+
+    if (!TEST_true(BIO_ctrl(netem, BIO_CTRL_NETEM_GET_STATS, 0, &stats))
+            || !TEST_uint64_t_eq(stats.dgrams_sent, 4)
+            || !TEST_uint64_t_eq(stats.dgrams_delivered, 3)
+            || !TEST_uint64_t_eq(stats.dgrams_too_big, 1))
+        goto err;
+
+    /* Held datagrams can be pushed back, e.g. by the sender's CPU time */
+    params.rate_bps = 0;
+    if (!TEST_true(BIO_ctrl(netem, BIO_CTRL_NETEM_SET_PARAMS, 0, &params))
+            || !TEST_true(BIO_ctrl(netem, BIO_CTRL_NETEM_SET_HOLD, 1, NULL))
+            || !TEST_true(netem_send(netem, buf, 100)))
+        goto err;
+    netem_fake_now = ossl_ms2time(1032);
+    delay.first_dgram = stats.dgrams_sent;
+    delay.delay = ossl_ms2time(5);
+    if (!TEST_long_eq(BIO_ctrl(netem, BIO_CTRL_NETEM_FLUSH, 0, NULL), 0)
+            || !TEST_true(BIO_ctrl(netem, BIO_CTRL_NETEM_DELAY_QUEUED, 0,
+                                   &delay))
+            || !TEST_true(BIO_ctrl(netem, BIO_CTRL_NETEM_SET_HOLD, 0, NULL))
+            || !TEST_long_eq(BIO_ctrl(netem, BIO_CTRL_NETEM_FLUSH, 0, NULL), 0)
+            || !TEST_true(BIO_ctrl(netem, BIO_CTRL_NETEM_GET_NEXT_DEADLINE, 0,
+                                   &deadline))
+            || !TEST_uint64_t_eq(ossl_time2ms(deadline), 1037))
+        goto err;
+
+    /* The same seed gives the same bursty losses on two filters */
+    params.loss_model = NETEM_LOSS_GILBERT_ELLIOTT;
+    params.ge_p = 0.1;
+    params.ge_r = 0.3;
+    params.ge_loss_good = 0.01;
+    params.ge_loss_bad = 0.8;
+    params.seed = 42;
+    BIO_push(netem2, bio2);
+    bio2 = NULL;
+    if (!TEST_true(BIO_ctrl(netem, BIO_CTRL_NETEM_SET_PARAMS, 0, &params))
+            || !TEST_true(BIO_ctrl(netem2, BIO_CTRL_NETEM_SET_PARAMS, 0,
+                                   &params))
+            || !TEST_true(BIO_ctrl(netem2, BIO_CTRL_NETEM_SET_NOW_CB, 0,
+                                   &now_cb)))
+        goto err;
+
+    for (i = 0; i < 200; i++)
+        if (!TEST_true(netem_send(netem, buf, 100))
+                || !TEST_true(netem_send(netem2, buf, 100)))
+            goto err;
+    if (!TEST_true(BIO_ctrl(netem, BIO_CTRL_NETEM_GET_STATS, 0, &stats))
+            || !TEST_true(BIO_ctrl(netem2, BIO_CTRL_NETEM_GET_STATS, 0,
+                                   &stats2))
+            || !TEST_uint64_t_gt(stats.dgrams_lost, 0)
+            || !TEST_uint64_t_lt(stats.dgrams_lost, 200)
+            || !TEST_uint64_t_eq(stats.dgrams_lost, stats2.dgrams_lost))
+        goto err;
+
+    /* Everything is lost at a loss rate of 1 */
+    params.loss_model = NETEM_LOSS_BERNOULLI;
+    params.loss = 1.0;
+    if (!TEST_true(BIO_ctrl(netem, BIO_CTRL_NETEM_SET_PARAMS, 0, &params))
+            || !TEST_true(netem_send(netem, buf, 100))
+            || !TEST_true(BIO_ctrl(netem, BIO_CTRL_NETEM_GET_STATS, 0,
+                                   &stats2))
+            || !TEST_uint64_t_eq(stats2.dgrams_lost, stats.dgrams_lost + 1))
+        goto err;
+
+    testresult = 1;
+ err:
+    BIO_free_all(netem);
+    BIO_free_all(netem2);
+    BIO_free(bio1);
+    BIO_free(bio2);
+    return testresult;
+}
+
 enum {
     TPARAM_OP_DUP,
     TPARAM_OP_DROP,
@@ -2776,7 +3111,11 @@ int setup_tests(void)
     ADD_ALL_TESTS(test_alpn, 2);
     ADD_ALL_TESTS(test_noisy_dgram, 2);
     ADD_TEST(test_bw_limit);
+    ADD_TEST(test_netem_filter);
     ADD_TEST(test_get_shutdown);
+    ADD_TEST(test_handshake_timeline);
+    ADD_TEST(test_handshake_cpu_stats);
+    ADD_TEST(test_quic_level_stats);
     ADD_ALL_TESTS(test_tparam, OSSL_NELEM(tparam_tests));
     ADD_TEST(test_session_cb);
     ADD_TEST(test_domain_flags);
@@ -2796,6 +3135,7 @@ void cleanup_tests(void)
 {
     bio_f_noisy_dgram_filter_free();
     bio_f_pkt_split_dgram_filter_free();
+    bio_f_netem_dgram_filter_free();
     OPENSSL_free(cert);
     OPENSSL_free(privkey);
     OPENSSL_free(ccert);
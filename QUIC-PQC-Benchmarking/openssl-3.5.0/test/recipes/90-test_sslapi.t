@@ -144,6 +144,7 @@ SKIP: {
        "running sslapitest with modified fips config");
 }
 
-ok(run(test(["ssl_handshake_rtt_test"])),"running ssl_handshake_rtt_test");
+ok(run(test(["ssl_handshake_rtt_test", srctop_dir("test", "certs")])),
+   "running ssl_handshake_rtt_test");
 
 unlink $tmpfilename;
@@ -17,6 +17,7 @@
 
 #include <stdio.h>
 #include <string.h>
+#include <time.h>
 
 #include <openssl/opensslconf.h>
 #include <openssl/bio.h>
@@ -131,9 +132,212 @@ static int test_handshake_rtt(int tst)
     return testresult;
 }
 
+/* Events of |order| must have been recorded and must be non-decreasing */
+static int check_timeline(const SSL_HANDSHAKE_TIMELINE *tl, const int *order,
+                          size_t n)
+{
+    size_t i;
+
+    for (i = 0; i < n; i++) {
+        if (!TEST_uint64_t_ne(tl->event[order[i]], 0)) {
+            TEST_info("event %d not recorded", order[i]);
+            return 0;
+        }
+        if (i > 0 && !TEST_uint64_t_ge(tl->event[order[i]],
+                                       tl->event[order[i - 1]])) {
+            TEST_info("event %d before event %d", order[i], order[i - 1]);
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/*
+ * Test 0: Handshake timeline of a full TLSv1.2 handshake
+ * Test 1: Handshake timeline of a full TLSv1.3 handshake
+ */
+static int test_handshake_timeline(int tst)
+{
+    static const int client12[] = {
+        SSL_HANDSHAKE_EVENT_START, SSL_HANDSHAKE_EVENT_CLIENT_HELLO,
+        SSL_HANDSHAKE_EVENT_SERVER_HELLO, SSL_HANDSHAKE_EVENT_CERT_RECEIVED,
+        SSL_HANDSHAKE_EVENT_CERT_CHAIN_VERIFIED,
+        SSL_HANDSHAKE_EVENT_KEYSHARE_GENERATED,
+        SSL_HANDSHAKE_EVENT_KEY_EXCHANGE_DONE,
+        SSL_HANDSHAKE_EVENT_FINISHED_SENT,
+        SSL_HANDSHAKE_EVENT_FINISHED_RECEIVED,
+        SSL_HANDSHAKE_EVENT_COMPLETE, SSL_HANDSHAKE_EVENT_CONFIRMED
+    };
+    static const int client13[] = {
+        SSL_HANDSHAKE_EVENT_START, SSL_HANDSHAKE_EVENT_KEYSHARE_GENERATED,
+        SSL_HANDSHAKE_EVENT_CLIENT_HELLO, SSL_HANDSHAKE_EVENT_SERVER_HELLO,
+        SSL_HANDSHAKE_EVENT_KEY_EXCHANGE_DONE,
+        SSL_HANDSHAKE_EVENT_CERT_RECEIVED,
+        SSL_HANDSHAKE_EVENT_CERT_CHAIN_VERIFIED,
+        SSL_HANDSHAKE_EVENT_CERT_VERIFY_RECEIVED,
+        SSL_HANDSHAKE_EVENT_CERT_VERIFY_DONE,
+        SSL_HANDSHAKE_EVENT_FINISHED_RECEIVED,
+        SSL_HANDSHAKE_EVENT_FINISHED_SENT,
+        SSL_HANDSHAKE_EVENT_COMPLETE, SSL_HANDSHAKE_EVENT_CONFIRMED
+    };
+    static const int server13[] = {
+        SSL_HANDSHAKE_EVENT_START, SSL_HANDSHAKE_EVENT_CLIENT_HELLO,
+        SSL_HANDSHAKE_EVENT_KEY_EXCHANGE_DONE,
+        SSL_HANDSHAKE_EVENT_SERVER_HELLO, SSL_HANDSHAKE_EVENT_FINISHED_SENT,
+        SSL_HANDSHAKE_EVENT_FINISHED_RECEIVED,
+        SSL_HANDSHAKE_EVENT_COMPLETE, SSL_HANDSHAKE_EVENT_CONFIRMED
+    };
+    SSL_CTX *cctx = NULL, *sctx = NULL;
+    SSL *clientssl = NULL, *serverssl = NULL;
+    const SSL_HANDSHAKE_TIMELINE *ctl, *stl;
+    int testresult = 0;
+
+#ifdef OPENSSL_NO_TLS1_2
+    if (tst == 0)
+        return 1;
+#endif
+#ifdef OSSL_NO_USABLE_TLS1_3
+    if (tst == 1)
+        return 1;
+#endif
+
+    if (!TEST_true(create_ssl_ctx_pair(libctx, TLS_server_method(),
+                                       TLS_client_method(),
+                                       TLS1_VERSION,
+                                       tst == 0 ? TLS1_2_VERSION
+                                                : TLS1_3_VERSION,
+                                       &sctx, &cctx, cert, privkey))
+            || !TEST_true(create_ssl_objects(sctx, cctx, &serverssl, &clientssl,
+                                             NULL, NULL)))
+        goto end;
+
+    if (!TEST_ptr(ctl = SSL_get0_handshake_timeline(clientssl))
+            || !TEST_ptr(stl = SSL_get0_handshake_timeline(serverssl))
+            || !TEST_uint64_t_eq(ctl->event[SSL_HANDSHAKE_EVENT_START], 0)
+            || !TEST_true(create_ssl_connection(serverssl, clientssl,
+                                                SSL_ERROR_NONE)))
+        goto end;
+
+    if (tst == 0) {
+        if (!check_timeline(ctl, client12, OSSL_NELEM(client12))
+                /* No CertificateVerify from a TLSv1.2 server */
+                || !TEST_uint64_t_eq(ctl->event[SSL_HANDSHAKE_EVENT_CERT_VERIFY_DONE],
+                                     0))
+            goto end;
+    } else {
+        if (!check_timeline(ctl, client13, OSSL_NELEM(client13))
+                || !check_timeline(stl, server13, OSSL_NELEM(server13)))
+            goto end;
+    }
+
+    /* Transport-level events are QUIC only */
+    if (!TEST_uint64_t_eq(ctl->event[SSL_HANDSHAKE_EVENT_FIRST_INITIAL_SENT], 0))
+        goto end;
+
+    /* SSL_clear() starts a new timeline */
+    if (!TEST_true(SSL_clear(clientssl))
+            || !TEST_uint64_t_eq(ctl->event[SSL_HANDSHAKE_EVENT_COMPLETE], 0))
+        goto end;
+
+    testresult = 1;
+
+ end:
+    SSL_free(serverssl);
+    SSL_free(clientssl);
+    SSL_CTX_free(sctx);
+    SSL_CTX_free(cctx);
+
+    return testresult;
+}
+
+/*
+ * The TLSv1.3 server spends CPU time on its key share and on signing the
+ * CertificateVerify, the client on its key share and on verifying the server
+ * certificate and CertificateVerify. Record protection is only accounted for
+ * QUIC.
+ */
+static int test_handshake_cpu_stats(void)
+{
+    SSL_CTX *cctx = NULL, *sctx = NULL;
+    SSL *clientssl = NULL, *serverssl = NULL;
+    SSL_HANDSHAKE_CPU_STATS cst, sst;
+    int testresult = 0;
+
+#ifdef OSSL_NO_USABLE_TLS1_3
+    return 1;
+#endif
+
+    if (!TEST_true(create_ssl_ctx_pair(libctx, TLS_server_method(),
+                                       TLS_client_method(),
+                                       TLS1_VERSION, TLS1_3_VERSION,
+                                       &sctx, &cctx, cert, privkey))
+            || !TEST_true(create_ssl_objects(sctx, cctx, &serverssl, &clientssl,
+                                             NULL, NULL))
+            || !TEST_true(create_ssl_connection(serverssl, clientssl,
+                                                SSL_ERROR_NONE)))
+        goto end;
+
+    if (!TEST_long_eq(SSL_get_handshake_cpu_stats(clientssl, &cst), 1)
+            || !TEST_long_eq(SSL_get_handshake_cpu_stats(serverssl, &sst), 1)
+            || !TEST_long_eq(SSL_get_handshake_cpu_stats(serverssl, NULL), 0))
+        goto end;
+
+#ifdef CLOCK_THREAD_CPUTIME_ID
+    if (!TEST_uint64_t_gt(cst.keyshare_ns, 0)
+            || !TEST_uint64_t_gt(sst.keyshare_ns, 0)
+            || !TEST_uint64_t_gt(sst.sign_ns, 0)
+            || !TEST_uint64_t_gt(cst.verify_ns, 0))
+        goto end;
+#endif
+    if (!TEST_uint64_t_eq(cst.sign_ns, 0)
+            || !TEST_uint64_t_eq(sst.verify_ns, 0)
+            || !TEST_uint64_t_eq(cst.record_ns, 0)
+            || !TEST_uint64_t_eq(sst.record_ns, 0))
+        goto end;
+
+    /* SSL_clear() resets the counters */
+    if (!TEST_true(SSL_clear(serverssl))
+            || !TEST_long_eq(SSL_get_handshake_cpu_stats(serverssl, &sst), 1)
+            || !TEST_uint64_t_eq(sst.keyshare_ns, 0)
+            || !TEST_uint64_t_eq(sst.sign_ns, 0))
+        goto end;
+
+    testresult = 1;
+
+ end:
+    SSL_free(serverssl);
+    SSL_free(clientssl);
+    SSL_CTX_free(sctx);
+    SSL_CTX_free(cctx);
+
+    return testresult;
+}
+
+OPT_TEST_DECLARE_USAGE("certdir\n")
+
 int setup_tests(void)
 {
+    char *certsdir = NULL;
+
+    if (!test_skip_common_options()) {
+        TEST_error("Error parsing test options\n");
+        return 0;
+    }
+
+    if (!TEST_ptr(certsdir = test_get_argument(0))
+            || !TEST_ptr(cert = test_mk_file_path(certsdir, "servercert.pem"))
+            || !TEST_ptr(privkey = test_mk_file_path(certsdir, "serverkey.pem")))
+        return 0;
+
     ADD_ALL_TESTS(test_handshake_rtt, 5);
+    ADD_ALL_TESTS(test_handshake_timeline, 2);
+    ADD_TEST(test_handshake_cpu_stats);
 
     return 1;
 }
+
+void cleanup_tests(void)
+{
+    OPENSSL_free(cert);
+    OPENSSL_free(privkey);
+}
@@ -0,0 +1,459 @@
+#!/usr/bin/env python3
+"""
+run_matrix.py
+Run a full handshake benchmark matrix (KEM groups x signature algorithms x
+network profiles x repeats) and store every sample in one SQLite file, keyed
+by host and commit.
+
+Loopback profiles start the demo server and drive it with the in-process load
+generator (demos/quic/loadgen); emulated profiles run test/quic_netem_bench.
+"""
+import argparse
+import contextlib
+import csv
+import io
+import json
+import math
+import os
+import platform
+import signal
+import socket
+import sqlite3
+import subprocess
+import sys
+import tempfile
+import time
+from datetime import datetime, timezone
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+
+# === Database layout ===
+# runs:    one row per invocation (host, commit, spec)
+# cells:   one row per kem x sig x profile x repeat
+# samples: one row per handshake
+SCHEMA = """
+CREATE TABLE IF NOT EXISTS runs (
+    id INTEGER PRIMARY KEY,
+    host TEXT NOT NULL,
+    commit_id TEXT NOT NULL,
+    started TEXT NOT NULL,
+    openssl TEXT,
+    spec TEXT NOT NULL
+);
+CREATE TABLE IF NOT EXISTS cells (
+    id INTEGER PRIMARY KEY,
+    run_id INTEGER NOT NULL REFERENCES runs(id),
+    kem TEXT NOT NULL,
+    sig TEXT NOT NULL,
+    profile TEXT NOT NULL,
+    repeat INTEGER NOT NULL,
+    backend TEXT NOT NULL,
+    ok INTEGER NOT NULL,
+    failed INTEGER NOT NULL
+);
+CREATE TABLE IF NOT EXISTS samples (
+    cell_id INTEGER NOT NULL REFERENCES cells(id),
+    seq INTEGER NOT NULL,
+    status TEXT NOT NULL,
+    handshake_ms REAL,
+    rtt_ms REAL,
+    session TEXT,
+    round_trips INTEGER,
+    client_bytes INTEGER,
+    server_bytes INTEGER,
+    client_cpu_ms REAL,
+    server_cpu_ms REAL
+);
+CREATE INDEX IF NOT EXISTS runs_host_commit ON runs(host, commit_id);
+CREATE INDEX IF NOT EXISTS cells_matrix ON cells(run_id, kem, sig, profile);
+CREATE INDEX IF NOT EXISTS samples_cell ON samples(cell_id);
+"""
+
+# genpkey arguments for signature names that are not plain algorithm names
+SIG_KEYGEN = {
+    "EC": ["-algorithm", "EC", "-pkeyopt", "ec_paramgen_curve:P-256"],
+    "ECDSA-P256": ["-algorithm", "EC", "-pkeyopt", "ec_paramgen_curve:P-256"],
+    "ECDSA-P384": ["-algorithm", "EC", "-pkeyopt", "ec_paramgen_curve:P-384"],
+    "RSA-2048": ["-algorithm", "RSA", "-pkeyopt", "rsa_keygen_bits:2048"],
+    "RSA-3072": ["-algorithm", "RSA", "-pkeyopt", "rsa_keygen_bits:3072"],
+}
+
+# TLS signature algorithm the load generator offers to select the certificate of a
+# signature name; other names are lowercased without dashes (ML-DSA-65 -> mldsa65)
+SIG_TLS = {
+    "EC": "ecdsa_secp256r1_sha256",
+    "ECDSA-P256": "ecdsa_secp256r1_sha256",
+    "ECDSA-P384": "ecdsa_secp384r1_sha384",
+    "RSA-2048": "rsa_pss_rsae_sha256",
+    "RSA-3072": "rsa_pss_rsae_sha256",
+}
+
+# Certificates one demo server loads at most (MAX_CERTS in demos/quic/server)
+SERVER_MAX_CERTS = 8
+
+# quic_netem_bench options set by the keys of an emulated profile
+NETEM_KEYS = {"rtt_ms": "-r", "loss_pct": "-l", "bw_kbps": "-b",
+              "jitter_ms": "-j", "mtu": "-m", "gilbert": "-G", "cpu_scale": "-x"}
+
+
+# === Helper Function: Percentile over a sorted list (nearest rank) ===
+def percentile(values, p):
+    """Same ranks as the load generator's summary (python3 -m doctest run_matrix.py):
+
+    >>> percentile(list(range(1, 11)), 90), percentile(list(range(1, 11)), 50)
+    (9, 5)
+    >>> percentile(list(range(1, 101)), 99)
+    99
+    """
+    if not values:
+        return float("nan")
+    k = max(0, min(len(values) - 1, math.ceil(p * len(values) / 100.0) - 1))
+    return values[k]
+
+
+# === Helper Function: Host and commit the results are keyed by ===
+def run_identity(openssl_dir):
+    try:
+        commit = subprocess.run(["git", "-C", HERE, "rev-parse", "--short", "HEAD"],
+                                capture_output=True, text=True, check=True).stdout.strip()
+        dirty = subprocess.run(["git", "-C", HERE, "status", "--porcelain",
+                                "--untracked-files=no"],
+                               capture_output=True, text=True).stdout.strip()
+        if dirty:
+            commit += "-dirty"
+    except (OSError, subprocess.CalledProcessError):
+        commit = "unknown"
+    try:
+        version = subprocess.run([openssl_bin(openssl_dir), "version"],
+                                 capture_output=True, text=True,
+                                 env=tool_env(openssl_dir)).stdout.strip()
+    except OSError:
+        version = None
+    return platform.node(), commit, version
+
+
+def openssl_bin(openssl_dir):
+    return os.path.join(openssl_dir, "apps", "openssl")
+
+
+def tool_env(openssl_dir):
+    env = dict(os.environ)
+    env["LD_LIBRARY_PATH"] = os.pathsep.join(
+        p for p in (openssl_dir, env.get("LD_LIBRARY_PATH")) if p)
+    return env
+
+
+def require(path, hint):
+    if not os.access(path, os.X_OK):
+        sys.exit(f"error: {path} not found, {hint}")
+    return path
+
+
+# === Helper Function: Self-signed certificate per signature algorithm ===
+def make_cert(openssl_dir, sig, workdir):
+    base = os.path.join(workdir, sig.replace("/", "_"))
+    key, crt = base + ".key", base + ".crt"
+    if os.path.exists(key) and os.path.exists(crt):
+        return crt, key
+    env = tool_env(openssl_dir)
+    keygen = SIG_KEYGEN.get(sig, ["-algorithm", sig])
+    subprocess.run([openssl_bin(openssl_dir), "genpkey", *keygen, "-out", key],
+                   check=True, env=env)
+    subprocess.run([openssl_bin(openssl_dir), "req", "-x509", "-new", "-key", key,
+                    "-out", crt, "-days", "365", "-subj", "/CN=localhost"],
+                   check=True, env=env)
+    return crt, key
+
+
+def tls_sigalg(sig):
+    return SIG_TLS.get(sig, sig.replace("-", "").lower())
+
+
+# === Helper Function: Split the signatures over as few servers as possible ===
+# Certificates of the same key type (e.g. ECDSA P-256 and P-384) replace each
+# other in one server, so they are put on different servers.
+def server_sets(sigs):
+    sets = []
+    for sig in sigs:
+        slot = SIG_KEYGEN[sig][1] if sig in SIG_KEYGEN else sig.upper()
+        for s in sets:
+            if slot not in s["slots"] and len(s["sigs"]) < SERVER_MAX_CERTS:
+                break
+        else:
+            s = {"slots": set(), "sigs": []}
+            sets.append(s)
+        s["slots"].add(slot)
+        s["sigs"].append(sig)
+    return [s["sigs"] for s in sets]
+
+
+def free_udp_port():
+    with socket.socket(socket.AF_INET, socket.SOCK_DGRAM) as s:
+        s.bind(("127.0.0.1", 0))
+        return s.getsockname()[1]
+
+
+# === Backend: demo server + load generator over loopback ===
+# One server accepts every KEM group and holds the certificates of several
+# signatures; the load generator selects both per cell. Yields the server port.
+@contextlib.contextmanager
+def loopback_server(openssl_dir, kems, certs, log_path):
+    server = require(os.path.join(openssl_dir, "demos", "quic", "server", "server"),
+                     "run make in demos/quic/server")
+    port = free_udp_port()
+    cmd = [server, "--threads", "1", "--groups", ":".join(kems)]
+    for crt, key in certs:
+        cmd += ["--cert", crt, "--key", key]
+    log = open(log_path, "w")
+    srv = subprocess.Popen(cmd + [str(port)], stdout=subprocess.DEVNULL, stderr=log,
+                           env=tool_env(openssl_dir))
+    try:
+        # The pool server reports once every worker socket is bound
+        deadline = time.monotonic() + 10
+        while True:
+            with open(log_path) as f:
+                text = f.read()
+            if "Serving on port" in text:
+                break
+            if srv.poll() is not None or time.monotonic() > deadline:
+                raise RuntimeError(f"server did not start:\n{text}")
+            time.sleep(0.05)
+        yield port
+    finally:
+        srv.send_signal(signal.SIGTERM)
+        try:
+            srv.wait(timeout=10)
+        except subprocess.TimeoutExpired:
+            srv.kill()
+            srv.wait()
+        log.close()
+
+
+def run_loopback(openssl_dir, spec, kem, sig, port, workdir):
+    loadgen = require(os.path.join(openssl_dir, "demos", "quic", "loadgen", "loadgen"),
+                      "run make in demos/quic/loadgen")
+    out = os.path.join(workdir, "loadgen.csv")
+    cmd = [loadgen, "--groups", kem, "--sigalgs", tls_sigalg(sig),
+           "--count", str(spec["count"]), "--warmup", str(spec["warmup"]),
+           "--concurrency", str(spec["concurrency"]), "--out", out]
+    if spec["resume"] > 0:
+        cmd += ["--resume", str(spec["resume"])]
+    subprocess.run(cmd + ["127.0.0.1", str(port)], check=True,
+                   env=tool_env(openssl_dir), stdout=subprocess.DEVNULL)
+
+    rows = []
+    with open(out, newline="") as f:
+        for r in csv.DictReader(f):
+            if r["Phase"] == "warmup":
+                continue
+            rows.append({"status": r["Status"],
+                         "handshake_ms": float(r["HandshakeMs"]),
+                         "rtt_ms": float(r["RttMs"]),
+                         "session": r["Session"]})
+    return rows
+
+
+# === Backend: simulated network with test/quic_netem_bench ===
+def run_netem(openssl_dir, spec, profile, kem, crt, key, repeat):
+    bench = require(os.path.join(openssl_dir, "test", "quic_netem_bench"),
+                    "build the tests with make")
+    cmd = [bench, "-g", kem, "-c", f"{crt}:{key}", "-n", str(spec["count"]),
+           "-s", str(1 + repeat * spec["count"])]
+    for name, opt in NETEM_KEYS.items():
+        if name in profile:
+            cmd += [opt, str(profile[name])]
+    if profile.get("no_retry"):
+        cmd.append("-N")
+    res = subprocess.run(cmd, check=True, capture_output=True, text=True,
+                         env=tool_env(openssl_dir))
+
+    rows = []
+    for r in csv.DictReader(io.StringIO(res.stdout)):
+        rows.append({"status": r["Status"],
+                     "handshake_ms": float(r["HandshakeMs"]),
+                     "round_trips": int(r["RoundTrips"]),
+                     "client_bytes": int(r["ClientBytes"]),
+                     "server_bytes": int(r["ServerBytes"]),
+                     "client_cpu_ms": float(r["ClientCpuMs"]),
+                     "server_cpu_ms": float(r["ServerCpuMs"])})
+    return rows
+
+
+def is_emulated(profile):
+    return any(k in profile for k in NETEM_KEYS) or profile.get("no_retry")
+
+
+# === Helper Function: Read and complete the matrix spec ===
+def load_spec(path):
+    with open(path) as f:
+        spec = json.load(f)
+    for field in ("kems", "sigs", "profiles"):
+        if not spec.get(field):
+            sys.exit(f"error: {path}: '{field}' must be a non-empty list")
+    for p in spec["profiles"]:
+        if "name" not in p:
+            sys.exit(f"error: {path}: every profile needs a 'name'")
+    spec.setdefault("repeats", 3)
+    spec.setdefault("count", 100)
+    spec.setdefault("warmup", 10)
+    spec.setdefault("concurrency", 1)
+    spec.setdefault("resume", 0)
+    return spec
+
+
+def store_cell(db, run_id, kem, sig, profile, repeat, backend, rows):
+    ok = sum(1 for r in rows if r["status"] == "ok")
+    cur = db.execute(
+        "INSERT INTO cells (run_id, kem, sig, profile, repeat, backend, ok, failed) "
+        "VALUES (?, ?, ?, ?, ?, ?, ?, ?)",
+        (run_id, kem, sig, profile, repeat, backend, ok, len(rows) - ok))
+    db.executemany(
+        "INSERT INTO samples (cell_id, seq, status, handshake_ms, rtt_ms, session, "
+        "round_trips, client_bytes, server_bytes, client_cpu_ms, server_cpu_ms) "
+        "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)",
+        [(cur.lastrowid, i, r["status"], r.get("handshake_ms"), r.get("rtt_ms"),
+          r.get("session"), r.get("round_trips"), r.get("client_bytes"),
+          r.get("server_bytes"), r.get("client_cpu_ms"), r.get("server_cpu_ms"))
+         for i, r in enumerate(rows)])
+    db.commit()
+    return ok, len(rows) - ok
+
+
+def run_matrix(args, db):
+    spec = load_spec(args.spec)
+    openssl_dir = os.path.abspath(args.openssl_dir)
+    host, commit, version = run_identity(openssl_dir)
+    cur = db.execute(
+        "INSERT INTO runs (host, commit_id, started, openssl, spec) VALUES (?, ?, ?, ?, ?)",
+        (host, commit, datetime.now(timezone.utc).isoformat(timespec="seconds"),
+         version, json.dumps(spec, sort_keys=True)))
+    run_id = cur.lastrowid
+    db.commit()
+
+    workdir = args.cert_dir or tempfile.mkdtemp(prefix="quic-matrix-")
+    os.makedirs(workdir, exist_ok=True)
+    certs = {sig: make_cert(openssl_dir, sig, workdir) for sig in spec["sigs"]}
+    sets = server_sets(spec["sigs"])
+    set_of = {sig: i for i, s in enumerate(sets) for sig in s}
+
+    total = len(spec["kems"]) * len(spec["sigs"]) * len(spec["profiles"]) * spec["repeats"]
+    done = 0
+    print(f"Run {run_id} on {host} at {commit}: {total} cells", file=sys.stderr)
+    # Loopback servers are started on first use and kept until the end of the run
+    with contextlib.ExitStack() as stack:
+        servers = {}
+        # Repeats outermost, so slow drift of the machine spreads over all cells
+        for repeat in range(spec["repeats"]):
+            for profile in spec["profiles"]:
+                for sig in spec["sigs"]:
+                    for kem in spec["kems"]:
+                        crt, key = certs[sig]
+                        start = time.monotonic()
+                        if is_emulated(profile):
+                            backend = "netem_bench"
+                            rows = run_netem(openssl_dir, spec, profile, kem, crt, key,
+                                             repeat)
+                        else:
+                            backend = "loadgen"
+                            srv = (profile["name"], set_of[sig])
+                            if srv not in servers:
+                                log = os.path.join(workdir, "server-%s-%d.log" % srv)
+                                servers[srv] = stack.enter_context(loopback_server(
+                                    openssl_dir, spec["kems"],
+                                    [certs[s] for s in sets[srv[1]]], log))
+                            rows = run_loopback(openssl_dir, spec, kem, sig, servers[srv],
+                                                workdir)
+                        ok, failed = store_cell(db, run_id, kem, sig, profile["name"],
+                                                repeat, backend, rows)
+                        done += 1
+                        print(f"[{done}/{total}] {profile['name']} {sig} {kem} "
+                              f"repeat {repeat}: {ok} ok, {failed} failed "
+                              f"({time.monotonic() - start:.1f} s)", file=sys.stderr)
+    return run_id
+
+
+# === Summary tables ===
+def print_summary(db, run_ids):
+    marks = ",".join("?" * len(run_ids))
+    cells = db.execute(
+        f"SELECT c.profile, c.sig, c.kem, r.host, r.commit_id, c.id, c.failed "
+        f"FROM cells c JOIN runs r ON r.id = c.run_id WHERE c.run_id IN ({marks}) "
+        f"ORDER BY c.profile, c.sig, c.kem", run_ids).fetchall()
+    groups = {}
+    for profile, sig, kem, host, commit, cell_id, failed in cells:
+        g = groups.setdefault((profile, host, commit), {}).setdefault(
+            (sig, kem), {"cells": [], "failed": 0})
+        g["cells"].append(cell_id)
+        g["failed"] += failed
+
+    for (profile, host, commit), entries in groups.items():
+        print(f"\n== {profile}  ({host}, {commit}) ==")
+        print(f"{'Signature':<20} {'KEM':<18} {'n':>6} {'fail':>5} "
+              f"{'p50 ms':>9} {'p90 ms':>9} {'p99 ms':>9} {'p50 RTs':>8}")
+        for (sig, kem), g in entries.items():
+            q = ",".join("?" * len(g["cells"]))
+            hs = sorted(v for (v,) in db.execute(
+                f"SELECT handshake_ms FROM samples WHERE status = 'ok' "
+                f"AND cell_id IN ({q})", g["cells"]))
+            rts = sorted(v for (v,) in db.execute(
+                f"SELECT round_trips FROM samples WHERE status = 'ok' "
+                f"AND round_trips IS NOT NULL AND cell_id IN ({q})", g["cells"]))
+            rt = f"{percentile(rts, 50):>8d}" if rts else f"{'-':>8}"
+            print(f"{sig:<20} {kem:<18} {len(hs):>6} {g['failed']:>5} "
+                  f"{percentile(hs, 50):>9.3f} {percentile(hs, 90):>9.3f} "
+                  f"{percentile(hs, 99):>9.3f} {rt}")
+
+
+def select_runs(db, args):
+    if args.run:
+        return args.run
+    query, params = "SELECT id FROM runs WHERE 1 = 1", []
+    if args.host:
+        query += " AND host = ?"
+        params.append(args.host)
+    if args.commit:
+        query += " AND commit_id LIKE ?"
+        params.append(args.commit + "%")
+    ids = [i for (i,) in db.execute(query + " ORDER BY id", params)]
+    # Without a filter only the newest run is shown
+    return ids if (args.host or args.commit) else ids[-1:]
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Run a KEM x signature x network profile x repeat handshake matrix "
+                    "and store the results in SQLite.",
+        epilog="Example:\n  ./run_matrix.py --spec matrix.json --db results.sqlite\n"
+               "  ./run_matrix.py --db results.sqlite --summary --host raspberrypi",
+        formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--spec", help="Matrix spec (JSON), see matrix.example.json")
+    parser.add_argument("--db", default="results.sqlite",
+                        help="SQLite file to append to (default: results.sqlite)")
+    parser.add_argument("--openssl-dir", default=os.path.join(HERE, "openssl-3.5.0"),
+                        help="Built OpenSSL tree (default: openssl-3.5.0 next to this script)")
+    parser.add_argument("--cert-dir", help="Keep the generated certificates here and reuse them")
+    parser.add_argument("--summary", action="store_true",
+                        help="Only print summary tables of stored runs")
+    parser.add_argument("--run", type=int, action="append",
+                        help="Summarise this run id, may be repeated")
+    parser.add_argument("--host", help="Summarise the runs of this host")
+    parser.add_argument("--commit", help="Summarise the runs of this commit (prefix)")
+    args = parser.parse_args()
+
+    if not args.summary and not args.spec:
+        parser.error("--spec is required unless --summary is given")
+
+    db = sqlite3.connect(args.db)
+    db.executescript(SCHEMA)
+    if args.summary:
+        run_ids = select_runs(db, args)
+        if not run_ids:
+            sys.exit("no matching runs")
+    else:
+        run_ids = [run_matrix(args, db)]
+    print_summary(db, run_ids)
+    db.close()
+
+
+if __name__ == "__main__":
+    main()